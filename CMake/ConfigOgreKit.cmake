@@ -57,6 +57,7 @@ macro (configure_ogrekit ROOT OGREPATH OGRE_BACKEND)
 	option(OGREKIT_COMPILE_SOFTBODY			"Enable / Disable Bullet Softbody build" OFF)
 	option(OGREKIT_USE_NNODE				"Use Logic Node (It's Nodal Logic, not Blender LogicBrick)" OFF)
 	option(OGREKIT_USE_PARTICLE				"Use Paritcle" ON)
+	option(OGREKIT_USE_PROFILER			"Enable / Disable the scoped frame profiler" ON)
 	option(OGREKIT_COMPILE_OGRE_COMPONENTS	"Enable compile additional Ogre components (RTShader, Terrain, Paging, ... etc)" OFF)
 	option(OGREKIT_USE_RTSHADER_SYSTEM		"Enable shader system instead of fixed piped functions." OFF)
 	option(OGREKIT_USE_COMPOSITOR			"Enable post effect by compositor (Bloom, BlackAndWhite, HDR, ...)" OFF)
@@ -204,6 +205,7 @@ macro (configure_ogrekit ROOT OGREPATH OGRE_BACKEND)
 	option(SAMPLES_LUARUNTIME     "Build Samples/LuaRuntime"    OFF)
     option(SAMPLES_ANDROIDTEST    "Build Samples/Android/Test"  OFF)
 	option(SAMPLES_OGREDEMO		  "Build Samples/SampleBrowser" OFF)
+	option(SAMPLES_BENCHMARK      "Build Samples/Benchmark"     OFF)
 	
 	IF (SAMPLES_OGREDEMO)
 		set(OGREKIT_DISABLE_ZIP FALSE CACHE BOOL "Use external .zip resource loading" FORCE)	
@@ -113,6 +113,12 @@ UT_ASSERTCOMP(sizeof(void *) == 4, VOID_IS_4);
 #  define UT_INLINE    inline
 #endif
 
+#if UT_COMPILER == UT_COMPILER_MSVC
+# define UT_THREAD_LOCAL __declspec(thread)
+#else
+# define UT_THREAD_LOCAL __thread
+#endif
+
 #if (defined (_WIN32) && (_MSC_VER) && _MSC_VER >= 1400)
 	#define UT_ATTRIBUTE_ALIGNED_CLASS16(a) __declspec(align(16)) a
 	#define UT_ATTRIBUTE_ALIGN16 __declspec(align(16))
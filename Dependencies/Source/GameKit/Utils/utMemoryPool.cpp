@@ -0,0 +1,130 @@
+/*
+-------------------------------------------------------------------------------
+    General Purpose Utility Library, should be kept dependency free.
+    Unless the dependency can be compiled along with this library.
+
+    Copyright (c) 2009-2010 Charlie C.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "utMemoryPool.h"
+
+
+static volatile long    utPoolThreadCount = 0;
+static UT_THREAD_LOCAL  UTsize utPoolThreadSlot = 0;   // index + 1, 0 until first use
+
+
+UTsize utGetPoolThreadSlot(void)
+{
+	if (utPoolThreadSlot == 0)
+		utPoolThreadSlot = (UTsize)utAtomicAdd(&utPoolThreadCount, 1);
+
+	return utPoolThreadSlot <= UT_POOL_MAX_THREADS ? utPoolThreadSlot - 1 : UT_NPOS;
+}
+
+
+
+template <UTsize N>
+struct utPoolBytes
+{
+	UTuint8 m_bytes[N];
+};
+
+#define UT_POOL_CLASS_COUNT 8
+
+static utMemoryPool<utPoolBytes<32>,  0> utPool32;
+static utMemoryPool<utPoolBytes<64>,  0> utPool64;
+static utMemoryPool<utPoolBytes<96>,  0> utPool96;
+static utMemoryPool<utPoolBytes<128>, 0> utPool128;
+static utMemoryPool<utPoolBytes<192>, 0> utPool192;
+static utMemoryPool<utPoolBytes<256>, 0> utPool256;
+static utMemoryPool<utPoolBytes<384>, 0> utPool384;
+static utMemoryPool<utPoolBytes<512>, 0> utPool512;
+
+
+// One size class per 32 bytes up to MAX_SIZE.
+static const UTuint8 utPoolClassLookup[utPoolAllocator::MAX_SIZE / 32] =
+{
+	0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7
+};
+
+
+void* utPoolAllocator::allocate(size_t size)
+{
+	if (size == 0 || size > MAX_SIZE)
+		return malloc(size ? size : 1);
+
+	switch (utPoolClassLookup[(size - 1) / 32])
+	{
+	case 0: return utPool32.allocRaw();
+	case 1: return utPool64.allocRaw();
+	case 2: return utPool96.allocRaw();
+	case 3: return utPool128.allocRaw();
+	case 4: return utPool192.allocRaw();
+	case 5: return utPool256.allocRaw();
+	case 6: return utPool384.allocRaw();
+	default: return utPool512.allocRaw();
+	}
+}
+
+
+void utPoolAllocator::deallocate(void* p, size_t size)
+{
+	if (!p)
+		return;
+
+	if (size == 0 || size > MAX_SIZE)
+	{
+		free(p);
+		return;
+	}
+
+	switch (utPoolClassLookup[(size - 1) / 32])
+	{
+	case 0: utPool32.deallocRaw(p);  break;
+	case 1: utPool64.deallocRaw(p);  break;
+	case 2: utPool96.deallocRaw(p);  break;
+	case 3: utPool128.deallocRaw(p); break;
+	case 4: utPool192.deallocRaw(p); break;
+	case 5: utPool256.deallocRaw(p); break;
+	case 6: utPool384.deallocRaw(p); break;
+	default: utPool512.deallocRaw(p); break;
+	}
+}
+
+
+UTsize utPoolAllocator::getClassCount(void)
+{
+	return UT_POOL_CLASS_COUNT;
+}
+
+
+void utPoolAllocator::getStats(UTsize cls, utMemoryPoolStats& stats)
+{
+	switch (cls)
+	{
+	case 0: utPool32.getStats(stats);  break;
+	case 1: utPool64.getStats(stats);  break;
+	case 2: utPool96.getStats(stats);  break;
+	case 3: utPool128.getStats(stats); break;
+	case 4: utPool192.getStats(stats); break;
+	case 5: utPool256.getStats(stats); break;
+	case 6: utPool384.getStats(stats); break;
+	default: utPool512.getStats(stats); break;
+	}
+}
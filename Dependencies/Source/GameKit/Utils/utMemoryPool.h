@@ -27,84 +27,327 @@
 
 #include "utCommon.h"
 #include "utTypes.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
 
-// MemoryPool adapted from PocoC++
 
+// Slots are carved out of blocks of about this many bytes.
+#define UT_POOL_BLOCK_BYTES     16384
+#define UT_POOL_ALIGN           16
+
+// Threads after the first UT_POOL_MAX_THREADS share the locked free list.
+#define UT_POOL_MAX_THREADS     16
+#define UT_POOL_MAGAZINE        15
+
+
+#if UT_COMPILER == UT_COMPILER_MSVC
+UT_INLINE long utAtomicAdd(volatile long *p, long v)                { return _InterlockedExchangeAdd(p, v) + v; }
+UT_INLINE bool utAtomicCas(volatile long *p, long expected, long v) { return _InterlockedCompareExchange(p, v, expected) == expected; }
+UT_INLINE void utAtomicRelease(volatile long *p)                    { _InterlockedExchange(p, 0); }
+#else
+UT_INLINE long utAtomicAdd(volatile long *p, long v)                { return __sync_add_and_fetch(p, v); }
+UT_INLINE bool utAtomicCas(volatile long *p, long expected, long v) { return __sync_bool_compare_and_swap(p, expected, v); }
+UT_INLINE void utAtomicRelease(volatile long *p)                    { __sync_lock_release(p); }
+#endif
+
+
+// Small per process index of the calling thread, UT_NPOS once they run out.
+extern UTsize utGetPoolThreadSlot(void);
+
+
+struct utMemoryPoolStats
+{
+	UTsize  live;           // objects handed out
+	UTsize  peak;           // highest live count
+	UTsize  slots;          // slots carved from blocks so far
+	UTsize  slotSize;       // bytes per slot
+	UTsize  blocks;
+	UTsize  reservedBytes;  // held in blocks
+};
+
+
+// Slab pool for objects of type T.
+//
+// Objects are constructed with placement new into slots carved from large
+// contiguous blocks, and freed slots go on an intrusive free list. Each of the
+// first UT_POOL_MAX_THREADS threads keeps a small magazine of free slots, so the
+// pool lock is only taken to move half a magazine at a time. Blocks are released
+// when the pool is destroyed; objects still out at that point are not destructed.
+//
+// maxAlloc limits the slots carved, 0 for no limit.
 template <typename T, UTsize maxAlloc>
 class utMemoryPool
 {
 public:
-	typedef utArray<T *> BlockAlloc;
 
-public:
+	enum
+	{
+		SLOT_SIZE   = ((sizeof(T) > sizeof(void *) ? sizeof(T) : sizeof(void *)) + UT_POOL_ALIGN - 1) & ~(UT_POOL_ALIGN - 1),
+		BLOCK_SLOTS = UT_POOL_BLOCK_BYTES / SLOT_SIZE > 16 ? UT_POOL_BLOCK_BYTES / SLOT_SIZE : 16
+	};
 
+	typedef utArray<char *> Blocks;
 
-	utMemoryPool(UTsize nrAlloc)
+public:
+
+	utMemoryPool(UTsize nrAlloc = 0)
+		:   m_free(0), m_cursor(0), m_end(0),
+		    m_total(0), m_reserved(0), m_live(0), m_peak(0), m_lock(0)
 	{
+		memset(m_magazines, 0, sizeof(m_magazines));
 		initializePool(nrAlloc);
 	}
 
 	~utMemoryPool()
 	{
-		for (UTsize i=0; i<m_usedBlocks.capacity(); i++)
-			delete m_usedBlocks.at(i);
+		if (m_live != 0)
+			return;
+
+		for (UTsize i = 0; i < m_blocks.size(); i++)
+			free(m_blocks.at(i));
 	}
 
 	T *alloc(void)
 	{
-		if (m_usedBlocks.empty())
+		void *p = allocRaw();
+		return p ? new(p) T() : 0;
+	}
+
+	void dealloc(T *p)
+	{
+		if (p != 0)
 		{
-			if (maxAlloc ==0 || m_total < maxAlloc)
-			{
-				m_total += 1;
-				T *ptr = new T();
-				return ptr;
-			}
+			p->~T();
+			deallocRaw(p);
+		}
+	}
+
+	// Uninitialized slot of SLOT_SIZE bytes.
+	void *allocRaw(void)
+	{
+		void *p = 0;
+
+		UTsize thread = utGetPoolThreadSlot();
+		if (thread < UT_POOL_MAX_THREADS)
+		{
+			Magazine &mag = m_magazines[thread];
+			if (mag.count == 0)
+				refill(mag);
+
+			if (mag.count != 0)
+				p = mag.items[--mag.count];
 		}
 		else
 		{
-			T *r = m_usedBlocks.back();
-			m_usedBlocks.pop_back();
-			return r;
+			lock();
+			p = take();
+			unlock();
 		}
 
-		printf("Maximum nr of allocs exceeded");
-		return 0;
+		if (!p)
+		{
+			printf("Maximum nr of allocs exceeded\n");
+			return 0;
+		}
+
+		long live = utAtomicAdd(&m_live, 1), peak = m_peak;
+		while (live > peak && !utAtomicCas(&m_peak, peak, live))
+			peak = m_peak;
+
+		return p;
 	}
 
-	void dealloc(T *p)
+	void deallocRaw(void *p)
 	{
-		if (p != 0)
-			m_usedBlocks.push_back(p);
+		if (p == 0)
+			return;
+
+		utAtomicAdd(&m_live, -1);
+
+		UTsize thread = utGetPoolThreadSlot();
+		if (thread < UT_POOL_MAX_THREADS)
+		{
+			Magazine &mag = m_magazines[thread];
+			if (mag.count == UT_POOL_MAGAZINE)
+				spill(mag);
+
+			mag.items[mag.count++] = p;
+		}
+		else
+		{
+			lock();
+			give(p);
+			unlock();
+		}
 	}
 
 
 	UT_INLINE UTsize        getAllocatedCount(void)     { return m_total; }
 	UT_INLINE const UTsize  getMaxAlloc(void)           { return maxAlloc; }
-	UT_INLINE UTsize        getBlockSize(void)          { return sizeof (T); }
-	UT_INLINE UTsize        getPoolSize(void)           { return sizeof (T) * m_total; }
+	UT_INLINE UTsize        getBlockSize(void)          { return SLOT_SIZE; }
+	UT_INLINE UTsize        getPoolSize(void)           { return SLOT_SIZE * m_total; }
+	UT_INLINE UTsize        getLiveCount(void)          { return (UTsize)m_live; }
+	UT_INLINE UTsize        getPeakCount(void)          { return (UTsize)m_peak; }
+	UT_INLINE UTsize        getLiveBytes(void)          { return SLOT_SIZE * (UTsize)m_live; }
+
+	void getStats(utMemoryPoolStats &stats)
+	{
+		lock();
+		stats.live          = (UTsize)m_live;
+		stats.peak          = (UTsize)m_peak;
+		stats.slots         = m_total;
+		stats.slotSize      = SLOT_SIZE;
+		stats.blocks        = m_blocks.size();
+		stats.reservedBytes = m_reserved;
+		unlock();
+	}
 
 
 protected:
 
+	struct Slot
+	{
+		Slot *next;
+	};
+
+	// One cache line pair per thread, written by that thread only.
+	struct Magazine
+	{
+		UTsize  count;
+		void   *items[UT_POOL_MAGAZINE];
+	};
+
+
 	void initializePool(UTsize nr)
 	{
 		if (nr == 0 || nr == UT_NPOS)
 			return;
 
-		m_total = nr;
+		if (maxAlloc != 0 && nr > maxAlloc)
+			nr = maxAlloc;
+
+		addBlock(nr);
+	}
+
+	UT_INLINE void lock(void)
+	{
+		while (!utAtomicCas(&m_lock, 0, 1))
+			while (m_lock != 0) {}
+	}
+
+	UT_INLINE void unlock(void)
+	{
+		utAtomicRelease(&m_lock);
+	}
 
-		m_usedBlocks.reserve(m_total);
-		for (UTsize i=0; i<nr; i++)
+	void refill(Magazine &mag)
+	{
+		lock();
+		while (mag.count < (UT_POOL_MAGAZINE + 1) / 2)
 		{
-			T *ptr = new T();
-			m_usedBlocks.push_back(ptr);
+			void *p = take();
+			if (!p)
+				break;
+			mag.items[mag.count++] = p;
 		}
+		unlock();
+	}
+
+	void spill(Magazine &mag)
+	{
+		lock();
+		while (mag.count > UT_POOL_MAGAZINE / 2)
+			give(mag.items[--mag.count]);
+		unlock();
 	}
 
-	BlockAlloc  m_usedBlocks;
-	UTsize      m_total;
+	// Called with the lock held.
+	void *take(void)
+	{
+		if (m_free)
+		{
+			Slot *s = m_free;
+			m_free = s->next;
+			return s;
+		}
+
+		if (m_cursor == m_end)
+		{
+			UTsize nr = BLOCK_SLOTS;
+			if (maxAlloc != 0)
+			{
+				if (m_total >= maxAlloc)
+					return 0;
+				if (nr > maxAlloc - m_total)
+					nr = maxAlloc - m_total;
+			}
 
+			if (!addBlock(nr))
+				return 0;
+		}
+
+		void *p = m_cursor;
+		m_cursor += SLOT_SIZE;
+		return p;
+	}
+
+	UT_INLINE void give(void *p)
+	{
+		Slot *s = (Slot *)p;
+		s->next = m_free;
+		m_free = s;
+	}
+
+	bool addBlock(UTsize nr)
+	{
+		char *block = (char *)malloc(nr * SLOT_SIZE + UT_POOL_ALIGN);
+		if (!block)
+			return false;
+
+		m_blocks.push_back(block);
+		m_total    += nr;
+		m_reserved += nr * SLOT_SIZE + UT_POOL_ALIGN;
+
+		m_cursor = (char *)(((UTuintPtr)block + UT_POOL_ALIGN - 1) & ~(UTuintPtr)(UT_POOL_ALIGN - 1));
+		m_end    = m_cursor + nr * SLOT_SIZE;
+		return true;
+	}
+
+
+	Magazine        m_magazines[UT_POOL_MAX_THREADS];
+
+	Blocks          m_blocks;
+	Slot           *m_free;
+	char           *m_cursor, *m_end;
+	UTsize          m_total, m_reserved;
+	volatile long   m_live, m_peak;
+	volatile long   m_lock;
+};
+
+
+
+// Fixed size classes over slab pools, for class level operator new / delete
+// of polymorphic types. Larger requests go to the general heap.
+class utPoolAllocator
+{
+public:
+	enum { MAX_SIZE = 512 };
+
+	static void *allocate(size_t size);
+	static void  deallocate(void *p, size_t size);
+
+	static UTsize getClassCount(void);
+	static void   getStats(UTsize cls, utMemoryPoolStats &stats);
 };
 
+
+// Routes new / delete of a class and everything derived from it through
+// utPoolAllocator. The class needs a virtual destructor, delete reads the
+// size of the dynamic type.
+#define UT_DECLARE_POOLED_CLASS() \
+	static void* operator new(size_t size)              { void* p = utPoolAllocator::allocate(size); if (!p) throw std::bad_alloc(); return p; } \
+	static void  operator delete(void* p, size_t size)  { utPoolAllocator::deallocate(p, size); }
+
+
 #endif//_utMemoryPool_h_
@@ -39,6 +39,7 @@
 
 
 typedef std::string utString;
+
 typedef utArray<utString> utStringArray;
 
 
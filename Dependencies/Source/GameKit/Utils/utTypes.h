@@ -29,6 +29,7 @@
 
 #include "utCommon.h"
 #include <memory.h>
+#include <string>
 
 
 #define _UT_CACHE_LIMIT 999
@@ -40,6 +41,54 @@ template <typename T> UT_INLINE T       utMin(const T &a, const T &b)
 template <typename T> UT_INLINE T       utClamp(const T &v, const T &a, const T &b)     { return v < a ? a : v > b ? b : v; }
 
 
+// Element traits for utArray. POD elements are copied with memcpy, move()
+// hands an element's contents over to a default constructed one when storage
+// grows, so containers of containers do not deep copy.
+template <typename T>
+struct utTypeTraits
+{
+	enum { POD = 0 };
+	static UT_INLINE void move(T &dst, T &src) { dst = src; }
+};
+
+template <typename T>
+struct utTypeTraits<T *>
+{
+	enum { POD = 1 };
+	static UT_INLINE void move(T *&dst, T *&src) { dst = src; }
+};
+
+#define UT_DECLARE_POD_TYPE(T) \
+	template <> struct utTypeTraits<T> \
+	{ \
+		enum { POD = 1 }; \
+		static UT_INLINE void move(T &dst, T &src) { dst = src; } \
+	};
+
+UT_DECLARE_POD_TYPE(bool)
+UT_DECLARE_POD_TYPE(char)
+UT_DECLARE_POD_TYPE(signed char)
+UT_DECLARE_POD_TYPE(unsigned char)
+UT_DECLARE_POD_TYPE(short)
+UT_DECLARE_POD_TYPE(unsigned short)
+UT_DECLARE_POD_TYPE(int)
+UT_DECLARE_POD_TYPE(unsigned int)
+UT_DECLARE_POD_TYPE(long)
+UT_DECLARE_POD_TYPE(unsigned long)
+UT_DECLARE_POD_TYPE(UTint64)
+UT_DECLARE_POD_TYPE(UTuint64)
+UT_DECLARE_POD_TYPE(float)
+UT_DECLARE_POD_TYPE(double)
+
+// utString, here so no array of strings is instantiated without it
+template <typename C, typename Tr, typename A>
+struct utTypeTraits<std::basic_string<C, Tr, A> >
+{
+	enum { POD = 0 };
+	static UT_INLINE void move(std::basic_string<C, Tr, A> &dst, std::basic_string<C, Tr, A> &src) { dst.swap(src); }
+};
+
+
 // List iterator access.
 template <typename T>
 class utListIterator
@@ -572,7 +621,18 @@ public:
 
 };
 
+// Default utArray storage: allocate() returns nr default constructed
+// objects, deallocate() destroys and frees them.
 template <typename T>
+class utArrayAllocator
+{
+public:
+	static T   *allocate(UTsize nr)             { return new T[nr]; }
+	static void deallocate(T *p, UTsize nr)     { delete []p; }
+};
+
+
+template <typename T, typename Allocator = utArrayAllocator<T> >
 class utArray
 {
 public:
@@ -585,14 +645,14 @@ public:
 	typedef T           &ReferenceType;
 	typedef const T     &ConstReferenceType;
 
-	typedef utArrayIterator<utArray<T> >       Iterator;
-	typedef const utArrayIterator<utArray<T> > ConstIterator;
+	typedef utArrayIterator<utArray<T, Allocator> >       Iterator;
+	typedef const utArrayIterator<utArray<T, Allocator> > ConstIterator;
 
 public:
-	utArray() : m_size(0), m_capacity(0), m_data(0), m_cache(0)  {}
+	utArray() : m_size(0), m_capacity(0), m_data(0), m_cache(0), m_inline(0), m_inlineCapacity(0)  {}
 
-	utArray(const utArray<T>& o)
-		: m_size(o.size()), m_capacity(0), m_data(0), m_cache(0)
+	utArray(const utArray<T, Allocator>& o)
+		: m_size(o.size()), m_capacity(0), m_data(0), m_cache(0), m_inline(0), m_inlineCapacity(0)
 	{
 		reserve(m_size);
 		copy(m_data, o.m_data, m_size);
@@ -604,10 +664,9 @@ public:
 	{
 		if (!useCache)
 		{
-			if (m_data)
-				delete []m_data;
-			m_data = 0;
-			m_capacity = 0;
+			release();
+			m_data = m_inline;
+			m_capacity = m_inlineCapacity;
 			m_size = 0;
 			m_cache = 0;
 		}
@@ -642,7 +701,7 @@ public:
 	UT_INLINE void pop_back(void)
 	{
 		m_size--;
-		m_data[m_size].~T();
+		reset(m_data[m_size]);
 	}
 
 
@@ -651,15 +710,17 @@ public:
 		erase(find(v));
 	}
 
+	// Unordered, the last element moves into the hole.
 	void erase(UTsize pos)
 	{
 		if (m_size > 0)
 		{
 			if (pos != UT_NPOS)
 			{
-				swap(pos, m_size-1);
 				m_size--;
-				m_data[m_size].~T();
+				if (pos != m_size)
+					utTypeTraits<T>::move(m_data[pos], m_data[m_size]);
+				reset(m_data[m_size]);
 			}
 		}
 	}
@@ -702,17 +763,43 @@ public:
 
 		if (m_capacity < nr)
 		{
-			T *p = new T[nr];
+			T *p = Allocator::allocate(nr);
 			if (m_data != 0)
 			{
-				copy(p, m_data, m_size);
-				delete []m_data;
+				if (utTypeTraits<T>::POD)
+					memcpy(p, m_data, m_size * sizeof(T));
+				else
+				{
+					for (UTsize i = 0; i < m_size; i++)
+						utTypeTraits<T>::move(p[i], m_data[i]);
+				}
+				release();
 			}
 			m_data = p;
 			m_capacity = nr;
 		}
 	}
 
+	// Exchanges contents, without copying unless either side is inline.
+	void swap(utArray<T, Allocator> &o)
+	{
+		if (this == &o)
+			return;
+
+		if ((m_inline && m_data == m_inline) || (o.m_inline && o.m_data == o.m_inline))
+		{
+			utArray<T, Allocator> t(*this);
+			*this = o;
+			o = t;
+			return;
+		}
+
+		utSwap(m_data, o.m_data);
+		utSwap(m_size, o.m_size);
+		utSwap(m_capacity, o.m_capacity);
+		utSwap(m_cache, o.m_cache);
+	}
+
 	void sort(bool (*cmp)(const T &a, const T &b))
 	{
 		UTsize i, n=m_size;
@@ -756,17 +843,25 @@ public:
 	UT_INLINE Iterator       iterator(void)       { return m_data && m_size > 0 ? Iterator(m_data, m_size) : Iterator(); }
 	UT_INLINE ConstIterator  iterator(void) const { return m_data && m_size > 0 ? ConstIterator(m_data, m_size) : ConstIterator(); }
 
-	utArray<T> &operator= (const utArray<T> &rhs)
+	// Reuses the current storage when it is big enough.
+	utArray<T, Allocator> &operator= (const utArray<T, Allocator> &rhs)
 	{
 		if (this != &rhs)
 		{
-			clear();
 			UTsize os = rhs.size();
-			if (os > 0)
+			if (os > m_capacity)
 			{
-				resize(os);
-				copy(m_data, rhs.m_data, os);
+				clear();
+				reserve(os);
 			}
+			else if (!utTypeTraits<T>::POD)
+			{
+				for (UTsize i = os; i < m_size; i++)
+					reset(m_data[i]);
+			}
+
+			m_size = os;
+			copy(m_data, rhs.m_data, os);
 		}
 
 		return *this;
@@ -775,11 +870,38 @@ public:
 	UT_INLINE void copy(Pointer dst, ConstPointer src, UTsize size)
 	{
 		UT_ASSERT(size <= m_size);
-		for (UTsize i = 0; i < size; i++) dst[i] = src[i];
+		if (utTypeTraits<T>::POD)
+		{
+			if (size > 0)
+				memcpy(dst, src, size * sizeof(T));
+		}
+		else
+		{
+			for (UTsize i = 0; i < size; i++) dst[i] = src[i];
+		}
 	}
 
 protected:
 
+	// Starts out in storage the caller owns, see utSmallArray.
+	utArray(Pointer storage, UTsize nr)
+		: m_size(0), m_capacity(nr), m_data(storage), m_cache(0), m_inline(storage), m_inlineCapacity(nr)
+	{
+	}
+
+	UT_INLINE void release(void)
+	{
+		if (m_data && m_data != m_inline)
+			Allocator::deallocate(m_data, m_capacity);
+	}
+
+	// Slots past the end stay constructed, drop what a removed element held.
+	UT_INLINE void reset(T &v)
+	{
+		if (!utTypeTraits<T>::POD)
+			v = T();
+	}
+
 	void swap(UTsize a, UTsize b)
 	{
 		ValueType t= m_data[a];
@@ -791,6 +913,56 @@ protected:
 	UTsize      m_capacity;
 	Pointer     m_data;
 	int         m_cache;
+	Pointer     m_inline;
+	UTsize      m_inlineCapacity;
+};
+
+
+// utArray with room for N elements inline, it only allocates once it outgrows
+// them. Can be passed anywhere a utArray<T> is expected.
+template <typename T, UTsize N, typename Allocator = utArrayAllocator<T> >
+class utSmallArray : public utArray<T, Allocator>
+{
+public:
+	typedef utArray<T, Allocator> Base;
+
+public:
+	utSmallArray() : Base(m_storage, N) {}
+
+	utSmallArray(const Base &o) : Base(m_storage, N)
+	{
+		Base::operator=(o);
+	}
+
+	utSmallArray(const utSmallArray<T, N, Allocator> &o) : Base(m_storage, N)
+	{
+		Base::operator=(o);
+	}
+
+	utSmallArray<T, N, Allocator> &operator= (const Base &rhs)
+	{
+		Base::operator=(rhs);
+		return *this;
+	}
+
+	utSmallArray<T, N, Allocator> &operator= (const utSmallArray<T, N, Allocator> &rhs)
+	{
+		Base::operator=(rhs);
+		return *this;
+	}
+
+	UT_INLINE bool isInline(void) const { return this->m_data == m_storage; }
+
+private:
+	T m_storage[N];
+};
+
+
+template <typename T, typename Allocator>
+struct utTypeTraits<utArray<T, Allocator> >
+{
+	enum { POD = 0 };
+	static UT_INLINE void move(utArray<T, Allocator> &dst, utArray<T, Allocator> &src) { dst.swap(src); }
 };
 
 template <typename T>
@@ -32,6 +32,8 @@
 #include "gkRigidBody.h"
 #include "gkLogger.h"
 #include "gkNavPath.h"
+#include "gkScene.h"
+#include "gkSpatialHash.h"
 #include "PolylineSegmentedPathwaySegmentRadii.h"
 #include "QueryPathAlike.h"
 #include "QueryPathAlikeUtilities.h"
@@ -42,6 +44,7 @@
 using namespace OpenSteer;
 
 gkSteeringObject::OTHERS gkSteeringObject::m_others;
+gkSteeringObject::BY_OBJECT gkSteeringObject::m_byObject;
 
 /////////////////////////////////
 
@@ -318,6 +321,7 @@ gkSteeringObject::gkSteeringObject(gkGameObject* obj, gkScalar maxSpeed, const g
 	  m_speed(0),
 	  m_maxForce(maxSpeed),
 	  m_maxSpeed(maxSpeed),
+	  m_evadeRadius(0.f),
 	  m_state(UNKNOWN),
 	  m_smoothedAcceleration(Vec3::zero),
 	  m_forward(forward),
@@ -342,11 +346,16 @@ gkSteeringObject::gkSteeringObject(gkGameObject* obj, gkScalar maxSpeed, const g
 	reset();
 
 	gkSteeringObject::m_others.insert(this);
+	gkSteeringObject::m_byObject.insert(m_obj, this);
 }
 
 gkSteeringObject::~gkSteeringObject()
 {
 	gkSteeringObject::m_others.erase(this);
+
+	UTsize pos = gkSteeringObject::m_byObject.find(m_obj);
+	if (pos != UT_NPOS && gkSteeringObject::m_byObject.at(pos) == this)
+		gkSteeringObject::m_byObject.remove(m_obj);
 }
 
 void gkSteeringObject::reset()
@@ -597,41 +606,60 @@ Vec3 gkSteeringObject::steerToEvadeOthers(const gkGameObject* target)
 	// sum up weighted evasion
 	Vec3 evade (0, 0, 0);
 
+	gkSpatialHash* hash = m_obj->getOwner() ? m_obj->getOwner()->getSpatialHash() : 0;
+	if (hash && m_evadeRadius > 0)
+	{
+		// only the neighbours, far ones barely weigh in
+		utSmallArray<gkGameObject*, 16> neighbours;
+		hash->querySphere(m_obj->getWorldPosition(), m_evadeRadius, neighbours);
+
+		for (UTsize i = 0; i < neighbours.size(); i++)
+		{
+			UTsize pos = gkSteeringObject::m_byObject.find(neighbours[i]);
+			if (pos != UT_NPOS)
+				addEvasion(evade, *gkSteeringObject::m_byObject.at(pos), target);
+		}
+
+		return evade;
+	}
+
 	OTHERS::iterator it = gkSteeringObject::m_others.begin();
 
 	while (it != gkSteeringObject::m_others.end())
 	{
-		gkSteeringObject& e = **it;
-
-		if (this->m_obj != e.m_obj && target != e.m_obj && e.speed() > std::numeric_limits<float>::epsilon())
-		{
-			const Vec3 eOffset = e.position() - position();
-			const float eDistance = eOffset.length();
+		addEvasion(evade, **it, target);
+		++it;
+	}
+	return evade;
+}
 
-			GK_ASSERT(eDistance >= std::numeric_limits<float>::epsilon());
+void gkSteeringObject::addEvasion(Vec3& evade, const gkSteeringObject& e, const gkGameObject* target)
+{
+	if (this->m_obj != e.m_obj && target != e.m_obj && e.speed() > std::numeric_limits<float>::epsilon())
+	{
+		const Vec3 eOffset = e.position() - position();
+		const float eDistance = eOffset.length();
 
-			// xxx maybe this should take into account e's heading? xxx
-			const float timeEstimate = 0.5f * eDistance / e.speed(); //xxx
-			const Vec3 eFuture = e.predictFuturePosition (timeEstimate);
+		GK_ASSERT(eDistance >= std::numeric_limits<float>::epsilon());
 
-			// steering to flee from eFuture (enemy's future position)
-			const Vec3 flee = xxxsteerForFlee(eFuture);
+		// xxx maybe this should take into account e's heading? xxx
+		const float timeEstimate = 0.5f * eDistance / e.speed(); //xxx
+		const Vec3 eFuture = e.predictFuturePosition (timeEstimate);
 
-			const float eForwardDistance = forward().dotProduct(eOffset);
-			const float behindThreshold = radius() * -2;
+		// steering to flee from eFuture (enemy's future position)
+		const Vec3 flee = xxxsteerForFlee(eFuture);
 
-			const float distanceWeight = 4 / eDistance;
-			const float forwardWeight = ((eForwardDistance > behindThreshold) ?
-			                             1.0f : 0.5f);
+		const float eForwardDistance = forward().dotProduct(eOffset);
+		const float behindThreshold = radius() * -2;
 
-			const Vec3 adjustedFlee = flee * distanceWeight * forwardWeight;
+		const float distanceWeight = 4 / eDistance;
+		const float forwardWeight = ((eForwardDistance > behindThreshold) ?
+		                             1.0f : 0.5f);
 
-			evade += adjustedFlee;
-		}
+		const Vec3 adjustedFlee = flee * distanceWeight * forwardWeight;
 
-		++it;
+		evade += adjustedFlee;
 	}
-	return evade;
 }
 
 // QQQ ad hoc speed limitation based on path orientation...
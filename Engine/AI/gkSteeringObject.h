@@ -77,6 +77,9 @@ public:
 	GK_INLINE float maxSpeed(void) const {return m_maxSpeed;}
 	GK_INLINE float setMaxSpeed(float ms) {return m_maxSpeed = ms;}
 
+	GK_INLINE float evadeRadius(void) const {return m_evadeRadius;}
+	GK_INLINE float setEvadeRadius(float r) {return m_evadeRadius = r;}
+
 	GK_INLINE gkScalar curvature () const {return m_curvature;}
 	void measurePathCurvature (const float elapsedTime);
 
@@ -102,6 +105,7 @@ protected:
 	bool clearPathToGoal(const gkVector3& goalPosition, gkGameObject* target = 0);
 	gkScalar adjustObstacleAvoidanceLookAhead(bool clearPath, const gkVector3& goalPosition, gkScalar minPredictTime, gkScalar maxPredictTime);
 	OpenSteer::Vec3 steerToEvadeOthers(const gkGameObject* target = 0);
+	void addEvasion(OpenSteer::Vec3& evade, const gkSteeringObject& e, const gkGameObject* target);
 	gkVector3 steerToFollowPathLinear(const int direction, const float predictionTime, const gkNavPath& path);
 	gkScalar combinedLookAheadTime (float minTime, gkScalar minDistance) const;
 	OpenSteer::Vec3 mapPointAndDirectionToTangent(gkNavPath const& pathway, OpenSteer::Vec3 const& point, int direction) const;
@@ -119,6 +123,10 @@ protected:
 	typedef std::set<gkSteeringObject*> OTHERS;
 	static OTHERS m_others;
 
+	// by steered object, for neighbours found through gkSpatialHash
+	typedef utHashTable<utPointerHashKey, gkSteeringObject*> BY_OBJECT;
+	static BY_OBJECT m_byObject;
+
 	float m_mass;       // mass (defaults to unity so acceleration=force)
 
 	float m_radius;     // size of bounding sphere, for obstacle avoidance, etc.
@@ -132,6 +140,8 @@ protected:
 	float m_maxSpeed;   // the maximum speed this vehicle is allowed to move
 	// (velocity is clipped to this magnitude)
 
+	float m_evadeRadius; // others further away are not evaded, 0 evades all
+
 private:
 
 	STATE m_state;
@@ -51,7 +51,9 @@ void gkTransformChannel::evaluateImpl(const gkScalar& time, const gkScalar& delt
 	// clear previous channel
 	gkTransformState channel = obj->getTransformState();
 
-	gkEuler euler = obj->getRotation();
+	gkEuler euler;
+	if (m_isEulerRotation)
+		euler = obj->getRotation();
 
 	
 	while (i < len)
@@ -129,7 +131,7 @@ void gkBoneChannel::applyTransform(void* object, const gkTransformState* transfo
 	
 	if(skel)
 	{
-		gkBone* bone = skel->getBone(m_name);
+		gkBone* bone = skel->getBone(m_boneName);
 		if(bone && !(bone -> isManuallyControlled()))
 			bone->applyChannelTransform(*transform, weight);
 	}
@@ -168,11 +168,13 @@ protected:
 class gkBoneChannel : public gkTransformChannel
 {
 public:
-	gkBoneChannel(const gkString& name, gkAnimation* parent) : gkTransformChannel(name, parent) {}
+	gkBoneChannel(const gkString& name, gkAnimation* parent) : gkTransformChannel(name, parent), m_boneName(name) {}
 	virtual ~gkBoneChannel() {}
 
 protected:
 	virtual void applyTransform(void* object, const gkTransformState* transform, const gkScalar& weight) const;
+
+	gkHashedString m_boneName; // hashed once, looked up every evaluation
 };
 
 
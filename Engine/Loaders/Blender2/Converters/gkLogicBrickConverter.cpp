@@ -584,7 +584,6 @@ void gkLogicLoader::convertObject(Blender::Object* bobj, gkGameObject* gobj, gkL
 			break;
 		case CONT_EXPRESSION:
 			{
-#ifdef OGREKIT_USE_LUA
 				gkExpressionController* sc = new gkExpressionController(gobj, lnk, bcont->name);
 				lc = sc;
 
@@ -595,7 +594,6 @@ void gkLogicLoader::convertObject(Blender::Object* bobj, gkGameObject* gobj, gkL
 				{
 					sc->setExpression(pcon->str);
 				}
-#endif
 			} break;
 		case CONT_PYTHON:
 			{
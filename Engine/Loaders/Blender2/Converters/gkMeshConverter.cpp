@@ -300,6 +300,7 @@ void gkBlenderMeshConverter::convertTextureFace(gkMaterialProperties& gma, gkMes
 
 		sprintf(buf, "TextureFace %i", (uid++));
 		gma.m_name = buf;
+		gma.m_symbol = gma.m_name;
 	}
 
 	if (imas && gma.m_mode & gkMaterialProperties::MA_HASFACETEX)
@@ -357,6 +358,7 @@ void gkBlenderMeshConverter::convertMaterial(Blender::Material* bma, gkMaterialP
 	convertTextureFace(gma, hk, 0);
 
 	gma.m_name          = GKB_IDNAME(bma);
+	gma.m_symbol        = gma.m_name;
 	gma.m_hardness      = bma->har / 4.f;
 	gma.m_refraction    = bma->ref;
 	gma.m_emissive      = bma->emit;
@@ -309,6 +309,10 @@ void gkBlendFile::buildTextFiles(void)
 
 void gkBlendFile::buildAllTextures(void)
 {
+	// no texture manager without a render system
+	if (gkEngine::getSingleton().getUserDefs().headless)
+		return;
+
 	gkBlendListIterator iter = m_file->getImageList();
 
 	while (iter.hasMoreElements())	
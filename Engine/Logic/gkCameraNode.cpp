@@ -212,7 +212,7 @@ void gkCameraNode::calculateNewPosition(const gkVector3& currentPosition, gkScal
 
 		Ogre::Ray ray(m_center, direction);
 
-		gkSweptTest::AVOID_LIST avoidList;
+		utSmallArray<btCollisionObject*, 1> avoidList;
 		avoidList.push_back(m_centerObj->getPhysicsController()->getCollisionObject());
 
 		gkSweptTest sweptTest(avoidList);
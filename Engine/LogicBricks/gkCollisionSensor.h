@@ -45,8 +45,8 @@ public:
 class gkCollisionSensor : public gkLogicSensor
 {
 protected:
-	utArray<gkGameObject*> m_colObjList;
-	gkString m_material, m_prop;
+	utSmallArray<gkGameObject*, 8> m_colObjList;
+	gkHashedString m_material, m_prop;
 
 
 public:
@@ -58,12 +58,15 @@ public:
 
 	bool query(void);
 
+	// reads the contacts gathered by the last physics step
+	bool isParallelQuery(void) const {return true;}
+
 	GK_INLINE void            setMaterial(const gkString& material)       {m_material = material;}
 	GK_INLINE void            setProperty(const gkString& prop)           {m_prop = prop;}
-	GK_INLINE const gkString& getMaterial(void)                     const {return m_material;}
-	GK_INLINE const gkString& getProperty(void)                     const {return m_prop;}
+	GK_INLINE const gkString& getMaterial(void)                     const {return m_material.str();}
+	GK_INLINE const gkString& getProperty(void)                     const {return m_prop.str();}
 	GK_INLINE const int 	  getHitObjectCount(void)               const {return m_colObjList.size();}
-	GK_INLINE const utArray<gkGameObject*> getHitObjects(void)      const {return m_colObjList;}
+	GK_INLINE const utArray<gkGameObject*>& getHitObjects(void)     const {return m_colObjList;}
 	GK_INLINE  gkGameObject*  getHitObject(int nr)                        {return (nr<(int)m_colObjList.size()) ? m_colObjList[nr] : NULL;}
 
 
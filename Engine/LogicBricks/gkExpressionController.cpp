@@ -25,19 +25,57 @@
 -------------------------------------------------------------------------------
 */
 #include "gkCommon.h"
-#ifdef OGREKIT_USE_LUA
-
 #include "gkExpressionController.h"
 #include "gkLogicManager.h"
-#include "gkTextManager.h"
-#include "gkTextFile.h"
+#include "gkLogicSensor.h"
+#include "gkLogicLink.h"
+#include "gkGameObject.h"
 #include "gkUtils.h"
+#include "gkLogger.h"
+
+#ifdef OGREKIT_USE_LUA
 #include "Script/Lua/gkLuaManager.h"
 #include "Script/Lua/gkLuaUtils.h"
+#endif
+
+
+// Names resolve to the linked sensors first, then the owner's properties.
+class gkExpressionControllerScope : public gkLogicExpression::Scope
+{
+public:
+	gkExpressionControllerScope(gkSensors& sensors, gkGameObject* object)
+		:    m_sensors(sensors), m_object(object)
+	{
+	}
+
+	gkLogicSensor* findSensor(const gkString& name)
+	{
+		gkSensorIterator it(m_sensors);
+		while (it.hasMoreElements())
+		{
+			gkLogicSensor* sens = it.getNext();
+			if (sens->getName() == name)
+				return sens;
+		}
+		return 0;
+	}
+
+	gkVariable* findVariable(const gkString& name)
+	{
+		if (m_object && m_object->hasVariable(name))
+			return m_object->getVariable(name);
+		return 0;
+	}
+
+private:
+	gkSensors&    m_sensors;
+	gkGameObject* m_object;
+};
+
 
 
 gkExpressionController::gkExpressionController(gkGameObject* object, gkLogicLink* link, const gkString& name)
-	:       gkLogicController(object, link, name), m_script(0), m_error(false), m_isModule(false)
+	:       gkLogicController(object, link, name), m_script(0), m_error(false), m_isModule(false), m_compiled(false)
 {
 }
 
@@ -55,18 +93,48 @@ gkLogicBrick* gkExpressionController::clone(gkLogicLink* link, gkGameObject* des
 	gkExpressionController* cont = new gkExpressionController(*this);
 	cont->cloneImpl(link, dest);
 
+	// names resolve again against the clone's own sensors and properties
+	cont->m_native.clear();
+	cont->m_compiled = false;
+
 	return cont;
 }
 
 
 void gkExpressionController::setExpression(const gkString& str)
 {
+	// sensors are linked after controllers, compiling waits for the first execute
+	m_expression = str;
+	m_native.clear();
+	m_compiled = false;
+	m_error = false;
+}
+
 
-	gkString expr = "return " + str + "\n";
-	gkLuaScript* scrpt = gkLuaManager::getSingleton().createFromText(
-		gkResourceName(gkUtils::getUniqueName(m_name), getObjectGroupName()), expr);
-	if (scrpt)
-		m_script = scrpt;	
+void gkExpressionController::compile(void)
+{
+	m_compiled = true;
+	if (m_expression.empty())
+		return;
+
+	gkExpressionControllerScope scope(m_sensors, m_object);
+	if (m_native.compile(m_expression, scope))
+		return;
+
+#ifdef OGREKIT_USE_LUA
+	if (!m_script)
+	{
+		gkString expr = "return " + m_expression + "\n";
+		m_script = gkLuaManager::getSingleton().createFromText(
+			gkResourceName(gkUtils::getUniqueName(m_name), getObjectGroupName()), expr);
+	}
+
+	if (m_script)
+		return;
+#endif
+
+	gkLogMessage("ExpressionController: " << m_name << ": " << m_native.getError());
+	m_error = true;
 }
 
 
@@ -75,22 +143,36 @@ void gkExpressionController::execute(void)
 	if (m_error || m_sensors.empty())
 		return;
 
-	// Main script, can be null.
-	if (m_script != 0)
+	if (!m_compiled)
+		compile();
+
+	bool ret;
+	if (m_native.isCompiled())
+		ret = m_native.evaluate();
+	else
 	{
+#ifdef OGREKIT_USE_LUA
+		if (!m_script)
+			return;
+
 		m_error = !m_script->execute();
-		if (!m_error && !m_actuators.empty())
+		if (m_error)
+			return;
+
+		ret = m_script->getReturnBoolValue();
+#else
+		return;
+#endif
+	}
+
+	if (!m_actuators.empty())
+	{
+		gkLogicManager* mgr = m_link->getLogicManager();
+		gkActuatorIterator it(m_actuators);
+		while (it.hasMoreElements())
 		{
-			bool ret = m_script->getReturnBoolValue();
-			gkLogicManager* mgr = m_link->getLogicManager();
-			gkActuatorIterator it(m_actuators);
-			while (it.hasMoreElements())
-			{
-				gkLogicActuator* act = it.getNext();
-				mgr->push(this, act, ret);
-			}
+			gkLogicActuator* act = it.getNext();
+			mgr->push(this, act, ret);
 		}
 	}
-
 }
-#endif //OGREKIT_USE_LUA
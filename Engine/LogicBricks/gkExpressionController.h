@@ -28,14 +28,20 @@
 #define _gkExpressionController_h_
 
 #include "gkLogicController.h"
-#ifdef OGREKIT_USE_LUA
+#include "gkLogicExpression.h"
 
 
+// Expressions are compiled natively on first use, the Lua script is only
+// built for expressions the native compiler rejects.
 class gkExpressionController : public gkLogicController
 {
 protected:
 	class gkLuaScript* m_script;
-	bool m_error, m_isModule;
+	bool m_error, m_isModule, m_compiled;
+	gkString m_expression;
+	gkLogicExpression m_native;
+
+	void compile(void);
 
 public:
 
@@ -51,8 +57,9 @@ public:
 	GK_INLINE bool isModule(void)               {return m_isModule;}
 	GK_INLINE void setScript(gkLuaScript* sc)   {m_script = sc;}
 	GK_INLINE gkLuaScript* getScript(void)      {return m_script;}
-};
 
-#endif//OGREKIT_USE_LUA
+	GK_INLINE const gkString& getExpression(void) const        {return m_expression;}
+	GK_INLINE const gkLogicExpression& getNative(void) const   {return m_native;}
+};
 
 #endif//_gkExpressionController_h_
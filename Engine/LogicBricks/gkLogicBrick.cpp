@@ -31,7 +31,7 @@
 
 gkLogicBrick::gkLogicBrick(gkGameObject* object, gkLogicLink* link, const gkString& name)
 	:       m_object(object), m_name(name), m_link(link), m_stateMask(0), m_pulseState(BM_IDLE),
-	        m_debugMask(0), m_isActive(false), m_priority(0), m_listener(0)
+	        m_debugMask(0), m_isActive(false), m_priority(0), m_planIndex(-1), m_listener(0)
 {
 	GK_ASSERT(m_object);
 	m_scene = m_object->getOwner();
@@ -48,6 +48,7 @@ void gkLogicBrick::cloneImpl(gkLogicLink* link, gkGameObject* dest)
 	m_scene         = m_object->getOwner();
 	m_pulseState    = BM_IDLE;
 	m_isActive      = false;
+	m_planIndex     = -1;
 	m_link          = link;
 
 	m_link->getLogicManager()->notifySort();
@@ -32,6 +32,7 @@
 #include "gkString.h"
 #include "gkLogicLink.h"
 #include "gkScene.h"
+#include "utMemoryPool.h"
 
 class gkLogicSensor;
 class gkLogicController;
@@ -91,6 +92,7 @@ protected:
 	int                 m_stateMask, m_pulseState, m_debugMask;
 	bool                m_isActive;
 	int                 m_priority;
+	int                 m_planIndex;
 	Listener*           m_listener;
 
 	virtual void        cloneImpl(gkLogicLink* link, gkGameObject* dest);
@@ -101,6 +103,9 @@ public:
 	gkLogicBrick(gkGameObject* object, gkLogicLink* link, const gkString& name);
 	virtual ~gkLogicBrick();
 
+	// bricks are cloned with their objects at runtime, keep them off the general heap
+	UT_DECLARE_POOLED_CLASS()
+
 	bool inActiveState(void) const;
 
 	bool wantsDebug(void) const;
@@ -133,6 +138,10 @@ public:
 	GK_INLINE gkLogicLink*      getLink(void)             { return m_link; }
 	GK_INLINE int               getPriority(void)   const { return m_priority;}
 
+	// slot in gkLogicManager's actuator plan, -1 until planned
+	GK_INLINE void              _setPlanIndex(int v)      { m_planIndex = v;}
+	GK_INLINE int               _getPlanIndex(void) const { return m_planIndex;}
+
 	void setPriority(bool v);
 	void setPriority(int v);
 
@@ -27,6 +27,40 @@
 #include "gkLogicDispatcher.h"
 #include "gkLogicSensor.h"
 #include "gkGameObject.h"
+#include "gkEngine.h"
+#include "gkUserDefs.h"
+#include "Thread/gkJobSystem.h"
+
+// fewer batched queries than this run on the calling thread
+#define GK_SENSOR_QUERY_GRAIN 8
+
+
+enum gkSensorStep
+{
+	SS_SKIP = 0,
+	SS_SERIAL,
+	SS_BATCHED,
+};
+
+
+class gkSensorQueryBody : public gkParallelForCall
+{
+public:
+	gkSensorQueryBody(gkAbstractDispatcher::SensorList& batch, utArray<UTuint8>& results)
+		:    m_batch(batch), m_results(results)
+	{
+	}
+
+	void run(UTsize begin, UTsize end)
+	{
+		for (UTsize i = begin; i < end; i++)
+			m_results[i] = m_batch[i]->query() ? 1 : 0;
+	}
+
+private:
+	gkAbstractDispatcher::SensorList& m_batch;
+	utArray<UTuint8>&                 m_results;
+};
 
 
 
@@ -36,6 +70,13 @@ void gkAbstractDispatcher::doDispatch(SensorList& senslist)
 {
 	if (!senslist.empty())
 	{
+		gkJobSystem* jobs = gkJobSystem::getSingletonPtr();
+		if (jobs && jobs->getNumWorkers() > 0 && gkEngine::getSingleton().getUserDefs().parallelSensors)
+		{
+			doBatchedDispatch(senslist);
+			return;
+		}
+
 		SensorList::Iterator it = senslist.iterator();
 		while (it.hasMoreElements())
 		{
@@ -49,6 +90,71 @@ void gkAbstractDispatcher::doDispatch(SensorList& senslist)
 }
 
 
+void gkAbstractDispatcher::doBatchedDispatch(SensorList& senslist)
+{
+	// Gather: sensor headers run in list order, queries that can go
+	// parallel are collected and capture their inputs.
+
+	UTsize i, s = senslist.size();
+	m_steps.resize(s);
+	m_batch.clear(true);
+
+	for (i = 0; i < s; ++i)
+	{
+		gkLogicSensor*   sens = senslist[i];
+		gkGameObject*    obj = sens->getObject();
+
+		m_steps[i] = SS_SKIP;
+		if (!obj || !obj->isInstanced() || !sens->_beginQuery())
+			continue;
+
+		if (sens->_canBatchQuery())
+		{
+			sens->prepareQuery();
+			m_batch.push_back(sens);
+			m_steps[i] = SS_BATCHED;
+		}
+		else
+			m_steps[i] = SS_SERIAL;
+	}
+
+
+	// Query: the post step world is only read from here on.
+
+	UTsize nb = m_batch.size();
+	m_results.resize(nb);
+
+	gkSensorQueryBody body(m_batch, m_results);
+	if (nb > GK_SENSOR_QUERY_GRAIN)
+		gkJobSystem::getSingleton().parallelFor(nb, GK_SENSOR_QUERY_GRAIN, body);
+	else
+		body.run(0, nb);
+
+
+	// Apply: results dispatch in list order, so controllers and actuators
+	// are pushed exactly as a serial pass would.
+
+	UTsize b = 0;
+	for (i = 0; i < s; ++i)
+	{
+		gkLogicSensor* sens = senslist[i];
+
+		switch (m_steps[i])
+		{
+		case SS_BATCHED:
+			sens->_endQuery(m_results[b++] != 0);
+			break;
+		case SS_SERIAL:
+			sens->prepareQuery();
+			sens->_endQuery(sens->_runQuery());
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+
 
 void gkAbstractDispatcher::reset(void)
 {
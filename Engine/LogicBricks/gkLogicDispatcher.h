@@ -43,7 +43,13 @@ public:
 protected:
 	SensorList m_sensors;
 
+	// batched dispatch scratch, reused between ticks
+	utArray<UTuint8>        m_steps;
+	SensorList              m_batch;
+	utArray<UTuint8>        m_results;
+
 	void doDispatch(SensorList& senslist);
+	void doBatchedDispatch(SensorList& senslist);
 
 public:
 	gkAbstractDispatcher() {}
@@ -0,0 +1,596 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkLogicExpression.h"
+#include "gkLogicSensor.h"
+#include "gkVariable.h"
+#include "OgreStringConverter.h"
+#include <math.h>
+#include <stdlib.h>
+
+
+// Recursive descent over the source, emitting code into the expression as
+// it goes. Precedence, loosest first: or, and, not, comparisons, + -,
+// * / // %, unary - +, **. Every production returns the static type of
+// the value it leaves on the stack.
+class gkLogicExpressionParser
+{
+public:
+	enum Type
+	{
+		ET_ERROR = -1,
+		ET_BOOL,
+		ET_NUM,
+		ET_STR
+	};
+
+	gkLogicExpressionParser(gkLogicExpression& expr, gkLogicExpression::Scope& scope, const gkString& src)
+		:    m_expr(expr), m_scope(scope), m_src(src), m_pos(0), m_start(0),
+		     m_tok(TK_END), m_num(0.0), m_depth(0)
+	{
+	}
+
+	bool parse(void)
+	{
+		next();
+
+		Type t = parseOr();
+		if (t == ET_ERROR)
+			return false;
+		if (m_tok != TK_END)
+		{
+			fail("unexpected '" + m_text + "'");
+			return false;
+		}
+
+		truth(t);
+		return true;
+	}
+
+private:
+	enum Token
+	{
+		TK_END,
+		TK_NUM,
+		TK_STR,
+		TK_NAME,
+		TK_OP
+	};
+
+	gkLogicExpression&         m_expr;
+	gkLogicExpression::Scope&  m_scope;
+	const gkString&            m_src;
+	size_t                     m_pos, m_start;
+	Token                      m_tok;
+	gkString                   m_text;
+	double                     m_num;
+	int                        m_depth;
+
+
+	Type fail(const gkString& msg)
+	{
+		if (m_expr.m_error.empty())
+			m_expr.m_error = "column " + Ogre::StringConverter::toString((int)m_start + 1) + ": " + msg;
+		return ET_ERROR;
+	}
+
+
+	static bool isNumeric(Type t) { return t == ET_BOOL || t == ET_NUM; }
+
+	bool isToken(const char* text) const
+	{
+		return (m_tok == TK_OP || m_tok == TK_NAME) && m_text == text;
+	}
+
+	bool accept(const char* text)
+	{
+		if (!isToken(text))
+			return false;
+		next();
+		return true;
+	}
+
+
+	void next(void)
+	{
+		const char* cp = m_src.c_str();
+		while (m_pos < m_src.size() && isspace((unsigned char)cp[m_pos]))
+			++m_pos;
+
+		m_start = m_pos;
+		m_text.clear();
+		if (m_pos >= m_src.size())
+		{
+			m_tok = TK_END;
+			return;
+		}
+
+		const char c = cp[m_pos];
+		if (isdigit((unsigned char)c) || (c == '.' && isdigit((unsigned char)cp[m_pos + 1])))
+		{
+			char* end = 0;
+			m_num = strtod(cp + m_pos, &end);
+			m_pos = end - cp;
+			m_text = m_src.substr(m_start, m_pos - m_start);
+			m_tok = TK_NUM;
+		}
+		else if (isalpha((unsigned char)c) || c == '_')
+		{
+			while (m_pos < m_src.size() && (isalnum((unsigned char)cp[m_pos]) || cp[m_pos] == '_'))
+				++m_pos;
+			m_text = m_src.substr(m_start, m_pos - m_start);
+			m_tok = TK_NAME;
+		}
+		else if (c == '\'' || c == '"')
+		{
+			m_tok = TK_STR;
+			for (++m_pos; m_pos < m_src.size() && cp[m_pos] != c; ++m_pos)
+			{
+				char ch = cp[m_pos];
+				if (ch == '\\' && m_pos + 1 < m_src.size())
+				{
+					ch = cp[++m_pos];
+					if (ch == 'n')      ch = '\n';
+					else if (ch == 't') ch = '\t';
+				}
+				m_text += ch;
+			}
+
+			if (m_pos >= m_src.size())
+			{
+				// unterminated, reported by the caller
+				m_tok = TK_OP;
+				m_text = c;
+				return;
+			}
+			++m_pos;
+		}
+		else
+		{
+			static const char* pairs[] = {"==", "!=", "<>", "~=", "<=", ">=", "//", "**", 0};
+
+			m_tok = TK_OP;
+			for (int i = 0; pairs[i]; ++i)
+			{
+				if (m_src.compare(m_pos, 2, pairs[i]) == 0)
+				{
+					m_text = pairs[i];
+					m_pos += 2;
+					return;
+				}
+			}
+			m_text = c;
+			++m_pos;
+		}
+	}
+
+
+	void emit(int op, int arg = 0, double num = 0.0)
+	{
+		gkLogicExpression::Instruction in = {op, arg, num};
+		m_expr.m_code.push_back(in);
+	}
+
+	void grow(int n)
+	{
+		m_depth += n;
+		if (m_depth > m_expr.m_depth)
+			m_expr.m_depth = m_depth;
+	}
+
+	void push(int op, int arg = 0, double num = 0.0)
+	{
+		emit(op, arg, num);
+		grow(1);
+	}
+
+	void truth(Type t)
+	{
+		if (t == ET_STR)
+			emit(gkLogicExpression::OP_STR_BOOL);
+	}
+
+
+	Type parseOr(void)
+	{
+		Type t = parseAnd();
+		while (t != ET_ERROR && isToken("or"))
+		{
+			next();
+			t = parseShortCircuit(t, gkLogicExpression::OP_JUMP_TRUE, &gkLogicExpressionParser::parseAnd);
+		}
+		return t;
+	}
+
+	Type parseAnd(void)
+	{
+		Type t = parseNot();
+		while (t != ET_ERROR && isToken("and"))
+		{
+			next();
+			t = parseShortCircuit(t, gkLogicExpression::OP_JUMP_FALSE, &gkLogicExpressionParser::parseNot);
+		}
+		return t;
+	}
+
+	// The jump keeps the left value when it decides the result, otherwise
+	// pops it and the right side takes its slot.
+	Type parseShortCircuit(Type lhs, int op, Type (gkLogicExpressionParser::*rhs)(void))
+	{
+		truth(lhs);
+
+		const UTsize jump = m_expr.m_code.size();
+		emit(op);
+		grow(-1);
+
+		Type t = (this->*rhs)();
+		if (t == ET_ERROR)
+			return t;
+
+		truth(t);
+		m_expr.m_code[jump].arg = (int)m_expr.m_code.size();
+		return ET_BOOL;
+	}
+
+	Type parseNot(void)
+	{
+		if (!accept("not"))
+			return parseCompare();
+
+		Type t = parseNot();
+		if (t == ET_ERROR)
+			return t;
+
+		truth(t);
+		emit(gkLogicExpression::OP_NOT);
+		return ET_BOOL;
+	}
+
+
+	int compareOp(void) const
+	{
+		if (m_tok != TK_OP)
+			return -1;
+
+		if (m_text == "==")                                       return gkLogicExpression::OP_EQ;
+		if (m_text == "!=" || m_text == "<>" || m_text == "~=")   return gkLogicExpression::OP_NE;
+		if (m_text == "<")                                        return gkLogicExpression::OP_LT;
+		if (m_text == "<=")                                       return gkLogicExpression::OP_LE;
+		if (m_text == ">")                                        return gkLogicExpression::OP_GT;
+		if (m_text == ">=")                                       return gkLogicExpression::OP_GE;
+		return -1;
+	}
+
+	Type parseCompare(void)
+	{
+		Type t = parseSum();
+		int op = compareOp();
+		if (t == ET_ERROR || op == -1)
+			return t;
+
+		next();
+		Type r = parseSum();
+		if (r == ET_ERROR)
+			return r;
+
+		if (t == ET_STR && r == ET_STR)
+			op += gkLogicExpression::OP_STR_EQ - gkLogicExpression::OP_EQ;
+		else if (!isNumeric(t) || !isNumeric(r))
+			return fail("cannot compare a string with a number");
+
+		emit(op);
+		grow(-1);
+
+		if (compareOp() != -1)
+			return fail("chained comparisons are not supported");
+		return ET_BOOL;
+	}
+
+
+	Type parseArithmetic(Type t, int op, Type (gkLogicExpressionParser::*rhs)(void))
+	{
+		Type r = (this->*rhs)();
+		if (r == ET_ERROR)
+			return r;
+
+		if (!isNumeric(t) || !isNumeric(r))
+			return fail("arithmetic on a string");
+
+		emit(op);
+		grow(-1);
+		return ET_NUM;
+	}
+
+	Type parseSum(void)
+	{
+		Type t = parseTerm();
+		while (t != ET_ERROR && m_tok == TK_OP)
+		{
+			int op;
+			if (m_text == "+")      op = gkLogicExpression::OP_ADD;
+			else if (m_text == "-") op = gkLogicExpression::OP_SUB;
+			else break;
+
+			next();
+			t = parseArithmetic(t, op, &gkLogicExpressionParser::parseTerm);
+		}
+		return t;
+	}
+
+	Type parseTerm(void)
+	{
+		Type t = parseUnary();
+		while (t != ET_ERROR && m_tok == TK_OP)
+		{
+			int op;
+			if (m_text == "*")       op = gkLogicExpression::OP_MUL;
+			else if (m_text == "/")  op = gkLogicExpression::OP_DIV;
+			else if (m_text == "//") op = gkLogicExpression::OP_FLOORDIV;
+			else if (m_text == "%")  op = gkLogicExpression::OP_MOD;
+			else break;
+
+			next();
+			t = parseArithmetic(t, op, &gkLogicExpressionParser::parseUnary);
+		}
+		return t;
+	}
+
+	Type parseUnary(void)
+	{
+		const bool neg = isToken("-");
+		if (!neg && !isToken("+"))
+			return parsePower();
+
+		next();
+		Type t = parseUnary();
+		if (t == ET_ERROR)
+			return t;
+		if (!isNumeric(t))
+			return fail("unary sign on a string");
+
+		if (neg)
+			emit(gkLogicExpression::OP_NEG);
+		return ET_NUM;
+	}
+
+	Type parsePower(void)
+	{
+		Type t = parsePrimary();
+		if (t != ET_ERROR && accept("**"))
+			t = parseArithmetic(t, gkLogicExpression::OP_POW, &gkLogicExpressionParser::parseUnary);
+		return t;
+	}
+
+
+	Type parsePrimary(void)
+	{
+		switch (m_tok)
+		{
+		case TK_NUM:
+			push(gkLogicExpression::OP_NUM, 0, m_num);
+			next();
+			return ET_NUM;
+
+		case TK_STR:
+			m_expr.m_strings.push_back(m_text);
+			push(gkLogicExpression::OP_STR, (int)m_expr.m_strings.size() - 1);
+			next();
+			return ET_STR;
+
+		case TK_NAME:
+			return parseName();
+
+		case TK_OP:
+			if (accept("("))
+			{
+				Type t = parseOr();
+				if (t != ET_ERROR && !accept(")"))
+					return fail("missing ')'");
+				return t;
+			}
+			return fail("unexpected '" + m_text + "'");
+
+		default:
+			return fail("unexpected end of expression");
+		}
+	}
+
+	Type parseName(void)
+	{
+		const gkString name = m_text;
+		if (name == "True" || name == "true" || name == "False" || name == "false")
+		{
+			push(gkLogicExpression::OP_NUM, 0, name[0] == 'T' || name[0] == 't' ? 1.0 : 0.0);
+			next();
+			return ET_BOOL;
+		}
+
+		if (name == "and" || name == "or" || name == "not")
+			return fail("unexpected '" + name + "'");
+
+		gkLogicSensor* sensor = m_scope.findSensor(name);
+		if (sensor)
+		{
+			m_expr.m_sensors.push_back(sensor);
+			push(gkLogicExpression::OP_SENSOR, (int)m_expr.m_sensors.size() - 1);
+			next();
+			return ET_BOOL;
+		}
+
+		gkVariable* var = m_scope.findVariable(name);
+		if (!var)
+			return fail("unknown name '" + name + "'");
+
+		Type t;
+		int op;
+		switch (var->getType())
+		{
+		case gkVariable::VAR_BOOL:   op = gkLogicExpression::OP_PROP_BOOL; t = ET_BOOL; break;
+		case gkVariable::VAR_INT:
+		case gkVariable::VAR_REAL:   op = gkLogicExpression::OP_PROP_NUM;  t = ET_NUM;  break;
+		case gkVariable::VAR_STRING: op = gkLogicExpression::OP_PROP_STR;  t = ET_STR;  break;
+		default:
+			return fail("property '" + name + "' has no scalar value");
+		}
+
+		m_expr.m_variables.push_back(var);
+		push(op, (int)m_expr.m_variables.size() - 1);
+		next();
+		return t;
+	}
+};
+
+
+
+gkLogicExpression::gkLogicExpression()
+	:    m_depth(0)
+{
+}
+
+
+void gkLogicExpression::clear(void)
+{
+	m_code.clear();
+	m_strings.clear();
+	m_sensors.clear();
+	m_variables.clear();
+	m_depth = 0;
+	m_error.clear();
+}
+
+
+bool gkLogicExpression::compile(const gkString& expr, Scope& scope)
+{
+	clear();
+
+	gkLogicExpressionParser parser(*this, scope, expr);
+	bool result = parser.parse();
+
+	if (result && m_depth > GK_EXPRESSION_STACK)
+	{
+		m_error = "expression nests too deep";
+		result = false;
+	}
+
+	if (!result)
+	{
+		gkString error = m_error;
+		clear();
+		m_error = error;
+	}
+	return result;
+}
+
+
+static double gkLogicExpressionNumber(const gkVariable* var)
+{
+	// ints go through double so large values compare exactly
+	if (var->getType() == gkVariable::VAR_INT)
+		return var->getValueInt();
+	return var->getValueReal();
+}
+
+
+static double gkLogicExpressionMod(double a, double b)
+{
+	if (b == 0.0)
+		return 0.0;
+
+	// sign follows the divisor, as in Python
+	double r = fmod(a, b);
+	if (r != 0.0 && ((r < 0.0) != (b < 0.0)))
+		r += b;
+	return r;
+}
+
+
+bool gkLogicExpression::evaluate(void) const
+{
+	if (m_code.empty())
+		return false;
+
+	// a slot holds either a number or a string, which is fixed at compile time
+	double num[GK_EXPRESSION_STACK];
+	const gkString* str[GK_EXPRESSION_STACK];
+	int top = -1;
+
+	const Instruction* code = m_code.ptr();
+	const int size = (int)m_code.size();
+
+	for (int pc = 0; pc < size; ++pc)
+	{
+		const Instruction& in = code[pc];
+		switch (in.op)
+		{
+		case OP_NUM:        num[++top] = in.num; break;
+		case OP_STR:        str[++top] = &m_strings[in.arg]; break;
+		case OP_SENSOR:     num[++top] = m_sensors[in.arg]->isPositive() ? 1.0 : 0.0; break;
+		case OP_PROP_BOOL:  num[++top] = m_variables[in.arg]->getValueBool() ? 1.0 : 0.0; break;
+		case OP_PROP_NUM:   num[++top] = gkLogicExpressionNumber(m_variables[in.arg]); break;
+		case OP_PROP_STR:   str[++top] = &m_variables[in.arg]->getValue().getString(); break;
+		case OP_STR_BOOL:   num[top] = str[top]->empty() ? 0.0 : 1.0; break;
+		case OP_NOT:        num[top] = num[top] == 0.0 ? 1.0 : 0.0; break;
+		case OP_NEG:        num[top] = -num[top]; break;
+
+		case OP_ADD:        --top; num[top] += num[top + 1]; break;
+		case OP_SUB:        --top; num[top] -= num[top + 1]; break;
+		case OP_MUL:        --top; num[top] *= num[top + 1]; break;
+		case OP_DIV:        --top; num[top] = num[top + 1] != 0.0 ? num[top] / num[top + 1] : 0.0; break;
+		case OP_FLOORDIV:   --top; num[top] = num[top + 1] != 0.0 ? floor(num[top] / num[top + 1]) : 0.0; break;
+		case OP_MOD:        --top; num[top] = gkLogicExpressionMod(num[top], num[top + 1]); break;
+		case OP_POW:        --top; num[top] = pow(num[top], num[top + 1]); break;
+
+		case OP_EQ:         --top; num[top] = num[top] == num[top + 1] ? 1.0 : 0.0; break;
+		case OP_NE:         --top; num[top] = num[top] != num[top + 1] ? 1.0 : 0.0; break;
+		case OP_LT:         --top; num[top] = num[top] <  num[top + 1] ? 1.0 : 0.0; break;
+		case OP_LE:         --top; num[top] = num[top] <= num[top + 1] ? 1.0 : 0.0; break;
+		case OP_GT:         --top; num[top] = num[top] >  num[top + 1] ? 1.0 : 0.0; break;
+		case OP_GE:         --top; num[top] = num[top] >= num[top + 1] ? 1.0 : 0.0; break;
+
+		case OP_STR_EQ:     --top; num[top] = *str[top] == *str[top + 1] ? 1.0 : 0.0; break;
+		case OP_STR_NE:     --top; num[top] = *str[top] != *str[top + 1] ? 1.0 : 0.0; break;
+		case OP_STR_LT:     --top; num[top] = str[top]->compare(*str[top + 1]) <  0 ? 1.0 : 0.0; break;
+		case OP_STR_LE:     --top; num[top] = str[top]->compare(*str[top + 1]) <= 0 ? 1.0 : 0.0; break;
+		case OP_STR_GT:     --top; num[top] = str[top]->compare(*str[top + 1]) >  0 ? 1.0 : 0.0; break;
+		case OP_STR_GE:     --top; num[top] = str[top]->compare(*str[top + 1]) >= 0 ? 1.0 : 0.0; break;
+
+		case OP_JUMP_FALSE:
+			if (num[top] == 0.0)
+				pc = in.arg - 1;
+			else
+				--top;
+			break;
+		case OP_JUMP_TRUE:
+			if (num[top] != 0.0)
+				pc = in.arg - 1;
+			else
+				--top;
+			break;
+		}
+	}
+
+	return num[0] != 0.0;
+}
@@ -0,0 +1,136 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkLogicExpression_h_
+#define _gkLogicExpression_h_
+
+#include "gkCommon.h"
+#include "utTypes.h"
+
+class gkLogicSensor;
+class gkVariable;
+
+// Deepest operand stack a compiled expression may use.
+#define GK_EXPRESSION_STACK 32
+
+
+// Compiled form of an expression controller's expression.
+//
+// Accepts the Python subset Blender writes for expression controllers:
+// numbers, quoted strings, True/False, sensor and property names,
+// 'and' 'or' 'not', comparisons and + - * / // % **. Names are resolved
+// once at compile time, sensors first and then the object's properties,
+// and the result is a flat typed stack program. Evaluating it touches
+// only the resolved pointers and a local stack, it never allocates.
+class gkLogicExpression
+{
+public:
+
+	// Name lookup used while compiling.
+	class Scope
+	{
+	public:
+		virtual ~Scope() {}
+
+		virtual gkLogicSensor* findSensor(const gkString& name) = 0;
+		virtual gkVariable*    findVariable(const gkString& name) = 0;
+	};
+
+
+	enum OpCode
+	{
+		OP_NUM,
+		OP_STR,
+		OP_SENSOR,
+		OP_PROP_BOOL,
+		OP_PROP_NUM,
+		OP_PROP_STR,
+		OP_STR_BOOL,
+		OP_NOT,
+		OP_NEG,
+		OP_ADD,
+		OP_SUB,
+		OP_MUL,
+		OP_DIV,
+		OP_FLOORDIV,
+		OP_MOD,
+		OP_POW,
+		OP_EQ,
+		OP_NE,
+		OP_LT,
+		OP_LE,
+		OP_GT,
+		OP_GE,
+		OP_STR_EQ,
+		OP_STR_NE,
+		OP_STR_LT,
+		OP_STR_LE,
+		OP_STR_GT,
+		OP_STR_GE,
+		OP_JUMP_FALSE,
+		OP_JUMP_TRUE
+	};
+
+	struct Instruction
+	{
+		int    op;
+		int    arg;
+		double num;
+	};
+
+	typedef utArray<Instruction>    Code;
+	typedef utArray<gkString>       Strings;
+	typedef utArray<gkLogicSensor*> Sensors;
+	typedef utArray<gkVariable*>    Variables;
+
+public:
+
+	gkLogicExpression();
+
+	// Compiles the expression, any previous program is dropped. On failure
+	// the reason is kept in getError() and the expression is left empty.
+	bool compile(const gkString& expr, Scope& scope);
+	void clear(void);
+
+	bool evaluate(void) const;
+
+	GK_INLINE bool            isCompiled(void) const {return !m_code.empty();}
+	GK_INLINE const gkString& getError(void) const   {return m_error;}
+	GK_INLINE const Code&     getCode(void) const    {return m_code;}
+	GK_INLINE int             getStackDepth(void) const {return m_depth;}
+
+private:
+	friend class gkLogicExpressionParser;
+
+	Code      m_code;
+	Strings   m_strings;
+	Sensors   m_sensors;
+	Variables m_variables;
+	int       m_depth;
+	gkString  m_error;
+};
+
+#endif//_gkLogicExpression_h_
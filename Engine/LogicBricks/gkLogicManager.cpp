@@ -100,6 +100,11 @@ void gkLogicManager::clear(void)
 	m_ain.clear();
 	m_aout.clear();
 
+	m_plan.clear();
+	m_ainSlot.clear();
+	m_tickBits.clear();
+	m_ticked.clear();
+
 	m_updateBricks.clear();
 }
 
@@ -145,8 +150,7 @@ void gkLogicManager::clearActive(gkLogicLink* link)
 			act->setPulse(BM_OFF);
 			act->notifyLinkDestroyed();
 
-			if ((fnd = m_ain.find(act)) != UT_NPOS)
-				m_ain.erase(fnd);
+			popActive(act);
 			if (( fnd = m_aout.find(act)) != UT_NPOS)
 				m_aout.erase(fnd);
 		}
@@ -205,9 +209,17 @@ void gkLogicManager::push(gkLogicController* ctrl, gkLogicActuator* act, bool st
 #endif
 
 
-		if (!m_tickActuators.find(act))
+		UTsize idx = findPlan(act);
+		if (idx == UT_NPOS)
+			idx = appendPlan(act);
+
+		UTuint32& word = m_tickBits[idx >> 5];
+		UTuint32  bit  = 1U << (idx & 31);
+
+		if (!(word & bit))
 		{
-			m_tickActuators.push_back(act);
+			word |= bit;
+			m_ticked.push_back(idx);
 			act->setPulse(stateValue ? BM_ON : BM_OFF);
 		}
 		else if (stateValue)
@@ -218,7 +230,7 @@ void gkLogicManager::push(gkLogicController* ctrl, gkLogicActuator* act, bool st
 		if (!act->isActive())
 		{
 			act->setActive(true);
-			m_ain.push_back(act);
+			pushActive(act, idx);
 		}
 
 	}
@@ -325,7 +337,7 @@ void gkLogicManager::clearActuators(void)
 				dsPrintf("Pop:  Actuator %s\n", b[i]->getName().c_str());
 #endif
 			b[i]->setActive(false);
-			m_ain.erase(b[i]);
+			popActive(b[i]);
 			++i;
 		}
 		m_aout.clear(true);
@@ -333,7 +345,123 @@ void gkLogicManager::clearActuators(void)
 		if (m_ain.empty())
 			m_ain.clear(true);
 	}
-	m_tickActuators.clear();
+
+	if (!m_ticked.empty())
+	{
+		UTsize i, s;
+		Slots::Pointer t;
+		i = 0; s = m_ticked.size();
+		t = m_ticked.ptr();
+		while (i < s)
+		{
+			m_tickBits[t[i] >> 5] = 0;
+			++i;
+		}
+		m_ticked.clear(true);
+	}
+}
+
+
+UTsize gkLogicManager::findPlan(gkLogicBrick* act) const
+{
+	int idx = act->_getPlanIndex();
+	if (idx >= 0 && (UTsize)idx < m_plan.size() && m_plan[idx] == act)
+		return (UTsize)idx;
+	return UT_NPOS;
+}
+
+
+UTsize gkLogicManager::appendPlan(gkLogicBrick* act)
+{
+	UTsize idx = m_plan.size();
+
+	m_plan.push_back(act);
+	m_ainSlot.push_back(UT_NPOS);
+	if ((idx >> 5) >= m_tickBits.size())
+		m_tickBits.push_back(0);
+
+	act->_setPlanIndex((int)idx);
+	return idx;
+}
+
+
+void gkLogicManager::buildPlan(void)
+{
+	// Reindexes every actuator in link order, dropping destroyed ones.
+	// Tick bits and m_ain slots carry over to the new indices.
+
+	Bricks old(m_plan);
+	Bits oldBits(m_tickBits);
+
+	m_plan.clear(true);
+	m_ainSlot.clear(true);
+	m_tickBits.clear(true);
+	m_ticked.clear(true);
+
+	gkLogicLink* node = m_links.begin();
+	while (node)
+	{
+		utListIterator<gkLogicLink::BrickList> iter(node->getActuators());
+		while (iter.hasMoreElements())
+		{
+			gkLogicBrick* act = iter.getNext();
+
+			int oidx = act->_getPlanIndex();
+			bool ticked = oidx >= 0 && (UTsize)oidx < old.size() && old[oidx] == act &&
+			              (oldBits[oidx >> 5] & (1U << (oidx & 31))) != 0;
+
+			UTsize idx = appendPlan(act);
+			if (ticked)
+			{
+				m_tickBits[idx >> 5] |= 1U << (idx & 31);
+				m_ticked.push_back(idx);
+			}
+		}
+		node = node->getNext();
+	}
+
+	UTsize i;
+	for (i = 0; i < m_ain.size(); ++i)
+	{
+		UTsize idx = findPlan(m_ain[i]);
+		if (idx == UT_NPOS)
+			idx = appendPlan(m_ain[i]);
+		m_ainSlot[idx] = i;
+	}
+}
+
+
+void gkLogicManager::pushActive(gkLogicBrick* act, UTsize idx)
+{
+	m_ainSlot[idx] = m_ain.size();
+	m_ain.push_back(act);
+}
+
+
+void gkLogicManager::popActive(gkLogicBrick* act)
+{
+	// same result as m_ain.erase(act), the last element moves into the hole
+
+	UTsize idx = findPlan(act);
+	if (idx == UT_NPOS)
+	{
+		m_ain.erase(act);
+		return;
+	}
+
+	UTsize pos = m_ainSlot[idx];
+	if (pos == UT_NPOS)
+		return;
+
+	UTsize last = m_ain.size() - 1;
+	if (pos != last)
+	{
+		gkLogicBrick* moved = m_ain[last];
+		m_ain[pos] = moved;
+		m_ainSlot[findPlan(moved)] = pos;
+	}
+	m_ain.pop_back();
+	m_ainSlot[idx] = UT_NPOS;
 }
 
 void gkLogicManager::sort(void)
@@ -344,6 +472,8 @@ void gkLogicManager::sort(void)
 		while (i < DIS_MAX)
 			m_dispatchers[i++]->sort();
 	}
+
+	buildPlan();
 }
 
 
@@ -61,7 +61,8 @@ public:
 	typedef gkAbstractDispatcher*    gkAbstractDispatcherPtr;
 	typedef utArray<gkLogicBrick*>   Bricks;
 	typedef utHashSet<gkLogicBrick*> BrickSet;
-	typedef utList<gkLogicActuator*> TickActuators;
+	typedef utArray<UTsize>          Slots;
+	typedef utArray<UTuint32>        Bits;
 	typedef utList<gkLogicManager*>	LogicManagerList;
 protected:
 
@@ -74,11 +75,24 @@ protected:
 	bool                        m_sort;
 
 	BrickSet					m_updateBricks;
-	TickActuators 				m_tickActuators; // actuators that get processed by the controller.
-											//  This list makes it possible to set the actuator-state to false and only change to true if needed
+
+	// Flat actuator plan, rebuilt on sort. Per actuator state lives in arrays
+	// indexed by gkLogicBrick::_getPlanIndex.
+	Bricks                      m_plan;
+	Slots                       m_ainSlot;  // position in m_ain, UT_NPOS when inactive
+	Bits                        m_tickBits; // actuators processed by a controller this tick.
+	                                        // Makes it possible to set the actuator-state to false and only change to true if needed
+	Slots                       m_ticked;   // set bits, cleared after the tick
 
 	void push(gkLogicBrick* a, gkLogicBrick* b, Bricks& in, bool stateValue);
 
+	UTsize findPlan(gkLogicBrick* act) const;
+	UTsize appendPlan(gkLogicBrick* act);
+	void   buildPlan(void);
+
+	void   pushActive(gkLogicBrick* act, UTsize idx);
+	void   popActive(gkLogicBrick* act);
+
 	void clearActuators(void);
 	void clearActive(gkLogicLink* link);
 
@@ -46,6 +46,7 @@ gkLogicSensor::gkLogicSensor(gkGameObject* object, gkLogicLink* link, const gkSt
 	        m_sorted(false), m_isDetector(false),
 	        m_oldState(-1),
 	        m_firstTap(TAP_IN), m_lastTap(TAP_OUT),
+	        m_dispatchPending(false), m_lastPositive(false),
 	        m_dispatchType(-1)
 {
 }
@@ -133,6 +134,16 @@ bool gkLogicSensor::isPositive(void) const
 
 
 void gkLogicSensor::execute(void)
+{
+	if (_beginQuery())
+	{
+		prepareQuery();
+		_endQuery(_runQuery());
+	}
+}
+
+
+bool gkLogicSensor::_beginQuery(void)
 {
 	if (!inActiveState())
 	{
@@ -143,13 +154,13 @@ void gkLogicSensor::execute(void)
 			m_firstExec = true;
 			m_positive  = false;
 		}
-		return;
+		return false;
 	}
 
 	if (m_suspend || m_controllers.empty())
-		return;
+		return false;
 
-	bool doDispatch = false, detDispatch = false;
+	bool doDispatch = false;
 	if (m_oldState != m_link->getState())
 	{
 		m_firstExec = true;
@@ -168,88 +179,98 @@ void gkLogicSensor::execute(void)
 		m_tick = 0;
 	}
 
+	m_dispatchPending = doDispatch;
+	m_lastPositive = m_positive;
+	return doQuery;
+}
+
 
-	if (doQuery)
+bool gkLogicSensor::_runQuery(void)
+{
+	// Sensor detection.
+	if (m_listener)
 	{
-		// Sensor detection.
-		bool lp = m_positive;
+		if (m_listener->m_mode == gkLogicBrick::Listener::OVERIDE)
+			return m_listener->executeEvent(this);
+		else
+			return m_listener->executeEvent(this) && query();
+	}
+	return query();
+}
 
-		if (m_listener)
+
+void gkLogicSensor::_endQuery(bool positive)
+{
+	bool doDispatch = m_dispatchPending, detDispatch = false, doQuery;
+
+	bool lp = m_lastPositive;
+	m_positive = positive;
+
+	// Sensor Pulse.
+	if (m_pulse == PM_IDLE)
+		doDispatch = lp != m_positive;
+	else
+	{
+		if (m_pulse & PM_TRUE)
 		{
-			if (m_listener->m_mode == gkLogicBrick::Listener::OVERIDE)
-				m_positive = m_listener->executeEvent(this);
+			if (!m_invert)
+				doDispatch = (lp != m_positive) || m_positive;
 			else
-				m_positive = m_listener->executeEvent(this) && query();
+				doDispatch = (lp != m_positive) || !m_positive;
 		}
-		else
-			m_positive = query();
-
-		// Sensor Pulse.
-		if (m_pulse == PM_IDLE)
-			doDispatch = lp != m_positive;
-		else
+		if (m_pulse & PM_FALSE)
 		{
-			if (m_pulse & PM_TRUE)
-			{
-				if (!m_invert)
-					doDispatch = (lp != m_positive) || m_positive;
-				else
-					doDispatch = (lp != m_positive) || !m_positive;
-			}
-			if (m_pulse & PM_FALSE)
-			{
-				if (!m_invert)
-					doDispatch = (lp != m_positive) || !m_positive;
-				else
-					doDispatch = (lp != m_positive) || m_positive;
-			}
+			if (!m_invert)
+				doDispatch = (lp != m_positive) || !m_positive;
+			else
+				doDispatch = (lp != m_positive) || m_positive;
 		}
+	}
 
-		// Tap mode (Switch On->Switch Off)
-		if (m_tap && !(m_pulse & PM_TRUE))
+	// Tap mode (Switch On->Switch Off)
+	if (m_tap && !(m_pulse & PM_TRUE))
+	{
+		doQuery = m_positive;
+		if (m_invert)
+			doQuery = !doQuery;
+
+		doDispatch = false;
+		m_pulseState = BM_OFF;
+
+		if (m_firstTap == TAP_IN && doQuery)
 		{
-			doQuery = m_positive;
-			if (m_invert)
-				doQuery = !doQuery;
-
-			doDispatch = false;
-			m_pulseState = BM_OFF;
-
-			if (m_firstTap == TAP_IN && doQuery)
-			{
-				doDispatch = true;
-				m_positive = true;
-				m_pulseState = BM_ON;
-				m_firstTap = TAP_OUT;
-				m_lastTap = TAP_IN;
-			}
-			else if (m_lastTap == TAP_IN)
-			{
-				m_positive = false;
-				doDispatch = true;
-				m_lastTap = TAP_OUT;
-			}
-			else
-			{
-				m_positive = false;
-				if (!doQuery)
-					m_firstTap  = TAP_IN;
-			}
+			doDispatch = true;
+			m_positive = true;
+			m_pulseState = BM_ON;
+			m_firstTap = TAP_OUT;
+			m_lastTap = TAP_IN;
 		}
-		else m_pulseState = isPositive() ? BM_ON : BM_OFF;
-
-		if (m_firstExec)
+		else if (m_lastTap == TAP_IN)
+		{
+			m_positive = false;
+			doDispatch = true;
+			m_lastTap = TAP_OUT;
+		}
+		else
 		{
-			m_firstExec = false;
-			if (m_invert && !doDispatch)
-				doDispatch = true;
+			m_positive = false;
+			if (!doQuery)
+				m_firstTap  = TAP_IN;
 		}
-		if (!doDispatch)
-			doDispatch = detDispatch;
+	}
+	else m_pulseState = isPositive() ? BM_ON : BM_OFF;
 
-		// Dispatch results
-		if (doDispatch) dispatch();
+	if (m_firstExec)
+	{
+		m_firstExec = false;
+		if (m_invert && !doDispatch)
+			doDispatch = true;
 	}
+	if (!doDispatch)
+		doDispatch = detDispatch;
+
+	// Dispatch results
+	if (doDispatch) dispatch();
 }
 
 void gkLogicSensor::dispatch(void)
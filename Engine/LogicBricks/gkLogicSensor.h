@@ -50,7 +50,6 @@ protected:
 	int     m_freq, m_tick, m_pulse;
 	bool    m_invert, m_positive, m_suspend, m_tap, m_firstExec;
 	bool    m_sorted, m_isDetector;
-	int     m_dispatchType;
 
 
 	// state cache
@@ -59,6 +58,11 @@ protected:
 	// tap detection
 	int m_firstTap, m_lastTap;
 
+	// carried from _beginQuery to _endQuery
+	bool    m_dispatchPending, m_lastPositive;
+
+	int     m_dispatchType;
+
 
 	void cloneImpl(gkLogicLink* link, gkGameObject* dest);
 
@@ -77,6 +81,19 @@ public:
 
 	virtual bool query(void) = 0;
 
+	// execute() in three steps for batched dispatch: the header decides if a
+	// query is due, the query runs, and _endQuery applies its result.
+	bool _beginQuery(void);
+	bool _runQuery(void);
+	void _endQuery(bool positive);
+
+	// Queries that only read state which is stable while sensors dispatch
+	// may run on worker threads. prepareQuery is called serially before the
+	// query, to capture what it would otherwise read lazily.
+	virtual bool isParallelQuery(void) const {return false;}
+	virtual void prepareQuery(void) {}
+	GK_INLINE bool _canBatchQuery(void) const {return !m_listener && isParallelQuery();}
+
 	void sort(void);
 
 	///Reset the sensor's header to initial state.
@@ -31,7 +31,7 @@
 #include "gkVariable.h"
 
 gkMessageActuator::gkMessageActuator(gkGameObject* object, gkLogicLink* link, const gkString& name)
-	:    gkLogicActuator(object, link, name), m_to(""), m_subject(""), m_bodyType(BT_TEXT), m_bodyText(""), m_bodyProp("")
+	:    gkLogicActuator(object, link, name), m_to(""), m_subject(""), m_bodyProp(""), m_bodyText(""), m_bodyType(BT_TEXT)
 {
 
 }
@@ -50,20 +50,13 @@ void gkMessageActuator::execute(void)
 	if (isPulseOff())
 		return;
 
-	gkString from, body;
+	const gkString& from = m_object->getName();
+	gkMessageManager& mgr = gkMessageManager::getSingleton();
 
-	from = m_object->getName();
-
-	if (m_bodyType == BT_TEXT)
-	{
-		body = m_bodyText;
-	}
-	else if (m_bodyType == BT_PROP && m_object->hasVariable(m_bodyProp))
-	{
-		body = m_object->getVariable(m_bodyProp)->getValueString();
-	}
-
-	gkMessageManager::getSingleton().sendMessage(from, m_to, m_subject, body);
+	if (m_bodyType == BT_PROP && m_object->hasVariable(m_bodyProp))
+		mgr.sendInternedMessage(from, m_to, m_subject, m_object->getVariable(m_bodyProp)->getValueString());
+	else
+		mgr.sendInternedMessage(from, m_to, m_subject, m_bodyType == BT_TEXT ? m_bodyText : gkStringUtils::BLANK);
 
 	setPulse(BM_OFF);
 }
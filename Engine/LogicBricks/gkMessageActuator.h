@@ -29,6 +29,7 @@
 #define GKMESSAGEACTUATOR_H
 
 #include "gkLogicActuator.h"
+#include "gkHashedString.h"
 
 class gkMessageActuator : public gkLogicActuator
 {
@@ -40,7 +41,8 @@ public:
 	};
 
 private:
-	gkString m_to, m_subject, m_bodyText, m_bodyProp;
+	gkHashedString m_to, m_subject, m_bodyProp;
+	gkString m_bodyText;
 	int m_bodyType;
 
 public:
@@ -57,11 +59,11 @@ public:
 	GK_INLINE void setBodyText(const gkString& v)     {m_bodyText = v;}
 	GK_INLINE void setBodyProperty(const gkString& v) {m_bodyProp = v;}
 
-	GK_INLINE const gkString& getTo(void)           const {return m_to;}
-	GK_INLINE const gkString& getSubject(void)      const {return m_subject;}
+	GK_INLINE const gkString& getTo(void)           const {return m_to.str();}
+	GK_INLINE const gkString& getSubject(void)      const {return m_subject.str();}
 	GK_INLINE int             getBodyType(void)     const {return m_bodyType;}
 	GK_INLINE const gkString& getBodyText(void)     const {return m_bodyText;}
-	GK_INLINE const gkString& getBodyProperty(void) const {return m_bodyProp;}
+	GK_INLINE const gkString& getBodyProperty(void) const {return m_bodyProp.str();}
 };
 
 #endif // GKMESSAGEACTUATOR_H
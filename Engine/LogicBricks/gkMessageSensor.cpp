@@ -33,9 +33,8 @@
 gkMessageSensor::gkMessageSensor(gkGameObject* object, gkLogicLink* link, const gkString& name)
 	:       gkLogicSensor(object, link, name)
 {
-	m_listener = new gkMessageManager::GenericMessageListener("",object->getName(),"");
-	m_listener->setAcceptEmptyTo(true);
-	gkMessageManager::getSingleton().addListener(m_listener);
+	m_listener = 0;
+	createListener();
 
 	m_dispatchType = DIS_CONSTANT;
 	connect();
@@ -47,7 +46,17 @@ gkMessageSensor::~gkMessageSensor()
 {
 	gkMessageManager::getSingleton().removeListener(m_listener);
 	delete m_listener;
-	m_messages.clear();
+}
+
+
+void gkMessageSensor::createListener(void)
+{
+	// addressed to the owner by name, or to nobody
+	gkHashedString subject = m_listener ? m_listener->m_subjectFilter : gkHashedString();
+
+	m_listener = new gkMessageManager::GenericMessageListener("", m_object->getName(), subject);
+	m_listener->setAcceptEmptyTo(true);
+	gkMessageManager::getSingleton().addListener(m_listener);
 }
 
 
@@ -55,37 +64,14 @@ gkLogicBrick* gkMessageSensor::clone(gkLogicLink* link, gkGameObject* dest)
 {
 	gkMessageSensor* sens = new gkMessageSensor(*this);
 	sens->cloneImpl(link, dest);
-	sens->m_listener = new gkMessageManager::GenericMessageListener("", "", m_listener->m_subjectFilter);
-	gkMessageManager::getSingleton().addListener(sens->m_listener);
+	sens->createListener();
 	return sens;
 }
 
 
 bool gkMessageSensor::query(void)
 {
-	bool ret = false;
-
-	m_messages.clear();
-
-	if (m_listener->m_messages.size() > 0 )
-	{
-		ret = true;
-
-		// We copy the massages so that Logic scripts can retrieve messages recieved between each logic step
-		utArrayIterator<utArray<gkMessageManager::Message> > iter(m_listener->m_messages);
-		while (iter.hasMoreElements())
-		{
-			gkMessageManager::Message m = iter.peekNext();
-			if (m.m_to==""
-					|| m.m_to == m_object->getName())
-			{
-				m_messages.push_back(m);
-			}
-			iter.getNext();
-		}
-	}
-
-	m_listener->emptyMessages();
-
-	return ret;
+	// messages stay readable by logic scripts until the next query
+	m_listener->swapMessages();
+	return !m_listener->m_received.empty();
 }
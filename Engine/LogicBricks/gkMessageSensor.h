@@ -36,9 +36,8 @@ class gkMessageSensor : public gkLogicSensor
 {
 private:
 	gkMessageManager::GenericMessageListener* m_listener;
-	utArray<gkMessageManager::Message>       m_messages;
-
 
+	void createListener(void);
 
 public:
 	gkMessageSensor(gkGameObject* object, gkLogicLink* link, const gkString& name);
@@ -47,10 +46,10 @@ public:
 	gkLogicBrick* clone(gkLogicLink* link, gkGameObject* dest);
 
 	bool query(void);
-	GK_INLINE void            setSubject(const gkString& v)       {m_listener->m_subjectFilter = v;}
-	GK_INLINE const gkString& getSubject(void)              const {return m_listener->m_subjectFilter;}
-	GK_INLINE int getMessageCount() { return m_messages.size();}
-	GK_INLINE gkMessageManager::Message getMessage(int nr) { return m_messages.at(nr);}
+	GK_INLINE void            setSubject(const gkString& v)       {m_listener->setSubjectFilter(v);}
+	GK_INLINE const gkString& getSubject(void)              const {return m_listener->m_subjectFilter.str();}
+	GK_INLINE int getMessageCount() { return m_listener->m_received.size();}
+	GK_INLINE const gkMessageManager::Message& getMessage(int nr) { return *m_listener->m_received.at(nr);}
 
 };
 
@@ -31,6 +31,7 @@
 #include "gkGameObject.h"
 #include "gkPhysicsController.h"
 #include "gkScene.h"
+#include "gkSpatialHash.h"
 #include "gkContactTest.h"
 #include "btBulletDynamicsCommon.h"
 #include "btBulletCollisionCommon.h"
@@ -53,15 +54,46 @@ gkLogicBrick* gkNearSensor::clone(gkLogicLink* link, gkGameObject* dest)
 
 
 
+bool gkNearSensor::isParallelQuery(void) const
+{
+	return m_scene->getSpatialHash() != 0;
+}
+
+
+void gkNearSensor::prepareQuery(void)
+{
+	m_queryPos = m_object->getWorldPosition();
+
+	gkSpatialHash* hash = m_scene->getSpatialHash();
+	if (hash && hash->isStale())
+		hash->refresh();
+}
+
+
 bool gkNearSensor::query(void)
 {
-	m_nearObjList.clear();
+	m_nearObjList.clear(true);
 	gkScene* scene = m_object->getOwner();
-	gkDynamicsWorld* dyn = scene->getDynamicsWorld();
 
-	btDynamicsWorld* btw = dyn->getBulletWorld();
+	gkVector3 vec = m_queryPos;
+
+	gkSpatialHash* hash = scene->getSpatialHash();
+	if (hash)
+	{
+		// only with spatialCellSize set: bounding spheres of the objects
+		// physics would see, coarser than contactTest against their shapes
+		gkSpatialHash::Filter filter;
+		filter.prop = m_prop;
+		filter.material = m_material;
+		filter.exclude = m_object;
+		filter.physicsOnly = true;
+
+		hash->querySphere(vec, m_previous ? m_resetrange : m_range, m_nearObjList, &filter);
+		return m_previous = !m_nearObjList.empty();
+	}
 
-	gkVector3 vec = m_object->getWorldPosition();
+	gkDynamicsWorld* dyn = scene->getDynamicsWorld();
+	btDynamicsWorld* btw = dyn->getBulletWorld();
 
 	gkAllContactResultCallback exec;
 
@@ -90,8 +122,7 @@ bool gkNearSensor::query(void)
 //	if (m_material.empty() && m_prop.empty())
 //		return m_previous = true;
 
-	utArray<const btCollisionObject*> contacts = exec.m_contactObjects;
-	utArrayIterator< utArray<const btCollisionObject*> > iter(contacts);
+	gkAllContactResultCallback::Objects::Iterator iter(exec.m_contactObjects);
 
 	while (iter.hasMoreElements())
 	{
@@ -34,9 +34,10 @@ class gkNearSensor : public gkLogicSensor
 
 private:
 	gkScalar    m_range, m_resetrange;
-	gkString    m_material, m_prop;
+	gkHashedString m_material, m_prop;
 	bool        m_previous;
-	utArray<gkGameObject*> m_nearObjList;
+	utSmallArray<gkGameObject*, 8> m_nearObjList;
+	gkVector3   m_queryPos;
 
 public:
 
@@ -47,6 +48,11 @@ public:
 
 	bool query(void);
 
+	// parallel when answered from the spatial hash, bullet's contactTest
+	// allocates from the shared dispatcher pools
+	bool isParallelQuery(void) const;
+	void prepareQuery(void);
+
 	GK_INLINE void setRange(gkScalar v)             {m_range = v;}
 	GK_INLINE void setResetRange(gkScalar v)        {m_resetrange = v;}
 	GK_INLINE void setMaterial(const gkString& v)   {m_material = v; m_prop = "";}
@@ -54,9 +60,9 @@ public:
 
 	GK_INLINE gkScalar getRange(void)               const {return m_range;}
 	GK_INLINE gkScalar getResetRange(void)          const {return m_resetrange;}
-	GK_INLINE const gkString& getMaterial(void)     const {return m_material;}
-	GK_INLINE const gkString& getProperty(void)     const {return m_prop;}
-	GK_INLINE const utArray<gkGameObject*> getNearObjects(void) const {return m_nearObjList;}
+	GK_INLINE const gkString& getMaterial(void)     const {return m_material.str();}
+	GK_INLINE const gkString& getProperty(void)     const {return m_prop.str();}
+	GK_INLINE const utArray<gkGameObject*>& getNearObjects(void) const {return m_nearObjList;}
 	GK_INLINE const int getNearObjectCount(void) 	    const {return m_nearObjList.size();}
 	GK_INLINE const gkGameObject* getNearObject(int nr)  {return m_nearObjList[nr];}
 };
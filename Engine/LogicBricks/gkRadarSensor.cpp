@@ -31,6 +31,7 @@
 #include "gkGameObject.h"
 #include "gkPhysicsController.h"
 #include "gkScene.h"
+#include "gkSpatialHash.h"
 #include "gkContactTest.h"
 #include "btBulletDynamicsCommon.h"
 
@@ -49,12 +50,25 @@ gkLogicBrick* gkRadarSensor::clone(gkLogicLink* link, gkGameObject* dest)
 }
 
 
+bool gkRadarSensor::isParallelQuery(void) const
+{
+	return m_scene->getSpatialHash() != 0;
+}
+
+
+void gkRadarSensor::prepareQuery(void)
+{
+	gkRaySensor::prepareQuery();
+
+	gkSpatialHash* hash = m_scene->getSpatialHash();
+	if (hash && hash->isStale())
+		hash->refresh();
+}
+
+
 bool gkRadarSensor::query(void)
 {
 	gkScene* scene = m_object->getOwner();
-	gkDynamicsWorld* dyn = scene->getDynamicsWorld();
-
-	btDynamicsWorld* btw = dyn->getBulletWorld();
 
 	const gkScalar offs = m_range / 2.f;
 	gkEuler ori;
@@ -69,6 +83,26 @@ bool gkRadarSensor::query(void)
 	case RA_ZNEG: {dir = gkVector3(0, 0, -offs); break;}
 	}
 
+	gkSpatialHash* hash = scene->getSpatialHash();
+	if (hash)
+	{
+		// only with spatialCellSize set, tests bounding spheres against the cone
+		gkSpatialHash::Filter filter;
+		filter.prop = m_prop;
+		filter.material = m_material;
+		filter.exclude = m_object;
+		filter.physicsOnly = true;
+
+		gkVector3 axis = m_queryRot * dir;
+		axis.normalise();
+
+		utSmallArray<gkGameObject*, 8> found;
+		return hash->queryCone(m_queryPos, axis, m_range, m_angle / 2, found, &filter) != 0;
+	}
+
+	gkDynamicsWorld* dyn = scene->getDynamicsWorld();
+	btDynamicsWorld* btw = dyn->getBulletWorld();
+
 	switch (m_axis)
 	{
 	case RA_XPOS: {ori = gkEuler(0,  -90,   0);     break;}
@@ -80,10 +114,10 @@ bool gkRadarSensor::query(void)
 	}
 
 
-	gkVector3 vec = m_object->getWorldPosition();
+	gkVector3 vec = m_queryPos;
 
-	dir = m_object->getWorldOrientation() * dir;
-	btQuaternion btr = gkMathUtils::get(m_object->getWorldOrientation() * ori.toQuaternion());
+	dir = m_queryRot * dir;
+	btQuaternion btr = gkMathUtils::get(m_queryRot * ori.toQuaternion());
 
 	gkAllContactResultCallback exec;
 
@@ -123,9 +157,7 @@ bool gkRadarSensor::query(void)
 	if (m_material.empty() && m_prop.empty())
 		return true;
 
-	utArray<const btCollisionObject*> contacts = exec.m_contactObjects;
-
-	utArrayIterator< utArray<const btCollisionObject*> > iter(contacts);
+	gkAllContactResultCallback::Objects::Iterator iter(exec.m_contactObjects);
 
 	while (iter.hasMoreElements())
 	{
@@ -43,6 +43,11 @@ public:
 
 	bool query(void);
 
+	// parallel when answered from the spatial hash, bullet's contactTest
+	// allocates from the shared dispatcher pools
+	bool isParallelQuery(void) const;
+	void prepareQuery(void);
+
 	GK_INLINE void      setAngle(gkScalar v)       {m_angle = v;}
 	GK_INLINE gkScalar  getAngle(void)       const {return m_angle;}
 };
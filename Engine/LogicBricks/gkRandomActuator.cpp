@@ -64,17 +64,14 @@ void gkRandomActuator::setSeed(int v)
 
 void gkRandomActuator::execute(void)
 {
-	gkVariable* variable;
-
 	if (isPulseOff())
 		return;
 
 	if (!m_object->isInstanced())
 		return;
 
-	if (m_object->hasVariable(m_prop))
-		variable = m_object->getVariable(m_prop);
-	else
+	gkVariable* variable = m_object->getVariable(m_prop);
+	if (!variable)
 		return;
 
 
@@ -29,6 +29,7 @@
 #define GKRANDOMACTUATOR_H
 
 #include "gkLogicActuator.h"
+#include "gkHashedString.h"
 #include "utRandom.h"
 
 class gkRandomActuator : public gkLogicActuator
@@ -53,7 +54,7 @@ private:
 	utRandomNumberGenerator* m_randGen;
 	int m_distribution;
 	int m_seed;
-	gkString m_prop;
+	gkHashedString m_prop;
 	float m_min;
 	float m_max;
 	float m_constant;
@@ -81,7 +82,7 @@ public:
 
 	GK_INLINE int             getSeed(void)                  const {return m_seed;}
 	GK_INLINE int             getDistribution(void)          const {return m_distribution;}
-	GK_INLINE const gkString& getProperty(void)              const {return m_prop;}
+	GK_INLINE const gkString& getProperty(void)              const {return m_prop.str();}
 	GK_INLINE float           getMin(void)                   const {return m_min;}
 	GK_INLINE float           getMax(void)                   const {return m_max;}
 	GK_INLINE float           getConstant(void)              const {return m_constant;}
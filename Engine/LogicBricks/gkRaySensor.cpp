@@ -54,6 +54,15 @@ gkLogicBrick* gkRaySensor::clone(gkLogicLink* link, gkGameObject* dest)
 
 
 
+// Not a parallel query: btDbvt::rayTestInternal shares one traversal
+// stack per tree, so concurrent rayTests on a world are unsafe.
+void gkRaySensor::prepareQuery(void)
+{
+	m_queryPos = m_object->getWorldPosition();
+	m_queryRot = m_object->getWorldOrientation();
+}
+
+
 bool gkRaySensor::query(void)
 {
 
@@ -61,7 +70,7 @@ bool gkRaySensor::query(void)
 	bool result;
 	gkRayTest test;
 	
-	from = m_object->getWorldPosition();
+	from = m_queryPos;
 	
 	switch (m_axis)
 	{
@@ -73,7 +82,7 @@ bool gkRaySensor::query(void)
 	case RA_ZNEG: {dir = gkVector3(0, 0, -m_range); break;}
 	}
 	
-	dir = m_object->getWorldOrientation() * dir;
+	dir = m_queryRot * dir;
 	to = from + dir;
 	
 	if(m_xray){
@@ -47,9 +47,13 @@ public:
 protected:
 	gkScalar    m_range;
 	int         m_axis;
-	gkString    m_material, m_prop;
+	gkHashedString m_material, m_prop;
         bool        m_xray;
 
+	// world transform captured by prepareQuery
+	gkVector3       m_queryPos;
+	gkQuaternion    m_queryRot;
+
 public:
 
 	gkRaySensor(gkGameObject* object, gkLogicLink* link, const gkString& name);
@@ -59,6 +63,8 @@ public:
 
 	bool query(void);
 
+	void prepareQuery(void);
+
 	GK_INLINE void setRange(gkScalar v)             {m_range = v;}
 	GK_INLINE void setAxis(int v)                   {m_axis = v;}
 	GK_INLINE void setMaterial(const gkString& v)   {m_material = v; m_prop = "";}
@@ -68,8 +74,8 @@ public:
 
 	GK_INLINE gkScalar        getRange(void)        const {return m_range;}
 	GK_INLINE int             getAxis(void)         const {return m_axis;}
-	GK_INLINE const gkString& getMaterial(void)     const {return m_material;}
-	GK_INLINE const gkString& getProperty(void)     const {return m_prop;}
+	GK_INLINE const gkString& getMaterial(void)     const {return m_material.str();}
+	GK_INLINE const gkString& getProperty(void)     const {return m_prop.str();}
 	GK_INLINE bool            getXray(void)         const {return m_xray;}
 };
 
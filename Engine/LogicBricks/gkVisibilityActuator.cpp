@@ -60,7 +60,10 @@ void gkVisibilityActuator::execute(void)
 	if (!m_object->isInstanced())
 		return;
 
-	m_object->getNode()->setVisible((m_flag & VA_INVIS_FLAG) == 0, (m_flag & VA_CHILDREN) != 0);
+	if (m_flag & VA_CHILDREN)
+		m_object->setVisibleRecursive((m_flag & VA_INVIS_FLAG) == 0);
+	else
+		m_object->setVisible((m_flag & VA_INVIS_FLAG) == 0);
 
 	setPulse(BM_OFF);
 
@@ -157,6 +157,7 @@
 #include "LogicBricks/gkLogicBrick.h"
 #include "LogicBricks/gkLogicController.h"
 #include "LogicBricks/gkLogicDispatcher.h"
+#include "LogicBricks/gkLogicExpression.h"
 #include "LogicBricks/gkLogicLink.h"
 #include "LogicBricks/gkLogicManager.h"
 #include "LogicBricks/gkLogicOpController.h"
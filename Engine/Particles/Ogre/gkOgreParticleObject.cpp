@@ -63,7 +63,7 @@ void gkOgreParticleObject::createInstanceImpl()
 		if (m_psys)
 		{
 			m_psys->setUserAny(Ogre::Any(this));
-			m_node->attachObject(m_psys);
+			getRenderNode()->attachObject(m_psys);
 
 			gkOgreParticleResource* resource = gkParticleManager::getSingleton().getByName<gkOgreParticleResource>(
 				gkResourceName(pname, getGroupName()));
@@ -94,7 +94,7 @@ void gkOgreParticleObject::destroyInstanceImpl()
 		if (!m_scene->isBeingDestroyed())
 		{
 			if (m_node)
-				m_node->detachObject(m_psys);
+				getRenderNode()->detachObject(m_psys);
 
 			manager->destroyParticleSystem(m_psys);
 			m_psys = 0;
@@ -28,6 +28,7 @@
 #define _gkContactTest_h_
 
 #include "utTypes.h"
+#include "gkFrameArena.h"
 #include "btBulletCollisionCommon.h"
 
 class gkAllContactResultCallback : public btCollisionWorld::ContactResultCallback
@@ -36,7 +37,10 @@ private:
 	bool m_hasHit;
 
 public:
-	utArray<const btCollisionObject*>  m_contactObjects;
+	// sensors run one query per logic tick, keep the hits in the frame arena
+	typedef utArray<const btCollisionObject*, gkFrameAllocator<const btCollisionObject*> > Objects;
+
+	Objects  m_contactObjects;
 
 	gkAllContactResultCallback() : btCollisionWorld::ContactResultCallback(), m_hasHit(false)
 	{
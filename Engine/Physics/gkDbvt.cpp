@@ -62,9 +62,16 @@ void gkDbvt::Process(const btDbvtNode* nd)
 
 void gkDbvt::mark(gkCamera* cam, btDbvtBroadphase* cullTree, gkPhysicsControllers& controllers)
 {
-	GK_ASSERT(cam && cullTree);
+	GK_ASSERT(cam);
 
-	const Ogre::Plane* planes = cam->getCamera()->getFrustumPlanes();
+	mark(cam->getCamera()->getFrustumPlanes(), cullTree, controllers);
+}
+
+
+
+void gkDbvt::mark(const Ogre::Plane* planes, btDbvtBroadphase* cullTree, gkPhysicsControllers& controllers)
+{
+	GK_ASSERT(planes && cullTree);
 
 	btVector3 normals[6];
 	btScalar offsets[6];
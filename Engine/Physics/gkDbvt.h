@@ -41,6 +41,7 @@ public:
 
 	gkVariable* getInfo(void) {return &m_debug;}
 	void mark(gkCamera* cam, struct btDbvtBroadphase* cullTree, gkPhysicsControllers& controllers);
+	void mark(const Ogre::Plane* planes, struct btDbvtBroadphase* cullTree, gkPhysicsControllers& controllers);
 
 	void Process(const btDbvtNode* nd);
 
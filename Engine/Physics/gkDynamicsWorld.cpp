@@ -35,6 +35,7 @@
 #include "gkCamera.h"
 #include "gkVariable.h"
 #include "gkDbvt.h"
+#include "gkProfiler.h"
 #include "btBulletDynamicsCommon.h"
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 #include "BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h"
@@ -54,7 +55,8 @@ gkDynamicsWorld::gkDynamicsWorld(const gkString& name, gkScene* scene)
 	        m_constraintSolver(0),
 	        m_debug(0),
 	        m_handleContacts(true),
-	        m_dbvt(0)
+	        m_dbvt(0),
+	        m_substepStart(0)
 {
 	createInstanceImpl();
 }
@@ -90,10 +92,12 @@ void gkDynamicsWorld::createInstanceImpl(void)
 	m_dynamicsWorld->setGravity(btVector3(grav.x, grav.y, grav.z));
 	m_dynamicsWorld->setWorldUserInfo(this);
 	m_dynamicsWorld->setInternalTickCallback(substepCallback, static_cast<void*>(this));
+	m_dynamicsWorld->setInternalTickCallback(presubstepCallback, static_cast<void*>(this), true);
 
 	enableDebugPhysics(gkEngine::getSingleton().getUserDefs().debugPhysics, gkEngine::getSingleton().getUserDefs().debugPhysicsAabb);
 
-	if (gkEngine::getSingleton().getUserDefs().useBulletDbvt)
+	// frustum culling is pointless when nothing is rendered
+	if (gkEngine::getSingleton().getUserDefs().useBulletDbvt && !gkEngine::getSingleton().getUserDefs().headless)
 		m_dbvt = new gkDbvt();
 
 	// register gimpact-algorithm
@@ -374,15 +378,19 @@ void gkDynamicsWorld::localDrawObject(gkPhysicsController* phyCon)
 
 
 
-void gkDynamicsWorld::step(gkScalar tick)
+void gkDynamicsWorld::step(gkScalar tick, bool drawDebug)
 {
 	GK_ASSERT(m_dynamicsWorld);
 
 	//uncomment this for better simulation quality (but a little bit less performance)
 	//	m_dynamicsWorld->stepSimulation(tick,10,1./240.);
-	m_dynamicsWorld->stepSimulation(tick);
 
-	m_dynamicsWorld->debugDrawWorld();
+	// ticks slower than bullet's internal 60hz still simulate the whole tick
+	int subSteps = 1 + (int)(tick * gkScalar(60.0) - gkScalar(0.001));
+	m_dynamicsWorld->stepSimulation(tick, subSteps);
+
+	if (drawDebug)
+		drawDebugWorld();
 
 	// uncomment this to print bullet profiling information
 	//CProfileManager::dumpAll();
@@ -390,6 +398,14 @@ void gkDynamicsWorld::step(gkScalar tick)
 
 
 
+void gkDynamicsWorld::drawDebugWorld(void)
+{
+	GK_ASSERT(m_dynamicsWorld);
+	m_dynamicsWorld->debugDrawWorld();
+}
+
+
+
 void gkDynamicsWorld::resetContacts()
 {
 	if (m_handleContacts && !m_objects.empty())
@@ -405,6 +421,8 @@ void gkDynamicsWorld::resetContacts()
 
 void gkDynamicsWorld::presubstep(gkScalar tick)
 {
+	GK_PROFILE_MARK(m_substepStart);
+
 	// update callbacks
 	utArrayIterator<gkDynamicsWorld::Listeners> iter(m_listeners);
 	while(iter.hasMoreElements())
@@ -416,6 +434,8 @@ void gkDynamicsWorld::substep(gkScalar tick)
 {
 	if (m_handleContacts)
 	{
+		GK_PROFILE_SCOPE("Contacts");
+
 		int nr = m_dispatcher->getNumManifolds();
 
 		for (int i = 0; i < nr; ++i)
@@ -445,6 +465,8 @@ void gkDynamicsWorld::substep(gkScalar tick)
 	utArrayIterator<gkDynamicsWorld::Listeners> iter(m_listeners);
 	while(iter.hasMoreElements())
 		iter.getNext()->subtick(tick);
+
+	GK_PROFILE_RECORD("PhysicsSubstep", m_substepStart);
 }
 
 
@@ -505,6 +527,16 @@ void gkDynamicsWorld::handleDbvt(gkCamera* cam)
 
 
 
+void gkDynamicsWorld::handleDbvt(const Ogre::Plane* planes)
+{
+	if (!m_dbvt)
+		return;
+
+	m_dbvt->mark(planes, (btDbvtBroadphase*)m_pairCache, m_objects);
+}
+
+
+
 void gkDynamicsWorld::exportBullet(const gkString& fileName)
 {
 	int maxSerializeBufferSize = 1024 * 1024 * 5;
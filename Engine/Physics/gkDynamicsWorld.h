@@ -78,6 +78,7 @@ protected:
 	bool                        m_handleContacts;
 	gkDbvt*                     m_dbvt;
 	Listeners                   m_listeners;
+	UTuint64                    m_substepStart;     // profiler mark, bullet pre to post tick
 
 
 	// drawing all but static wireframes
@@ -94,7 +95,8 @@ public:
 	virtual ~gkDynamicsWorld();
 
 	// Do one full physics step
-	void step(gkScalar tick);
+	void step(gkScalar tick, bool drawDebug = true);
+	void drawDebugWorld(void);
 	void presubstep(gkScalar tick);
 	void substep(gkScalar tick);
 
@@ -117,6 +119,7 @@ public:
 	void resetContacts();
 
 	void handleDbvt(gkCamera* cam);
+	void handleDbvt(const Ogre::Plane* planes);
 
 	gkPhysicsDebug* getDebug() const { return m_debug; }
 
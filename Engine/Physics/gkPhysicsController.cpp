@@ -190,7 +190,7 @@ bool gkPhysicsController::collidesWith(const gkString& name, gkContactInfo* cpy,
 
 
 
-bool gkPhysicsController::sensorCollides(const gkString& prop, const gkString& material, bool onlyActor, bool testAllMaterials, utArray<gkGameObject*>* collisionList)
+bool gkPhysicsController::sensorCollides(const gkHashedString& prop, const gkHashedString& material, bool onlyActor, bool testAllMaterials, utArray<gkGameObject*>* collisionList)
 {
 	if (collisionList){
 		collisionList->clear();
@@ -334,7 +334,7 @@ bool gkPhysicsController::_markDbvt(bool v)
 
 
 
-bool gkPhysicsController::sensorTest(gkGameObject* ob, const gkString& prop, const gkString& material, bool onlyActor, bool testAllMaterials)
+bool gkPhysicsController::sensorTest(gkGameObject* ob, const gkHashedString& prop, const gkHashedString& material, bool onlyActor, bool testAllMaterials)
 {
 	GK_ASSERT(ob);
 
@@ -679,14 +679,8 @@ void gkPhysicsController::setTransform(const btTransform& worldTrans)
 	const gkQuaternion& rot = gkMathUtils::get(worldTrans.getRotation());
 	const gkVector3& loc = gkMathUtils::get(worldTrans.getOrigin());
 
-	// apply to the node and sync state next update
-
-	Ogre::SceneNode* node = m_object->getNode();
-
-	node->setOrientation(rot);
-	node->setPosition(loc);
-
-	m_object->notifyUpdate();
+	// the store composes world transforms on the next update
+	m_object->_setPhysicsTransform(loc, rot);
 }
 
 
@@ -745,6 +739,7 @@ void gkPhysicsController::_handleManifold(btPersistentManifold* manifold)
 
 void gkPhysicsController::_resetContactInfo(void)
 {
+	// keep the storage, clear(true) would still free it every _UT_CACHE_LIMIT ticks
 	if (m_props.isContactListener())
-		m_localContacts.clear(true);
+		m_localContacts.resize(0);
 }
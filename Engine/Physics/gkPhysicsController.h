@@ -88,8 +88,8 @@ public:
 	// If onlyActor is true, filter collision on actor settings (gkGameObjectProperties).
 	// If testAllMaterials is true, test all assigned opposed to only testing the first assigned.
 //	bool sensorCollides(const gkString& prop, const gkString& material = "", bool onlyActor = false, bool testAllMaterials = false);
-	bool sensorCollides(const gkString& prop, const gkString& material, bool onlyActor, bool testAllMaterials, utArray<gkGameObject*>* list=NULL);
-	static bool sensorTest(gkGameObject* ob, const gkString& prop, const gkString& material = "", bool onlyActor = false, bool testAllMaterials = false);
+	bool sensorCollides(const gkHashedString& prop, const gkHashedString& material, bool onlyActor, bool testAllMaterials, utArray<gkGameObject*>* list=NULL);
+	static bool sensorTest(gkGameObject* ob, const gkHashedString& prop, const gkHashedString& material = gkHashedString(), bool onlyActor = false, bool testAllMaterials = false);
 
 	static gkPhysicsController* castController(btCollisionObject* colObj);
 	static gkPhysicsController* castController(const btCollisionObject* colObj);
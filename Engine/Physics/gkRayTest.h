@@ -97,11 +97,11 @@ struct notMeFilter : gkRayTest::gkRayTestFilter
 
 struct xrayFilter : gkRayTest::gkRayTestFilter
 {
-	xrayFilter(gkGameObject *self, const gkString& prop, const gkString& material)
+	xrayFilter(gkGameObject *self, const gkHashedString& prop, const gkHashedString& material)
 	:m_self(self), m_prop(prop), m_material(material) {}
 	
 	gkGameObject *m_self;
-	gkString m_prop, m_material;
+	gkHashedString m_prop, m_material;
 		
 	virtual bool filterFunc(btCollisionObject* ob) const;
 };
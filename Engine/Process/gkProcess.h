@@ -29,6 +29,7 @@
 #define _gkProcess_h_
 #include "gkMathUtils.h"
 #include "Process/gkProcess.h"
+#include "utMemoryPool.h"
 
 class gkProcess {
 	friend class gkProcessManager;
@@ -61,6 +62,8 @@ public:
 	gkProcess();
 	virtual ~gkProcess();
 
+	UT_DECLARE_POOLED_CLASS()
+
 	virtual bool isFinished() { return true; }
 	virtual void init() {}
 	virtual void update(gkScalar delta) {}
@@ -282,10 +282,17 @@ void gkSoundManager::update(gkScene* scene)
 
 	gkCamera* obj = scene->getMainCamera();
 
-	const gkVector3 pos     = obj->getWorldPosition();
-	const gkVector3 vel     = obj->getLinearVelocity();
-	const gkQuaternion rot  = obj->getWorldOrientation();
+	updateListener(obj->getWorldPosition(), obj->getLinearVelocity(), obj->getWorldOrientation());
 
+	drawDebug(scene);
+}
+
+
+
+void gkSoundManager::updateListener(const gkVector3& pos, const gkVector3& vel, const gkQuaternion& rot)
+{
+	if (!gkSndCtxValid())
+		return;
 
 	gkVector3 at = (rot * gkVector3(0, 0, -1));
 	gkVector3 up = (rot * gkVector3(0, 1, 0));
@@ -294,8 +301,12 @@ void gkSoundManager::update(gkScene* scene)
 	alListenerfv(AL_POSITION,       pos.ptr());
 	alListenerfv(AL_ORIENTATION,    ori);
 	alListenerfv(AL_VELOCITY,       vel.ptr());
+}
 
 
+
+void gkSoundManager::drawDebug(gkScene* scene)
+{
 	// Apply debug information.
 	if (gkEngine::getSingleton().getUserDefs().debugSounds && !m_playingSources.empty())
 	{
@@ -79,6 +79,8 @@ public:
 	void stopSound(gkSource*);
 
 	void update(gkScene* scene);
+	void updateListener(const gkVector3& pos, const gkVector3& vel, const gkQuaternion& rot);
+	void drawDebug(gkScene* scene);
 	void collectGarbage(void);
 
 
@@ -0,0 +1,84 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkAtomic_h_
+#define _gkAtomic_h_
+
+#include "gkNonCopyable.h"
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+// Integer with full-barrier atomic read-modify-write operations.
+class gkAtomicInt : gkNonCopyable
+{
+public:
+
+	gkAtomicInt(int value = 0)
+		: m_value(value)
+	{
+	}
+
+#ifdef WIN32
+
+	int get(void) const         { return (int)InterlockedCompareExchange(&m_value, 0, 0); }
+	void set(int value)         { InterlockedExchange(&m_value, value); }
+	int add(int value)          { return (int)InterlockedExchangeAdd(&m_value, value) + value; }
+
+	// returns true if the value was swapped
+	bool compareAndSwap(int expected, int value)
+	{
+		return InterlockedCompareExchange(&m_value, value, expected) == expected;
+	}
+
+#else
+
+	int get(void) const         { return __sync_fetch_and_add(&m_value, 0); }
+	void set(int value)         { __sync_lock_test_and_set(&m_value, value); __sync_synchronize(); }
+	int add(int value)          { return __sync_add_and_fetch(&m_value, value); }
+
+	// returns true if the value was swapped
+	bool compareAndSwap(int expected, int value)
+	{
+		return __sync_bool_compare_and_swap(&m_value, expected, value);
+	}
+
+#endif
+
+	int increment(void)         { return add(1); }
+	int decrement(void)         { return add(-1); }
+
+private:
+
+#ifdef WIN32
+	mutable volatile LONG m_value;
+#else
+	mutable volatile int m_value;
+#endif
+};
+
+#endif//_gkAtomic_h_
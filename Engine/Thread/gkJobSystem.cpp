@@ -0,0 +1,383 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkJobSystem.h"
+#include "gkLogger.h"
+#include "gkMathUtils.h"
+#include "gkProfiler.h"
+
+#include <stdio.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+
+// queue index owned by the running thread, -1 for foreign threads
+static GK_THREAD_LOCAL int gkJobThreadIndex = -1;
+static GK_THREAD_LOCAL int gkJobSerialDepth = 0;
+
+
+class gkJobSystem::Queue : gkNonCopyable
+{
+public:
+	gkCriticalSection   m_cs;
+	std::deque<gkJob>   m_jobs;
+};
+
+
+class gkJobSystem::Worker : public gkCall, gkNonCopyable
+{
+public:
+
+	Worker(gkJobSystem* sys, int index)
+		:   m_sys(sys),
+		    m_index(index),
+		    m_thread(0)
+	{
+		m_thread = new gkThread(this);
+	}
+
+	virtual ~Worker()
+	{
+		delete m_thread;
+	}
+
+	void run()
+	{
+		gkJobThreadIndex = m_index;
+		m_sys->workerMain(m_index);
+	}
+
+	void join()
+	{
+		m_thread->join();
+	}
+
+private:
+	gkJobSystem*    m_sys;
+	int             m_index;
+	gkThread*       m_thread;
+};
+
+
+
+UT_IMPLEMENT_SINGLETON(gkJobSystem);
+
+gkJobSystem::gkJobSystem(int numWorkers)
+{
+	if (numWorkers < 0)
+		numWorkers = (int)getNumProcessors() - 1;
+
+	int i;
+	for (i = 0; i <= numWorkers; i++)
+		m_queues.push_back(new Queue());
+
+	gkJobThreadIndex = 0;
+
+	for (i = 1; i <= numWorkers; i++)
+		m_workers.push_back(new Worker(this, i));
+}
+
+
+gkJobSystem::~gkJobSystem()
+{
+	m_quit.set(1);
+
+	UTsize i;
+	for (i = 0; i < m_workers.size(); i++)
+		m_wake.signal();
+
+	for (i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i]->join();
+		delete m_workers[i];
+	}
+
+	for (i = 0; i < m_queues.size(); i++)
+	{
+		GK_ASSERT(m_queues[i]->m_jobs.empty() && "Jobs left in flight");
+		delete m_queues[i];
+	}
+
+	gkJobThreadIndex = -1;
+}
+
+
+UTsize gkJobSystem::getNumProcessors(void)
+{
+#ifdef WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (UTsize)info.dwNumberOfProcessors : 1;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (UTsize)count : 1;
+#endif
+}
+
+
+void gkJobSystem::beginSerial(void)
+{
+	gkJobSerialDepth++;
+}
+
+
+void gkJobSystem::endSerial(void)
+{
+	GK_ASSERT(gkJobSerialDepth > 0);
+	gkJobSerialDepth--;
+}
+
+
+bool gkJobSystem::isSerial(void)
+{
+	return gkJobSerialDepth != 0;
+}
+
+
+void gkJobSystem::submit(gkCall* call, gkJobCounter* counter)
+{
+	GK_ASSERT(call);
+
+	gkJob job = {call, 0, 0, 0, counter};
+
+	if (counter)
+		counter->m_value.increment();
+
+	push(job);
+}
+
+
+void gkJobSystem::submitAfter(gkJobCounter& dependency, gkCall* call, gkJobCounter* counter)
+{
+	GK_ASSERT(call && &dependency != counter);
+
+	gkJob job = {call, 0, 0, 0, counter};
+
+	if (counter)
+		counter->m_value.increment();
+
+	{
+		gkCriticalSection::Lock guard(dependency.m_cs);
+
+		// the last decrement flushes the list under this lock,
+		// so a done counter will never see this job again
+		if (!dependency.isDone())
+		{
+			dependency.m_continuations.push_back(job);
+			return;
+		}
+	}
+
+	push(job);
+}
+
+
+void gkJobSystem::wait(gkJobCounter& counter)
+{
+	int index = gkJobThreadIndex;
+	gkJob job;
+
+	while (!counter.isDone())
+	{
+		if (!gkJobSerialDepth && fetch(index, job))
+			execute(job);
+		else
+			gkThread::yield();
+	}
+}
+
+
+void gkJobSystem::parallelFor(UTsize count, UTsize grain, gkParallelForCall& body)
+{
+	if (count == 0)
+		return;
+
+	UTsize threads = m_workers.size() + 1;
+	if (grain < 1)
+		grain = 1;
+
+	// a few chunks per thread so stealing can even out the load
+	UTsize chunk = count / (threads * 4);
+	if (chunk < grain)
+		chunk = grain;
+
+	if (chunk >= count || gkJobSerialDepth)
+	{
+		body.run(0, count);
+		return;
+	}
+
+	gkJobCounter counter;
+
+	// keep the first chunk for the calling thread
+	UTsize begin;
+	for (begin = chunk; begin < count; begin += chunk)
+	{
+		gkJob job = {0, &body, begin, gkMin(begin + chunk, count), &counter};
+		counter.m_value.increment();
+		push(job);
+	}
+
+	body.run(0, chunk);
+
+	wait(counter);
+}
+
+
+void gkJobSystem::push(const gkJob& job)
+{
+	if (gkJobSerialDepth)
+	{
+		// nothing queued here may depend on a worker picking it up
+		execute(job);
+		return;
+	}
+
+	int index = gkJobThreadIndex;
+	Queue* queue = m_queues[index < 0 ? 0 : index];
+
+	{
+		gkCriticalSection::Lock guard(queue->m_cs);
+		queue->m_jobs.push_back(job);
+	}
+
+	if (m_sleeping.get() > 0)
+		m_wake.signal();
+}
+
+
+bool gkJobSystem::fetch(int index, gkJob& job)
+{
+	int size = (int)m_queues.size();
+
+	if (index >= 0)
+	{
+		Queue* queue = m_queues[index];
+		gkCriticalSection::Lock guard(queue->m_cs);
+
+		if (!queue->m_jobs.empty())
+		{
+			job = queue->m_jobs.back();
+			queue->m_jobs.pop_back();
+			return true;
+		}
+	}
+
+	int i;
+	for (i = 1; i <= size; i++)
+	{
+		int victim = (index + i) % size;
+		if (victim == index || victim < 0)
+			continue;
+
+		Queue* queue = m_queues[victim];
+		gkCriticalSection::Lock guard(queue->m_cs);
+
+		if (!queue->m_jobs.empty())
+		{
+			job = queue->m_jobs.front();
+			queue->m_jobs.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void gkJobSystem::execute(const gkJob& job)
+{
+	try
+	{
+		if (job.call)
+			job.call->run();
+		else
+			job.body->run(job.begin, job.end);
+	}
+	catch (...) // catch all the exceptions.
+	{
+		gkLogMessage("JobSystem: job error.");
+	}
+
+	gkJobCounter* counter = job.counter;
+	if (!counter)
+		return;
+
+	utArray<gkJob> ready;
+	{
+		// decrement under the lock so submitAfter never races the flush
+		gkCriticalSection::Lock guard(counter->m_cs);
+
+		if (counter->m_value.decrement() != 0)
+			return;
+
+		ready.swap(counter->m_continuations);
+	}
+
+	UTsize i;
+	for (i = 0; i < ready.size(); i++)
+		push(ready[i]);
+}
+
+
+void gkJobSystem::workerMain(int index)
+{
+	gkJob job;
+
+#ifdef OGREKIT_USE_PROFILER
+	char name[32];
+	sprintf(name, "Job Worker %d", index);
+	GK_PROFILE_THREAD(name);
+#endif
+
+	while (!m_quit.get())
+	{
+		if (fetch(index, job))
+		{
+			execute(job);
+			continue;
+		}
+
+		// announce before re-checking, a push in between will see us
+		m_sleeping.increment();
+
+		if (fetch(index, job))
+		{
+			m_sleeping.decrement();
+			execute(job);
+			continue;
+		}
+
+		if (!m_quit.get())
+			m_wake.wait();
+
+		m_sleeping.decrement();
+	}
+}
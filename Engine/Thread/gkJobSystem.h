@@ -0,0 +1,140 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkJobSystem_h_
+#define _gkJobSystem_h_
+
+#include "gkCommon.h"
+#include "gkNonCopyable.h"
+#include "gkCriticalSection.h"
+#include "gkSyncObj.h"
+#include "gkThread.h"
+#include "gkAtomic.h"
+#include "utSingleton.h"
+
+class gkJobCounter;
+
+
+// Body of a parallel-for loop, called with sub ranges [begin, end).
+class gkParallelForCall
+{
+public:
+	virtual ~gkParallelForCall() {}
+
+	virtual void run(UTsize begin, UTsize end) = 0;
+};
+
+
+// A single unit of work. Jobs do not own their call, the caller must keep
+// it alive until the job's counter reaches zero.
+struct gkJob
+{
+	gkCall*             call;
+	gkParallelForCall*  body;
+	UTsize              begin;
+	UTsize              end;
+	gkJobCounter*       counter;
+};
+
+
+// Number of outstanding jobs. Jobs queued with gkJobSystem::submitAfter
+// are released once the counter they depend on drops to zero.
+class gkJobCounter : gkNonCopyable
+{
+public:
+	gkJobCounter() {}
+
+	// the lock waits out a job still releasing the counter
+	~gkJobCounter() { gkCriticalSection::Lock guard(m_cs); GK_ASSERT(isDone()); }
+
+	GK_INLINE int  get(void) const     { return m_value.get(); }
+	GK_INLINE bool isDone(void) const  { return m_value.get() == 0; }
+
+private:
+	friend class gkJobSystem;
+
+	gkAtomicInt         m_value;
+	gkCriticalSection   m_cs;
+	utArray<gkJob>      m_continuations;
+};
+
+
+// Pool of worker threads, one per core by default. Each thread owns a
+// queue, pushing and popping at the back, idle threads steal from the
+// front of the other queues. The thread that created the system owns
+// queue zero and only runs jobs from inside wait().
+class gkJobSystem : public utSingleton<gkJobSystem>
+{
+public:
+
+	// numWorkers < 0 uses one worker per core, minus the calling thread.
+	gkJobSystem(int numWorkers = -1);
+	~gkJobSystem();
+
+	void submit(gkCall* call, gkJobCounter* counter = 0);
+
+	// queue call once dependency reaches zero
+	void submitAfter(gkJobCounter& dependency, gkCall* call, gkJobCounter* counter = 0);
+
+	// runs pending jobs on the calling thread until counter reaches zero
+	void wait(gkJobCounter& counter);
+
+	// splits [0, count) in chunks of at least grain and waits for them
+	void parallelFor(UTsize count, UTsize grain, gkParallelForCall& body);
+
+	GK_INLINE UTsize getNumWorkers(void) const  { return m_workers.size(); }
+
+	static UTsize getNumProcessors(void);
+
+
+	// Between beginSerial and endSerial, jobs submitted by the calling thread
+	// run inline and wait() only yields, it never picks up unrelated jobs.
+	// Used under locks those jobs may want themselves.
+	static void beginSerial(void);
+	static void endSerial(void);
+	static bool isSerial(void);
+
+private:
+
+	class Worker;
+	class Queue;
+
+	void push(const gkJob& job);
+	bool fetch(int index, gkJob& job);
+	void execute(const gkJob& job);
+	void workerMain(int index);
+
+	utArray<Queue*>     m_queues;
+	utArray<Worker*>    m_workers;
+	gkSyncObj           m_wake;
+	gkAtomicInt         m_sleeping;
+	gkAtomicInt         m_quit;
+
+public:
+	UT_DECLARE_SINGLETON(gkJobSystem);
+};
+
+#endif//_gkJobSystem_h_
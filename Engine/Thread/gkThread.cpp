@@ -30,6 +30,8 @@
 
 #ifdef WIN32
 #include <process.h>
+#else
+#include <sched.h>
 #endif
 
 #ifdef WIN32
@@ -49,6 +51,8 @@ void* gkThread::task(void* p)
 	gkThread* pThread = static_cast<gkThread*>(p);
 
 	pThread->run();
+
+	return 0;
 }
 #endif
 
@@ -130,3 +134,12 @@ void gkThread::run()
 
 	m_syncObj.signal();
 }
+
+void gkThread::yield()
+{
+#ifdef WIN32
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
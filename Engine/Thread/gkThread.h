@@ -37,6 +37,12 @@
 #include "gkSyncObj.h"
 #include "gkPtrRef.h"
 
+#ifdef _MSC_VER
+#define GK_THREAD_LOCAL __declspec(thread)
+#else
+#define GK_THREAD_LOCAL __thread
+#endif
+
 class gkCall : public gkReferences
 {
 public:
@@ -57,6 +63,9 @@ public:
 
 	void join();
 
+	// give up the rest of the calling thread's time slice
+	static void yield();
+
 private:
 
 #ifdef WIN32
@@ -69,7 +69,7 @@ void gkCamera::createInstanceImpl(void)
 
 
 
-	m_node->attachObject(m_camera);
+	getRenderNode()->attachObject(m_camera);
 
 	if (m_cameraProps.m_start)
 		m_scene->setMainCamera(this);
@@ -87,7 +87,7 @@ void gkCamera::destroyInstanceImpl(void)
 		Ogre::SceneManager* manager = m_scene->getManager();
 
 
-		m_node->detachObject(m_camera);
+		getRenderNode()->detachObject(m_camera);
 		manager->destroyCamera(m_camera);
 	}
 
@@ -111,6 +111,8 @@ class gkDynamicsWorld;
 class gkDebugger;
 class gkScene;
 class gkActiveObject;
+class gkJobSystem;
+class gkTickState;
 
 class gkGameObjectGroup;
 class gkGameObjectInstance;
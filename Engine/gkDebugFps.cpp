@@ -31,7 +31,7 @@
 #include "gkEngine.h"
 #include "gkScene.h"
 #include "gkDynamicsWorld.h"
-#include "gkStats.h"
+#include "gkProfiler.h"
 
 #include "OgreOverlayManager.h"
 #include "OgreOverlayElement.h"
@@ -61,14 +61,6 @@ gkDebugFps::gkDebugFps()
 	m_keys += "DBVT:\n";
 	m_keys += "\n";
 	m_keys += "Total:\n";
-	m_keys += "Render:\n";
-	m_keys += "Physics:\n";
-	m_keys += "LogicBricks:\n";
-	m_keys += "LogicNodes:\n";
-	m_keys += "Sound:\n";
-	m_keys += "DBVT:\n";
-	m_keys += "Bufferswap&LOD:\n";
-	m_keys += "Animations:\n";
 }
 
 
@@ -165,19 +157,6 @@ void gkDebugFps::draw(void)
 	if (wo) dbvtVal = wo->getDBVTInfo();
 
 
-	float swap = gkStats::getSingleton().getLastTotalMicroSeconds() / 1000.0f;
-	float render = gkStats::getSingleton().getLastRenderMicroSeconds() / 1000.0f;
-	float phys = gkStats::getSingleton().getLastPhysicsMicroSeconds() / 1000.0f;
-	float logicb = gkStats::getSingleton().getLastLogicBricksMicroSeconds() / 1000.0f;
-	float logicn = gkStats::getSingleton().getLastLogicNodesMicroSeconds() / 1000.0f;
-	float sound = gkStats::getSingleton().getLastSoundMicroSeconds() / 1000.0f;
-	float dbvt = gkStats::getSingleton().getLastDbvtMicroSeconds() / 1000.0f;
-	float bufswaplod = gkStats::getSingleton().getLastBufSwapLodMicroSeconds() / 1000.0f;
-	float animations = gkStats::getSingleton().getLastAnimationsMicroSeconds() / 1000.0f;
-#ifdef OGREKIT_USE_PROCESSMANAGER
-	float process = gkStats::getSingleton().getLastProcessMicroSeconds() / 1000.0f;
-#endif
-
 	gkString vals = "";
 
 	vals += Ogre::StringConverter::toString(ogrestats.lastFPS) + '\n';
@@ -194,40 +173,29 @@ void gkDebugFps::draw(void)
 	else  vals += "Not Enabled\n";
 	vals += '\n';
 
-	vals += Ogre::StringConverter::toString(swap, 3, 7, '0', std::ios::fixed) + "ms 100%\n";
-
-	vals += Ogre::StringConverter::toString(render, 3, 7, '0', std::ios::fixed) + "ms ";
-	vals += Ogre::StringConverter::toString( int(100 * render / swap), 3 ) + "%\n";
-
-	vals += Ogre::StringConverter::toString(phys, 3, 7, '0', std::ios::fixed) + "ms ";
-	vals += Ogre::StringConverter::toString( int(100 * phys / swap), 3 ) + "%\n";
+	gkString keys = m_keys;
 
-	vals += Ogre::StringConverter::toString(logicb, 3, 7, '0', std::ios::fixed) + "ms ";
-	vals += Ogre::StringConverter::toString( int(100 * logicb / swap), 3 ) + "%\n";
+	// per frame zone rollups, indented by nesting
+	gkProfiler& profiler = gkProfiler::getSingleton();
+	float total = profiler.getLastFrameTime() / 1000000.0f;
 
-	vals += Ogre::StringConverter::toString(logicn, 3, 7, '0', std::ios::fixed) + "ms ";
-	vals += Ogre::StringConverter::toString( int(100 * logicn / swap), 3 ) + "%\n";
+	vals += Ogre::StringConverter::toString(total, 3, 7, '0', std::ios::fixed) + "ms 100%\n";
 
-	vals += Ogre::StringConverter::toString(sound, 3, 7, '0', std::ios::fixed) + "ms ";
-	vals += Ogre::StringConverter::toString( int(100 * sound / swap), 3 ) + "%\n";
-
-	vals += Ogre::StringConverter::toString(dbvt, 3, 7, '0', std::ios::fixed) + "ms ";
-	vals += Ogre::StringConverter::toString( int(100 * dbvt / swap), 3 ) + "%\n";
-
-	vals += Ogre::StringConverter::toString(bufswaplod, 3, 7, '0', std::ios::fixed) + "ms ";
-	vals += Ogre::StringConverter::toString( int(100 * bufswaplod / swap), 3 ) + "%\n";
+	const gkProfiler::Rollups& rollups = profiler.getLastFrame();
+	for (UTsize i = 0; i < rollups.size(); i++)
+	{
+		const gkProfiler::Rollup& rollup = rollups[i];
+		float ms = rollup.time / 1000000.0f;
 
-	vals += Ogre::StringConverter::toString(animations, 3, 7, '0', std::ios::fixed) + "ms ";
-	vals += Ogre::StringConverter::toString( int(100 * animations / swap), 3 ) + "%\n";
+		keys += gkString(gkMin<UTuint32>(rollup.depth, 4), ' ') + rollup.zone->getName() + ":\n";
 
-#ifdef OGREKIT_USE_PROCESSMANAGER
-	vals += Ogre::StringConverter::toString(process, 3, 7, '0', std::ios::fixed) + "ms ";
-	vals += Ogre::StringConverter::toString( int(100 * process / swap), 3 ) + "%\n";
-#endif
+		vals += Ogre::StringConverter::toString(ms, 3, 7, '0', std::ios::fixed) + "ms ";
+		vals += Ogre::StringConverter::toString(total > 0 ? int(100 * ms / total) : 0, 3) + "%\n";
+	}
 
-	if (!m_keys.empty() && !vals.empty())
+	if (!keys.empty() && !vals.empty())
 	{
-		m_key->setCaption(m_keys);
+		m_key->setCaption(keys);
 		m_val->setCaption(vals);
 	}
 }
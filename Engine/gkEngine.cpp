@@ -43,7 +43,8 @@
 #include "gkDebugProperty.h"
 #include "gkTickState.h"
 #include "gkDebugFps.h"
-#include "gkStats.h"
+#include "gkProfiler.h"
+#include "gkFrameArena.h"
 #include "gkMessageManager.h"
 #include "gkMeshManager.h"
 #include "gkSkeletonManager.h"
@@ -53,6 +54,9 @@
 #include "gkAnimationManager.h"
 #include "gkParticleManager.h"
 #include "gkHUDManager.h"
+#include "Thread/gkJobSystem.h"
+#include "gkSceneContext.h"
+#include "gkTransformSnapshot.h"
 
 #ifdef OGREKIT_COMPILE_ENET
 #include "Network/gkNetworkManager.h"
@@ -90,6 +94,7 @@
 #include "OgreStringConverter.h"
 #include "OgreFrameListener.h"
 #include "OgreOverlayManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
 
 // temporary hack for keeping compatibility with ogre18 due to the android-version
 #ifndef BUILD_OGRE18
@@ -111,6 +116,47 @@
 gkScalar gkEngine::m_tickRate = ENGINE_TICKS_PER_SECOND;
 
 
+// updates one scene on a job thread
+class gkSceneUpdateCall : public gkCall
+{
+public:
+	gkSceneUpdateCall() : scene(0), delta(0) {}
+
+	void run()
+	{
+		gkSceneContext context(scene);
+		scene->update(delta);
+	}
+
+	gkScene*    scene;
+	gkScalar    delta;
+};
+
+
+
+// steps physics of the coming tick while the frame renders
+class gkPhysicsAheadCall : public gkCall
+{
+public:
+	gkPhysicsAheadCall() : scenes(0), delta(0) {}
+
+	void run()
+	{
+		UTsize i;
+		for (i = 0; i < scenes->size(); i++)
+		{
+			gkScene* scene = scenes->at(i);
+			gkSceneContext context(scene);
+			scene->stepPhysicsAhead(delta);
+		}
+	}
+
+	gkSceneArray*   scenes;
+	gkScalar        delta;
+};
+
+
+
 class gkOgreEnginePrivate : public Ogre::FrameListener, public gkTickState
 {
 public:
@@ -119,12 +165,16 @@ public:
 		        engine(par),
 		        windowsystem(0),
 		        curScene(0),
+		        ticked(false),
+		        renderStart(0),
+		        swapStart(0),
 		        debug(0),
 		        debugPage(0),
 		        debugFps(0),
 				archive_factory(0),
 				timer(0),
-				root(0)
+				root(0),
+				bufferManager(0)
 
 	{
 		timer = new btClock();
@@ -137,6 +187,9 @@ public:
 
 	virtual ~Private()
 	{
+		for (UTsize i = 0; i < sceneCalls.size(); i++)
+			delete sceneCalls[i];
+
 		delete timer;
 		delete plugin_factory;
 		delete archive_factory;
@@ -145,9 +198,15 @@ public:
 
 	// one full update
 	void tickImpl(gkScalar delta);
+	void updateScenesConcurrent(gkScalar delta);
 	void beginTickImpl(void);
 	void endTickImpl(void);
 
+	// pipelined and interpolated rendering, see gkTransformSnapshot
+	void beginRenderFrame(void);
+	void captureSnapshots(void);
+	bool isInterpolating(void);
+
 
 	bool frameStarted(const Ogre::FrameEvent& evt);
 	bool frameRenderingQueued(const Ogre::FrameEvent& evt);
@@ -155,10 +214,17 @@ public:
 
 	gkEngine*                   engine;
 	gkWindowSystem*             windowsystem;       // current window system
-	gkScene*                    curScene;			// current scene
+	gkScene*                    curScene;			// main scene, see getActiveScene
 	gkSceneArray				scenes;
+	utArray<gkSceneUpdateCall*> sceneCalls;         // parallelScenes only
+	gkPhysicsAheadCall          aheadCall;          // pipelined only
+	gkJobCounter                aheadCounter;
+	bool                        ticked;             // a tick ran since the last snapshot
+	UTuint64                    renderStart;        // profiler marks spanning frame listener calls
+	UTuint64                    swapStart;
 	gkRenderFactoryPrivate*     plugin_factory;     // static plugin loading
 	Ogre::Root*                 root;
+	Ogre::HardwareBufferManager* bufferManager;     // software buffers, headless only
 	gkDebugScreen*              debug;
 	gkDebugPropertyPage*        debugPage;
 	gkDebugFps*                 debugFps;
@@ -220,7 +286,12 @@ void gkEngine::initialize()
 	gkUserDefs& defs = getUserDefs();
 	gkLogger::enable(defs.log, defs.verbose);
 
-	if (defs.rendersystem == OGRE_RS_UNKNOWN)
+	m_tickRate = (gkScalar)defs.tickRate;
+	m_private->initialize(defs.tickRate);
+	m_private->setMode(defs.tickAccumulator ? gkTickState::TM_ACCUMULATOR : gkTickState::TM_MILLISECOND);
+	m_private->setCatchUp(defs.tickCatchUp, defs.maxTickSteps);
+
+	if (defs.rendersystem == OGRE_RS_UNKNOWN && !defs.headless)
 	{
 		gkPrintf("Unknown rendersystem!\n");
 		return;
@@ -228,30 +299,52 @@ void gkEngine::initialize()
 
 	Ogre::Root* root = new Ogre::Root("", "");
 	m_private->root = root;
-	m_private->plugin_factory->createRenderSystem(root, defs.rendersystem);
-	m_private->plugin_factory->createCGProgrammManager(root);
+	if (!defs.headless)
+	{
+		m_private->plugin_factory->createRenderSystem(root, defs.rendersystem);
+		m_private->plugin_factory->createCGProgrammManager(root);
+	}
 	m_private->plugin_factory->createParticleSystem(root);
 	m_private->archive_factory->addArchiveFactory();
 
 #ifndef BUILD_OGRE18
 	m_private->overlaySystem = new Ogre::OverlaySystem();
 #endif
-	const Ogre::RenderSystemList& renderers = root->getAvailableRenderers();
-	if (renderers.empty())
+
+	if (defs.headless)
 	{
-		gkPrintf("No rendersystems present\n");
-		return;
+		// No render system, so no render targets and no GPU buffers.
+		// Meshes still need vertex / index data for physics and bounds,
+		// keep it in system memory.
+		m_private->bufferManager = new Ogre::DefaultHardwareBufferManager();
 	}
+	else
+	{
+		const Ogre::RenderSystemList& renderers = root->getAvailableRenderers();
+		if (renderers.empty())
+		{
+			gkPrintf("No rendersystems present\n");
+			return;
+		}
 
-	root->setRenderSystem(renderers[0]);
+		root->setRenderSystem(renderers[0]);
 #if defined(_MSC_VER) && defined(OGRE_BUILD_RENDERSYSTEM_GLES2)
-	renderers[0]->setConfigOption("RTT Preferred Mode", "Copy"); //angleproject gles2
+		renderers[0]->setConfigOption("RTT Preferred Mode", "Copy"); //angleproject gles2
 #endif
 
-	root->initialise(false);
+		root->initialise(false);
+	}
 
 	m_private->windowsystem = new gkWindowSystem();
 
+	// profiling, before the job workers name their threads
+	new gkProfiler();
+	GK_PROFILE_THREAD("Main");
+	if (!defs.profileTrace.empty())
+		gkProfiler::getSingleton().beginCapture();
+
+	new gkJobSystem(defs.jobThreads);
+
 	// gk Managers
 	new gkSceneManager();
 #ifdef OGREKIT_COMPILE_ENET
@@ -270,7 +363,10 @@ void gkEngine::initialize()
 #endif
 	new gkHUDManager();
 	new gkGroupManager();
-	new gkGameObjectManager();
+	gkGameObjectManager* objects = new gkGameObjectManager();
+
+	// scenes stream their objects in through this queue
+	objects->setQueueBudget((unsigned long)(defs.instanceBudget * 1000.f));
 
 	new gkAnimationManager();
 
@@ -302,10 +398,14 @@ void gkEngine::initialize()
 		loadResources(defs.resources);
 
 #ifdef OGREKIT_USE_RTSHADER_SYSTEM	
-	defs.hasFixedCapability = renderers[0]->getCapabilities()->hasCapability(Ogre::RSC_FIXED_FUNCTION);
+	if (!defs.headless)
+	{
+		Ogre::RenderSystem* renderer = root->getRenderSystem();
+		defs.hasFixedCapability = renderer->getCapabilities()->hasCapability(Ogre::RSC_FIXED_FUNCTION);
 
-	gkResourceGroupManager::getSingleton().initRTShaderSystem(
-		m_private->plugin_factory->getShaderLanguage(), defs.shaderCachePath, defs.hasFixedCapability);
+		gkResourceGroupManager::getSingleton().initRTShaderSystem(
+			m_private->plugin_factory->getShaderLanguage(), defs.shaderCachePath, defs.hasFixedCapability);
+	}
 #endif
 
 	// create the builtin resource group
@@ -318,22 +418,23 @@ void gkEngine::initialize()
 #endif
 
 #ifdef OGREKIT_USE_COMPOSITOR
-	gkCompositorManager::getSingleton().initialize();
+	if (!defs.headless)
+		gkCompositorManager::getSingleton().initialize();
 #endif
 
-	// debug info
-	m_private->debug = new gkDebugScreen();
-	m_private->debug->initialize();
-
-	m_private->debugPage = new gkDebugPropertyPage();
-	m_private->debugPage->initialize();
+	// debug info, overlays need somewhere to draw
+	if (!defs.headless)
+	{
+		m_private->debug = new gkDebugScreen();
+		m_private->debug->initialize();
 
-	m_private->debugFps = new gkDebugFps();
-	m_private->debugFps->initialize();
-	m_private->debugFps->show(defs.debugFps);
+		m_private->debugPage = new gkDebugPropertyPage();
+		m_private->debugPage->initialize();
 
-	// statistics and profiling
-	new gkStats();
+		m_private->debugFps = new gkDebugFps();
+		m_private->debugFps->initialize();
+		m_private->debugFps->show(defs.debugFps);
+	}
 
 	m_initialized = true;
 }
@@ -349,6 +450,11 @@ void gkEngine::initializeWindow(void)
 		gkUserDefs& defs = getUserDefs();
 
 		m_window = sys->createWindow(defs);
+
+		if (m_window && !defs.inputReplay.empty())
+			sys->startReplay(defs.inputReplay);
+		if (m_window && !defs.inputRecord.empty())
+			sys->startRecording(defs.inputRecord);
 	}
 }
 
@@ -432,9 +538,15 @@ void gkEngine::finalize()
 
 	delete gkBlendLoader::getSingletonPtr();
 	delete gkResourceGroupManager::getSingletonPtr();
+	delete gkJobSystem::getSingletonPtr();
 
 
-	delete gkStats::getSingletonPtr();
+	if (!m_defs->profileTrace.empty())
+	{
+		gkProfiler::getSingleton().endCapture();
+		gkProfiler::getSingleton().writeChromeTrace(m_defs->profileTrace);
+	}
+	delete gkProfiler::getSingletonPtr();
 	delete m_private->debugFps;
 	delete m_private->debugPage;
 	delete m_private->debug;
@@ -442,6 +554,7 @@ void gkEngine::finalize()
 	delete m_private->overlaySystem;
 #endif
 	delete m_private->root;
+	delete m_private->bufferManager;
 	delete m_private;
 
 	m_initialized = false;
@@ -611,7 +724,10 @@ void gkEngine::unregisterActiveScene(gkScene* scene)
 gkScene* gkEngine::getActiveScene(void)
 {
 	GK_ASSERT(m_private);
-	return m_private->curScene;
+
+	// the scene updating on this thread, if any
+	gkScene* scene = gkSceneContext::getCurrent();
+	return scene ? scene : m_private->curScene;
 }
 
 
@@ -663,8 +779,11 @@ bool gkEngine::initializeStepLoop(void)
 
 	// setup timer
 	m_private->root->clearEventTimes();
-	m_private->root->getRenderSystem()->_initRenderTargets();
-	m_private->root->addFrameListener(m_private);
+	if (!m_defs->headless)
+	{
+		m_private->root->getRenderSystem()->_initRenderTargets();
+		m_private->root->addFrameListener(m_private);
+	}
 	m_private->reset();
 
 	m_running = true;
@@ -680,7 +799,16 @@ bool gkEngine::stepOneFrame(void)
 	gkWindowSystem* sys = m_private->windowsystem;
 	sys->process();
 
-	if (!m_private->root->renderOneFrame())
+	if (m_defs->headless)
+	{
+		if (m_private->scenes.empty())
+			return false;
+
+		// exactly one fixed tick per step, nothing is rendered
+		m_private->step();
+		gkProfiler::getSingleton().nextFrame();
+	}
+	else if (!m_private->root->renderOneFrame())
 		return false;
 
 	return !sys->exitRequest();
@@ -689,7 +817,11 @@ bool gkEngine::stepOneFrame(void)
 
 void gkEngine::finalizeStepLoop(void)
 {
-	m_private->root->removeFrameListener(m_private);
+	if (!m_private->aheadCounter.isDone())
+		gkJobSystem::getSingleton().wait(m_private->aheadCounter);
+
+	if (!m_defs->headless)
+		m_private->root->removeFrameListener(m_private);
 	m_running = false;
 }
 
@@ -698,9 +830,18 @@ unsigned long gkEngine::getCurTime()
 	return m_private->curTime;
 }
 
+gkTickState& gkEngine::getTickState(void)
+{
+	return *m_private;
+}
+
 bool gkOgreEnginePrivate::frameStarted(const Ogre::FrameEvent& evt)
 {
-	gkStats::getSingleton().startClock();
+	GK_PROFILE_MARK(renderStart);
+
+	gkUserDefs& defs = engine->getUserDefs();
+	if ((defs.pipelined || defs.interpolate) && !scenes.empty())
+		beginRenderFrame();
 
 	return true;
 }
@@ -709,13 +850,16 @@ bool gkOgreEnginePrivate::frameStarted(const Ogre::FrameEvent& evt)
 
 bool gkOgreEnginePrivate::frameRenderingQueued(const Ogre::FrameEvent& evt)
 {
-	gkStats::getSingleton().stopRenderClock();
+	GK_PROFILE_RECORD("Render", renderStart);
+
+	if (!aheadCounter.isDone())
+		gkJobSystem::getSingleton().wait(aheadCounter);
 
 	if (!scenes.empty())
 		tick();
 
-	// restart the clock to mesure time for swapping buffer and updatind scenemanager LOD
-	gkStats::getSingleton().startClock();
+	// time swapping buffer and updating scenemanager LOD
+	GK_PROFILE_MARK(swapStart);
 
 	return !scenes.empty();
 }
@@ -725,8 +869,8 @@ bool gkOgreEnginePrivate::frameRenderingQueued(const Ogre::FrameEvent& evt)
 
 bool gkOgreEnginePrivate::frameEnded(const Ogre::FrameEvent& evt)
 {
-	gkStats::getSingleton().stopBufSwapLodClock();
-	gkStats::getSingleton().nextFrame();
+	GK_PROFILE_RECORD("BufferSwap&LOD", swapStart);
+	gkProfiler::getSingleton().nextFrame();
 
 	return true;
 }
@@ -738,6 +882,9 @@ void gkOgreEnginePrivate::beginTickImpl(void)
 {
 	GK_ASSERT(!scenes.empty());
 
+	// nothing from the last tick is in flight, see gkFrameArena
+	gkFrameArena::resetAll();
+
 	gkSceneArray::Iterator iter(scenes);
 	while (iter.hasMoreElements())
 		iter.getNext()->beginFrame();	
@@ -748,6 +895,11 @@ void gkOgreEnginePrivate::beginTickImpl(void)
 
 void gkOgreEnginePrivate::endTickImpl(void)
 {
+	// interpolation captured every tick already
+	if (ticked && engine->getUserDefs().pipelined && !isInterpolating())
+		captureSnapshots();
+	ticked = false;
+
 	if (debugPage && debugPage->isShown())
 		debugPage->draw();
 
@@ -762,18 +914,29 @@ void gkOgreEnginePrivate::tickImpl(gkScalar dt)
 {
 	// Proccess one full game tick
 	GK_ASSERT(windowsystem && !scenes.empty() && engine);
+	GK_PROFILE_SCOPE("Tick");
 
 
 	// dispatch inputs
 	windowsystem->dispatch();
 
+	ticked = true;
+
 	// update main scene
-	gkSceneArray::Iterator siter1(scenes);
-	while (siter1.hasMoreElements())
+	gkJobSystem* jobs = gkJobSystem::getSingletonPtr();
+	if (engine->getUserDefs().parallelScenes && scenes.size() > 1 && jobs && jobs->getNumWorkers() > 0)
+	{
+		updateScenesConcurrent(dt);
+	}
+	else
 	{
-		gkScene* scene = siter1.getNext();
-		curScene = scene;
-		scene->update(dt);
+		gkSceneArray::Iterator siter1(scenes);
+		while (siter1.hasMoreElements())
+		{
+			gkScene* scene = siter1.getNext();
+			gkSceneContext context(scene);
+			scene->update(dt);
+		}
 	}
 
 	// update callbacks
@@ -789,6 +952,82 @@ void gkOgreEnginePrivate::tickImpl(gkScalar dt)
 	gkGameObjectManager::getSingleton().postProcessQueue();
 	gkSceneManager::getSingleton().postProcessQueue();
 
+	if (isInterpolating())
+		captureSnapshots();
+}
+
+
+
+void gkOgreEnginePrivate::updateScenesConcurrent(gkScalar dt)
+{
+	gkJobSystem& jobs = gkJobSystem::getSingleton();
+	gkJobCounter counter;
+
+	while (sceneCalls.size() < scenes.size())
+		sceneCalls.push_back(new gkSceneUpdateCall());
+
+	gkSceneContext::setConcurrent(true);
+
+	UTsize i;
+	for (i = 0; i < scenes.size(); i++)
+	{
+		sceneCalls[i]->scene = scenes[i];
+		sceneCalls[i]->delta = dt;
+		jobs.submit(sceneCalls[i], &counter);
+	}
+
+	jobs.wait(counter);
+
+	gkSceneContext::setConcurrent(false);
+}
+
+
+
+void gkOgreEnginePrivate::beginRenderFrame(void)
+{
+	// Ogre draws this frame from the last tick's snapshot
+	gkScalar alpha = isInterpolating() ? getAlpha() : gkScalar(1.0);
+
+	UTsize i;
+	for (i = 0; i < scenes.size(); i++)
+	{
+		gkTransformSnapshot* snapshot = scenes[i]->getSnapshot();
+		if (snapshot)
+			snapshot->publish(alpha);
+	}
+
+	if (!engine->getUserDefs().pipelined)
+		return;
+
+	// Physics only moves the objects own nodes, so the first tick of
+	// the frame can step it while Ogre culls and queues the proxies.
+	gkJobSystem* jobs = gkJobSystem::getSingletonPtr();
+	if (jobs && jobs->getNumWorkers() > 0 && isTickDue())
+	{
+		aheadCall.scenes = &scenes;
+		aheadCall.delta  = gkEngine::getStepRate();
+		jobs->submit(&aheadCall, &aheadCounter);
+	}
+}
+
+
+
+void gkOgreEnginePrivate::captureSnapshots(void)
+{
+	UTsize i;
+	for (i = 0; i < scenes.size(); i++)
+	{
+		gkTransformSnapshot* snapshot = scenes[i]->getSnapshot();
+		if (snapshot)
+			snapshot->capture(scenes[i]);
+	}
+}
+
+
+
+bool gkOgreEnginePrivate::isInterpolating(void)
+{
+	return engine->getUserDefs().interpolate && getMode() == TM_ACCUMULATOR;
 }
 
 
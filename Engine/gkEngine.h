@@ -77,6 +77,9 @@ public:
 
 	unsigned long getCurTime(); //return ms, updated per frame
 
+	///Fixed tick timing, interpolation alpha and dropped tick counters.
+	gkTickState& getTickState(void);
+
 	gkScene* getActiveScene(void);
 
 	void registerActiveScene(gkScene* scene);
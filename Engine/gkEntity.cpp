@@ -55,8 +55,14 @@ gkEntity::~gkEntity()
 
 void gkEntity::createInstanceImpl(void)
 {
+	bool recycled = m_parked;
+
 	gkGameObject::createInstanceImpl();
 
+	// parked clones keep their entity
+	if (recycled)
+		return;
+
 	GK_ASSERT(!m_entity);
 
 
@@ -66,13 +72,18 @@ void gkEntity::createInstanceImpl(void)
 	if (m_skeleton)
 		m_skeleton->createInstance();
 
+	// Headless runs have no render system to compile materials against.
+	// Bounds & physics come from gkMesh, bones are driven without an Ogre skeleton.
+	if (gkEngine::getSingleton().getUserDefs().headless)
+		return;
+
 	Ogre::SceneManager* manager = m_scene->getManager();
 	m_entity = manager->createEntity(m_name.getName(), m_entityProps->m_mesh->getResourceName().getName(), 
 		m_name.getGroup().empty() ? Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME : m_name.getGroup());
 
 
 	m_entity->setCastShadows(m_entityProps->m_casts);
-	m_node->attachObject(m_entity);
+	getRenderNode()->attachObject(m_entity);
 
 	if (m_skeleton)
 		m_skeleton->updateFromController();
@@ -82,7 +93,7 @@ void gkEntity::createInstanceImpl(void)
 		_resetPose();
 
 	if (m_baseProps.isInvisible())
-		m_node->setVisible(false, false);
+		getRenderNode()->setVisible(false, false);
 }
 
 
@@ -90,7 +101,7 @@ void gkEntity::createInstanceImpl(void)
 
 void gkEntity::destroyInstanceImpl(void)
 {
-	if (m_entity)
+	if (m_entity && !m_parked)
 	{
 
 		Ogre::SceneManager* manager = m_scene->getManager();
@@ -101,7 +112,7 @@ void gkEntity::destroyInstanceImpl(void)
 		if (!m_scene->isBeingDestroyed())
 		{
 			if (m_node)
-				m_node->detachObject(m_entity);
+				getRenderNode()->detachObject(m_entity);
 
 			manager->destroyEntity(m_entity);
 		}
@@ -112,7 +123,8 @@ void gkEntity::destroyInstanceImpl(void)
 		}
 	}
 
-	m_entity = 0;
+	if (!m_parked)
+		m_entity = 0;
 
 
 	gkGameObject::destroyInstanceImpl();
@@ -141,7 +153,7 @@ void gkEntity::_destroyAsStaticGeometry(void)
 			_resetPose();
 
 		if (m_node)
-			m_node->detachObject(m_entity);
+			getRenderNode()->detachObject(m_entity);
 
 		manager->destroyEntity(m_entity);
 
@@ -191,7 +203,7 @@ gkBoundingBox gkEntity::getAabb() const
 }
 
 void gkEntity::setMaterialName(const gkString& matName) {
-	if (m_materialNameCache!=matName) {
+	if (m_entity && m_materialNameCache!=matName) {
 		m_entity->setMaterialName(matName);
 		m_materialNameCache = matName;
 	}
@@ -0,0 +1,183 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkFrameArena.h"
+#include "gkMathUtils.h"
+#include "gkLogger.h"
+#include "Thread/gkThread.h"
+#include "Thread/gkCriticalSection.h"
+
+#include <stdlib.h>
+
+
+// Owns every thread's arena, they outlive the threads that made them.
+class gkFrameArenaRegistry
+{
+public:
+	~gkFrameArenaRegistry()
+	{
+		for (UTsize i = 0; i < m_arenas.size(); i++)
+			delete m_arenas[i];
+	}
+
+	gkFrameArena* create(void)
+	{
+		gkCriticalSection::Lock guard(m_lock);
+		gkFrameArena* arena = new gkFrameArena();
+		m_arenas.push_back(arena);
+		return arena;
+	}
+
+	utArray<gkFrameArena*>  m_arenas;
+	gkCriticalSection       m_lock;
+};
+
+static gkFrameArenaRegistry gkFrameArenas;
+static GK_THREAD_LOCAL gkFrameArena* gkFrameThreadArena = 0;
+
+
+
+gkFrameArena::gkFrameArena()
+	:   m_current(0), m_cursor(0), m_end(0),
+	    m_used(0), m_peak(0), m_capacity(0)
+{
+}
+
+
+gkFrameArena::~gkFrameArena()
+{
+	for (UTsize i = 0; i < m_chunks.size(); i++)
+		free(m_chunks[i].data);
+}
+
+
+void* gkFrameArena::allocate(UTsize size)
+{
+	size = (size + ALIGN - 1) & ~(UTsize)(ALIGN - 1);
+
+	if (m_cursor == 0 || (UTsize)(m_end - m_cursor) < size)
+	{
+		if (!nextChunk(size))
+		{
+			// callers construct into what they get, there is no null to hand back
+			gkPrintf("gkFrameArena: out of memory allocating %u bytes, aborting.\n", (unsigned int)size);
+			abort();
+		}
+	}
+
+	void* p = m_cursor;
+	m_cursor += size;
+	m_used += size;
+	if (m_used > m_peak)
+		m_peak = m_used;
+	return p;
+}
+
+
+bool gkFrameArena::nextChunk(UTsize size)
+{
+	// skip to a later chunk that fits, they were all free this frame
+	UTsize next = m_cursor ? m_current + 1 : 0;
+	while (next < m_chunks.size() && m_chunks[next].size < size)
+		next++;
+
+	if (next >= m_chunks.size())
+	{
+		Chunk chunk;
+		chunk.size = gkMax<UTsize>(CHUNK_SIZE, size);
+		chunk.data = (char*)malloc(chunk.size);
+		if (!chunk.data)
+			return false;
+
+		m_chunks.push_back(chunk);
+		m_capacity += chunk.size;
+		next = m_chunks.size() - 1;
+	}
+
+	m_current = next;
+	m_cursor  = m_chunks[next].data;
+	m_end     = m_cursor + m_chunks[next].size;
+	return true;
+}
+
+
+void gkFrameArena::reset(void)
+{
+	if (m_chunks.size() > 1)
+	{
+		// one chunk the size of everything used so far
+		UTsize size = gkMax<UTsize>(m_capacity, m_peak);
+		for (UTsize i = 0; i < m_chunks.size(); i++)
+			free(m_chunks[i].data);
+
+		m_chunks.resize(1);
+		m_chunks[0].size = size;
+		m_chunks[0].data = (char*)malloc(size);
+		m_capacity = size;
+		if (!m_chunks[0].data)
+		{
+			m_chunks.clear();
+			m_capacity = 0;
+		}
+	}
+
+	m_current = 0;
+	m_cursor = m_end = 0;
+	m_used = 0;
+
+	if (!m_chunks.empty())
+	{
+		m_cursor = m_chunks[0].data;
+		m_end    = m_cursor + m_chunks[0].size;
+	}
+}
+
+
+gkFrameArena& gkFrameArena::get(void)
+{
+	if (!gkFrameThreadArena)
+		gkFrameThreadArena = gkFrameArenas.create();
+	return *gkFrameThreadArena;
+}
+
+
+void gkFrameArena::resetAll(void)
+{
+	gkCriticalSection::Lock guard(gkFrameArenas.m_lock);
+	for (UTsize i = 0; i < gkFrameArenas.m_arenas.size(); i++)
+		gkFrameArenas.m_arenas[i]->reset();
+}
+
+
+UTsize gkFrameArena::getTotalPeakBytes(void)
+{
+	gkCriticalSection::Lock guard(gkFrameArenas.m_lock);
+
+	UTsize total = 0;
+	for (UTsize i = 0; i < gkFrameArenas.m_arenas.size(); i++)
+		total += gkFrameArenas.m_arenas[i]->getPeakBytes();
+	return total;
+}
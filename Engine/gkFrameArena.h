@@ -0,0 +1,107 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkFrameArena_h_
+#define _gkFrameArena_h_
+
+#include "gkCommon.h"
+#include <new>
+
+
+// Linear scratch memory for tick scoped temporaries.
+//
+// Every thread gets its own arena on first use. Allocation bumps a cursor,
+// nothing is freed individually, and all arenas are reset together at the
+// start of each engine tick (gkOgreEnginePrivate::beginTickImpl), when no
+// jobs are in flight. Memory taken from it must not be kept past the tick.
+class gkFrameArena
+{
+public:
+	enum { CHUNK_SIZE = 64 * 1024, ALIGN = 16 };
+
+public:
+	gkFrameArena();
+	~gkFrameArena();
+
+	// Never returns 0, running out of memory aborts with a message.
+	void* allocate(UTsize size);
+
+	// Rewinds to the start. If the last frame overflowed the first chunk,
+	// the chunks are merged into one big enough for it.
+	void reset(void);
+
+	GK_INLINE UTsize getUsedBytes(void) const       { return m_used; }
+	GK_INLINE UTsize getPeakBytes(void) const       { return m_peak; }
+	GK_INLINE UTsize getCapacity(void) const        { return m_capacity; }
+
+
+	// Arena of the calling thread.
+	static gkFrameArena& get(void);
+
+	static void   resetAll(void);
+	static UTsize getTotalPeakBytes(void);
+
+private:
+
+	struct Chunk
+	{
+		char*   data;
+		UTsize  size;
+	};
+
+	bool nextChunk(UTsize size);
+
+	utArray<Chunk>  m_chunks;
+	UTsize          m_current;
+	char*           m_cursor;
+	char*           m_end;
+	UTsize          m_used, m_peak, m_capacity;
+};
+
+
+// utArray storage in the calling thread's frame arena. Only for arrays
+// that live within one tick; deallocate runs destructors but frees nothing.
+template <typename T>
+class gkFrameAllocator
+{
+public:
+	static T* allocate(UTsize nr)
+	{
+		T* p = static_cast<T*>(gkFrameArena::get().allocate(nr * sizeof(T)));
+		for (UTsize i = 0; i < nr; i++)
+			new(p + i) T();
+		return p;
+	}
+
+	static void deallocate(T* p, UTsize nr)
+	{
+		for (UTsize i = 0; i < nr; i++)
+			p[i].~T();
+	}
+};
+
+
+#endif//_gkFrameArena_h_
@@ -51,6 +51,7 @@
 #include "gkDynamicsWorld.h"
 #include "gkMesh.h"
 #include "gkVariable.h"
+#include "gkTransformStore.h"
 
 #include "gkAnimationManager.h"
 
@@ -62,12 +63,16 @@
 gkGameObject::gkGameObject(gkInstancedManager* creator, const gkResourceName& name, const gkResourceHandle& handle, gkGameObjectTypes type)
 	:    gkInstancedObject(creator, name, handle),
 	     m_type(type), m_baseProps(), m_parent(0), m_scene(0),
-	     m_node(0), m_logic(0), m_bricks(0),
+	     m_node(0), m_renderNode(0),
+	     m_transforms(0), m_transformSlot(UT_NPOS), m_detachedStamp(0),
+	     m_logic(0), m_bricks(0),
 	     m_rigidBody(0), m_character(0),m_ghost(0),
 	     m_groupID(0), m_group(0),
 	     m_state(0), m_activeLayer(true),
 	     m_layer(0xFFFFFFFF),
 	     m_isClone(false),
+	     m_parked(false),
+	     m_cloneSource(0),
 	     m_flags(0),
 	     m_actionBlender(0),
 	     m_cloneToScene(0),
@@ -141,6 +146,7 @@ void gkGameObject::cloneImpl(gkGameObject* clob)
 	clob->m_activeLayer = m_activeLayer;
 	clob->m_baseProps = m_baseProps;
 	clob->m_isClone = true;
+	clob->m_cloneSource = this;
 	clob->m_scene = m_scene;
 
 	// clone variables
@@ -177,10 +183,104 @@ void gkGameObject::cloneImpl(gkGameObject* clob)
 }
 
 
+void gkGameObject::park(void)
+{
+	GK_ASSERT(m_isClone && (isInstanced() || m_parked));
+
+	m_parked = true;
+	destroyInstance();
+}
+
+
+
+void gkGameObject::_recycleClone(void)
+{
+	GK_ASSERT(m_parked && m_cloneSource);
+
+	// start over from the source, as a fresh clone would
+	m_activeLayer = m_cloneSource->m_activeLayer;
+	m_baseProps = m_cloneSource->m_baseProps;
+	m_life.tick = 0;
+	m_state = 0;
+
+	if (m_bricks && m_cloneSource->m_bricks)
+	{
+		m_bricks->setState(m_cloneSource->m_bricks->getState());
+		m_bricks->notifyState();
+	}
+
+	gkEngine& eng = gkEngine::getSingleton();
+	VariableMap& source = m_cloneSource->m_variables;
+
+	// drop what was created since the last spawn
+	VariableList extra;
+	utHashTableIterator<VariableMap> cur(m_variables);
+	while (cur.hasMoreElements())
+	{
+		VariableMap::Entry& ent = cur.getNext();
+		if (source.find(ent.first) == UT_NPOS)
+			extra.push_back(ent.first);
+	}
+
+	for (UTsize i = 0; i < extra.size(); ++i)
+	{
+		gkVariable* v = m_variables.at(m_variables.find(extra[i]));
+		if (v->isDebug())
+			eng.removeDebugProperty(v);
+
+		m_variables.remove(extra[i]);
+		delete v;
+	}
+
+	// the source's set, with its values, lock and defaults
+	utHashTableIterator<VariableMap> iter(source);
+	while (iter.hasMoreElements())
+	{
+		VariableMap::Entry& ent = iter.getNext();
+
+		UTsize pos = m_variables.find(ent.first);
+		if (pos != UT_NPOS)
+		{
+			gkVariable* v = m_variables.at(pos);
+			if (v->isDebug())
+				eng.removeDebugProperty(v);
+
+			*v = *ent.second;
+			v->setDebug(false);
+		}
+		else
+		{
+			gkVariable* nvar = ent.second->clone();
+			nvar->setDebug(false);
+			m_variables.insert(ent.first, nvar);
+		}
+	}
+}
+
+
 
 
 void gkGameObject::createInstanceImpl(void)
 {
+	if (m_parked)
+	{
+		// recycled clone, only the transform is new
+		applyTransformState(m_baseProps.m_transform);
+
+		if (m_transforms)
+			m_transforms->syncNode(m_transformSlot);
+
+		if (m_renderNode)
+		{
+			m_renderNode->setPosition(m_node->_getDerivedPosition());
+			m_renderNode->setOrientation(m_node->_getDerivedOrientation());
+			m_renderNode->setScale(m_node->_getDerivedScale());
+		}
+
+		getRenderNode()->setVisible(!m_baseProps.isInvisible(), false);
+		return;
+	}
+
 	Ogre::SceneManager* manager = m_scene->getManager();
 	Ogre::SceneNode* parentNode = 0;
 
@@ -201,7 +301,20 @@ void gkGameObject::createInstanceImpl(void)
 	}
 	
 	m_node = parentNode ? parentNode->createChildSceneNode(m_name.getName())
-						: manager->getRootSceneNode()->createChildSceneNode(m_name.getName());
+						: m_scene->getObjectRoot()->createChildSceneNode(m_name.getName());
+
+	if (m_scene->hasRenderProxies())
+		m_renderNode = manager->getRootSceneNode()->createChildSceneNode();
+
+	m_transforms = m_scene->getTransformStore();
+	if (m_transforms)
+	{
+		UTsize parentSlot = parentNode ? m_parent->m_transformSlot : UT_NPOS;
+
+		m_transformSlot = m_transforms->create(m_node, m_baseProps.m_transform, parentSlot);
+		if (m_transformSlot == UT_NPOS)
+			m_transforms = 0;
+	}
 
 
 	applyTransformState(m_baseProps.m_transform);
@@ -225,11 +338,26 @@ void gkGameObject::createInstanceImpl(void)
 				}
 				else
 					m_node->addChild(pChild->m_node);
+
+				if (m_transforms && pChild->m_transforms)
+					m_transforms->setParent(pChild->m_transformSlot, m_transformSlot);
 			}
 		}
 	}
 
+	// the node has to be in place for its initial state
+	if (m_transforms)
+		m_transforms->syncNode(m_transformSlot);
+
 	m_node->setInitialState();
+
+	if (m_renderNode)
+	{
+		// start in place, snapshots take over from the next tick
+		m_renderNode->setPosition(m_node->_getDerivedPosition());
+		m_renderNode->setOrientation(m_node->_getDerivedOrientation());
+		m_renderNode->setScale(m_node->_getDerivedScale());
+	}
 }
 
 
@@ -239,6 +367,7 @@ void gkGameObject::postCreateInstanceImpl(void)
 {
 	// tell scene
 	m_scene->notifyInstanceCreated(this);
+	m_parked = false;
 
 	sendNotification(Notifier::INSTANCE_CREATED);
 }
@@ -272,7 +401,12 @@ void gkGameObject::destroyInstanceImpl(void)
 	Ogre::SceneManager* manager = m_scene->getManager();
 
 
-	if (!m_scene->isBeingDestroyed())
+	if (m_parked)
+	{
+		// keep the node and store slot for the next spawn
+		getRenderNode()->setVisible(false, false);
+	}
+	else if (!m_scene->isBeingDestroyed())
 	{
 		if (m_node)
 		{
@@ -291,9 +425,24 @@ void gkGameObject::destroyInstanceImpl(void)
 
 			manager->destroySceneNode(m_node);
 		}
+
+		if (m_renderNode)
+			manager->destroySceneNode(m_renderNode);
 	}
 
-	m_node = 0;
+	if (!m_parked)
+	{
+		m_node = 0;
+		m_renderNode = 0;
+	}
+
+	if (m_transforms && !m_parked)
+	{
+		// children move up to our parent, as their nodes did
+		m_transforms->destroy(m_transformSlot);
+		m_transforms = 0;
+		m_transformSlot = UT_NPOS;
+	}
 
 	m_scene->removeAnimationUpdate(this);
 
@@ -309,7 +458,7 @@ void gkGameObject::destroyInstanceImpl(void)
 
 
 
-bool gkGameObject::hasSensorMaterial(const gkString& name, bool onlyFirst)
+bool gkGameObject::hasSensorMaterial(const gkHashedString& name, bool onlyFirst)
 {
 	gkEntity* ent = getEntity();
 	if (ent)
@@ -318,14 +467,14 @@ bool gkGameObject::hasSensorMaterial(const gkString& name, bool onlyFirst)
 		if (me)
 		{
 			if (onlyFirst)
-				return me->getFirstMaterial().m_name == name;
+				return me->getFirstMaterial().isNamed(name);
 			else
 			{
 				gkMesh::SubMeshIterator iter = me->getSubMeshIterator();
 				while (iter.hasMoreElements())
 				{
 					gkSubMesh* sme = iter.getNext();
-					if (sme->getMaterialName() == name)
+					if (sme->getMaterial().isNamed(name))
 						return true;
 				}
 			}
@@ -381,6 +530,8 @@ const gkMatrix4& gkGameObject::getTransform(void)
 
 const gkVector3& gkGameObject::getPosition(void)
 {
+	if (m_transforms)
+		return m_transforms->getPosition(m_transformSlot);
 	if (m_node != 0)
 		return m_node->getPosition();
 	return m_baseProps.m_transform.loc;
@@ -389,6 +540,8 @@ const gkVector3& gkGameObject::getPosition(void)
 
 const gkVector3& gkGameObject::getScale(void)
 {
+	if (m_transforms)
+		return m_transforms->getScale(m_transformSlot);
 	if (m_node != 0)
 		return m_node->getScale();
 	return m_baseProps.m_transform.scl;
@@ -398,6 +551,8 @@ const gkVector3& gkGameObject::getScale(void)
 
 const gkQuaternion& gkGameObject::getOrientation(void)
 {
+	if (m_transforms)
+		return m_transforms->getOrientation(m_transformSlot);
 	if (m_node != 0)
 		return m_node->getOrientation();
 	return m_baseProps.m_transform.rot;
@@ -414,6 +569,11 @@ gkEuler gkGameObject::getRotation(void)
 const gkTransformState& gkGameObject::getWorldTransformState(void)
 {
 	static gkTransformState m_state;
+	if (m_transforms)
+	{
+		m_transforms->getWorld(m_transformSlot, m_state);
+		return m_state;
+	}
 	m_state.loc = getWorldPosition();
 	m_state.rot = getWorldOrientation();
 	m_state.scl = getWorldScale();
@@ -421,8 +581,10 @@ const gkTransformState& gkGameObject::getWorldTransformState(void)
 }
 
 
-const gkMatrix4& gkGameObject::getWorldTransform(void)
+gkMatrix4 gkGameObject::getWorldTransform(void)
 {
+	if (m_transforms)
+		return getWorldTransformState().toMatrix();
 	if (m_node != 0)
 		return m_node->_getFullTransform();
 	return gkMatrix4::IDENTITY;
@@ -432,6 +594,8 @@ const gkMatrix4& gkGameObject::getWorldTransform(void)
 
 const gkVector3& gkGameObject::getWorldPosition(void)
 {
+	if (m_transforms)
+		return m_transforms->getWorldPosition(m_transformSlot);
 	if (m_node != 0)
 		return m_node->_getDerivedPosition();
 	return m_baseProps.m_transform.loc;
@@ -440,6 +604,8 @@ const gkVector3& gkGameObject::getWorldPosition(void)
 
 const gkVector3& gkGameObject::getWorldScale(void)
 {
+	if (m_transforms)
+		return m_transforms->getWorldScale(m_transformSlot);
 	if (m_node != 0)
 		return m_node->_getDerivedScale();
 	return m_baseProps.m_transform.scl;
@@ -449,6 +615,8 @@ const gkVector3& gkGameObject::getWorldScale(void)
 
 const gkQuaternion& gkGameObject::getWorldOrientation(void)
 {
+	if (m_transforms)
+		return m_transforms->getWorldOrientation(m_transformSlot);
 	if (m_node != 0)
 		return m_node->_getDerivedOrientation();
 	return m_baseProps.m_transform.rot;
@@ -501,10 +669,14 @@ void gkGameObject::applyTransformState(const gkTransformState& newstate, const g
 	
 		}
 		
-		m_node->setPosition(state.loc);
-		m_node->setOrientation(state.rot);
-		m_node->setScale(state.scl);
-	//	m_node->needUpdate(true);
+		if (m_transforms)
+			m_transforms->setLocal(m_transformSlot, state);
+		else
+		{
+			m_node->setPosition(state.loc);
+			m_node->setOrientation(state.rot);
+			m_node->setScale(state.scl);
+		}
 
 		if (m_rigidBody)
 		{
@@ -558,7 +730,7 @@ void gkGameObject::setPosition(const gkVector3& v)
 
 	if (m_node != 0)
 	{
-		m_node->setPosition(v);
+		writePosition(v);
 		notifyUpdate();
 
 		// update the rigid body state
@@ -585,7 +757,7 @@ void gkGameObject::setScale(const gkVector3& v)
 
 	if (m_node != 0)
 	{
-		m_node->setScale(v);
+		writeScale(v);
 		notifyUpdate();
 	}
 }
@@ -600,7 +772,7 @@ void gkGameObject::setOrientation(const gkQuaternion& q)
 
 	if (m_node != 0)
 	{
-		m_node->setOrientation(q);
+		writeOrientation(q);
 		notifyUpdate();
 
 		// update the rigid body state
@@ -627,7 +799,7 @@ void gkGameObject::setOrientation(const gkEuler& v)
 	if (m_node != 0)
 	{
 		gkQuaternion q = v.toQuaternion();
-		m_node->setOrientation(q);
+		writeOrientation(q);
 		notifyUpdate();
 
 		// update the rigid body state
@@ -666,7 +838,7 @@ void gkGameObject::rotate(const gkQuaternion& dq, int tspace)
 
 	if (m_node != 0)
 	{
-		m_node->rotate(dq, (Ogre::Node::TransformSpace)tspace);
+		rotateLocal(dq, tspace);
 		notifyUpdate();
 
 		// update the rigid body state
@@ -694,7 +866,7 @@ void gkGameObject::yaw(const gkRadian& v, int tspace)
 
 	if (m_node != 0)
 	{
-		m_node->yaw(v, (Ogre::Node::TransformSpace)tspace);
+		rotateLocal(gkQuaternion(v, gkVector3::UNIT_Y), tspace);
 		notifyUpdate();
 
 		// update the rigid body state
@@ -722,7 +894,7 @@ void gkGameObject::pitch(const gkRadian& v, int tspace )
 
 	if (m_node != 0)
 	{
-		m_node->pitch(v, (Ogre::Node::TransformSpace)tspace);
+		rotateLocal(gkQuaternion(v, gkVector3::UNIT_X), tspace);
 		notifyUpdate();
 
 		// update the rigid body state
@@ -750,7 +922,7 @@ void gkGameObject::roll(const gkRadian& v, int tspace)
 
 	if (m_node != 0)
 	{
-		m_node->roll(v, (Ogre::Node::TransformSpace)tspace);
+		rotateLocal(gkQuaternion(v, gkVector3::UNIT_Z), tspace);
 		notifyUpdate();
 
 		// update the rigid body state
@@ -778,7 +950,7 @@ void gkGameObject::translate(const gkVector3& dloc, int tspace)
 
 	if (m_node != 0)
 	{
-		m_node->translate(dloc, (Ogre::Node::TransformSpace)tspace);
+		translateLocal(dloc, tspace);
 		notifyUpdate();
 
 		// update the rigid body state
@@ -806,13 +978,120 @@ void gkGameObject::scale(const gkVector3& dscale)
 
 	if (m_node != 0)
 	{
-		m_node->scale(dscale);
+		writeScale(getScale() * dscale);
 		notifyUpdate();
 	}
 }
 
 
 
+void gkGameObject::writePosition(const gkVector3& v)
+{
+	if (m_transforms)
+		m_transforms->setPosition(m_transformSlot, v);
+	else
+		m_node->setPosition(v);
+}
+
+
+
+void gkGameObject::writeOrientation(const gkQuaternion& q)
+{
+	if (m_transforms)
+		m_transforms->setOrientation(m_transformSlot, q);
+	else
+		m_node->setOrientation(q);
+}
+
+
+
+void gkGameObject::writeScale(const gkVector3& v)
+{
+	if (m_transforms)
+		m_transforms->setScale(m_transformSlot, v);
+	else
+		m_node->setScale(v);
+}
+
+
+
+void gkGameObject::rotateLocal(const gkQuaternion& dq, int tspace)
+{
+	if (!m_transforms)
+	{
+		m_node->rotate(dq, (Ogre::Node::TransformSpace)tspace);
+		return;
+	}
+
+	// as Ogre::Node::rotate
+	gkQuaternion q = dq;
+	q.normalise();
+
+	const gkQuaternion& rot = getOrientation();
+
+	switch (tspace)
+	{
+	case TRANSFORM_PARENT:
+		writeOrientation(q * rot);
+		break;
+	case TRANSFORM_WORLD:
+		{
+			const gkQuaternion& wrot = getWorldOrientation();
+			writeOrientation(rot * wrot.Inverse() * q * wrot);
+		}
+		break;
+	default:
+		writeOrientation(rot * q);
+		break;
+	}
+}
+
+
+
+void gkGameObject::translateLocal(const gkVector3& dloc, int tspace)
+{
+	if (!m_transforms)
+	{
+		m_node->translate(dloc, (Ogre::Node::TransformSpace)tspace);
+		return;
+	}
+
+	// as Ogre::Node::translate
+	switch (tspace)
+	{
+	case TRANSFORM_LOCAL:
+		writePosition(getPosition() + getOrientation() * dloc);
+		break;
+	case TRANSFORM_WORLD:
+		{
+			UTsize parent = m_transforms->getParent(m_transformSlot);
+			if (parent != UT_NPOS)
+			{
+				gkVector3 d = m_transforms->getWorldOrientation(parent).Inverse() * dloc;
+				writePosition(getPosition() + d / m_transforms->getWorldScale(parent));
+			}
+			else
+				writePosition(getPosition() + dloc);
+		}
+		break;
+	default:
+		writePosition(getPosition() + dloc);
+		break;
+	}
+}
+
+
+
+void gkGameObject::_setPhysicsTransform(const gkVector3& loc, const gkQuaternion& rot)
+{
+	writeOrientation(rot);
+	writePosition(loc);
+
+	notifyUpdate();
+}
+
+
+
 void gkGameObject::setLinearVelocity(const gkVector3& v, int tspace)
 {
 	if (isImmovable())
@@ -824,7 +1103,7 @@ void gkGameObject::setLinearVelocity(const gkVector3& v, int tspace)
 	}
 	else if (m_character)
 	{
-		m_character->setVelocity(m_node->getOrientation() * v, gkEngine::getStepRate());
+		m_character->setVelocity(getOrientation() * v, gkEngine::getStepRate());
 
 	}
 //	else if (m_ghost)
@@ -946,7 +1225,7 @@ gkVariable* gkGameObject::createVariable(const gkString& name, bool debug)
 
 
 
-gkVariable* gkGameObject::getVariable(const gkString& name)
+gkVariable* gkGameObject::getVariable(const gkHashedString& name)
 {
 
 	UTsize pos = m_variables.find(name);
@@ -958,11 +1237,41 @@ gkVariable* gkGameObject::getVariable(const gkString& name)
 
 
 
-bool gkGameObject::hasVariable(const gkString& name)
+bool gkGameObject::hasVariable(const gkHashedString& name)
 {
 	return m_variables.find(name) != UT_NPOS;
 }
 
+
+
+gkVariable* gkGameObject::getVariable(const gkString& name)
+{
+	return getVariable(name.c_str());
+}
+
+
+
+gkVariable* gkGameObject::getVariable(const char* name)
+{
+	// a name nobody interned cannot be a variable
+	const gkSymbolTable::Entry* entry = gkSymbolTable::find(name);
+	return entry ? getVariable(gkHashedString(*entry)) : 0;
+}
+
+
+
+bool gkGameObject::hasVariable(const gkString& name)
+{
+	return getVariable(name.c_str()) != 0;
+}
+
+
+
+bool gkGameObject::hasVariable(const char* name)
+{
+	return getVariable(name) != 0;
+}
+
 const gkGameObject::VariableMap &gkGameObject::getVariables() const
 {
 	return m_variables;
@@ -987,14 +1296,18 @@ void gkGameObject::removeVariable(const gkString& name)
 {
        gkVariable* v;
        gkEngine& eng = gkEngine::getSingleton();
-       UTsize pos = m_variables.find(name);
+       const gkSymbolTable::Entry* entry = gkSymbolTable::find(name.c_str());
+       if (!entry)
+            return;
+       gkHashedString key(*entry);
+       UTsize pos = m_variables.find(key);
        if (pos != UT_NPOS) 
        {
             v = m_variables.at(pos);
             // remove from debug list
             if (v->isDebug())
                     eng.removeDebugProperty(v);
-            m_variables.remove(name);
+            m_variables.remove(key);
        }
 }
 
@@ -1078,6 +1391,9 @@ void gkGameObject::addChild(gkGameObject* gobj)
 			node->getParentSceneNode()->removeChild(node);
 
 		m_node->addChild(gobj->getNode());
+
+		if (m_transforms && gobj->m_transforms)
+			m_transforms->setParent(gobj->m_transformSlot, m_transformSlot);
 	}
 }
 
@@ -1109,7 +1425,10 @@ void gkGameObject::removeChild(gkGameObject* gobj)
 		if (pNode)
 			pNode->addChild(node);
 		else
-			m_scene->getManager()->getRootSceneNode()->addChild(node);
+			m_scene->getObjectRoot()->addChild(node);
+
+		if (m_transforms && gobj->m_transforms)
+			m_transforms->setParent(gobj->m_transformSlot, m_transforms->getParent(m_transformSlot));
 
 		// Re-enable physics
 
@@ -1162,7 +1481,28 @@ btCollisionObject* gkGameObject::getCollisionObject()
 
 Ogre::AxisAlignedBox gkGameObject::getAabb() const
 {
-	return m_node->_getWorldAABB();
+	return (m_renderNode ? m_renderNode : m_node)->_getWorldAABB();
+}
+
+
+
+void gkGameObject::setVisibleRecursive(bool v)
+{
+	if (!m_renderNode)
+	{
+		m_node->setVisible(v, true);
+		return;
+	}
+
+	// proxies are flat, walk the object hierarchy instead
+	m_renderNode->setVisible(v, false);
+
+	UTsize i;
+	for (i = 0; i < m_children.size(); i++)
+	{
+		if (m_children[i]->isInstanced())
+			m_children[i]->setVisibleRecursive(v);
+	}
 }
 
 
@@ -38,6 +38,7 @@
 #include <OgreMovableObject.h>
 
 class gkCurve;
+class gkTransformStore;
 
 class gkGameObject : public gkInstancedObject
 {
@@ -86,12 +87,23 @@ public:
 	GK_INLINE gkScene*                  getOwner(void)           {return m_scene;}
 
 	GK_INLINE Ogre::SceneNode*          getNode(void)        {return m_node;}
+
+	// Node the attached movables hang off. Differs from getNode() only
+	// with pipelined rendering, see gkTransformSnapshot.
+	GK_INLINE Ogre::SceneNode*          getRenderNode(void)  {return m_renderNode ? m_renderNode : m_node;}
 	GK_INLINE gkGameObjectTypes         getType(void)        {return m_type;}
 	GK_INLINE gkGameObjectProperties&   getProperties(void)  {return m_baseProps;}
 	GK_INLINE bool                      isClone(void)        {return m_isClone;}
 
+	// Clone recycling, see gkScene::cloneObject.
+	// A parked clone is uninstanced but keeps its node, movables and physics.
+	GK_INLINE gkGameObject*             getCloneSource(void) {return m_cloneSource;}
+	GK_INLINE bool                      isParked(void)       {return m_parked;}
+	void                                park(void);
+	void                                _recycleClone(void);
+
 
-	bool hasSensorMaterial(const gkString& name, bool onlyFirst = true);
+	bool hasSensorMaterial(const gkHashedString& name, bool onlyFirst = true);
 
 	// subtype access
 	GK_INLINE gkEntity*         getEntity(void)         {return m_type == GK_ENTITY    ? (gkEntity*)this : 0; }
@@ -151,8 +163,15 @@ public:
 	// variables
 
 	gkVariable* createVariable(const gkString& name, bool debug);
+	gkVariable* getVariable(const gkHashedString& name);
+	bool        hasVariable(const gkHashedString& name);
+
+	// Look the name up without interning it, for names that may never be
+	// variables (scripts, per pulse strings).
 	gkVariable* getVariable(const gkString& name);
+	gkVariable* getVariable(const char* name);
 	bool        hasVariable(const gkString& name);
+	bool        hasVariable(const char* name);
 	const VariableMap& getVariables() const;
 	VariableList getVariableList() const;
 	void        removeVariable(const gkString& name);
@@ -168,7 +187,7 @@ public:
 	gkEuler                  getRotation(void);
 
 	const gkTransformState&  getWorldTransformState(void);
-	const gkMatrix4&         getWorldTransform(void);
+	gkMatrix4                getWorldTransform(void);
 	const gkVector3&         getWorldPosition(void);
 	const gkVector3&         getWorldScale(void);
 	const gkQuaternion&      getWorldOrientation(void);
@@ -258,9 +277,9 @@ public:
 	GK_INLINE bool   isStaticGeometry(void)   {return (m_flags & GK_STATIC_GEOM) != 0;}
 	GK_INLINE bool   isImmovable(void)        {return (m_flags & GK_IMMOVABLE) != 0;}
 	
-	GK_INLINE void setVisible(bool v)          {getNode()->setVisible(v, false);}
-	GK_INLINE void setVisibleRecursive(bool v) {getNode()->setVisible(v, true);}
-	GK_INLINE bool getVisible()                {return getNode()->getAttachedObject(0)->getVisible();}
+	GK_INLINE void setVisible(bool v)          {getRenderNode()->setVisible(v, false);}
+	void           setVisibleRecursive(bool v);
+	GK_INLINE bool getVisible()                {return getRenderNode()->getAttachedObject(0)->getVisible();}
 
 
 	// Grouping
@@ -301,6 +320,16 @@ public:
 
 	void _setBoneTransform(gkTransformState* transform);
 	gkTransformState* _getBoneTransform() { return m_boneTransform; }
+
+	// Simulated transform handed back by physics, nothing is fed back.
+	void _setPhysicsTransform(const gkVector3& loc, const gkQuaternion& rot);
+
+	// Slot in the scene's gkTransformStore, UT_NPOS when not stored.
+	GK_INLINE UTsize getTransformSlot(void) {return m_transformSlot;}
+
+	// Stamp of the last frame the owning scene detached this animation.
+	GK_INLINE void     _setDetachedStamp(UTuint32 v) {m_detachedStamp = v;}
+	GK_INLINE UTuint32 _getDetachedStamp(void)       {return m_detachedStamp;}
 protected:
 
 
@@ -328,6 +357,14 @@ protected:
 	// Ogre scenegraph node
 	Ogre::SceneNode*            m_node;
 
+	// Rendered proxy of m_node, pipelined rendering only
+	Ogre::SceneNode*            m_renderNode;
+
+	// Owning store of the transform while instanced, null if it was full
+	gkTransformStore*           m_transforms;
+	UTsize                      m_transformSlot;
+	UTuint32                    m_detachedStamp;
+
 	// Attached nodelogic trees
 	gkLogicTree*                m_logic;
 
@@ -352,6 +389,8 @@ protected:
 	bool                        m_activeLayer;
 	int                         m_layer;
 	bool                        m_isClone;
+	bool                        m_parked;
+	gkGameObject*               m_cloneSource;
 	int                         m_flags;
 	LifeSpan                    m_life;
 
@@ -373,6 +412,13 @@ protected:
 
 	void sendNotification(const Notifier::Event& e);
 
+	// Local transform writes, Ogre::Node semantics either way.
+	void writePosition(const gkVector3& v);
+	void writeOrientation(const gkQuaternion& q);
+	void writeScale(const gkVector3& v);
+	void rotateLocal(const gkQuaternion& dq, int tspace);
+	void translateLocal(const gkVector3& dloc, int tspace);
+
 private:
 
 	NavMeshData m_navMeshData;
@@ -28,7 +28,43 @@
 #define _gkHashedString_h_
 
 #include "gkString.h"
-typedef utHashedString gkHashedString;
+#include "gkSymbolTable.h"
+
+
+// Name interned in gkSymbolTable.
+//
+// A handle to the table entry: copies are one pointer, compares are pointer
+// compares, and str() refers to the single shared copy of the text. hash()
+// matches utHashedString, so it keys the same in utHashTable.
+class gkHashedString
+{
+public:
+	typedef gkSymbolTable::Entry Entry;
+
+public:
+	gkHashedString() : m_entry(&gkSymbolTable::empty()) {}
+	gkHashedString(const char* k) : m_entry(&gkSymbolTable::intern(k)) {}
+	gkHashedString(const gkString& k) : m_entry(&gkSymbolTable::intern(k)) {}
+	gkHashedString(const utHashedString& k) : m_entry(&gkSymbolTable::intern(k.str())) {}
+	gkHashedString(const Entry& e) : m_entry(&e) {}
+	gkHashedString(const gkHashedString& k) : m_entry(k.m_entry) {}
+
+	UT_INLINE gkHashedString& operator= (const gkHashedString& k)   { m_entry = k.m_entry; return *this; }
+
+	UT_INLINE const gkString&   str(void) const     { return m_entry->str; }
+	UT_INLINE const char*       c_str(void) const   { return m_entry->str.c_str(); }
+	UT_INLINE bool              empty(void) const   { return m_entry->id == 0; }
+	UT_INLINE gkSymbol          id(void) const      { return m_entry->id; }
+	UT_INLINE UThash            hash(void) const    { return m_entry->hash; }
+
+	UT_INLINE bool operator== (const gkHashedString& v) const   { return m_entry == v.m_entry; }
+	UT_INLINE bool operator!= (const gkHashedString& v) const   { return m_entry != v.m_entry; }
+	UT_INLINE bool operator== (const UThash& v) const           { return m_entry->hash == v; }
+	UT_INLINE bool operator!= (const UThash& v) const           { return m_entry->hash != v; }
+
+private:
+	const Entry* m_entry;
+};
 
 
 #endif//_gkHashedString_h_
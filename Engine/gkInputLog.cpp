@@ -0,0 +1,500 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkInputLog.h"
+#include "utStreams.h"
+
+#include <string.h>
+
+
+#define GK_INPUT_LOG_END 0xFF
+
+static UTsize gkInputLogLimit(UTsize n)
+{
+	return n < 0xFF ? n : 0xFE;
+}
+
+
+gkInputLog::gkInputLog(utStream* stream, bool owner)
+	:   m_stream(stream), m_owner(owner), m_frames(0)
+{
+}
+
+
+gkInputLog::~gkInputLog()
+{
+	for (UTsize i = 0; i < m_joysticks.size(); i++)
+		delete m_joysticks[i];
+
+	if (m_owner)
+		delete m_stream;
+}
+
+
+void gkInputLog::resetState(const Joysticks& layout)
+{
+	for (UTsize i = 0; i < m_joysticks.size(); i++)
+		delete m_joysticks[i];
+	m_joysticks.clear();
+
+	m_keyboard = gkKeyboard();
+	m_mouse = gkMouse();
+
+	for (UTsize i = 0; i < gkInputLogLimit(layout.size()); i++)
+	{
+		m_joysticks.push_back(new gkJoystick(gkInputLogLimit(layout[i]->buttons.size()),
+		                                     gkInputLogLimit(layout[i]->axes.size())));
+	}
+}
+
+
+void gkInputLog::writeU8(UTuint8 v)
+{
+	m_stream->write(&v, 1);
+}
+
+
+void gkInputLog::writeU16(UTuint16 v)
+{
+	UTuint8 b[2] = {(UTuint8)(v & 0xFF), (UTuint8)(v >> 8)};
+	m_stream->write(b, 2);
+}
+
+
+void gkInputLog::writeU32(UTuint32 v)
+{
+	UTuint8 b[4] = {(UTuint8)(v & 0xFF), (UTuint8)((v >> 8) & 0xFF), (UTuint8)((v >> 16) & 0xFF), (UTuint8)(v >> 24)};
+	m_stream->write(b, 4);
+}
+
+
+void gkInputLog::writeFloat(float v)
+{
+	UTuint32 bits;
+	memcpy(&bits, &v, 4);
+	writeU32(bits);
+}
+
+
+bool gkInputLog::readU8(UTuint8& v)
+{
+	return m_stream->read(&v, 1) == 1;
+}
+
+
+bool gkInputLog::readU16(UTuint16& v)
+{
+	UTuint8 b[2];
+	if (m_stream->read(b, 2) != 2)
+		return false;
+
+	v = (UTuint16)(b[0] | (b[1] << 8));
+	return true;
+}
+
+
+bool gkInputLog::readU32(UTuint32& v)
+{
+	UTuint8 b[4];
+	if (m_stream->read(b, 4) != 4)
+		return false;
+
+	v = (UTuint32)b[0] | ((UTuint32)b[1] << 8) | ((UTuint32)b[2] << 16) | ((UTuint32)b[3] << 24);
+	return true;
+}
+
+
+bool gkInputLog::readFloat(float& v)
+{
+	UTuint32 bits;
+	if (!readU32(bits))
+		return false;
+
+	memcpy(&v, &bits, 4);
+	return true;
+}
+
+
+
+gkInputRecorder::gkInputRecorder(utStream* stream, bool owner)
+	:   gkInputLog(stream, owner)
+{
+}
+
+
+void gkInputRecorder::begin(const Joysticks& joysticks)
+{
+	resetState(joysticks);
+
+	writeU32(MAGIC);
+	writeU16(VERSION);
+	writeU8((UTuint8)m_joysticks.size());
+
+	for (UTsize i = 0; i < m_joysticks.size(); i++)
+	{
+		writeU8((UTuint8)m_joysticks[i]->buttons.size());
+		writeU8((UTuint8)m_joysticks[i]->axes.size());
+	}
+}
+
+
+void gkInputRecorder::record(UTuint32 tick, const gkKeyboard& keyboard, const gkMouse& mouse, const Joysticks& joysticks)
+{
+	UTuint8 flags = 0;
+
+	if (writeKeyboard(keyboard, true))
+		flags |= IS_KEYBOARD;
+	if (writeMouse(mouse, true))
+		flags |= IS_MOUSE;
+
+	UTsize nrJoysticks = gkMin(joysticks.size(), m_joysticks.size());
+	for (UTsize i = 0; i < nrJoysticks && !(flags & IS_JOYSTICKS); i++)
+	{
+		if (writeJoystick(i, *joysticks[i], true))
+			flags |= IS_JOYSTICKS;
+	}
+
+	writeU32(tick);
+	writeU8(flags);
+
+	if (flags & IS_KEYBOARD)
+		writeKeyboard(keyboard, false);
+	if (flags & IS_MOUSE)
+		writeMouse(mouse, false);
+
+	if (flags & IS_JOYSTICKS)
+	{
+		for (UTsize i = 0; i < nrJoysticks; i++)
+		{
+			if (writeJoystick(i, *joysticks[i], true))
+				writeJoystick(i, *joysticks[i], false);
+		}
+		writeU8(GK_INPUT_LOG_END);
+	}
+
+	m_frames++;
+}
+
+
+bool gkInputRecorder::writeKeyboard(const gkKeyboard& keyboard, bool test)
+{
+	UTuint8 nr = 0;
+	for (int i = 0; i < KC_MAX; i++)
+	{
+		if (keyboard.keys[i] != m_keyboard.keys[i])
+			nr++;
+	}
+
+	if (test)
+	{
+		return nr > 0 || keyboard.key_count != m_keyboard.key_count ||
+		       keyboard.text != m_keyboard.text || keyboard.key_mod != m_keyboard.key_mod;
+	}
+
+	writeU8(nr);
+	for (int i = 0; i < KC_MAX; i++)
+	{
+		if (keyboard.keys[i] != m_keyboard.keys[i])
+		{
+			writeU8((UTuint8)i);
+			writeU8((UTuint8)keyboard.keys[i]);
+		}
+	}
+
+	writeU16((UTuint16)keyboard.key_count);
+	writeU32(keyboard.text);
+	writeU8((UTuint8)keyboard.key_mod);
+
+	m_keyboard = keyboard;
+	return true;
+}
+
+
+bool gkInputRecorder::writeMouse(const gkMouse& mouse, bool test)
+{
+	if (test)
+	{
+		return mouse.position != m_mouse.position || mouse.relative != m_mouse.relative ||
+		       mouse.wheelDelta != m_mouse.wheelDelta || mouse.moved != m_mouse.moved ||
+		       memcmp(mouse.buttons, m_mouse.buttons, sizeof(gkMouse::ButtonState)) != 0;
+	}
+
+	writeFloat(mouse.position.x);
+	writeFloat(mouse.position.y);
+	writeFloat(mouse.relative.x);
+	writeFloat(mouse.relative.y);
+	writeFloat(mouse.wheelDelta);
+	writeU8((UTuint8)(mouse.buttons[0] | (mouse.buttons[1] << 2) | (mouse.buttons[2] << 4)));
+	writeU8(mouse.moved ? 1 : 0);
+
+	m_mouse = mouse;
+	return true;
+}
+
+
+bool gkInputRecorder::writeJoystick(UTsize index, const gkJoystick& joystick, bool test)
+{
+	gkJoystick& last = *m_joysticks[index];
+
+	UTsize nrButtons = gkMin(joystick.buttons.size(), last.buttons.size());
+	UTsize nrAxes = gkMin(joystick.axes.size(), last.axes.size());
+
+	UTuint8 changedButtons = 0, changedAxes = 0;
+	for (UTsize i = 0; i < nrButtons; i++)
+	{
+		if (joystick.buttons[i] != last.buttons[i] || joystick.buttonsPressed[i] != last.buttonsPressed[i])
+			changedButtons++;
+	}
+
+	for (UTsize i = 0; i < nrAxes; i++)
+	{
+		if (joystick.axes[i] != last.axes[i] || joystick.relAxes[i] != last.relAxes[i])
+			changedAxes++;
+	}
+
+	if (test)
+	{
+		return changedButtons > 0 || changedAxes > 0 ||
+		       joystick.buttonCount != last.buttonCount || joystick.accel != last.accel;
+	}
+
+	writeU8((UTuint8)index);
+
+	writeU8(changedButtons);
+	for (UTsize i = 0; i < nrButtons; i++)
+	{
+		if (joystick.buttons[i] != last.buttons[i] || joystick.buttonsPressed[i] != last.buttonsPressed[i])
+		{
+			writeU8((UTuint8)i);
+			writeU8((UTuint8)joystick.buttons[i]);
+			writeU8((UTuint8)joystick.buttonsPressed[i]);
+
+			last.buttons[i] = joystick.buttons[i];
+			last.buttonsPressed[i] = joystick.buttonsPressed[i];
+		}
+	}
+
+	writeU8(changedAxes);
+	for (UTsize i = 0; i < nrAxes; i++)
+	{
+		if (joystick.axes[i] != last.axes[i] || joystick.relAxes[i] != last.relAxes[i])
+		{
+			writeU8((UTuint8)i);
+			writeU32((UTuint32)joystick.axes[i]);
+			writeU32((UTuint32)joystick.relAxes[i]);
+
+			last.axes[i] = joystick.axes[i];
+			last.relAxes[i] = joystick.relAxes[i];
+		}
+	}
+
+	writeU16((UTuint16)joystick.buttonCount);
+	writeFloat(joystick.accel.x);
+	writeFloat(joystick.accel.y);
+	writeFloat(joystick.accel.z);
+
+	last.buttonCount = joystick.buttonCount;
+	last.accel = joystick.accel;
+	return true;
+}
+
+
+
+gkInputPlayer::gkInputPlayer(utStream* stream, bool owner)
+	:   gkInputLog(stream, owner)
+{
+}
+
+
+bool gkInputPlayer::begin(void)
+{
+	UTuint32 magic;
+	UTuint16 version;
+	UTuint8 nrJoysticks;
+
+	if (!readU32(magic) || magic != MAGIC || !readU16(version) || version != VERSION || !readU8(nrJoysticks))
+		return false;
+
+	for (UTsize i = 0; i < m_joysticks.size(); i++)
+		delete m_joysticks[i];
+	m_joysticks.clear();
+
+	for (UTuint8 i = 0; i < nrJoysticks; i++)
+	{
+		UTuint8 nrButtons, nrAxes;
+		if (!readU8(nrButtons) || !readU8(nrAxes))
+			return false;
+
+		m_joysticks.push_back(new gkJoystick(nrButtons, nrAxes));
+	}
+	return true;
+}
+
+
+bool gkInputPlayer::play(UTuint32& tick, gkKeyboard& keyboard, gkMouse& mouse, Joysticks& joysticks, gkInputChanges& changes)
+{
+	changes.clear();
+
+	UTuint8 flags;
+	if (!readU32(tick) || !readU8(flags))
+		return false;
+
+	if ((flags & IS_KEYBOARD) && !readKeyboard(keyboard, changes))
+		return false;
+	if ((flags & IS_MOUSE) && !readMouse(mouse, changes))
+		return false;
+	if ((flags & IS_JOYSTICKS) && !readJoysticks(joysticks, changes))
+		return false;
+
+	m_frames++;
+	return true;
+}
+
+
+bool gkInputPlayer::readKeyboard(gkKeyboard& keyboard, gkInputChanges& changes)
+{
+	UTuint8 nr;
+	if (!readU8(nr))
+		return false;
+
+	for (UTuint8 i = 0; i < nr; i++)
+	{
+		UTuint8 key, state;
+		if (!readU8(key) || !readU8(state))
+			return false;
+
+		if (key < KC_MAX)
+		{
+			keyboard.keys[key] = state;
+			changes.keys.push_back(key);
+		}
+	}
+
+	UTuint16 count;
+	UTuint32 text;
+	UTuint8 mod;
+	if (!readU16(count) || !readU32(text) || !readU8(mod))
+		return false;
+
+	keyboard.key_count = (UTint16)count;
+	keyboard.text = text;
+	keyboard.key_mod = mod;
+	return true;
+}
+
+
+bool gkInputPlayer::readMouse(gkMouse& mouse, gkInputChanges& changes)
+{
+	float px, py, rx, ry, wheel;
+	UTuint8 buttons, moved;
+
+	if (!readFloat(px) || !readFloat(py) || !readFloat(rx) || !readFloat(ry) || !readFloat(wheel) ||
+	        !readU8(buttons) || !readU8(moved))
+		return false;
+
+	mouse.position = gkVector2(px, py);
+	mouse.relative = gkVector2(rx, ry);
+	mouse.wheelDelta = wheel;
+	mouse.moved = moved != 0;
+	changes.mouseMoved = mouse.moved;
+
+	for (int i = 0; i < 3; i++)
+	{
+		int state = (buttons >> (i * 2)) & 3;
+		if (mouse.buttons[i] != state)
+		{
+			mouse.buttons[i] = state;
+			changes.buttons.push_back(i);
+		}
+	}
+	return true;
+}
+
+
+bool gkInputPlayer::readJoysticks(Joysticks& joysticks, gkInputChanges& changes)
+{
+	// a scratch joystick soaks up entries the target can not hold
+	gkJoystick scratch(0xFF, 0xFF);
+
+	for (;;)
+	{
+		UTuint8 index;
+		if (!readU8(index))
+			return false;
+		if (index == GK_INPUT_LOG_END)
+			return true;
+
+		gkJoystick& js = index < joysticks.size() ? *joysticks[index] : scratch;
+
+		UTuint8 nr;
+		if (!readU8(nr))
+			return false;
+
+		for (UTuint8 i = 0; i < nr; i++)
+		{
+			UTuint8 button, state, pressed;
+			if (!readU8(button) || !readU8(state) || !readU8(pressed))
+				return false;
+
+			if (&js != &scratch && button < js.buttons.size())
+			{
+				js.buttons[button] = state;
+				js.buttonsPressed[button] = pressed;
+
+				gkInputChanges::Joystick change = {index, button, false};
+				changes.joysticks.push_back(change);
+			}
+		}
+
+		if (!readU8(nr))
+			return false;
+
+		for (UTuint8 i = 0; i < nr; i++)
+		{
+			UTuint8 axis;
+			UTuint32 abs, rel;
+			if (!readU8(axis) || !readU32(abs) || !readU32(rel))
+				return false;
+
+			if (&js != &scratch && axis < js.axes.size())
+			{
+				js.axes[axis] = (int)abs;
+				js.relAxes[axis] = (int)rel;
+
+				gkInputChanges::Joystick change = {index, axis, true};
+				changes.joysticks.push_back(change);
+			}
+		}
+
+		UTuint16 count;
+		float ax, ay, az;
+		if (!readU16(count) || !readFloat(ax) || !readFloat(ay) || !readFloat(az))
+			return false;
+
+		js.buttonCount = (UTint16)count;
+		js.accel = gkVector3(ax, ay, az);
+	}
+}
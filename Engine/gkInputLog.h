@@ -0,0 +1,156 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkInputLog_h_
+#define _gkInputLog_h_
+
+#include "gkCommon.h"
+#include "gkInput.h"
+
+class utStream;
+
+
+// Binary per tick input log, see gkWindowSystem::startRecording.
+//
+// header  : magic, version, joystick count, per joystick button and axis count
+// frame   : tick, section flags, then only the sections that changed since the
+//           previous frame. Values are little endian.
+class gkInputLog
+{
+public:
+	enum
+	{
+		MAGIC   = 0x4C494B47,   // "GKIL"
+		VERSION = 1,
+	};
+
+	enum Section
+	{
+		IS_KEYBOARD     = 1 << 0,
+		IS_MOUSE        = 1 << 1,
+		IS_JOYSTICKS    = 1 << 2,
+	};
+
+	typedef utArray<gkJoystick*> Joysticks;
+
+	gkInputLog(utStream* stream, bool owner);
+	virtual ~gkInputLog();
+
+	GK_INLINE utStream* getStream(void)       { return m_stream; }
+	GK_INLINE UTsize getFrameCount(void) const { return m_frames; }
+
+protected:
+
+	void writeU8(UTuint8 v);
+	void writeU16(UTuint16 v);
+	void writeU32(UTuint32 v);
+	void writeFloat(float v);
+
+	bool readU8(UTuint8& v);
+	bool readU16(UTuint16& v);
+	bool readU32(UTuint32& v);
+	bool readFloat(float& v);
+
+	// last logged state, frames store the difference to it
+	void resetState(const Joysticks& layout);
+
+	utStream*       m_stream;
+	bool            m_owner;
+	UTsize          m_frames;
+
+	gkKeyboard      m_keyboard;
+	gkMouse         m_mouse;
+	Joysticks       m_joysticks;
+};
+
+
+class gkInputRecorder : public gkInputLog
+{
+public:
+	gkInputRecorder(utStream* stream, bool owner = true);
+
+	// Writes the header, joysticks fix the layout for the whole log.
+	void begin(const Joysticks& joysticks);
+
+	// Appends the state after this tick's dispatch.
+	void record(UTuint32 tick, const gkKeyboard& keyboard, const gkMouse& mouse, const Joysticks& joysticks);
+
+private:
+	bool writeKeyboard(const gkKeyboard& keyboard, bool test);
+	bool writeMouse(const gkMouse& mouse, bool test);
+	bool writeJoystick(UTsize index, const gkJoystick& joystick, bool test);
+};
+
+
+// What a replayed frame changed, so the window can raise listener callbacks.
+struct gkInputChanges
+{
+	struct Joystick
+	{
+		UTuint8 joystick;
+		UTuint8 index;
+		bool    axis;
+	};
+
+	utArray<int>        keys;       // scan codes
+	utArray<int>        buttons;    // mouse buttons
+	bool                mouseMoved;
+	utArray<Joystick>   joysticks;
+
+	gkInputChanges() : mouseMoved(false) {}
+
+	void clear(void)
+	{
+		keys.clear(true);
+		buttons.clear(true);
+		joysticks.clear(true);
+		mouseMoved = false;
+	}
+};
+
+
+class gkInputPlayer : public gkInputLog
+{
+public:
+	gkInputPlayer(utStream* stream, bool owner = true);
+
+	// Reads the header, false if this is not an input log.
+	bool begin(void);
+
+	// Button and axis counts recorded per joystick.
+	GK_INLINE const Joysticks& getLayout(void) const { return m_joysticks; }
+
+	// Applies the next frame on top of the given state, false at the end of the log.
+	bool play(UTuint32& tick, gkKeyboard& keyboard, gkMouse& mouse, Joysticks& joysticks, gkInputChanges& changes);
+
+private:
+	bool readKeyboard(gkKeyboard& keyboard, gkInputChanges& changes);
+	bool readMouse(gkMouse& mouse, gkInputChanges& changes);
+	bool readJoysticks(Joysticks& joysticks, gkInputChanges& changes);
+};
+
+
+#endif//_gkInputLog_h_
@@ -26,10 +26,11 @@
 */
 #include "gkInstancedManager.h"
 #include "gkInstancedObject.h"
+#include "OgreTimer.h"
 
 
 gkInstancedManager::gkInstancedManager(const gkString& type, const gkString& rtype)
-	:    gkResourceManager(type, rtype)
+	:    gkResourceManager(type, rtype), m_queueBudget(0)
 {
 }
 
@@ -98,13 +99,30 @@ void gkInstancedManager::addReInstanceQueue(gkInstancedObject* iobj)
 	}
 }
 
+void gkInstancedManager::removeInstanceQueue(gkInstancedObject* iobj)
+{
+	UTsize i, n = 0;
+	for (i = 0; i < m_instanceQueue.size(); ++i)
+	{
+		if (m_instanceQueue[i].first != iobj)
+			m_instanceQueue[n++] = m_instanceQueue[i];
+	}
+
+	m_instanceQueue.resize(n);
+}
+
 void gkInstancedManager::postProcessQueue(void)
 {
-	InstanceParams::Iterator it = m_instanceQueue.iterator();
+	if (m_instanceQueue.empty())
+		return;
 
-	while (it.hasMoreElements())
+	static Ogre::Timer clock;
+	unsigned long start = m_queueBudget ? clock.getMicroseconds() : 0;
+
+	UTsize i = 0;
+	while (i < m_instanceQueue.size())
 	{
-		InstanceParam& iq = it.getNext();
+		InstanceParam iq = m_instanceQueue[i++];
 
 		switch (iq.second)
 		{
@@ -118,9 +136,23 @@ void gkInstancedManager::postProcessQueue(void)
 			iq.first->reinstance();
 			break;
 		}
+
+		if (m_queueBudget && clock.getMicroseconds() - start >= m_queueBudget)
+			break;
 	}
 
-	m_instanceQueue.clear(true);
+	if (i == m_instanceQueue.size())
+	{
+		m_instanceQueue.clear(true);
+		return;
+	}
+
+	// keep the rest in order for the next call
+	UTsize n;
+	for (n = 0; i < m_instanceQueue.size(); ++n, ++i)
+		m_instanceQueue[n] = m_instanceQueue[i];
+
+	m_instanceQueue.resize(n);
 }
 
 
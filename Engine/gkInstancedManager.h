@@ -76,8 +76,15 @@ public:
 	void addCreateInstanceQueue(gkInstancedObject* iobj);
 	void addDestroyInstanceQueue(gkInstancedObject* iobj);
 	void addReInstanceQueue(gkInstancedObject* iobj);
+	void removeInstanceQueue(gkInstancedObject* iobj);
 	void postProcessQueue(void);
 
+	// Microseconds postProcessQueue may spend, commands left
+	// over wait for the next call. 0 runs the whole queue.
+	void setQueueBudget(unsigned long micro)    {m_queueBudget = micro;}
+	unsigned long getQueueBudget(void)          {return m_queueBudget;}
+	UTsize getQueueSize(void)                   {return m_instanceQueue.size();}
+
 	void destroyGroupInstances(const gkString& group);
 	void destroyAllInstances(void);
 
@@ -97,6 +104,7 @@ public:
 protected:
 
 	InstanceParams m_instanceQueue;
+	unsigned long  m_queueBudget;
 
 	Instances m_instances;
 	InstanceListeners m_instanceListeners;
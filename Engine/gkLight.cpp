@@ -81,7 +81,7 @@ void gkLight::createInstanceImpl(void)
 	Ogre::SceneManager* manager = m_scene->getManager();
 
 	m_light = manager->createLight(m_name.getName());
-	m_node->attachObject(m_light);
+	getRenderNode()->attachObject(m_light);
 
 	updateProperties();
 }
@@ -97,7 +97,7 @@ void gkLight::destroyInstanceImpl(void)
 	{
 		Ogre::SceneManager* manager = m_scene->getManager();
 
-		m_node->detachObject(m_light);
+		getRenderNode()->detachObject(m_light);
 		manager->destroyLight(m_light);
 	}
 
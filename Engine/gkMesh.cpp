@@ -340,6 +340,13 @@ btTriangleMesh* gkMesh::getTriMesh(void)
 }
 
 
+void gkMesh::releaseTriMesh(void)
+{
+	delete m_triMesh;
+	m_triMesh = 0;
+}
+
+
 gkVertexGroup* gkMesh::createVertexGroup(const gkString& name)
 {
 	gkVertexGroup* group = new gkVertexGroup(name, m_groups.size());
@@ -127,7 +127,7 @@ public:
 	Triangles&          getIndexBuffer(void)                {return m_tris;}
 	DeformVerts&        getDeformVertexBuffer(void)         {return m_defverts;}
 	gkString            getMaterialName(void)               {return m_material->m_name;}
-	void                setMaterialName(const gkString& v)  {m_material->m_name = v;}
+	void                setMaterialName(const gkString& v)  {m_material->m_name = v; m_material->m_symbol = v;}
 	void                setTotalLayers(int v)               {m_uvlayers = v;}
 	int                 getUvLayerCount(void)               {return m_uvlayers;}
 	void                setVertexColors(bool v)             {m_hasVertexColors = v;}
@@ -205,6 +205,8 @@ public:
     void updateBounds(void);
 
 	btTriangleMesh*          getTriMesh(void);
+	// Frees the collision triangles, only while no shape uses them.
+	void                     releaseTriMesh(void);
 	gkMaterialProperties&    getFirstMaterial(void);
 
 
@@ -38,16 +38,88 @@ gkMessageManager::Message& gkMessageManager::Message::operator = (const Message&
 }
 
 
+void gkMessageManager::Message::release(void)
+{
+	GK_ASSERT(m_refs > 0);
+	if (--m_refs == 0)
+	{
+		gkMessageManager* mgr = gkMessageManager::getSingletonPtr();
+		if (mgr)
+			mgr->recycleMessage(this);
+	}
+}
+
+
+void gkMessageManager::MessageListener::getRoutes(Routes& routes) const
+{
+	Route r = {GK_NO_SYMBOL, GK_NO_SYMBOL};
+	routes.push_back(r);
+}
+
+
+void gkMessageManager::GenericMessageListener::setToFilter(const gkHashedString& v)
+{
+	m_toFilter = v;
+	if (gkMessageManager::getSingletonPtr())
+		gkMessageManager::getSingleton().updateListener(this);
+}
+
+
+void gkMessageManager::GenericMessageListener::setSubjectFilter(const gkHashedString& v)
+{
+	m_subjectFilter = v;
+	if (gkMessageManager::getSingletonPtr())
+		gkMessageManager::getSingleton().updateListener(this);
+}
+
+
+void gkMessageManager::GenericMessageListener::setAcceptEmptyTo(bool accept)
+{
+	m_acceptEmptyTo = accept;
+	if (gkMessageManager::getSingletonPtr())
+		gkMessageManager::getSingleton().updateListener(this);
+}
+
+
+void gkMessageManager::GenericMessageListener::getRoutes(Routes& routes) const
+{
+	const gkSymbol subject = m_subjectFilter.empty() ? GK_NO_SYMBOL : m_subjectFilter.id();
+
+	Route r = {m_toFilter.empty() ? GK_NO_SYMBOL : m_toFilter.id(), subject};
+	routes.push_back(r);
+
+	if (!m_toFilter.empty() && m_acceptEmptyTo)
+	{
+		// messages sent to nobody carry the empty symbol
+		r.m_to = gkHashedString().id();
+		routes.push_back(r);
+	}
+}
+
+
 void gkMessageManager::GenericMessageListener::handleMessage(gkMessageManager::Message* message)
 {
 	if (!m_fromFilter.empty() && m_fromFilter.compare(message->m_from) != 0) return;
-	if ((!m_toFilter.empty() && m_toFilter.compare(message->m_to) != 0)
-			&& (m_acceptEmptyTo && !message->m_to.empty())) return;
-	if (!m_subjectFilter.empty() && m_subjectFilter.compare(message->m_subject) != 0) return;
 
-	Message m = *message;
+	message->addRef();
+	m_messages.push_back(message);
+}
 
-	m_messages.push_back(m);
+
+void gkMessageManager::GenericMessageListener::swapMessages(void)
+{
+	for (UTsize i = 0; i < m_received.size(); ++i)
+		m_received[i]->release();
+
+	m_received.clear(true);
+	m_received.swap(m_messages);
+}
+
+
+void gkMessageManager::GenericMessageListener::emptyMessages(void)
+{
+	swapMessages();
+	swapMessages();
 }
 
 
@@ -57,35 +129,142 @@ gkMessageManager::gkMessageManager()
 }
 
 
+gkMessageManager::~gkMessageManager()
+{
+	for (UTsize i = 0; i < m_routeTable.size(); ++i)
+		delete m_routeTable.at(i);
+
+	for (UTsize i = 0; i < m_freeMessages.size(); ++i)
+		m_messagePool.dealloc(m_freeMessages[i]);
+}
+
+
+gkMessageManager::Listeners* gkMessageManager::getListeners(const Route& route, bool create)
+{
+	const utIntHashKey to((UTint32)route.m_to), subject((UTint32)route.m_subject);
+
+	SubjectRoutes** routes = m_routeTable.get(to);
+	if (!routes)
+	{
+		if (!create)
+			return 0;
+
+		m_routeTable.insert(to, new SubjectRoutes());
+		routes = m_routeTable.get(to);
+	}
+
+	Listeners* listeners = (*routes)->get(subject);
+	if (!listeners && create)
+	{
+		(*routes)->insert(subject, Listeners());
+		listeners = (*routes)->get(subject);
+	}
+	return listeners;
+}
+
+
 void gkMessageManager::addListener(MessageListener* listener)
 {
-	if ( m_listeners.find(listener) == UT_NPOS)
-		m_listeners.push_back(listener);
+	if (!listener->m_routes.empty())
+		return;
+
+	listener->getRoutes(listener->m_routes);
+	for (UTsize i = 0; i < listener->m_routes.size(); ++i)
+		getListeners(listener->m_routes[i], true)->push_back(listener);
 }
 
 
 void gkMessageManager::removeListener(MessageListener* listener)
 {
-	m_listeners.erase(listener);
+	for (UTsize i = 0; i < listener->m_routes.size(); ++i)
+	{
+		Listeners* listeners = getListeners(listener->m_routes[i], false);
+		if (listeners)
+			listeners->erase(listener);
+	}
+	listener->m_routes.clear();
+}
+
+
+void gkMessageManager::updateListener(MessageListener* listener)
+{
+	if (listener->m_routes.empty())
+		return;
+
+	removeListener(listener);
+	addListener(listener);
+}
+
+
+void gkMessageManager::sendMessage(const gkString& from, const gkString& to, const gkString& subject, const gkString& body)
+{
+	const gkSymbolTable::Entry* toEntry = gkSymbolTable::find(to.c_str());
+	const gkSymbolTable::Entry* subjectEntry = gkSymbolTable::find(subject.c_str());
+
+	route(from, to, subject, body,
+	      toEntry ? toEntry->id : GK_NO_SYMBOL,
+	      subjectEntry ? subjectEntry->id : GK_NO_SYMBOL);
 }
 
 
-void gkMessageManager::sendMessage(gkString from, gkString to, gkString subject, gkString body)
+void gkMessageManager::sendInternedMessage(const gkString& from, const gkHashedString& to, const gkHashedString& subject, const gkString& body)
 {
-	Message* m = new Message();
+	route(from, to.str(), subject.str(), body, to.id(), subject.id());
+}
+
+
+void gkMessageManager::route(const gkString& from, const gkString& to, const gkString& subject, const gkString& body,
+                             gkSymbol toSymbol, gkSymbol subjectSymbol)
+{
+	// exact and wildcard routes, a symbol that was never interned only matches wildcards
+	utSmallArray<MessageListener*, 16> targets;
+
+	const gkSymbol tos[2]      = {toSymbol, GK_NO_SYMBOL};
+	const gkSymbol subjects[2] = {subjectSymbol, GK_NO_SYMBOL};
+
+	for (int i = toSymbol == GK_NO_SYMBOL ? 1 : 0; i < 2; ++i)
+	{
+		for (int j = subjectSymbol == GK_NO_SYMBOL ? 1 : 0; j < 2; ++j)
+		{
+			Route r = {tos[i], subjects[j]};
+			Listeners* listeners = getListeners(r, false);
+			if (listeners)
+			{
+				for (UTsize k = 0; k < listeners->size(); ++k)
+					targets.push_back(listeners->at(k));
+			}
+		}
+	}
+
+	if (targets.empty())
+		return;
+
+	Message* m;
+	if (!m_freeMessages.empty())
+	{
+		m = m_freeMessages.back();
+		m_freeMessages.pop_back();
+	}
+	else
+		m = m_messagePool.alloc();
+
 	m->m_from = from;
 	m->m_to = to;
 	m->m_subject = subject;
 	m->m_body = body;
 
-	utArrayIterator<utArray<MessageListener*> > iter(m_listeners);
-	while (iter.hasMoreElements())
-	{
-		iter.peekNext()->handleMessage(m);
-		iter.getNext();
-	}
+	// held while delivering, so listeners that keep nothing free it again
+	m->addRef();
+	for (UTsize i = 0; i < targets.size(); ++i)
+		targets[i]->handleMessage(m);
+	m->release();
+}
 
-	delete m;
+
+void gkMessageManager::recycleMessage(Message* message)
+{
+	// kept whole, the strings reuse their buffers on the next send
+	m_freeMessages.push_back(message);
 }
 
 UT_IMPLEMENT_SINGLETON(gkMessageManager);
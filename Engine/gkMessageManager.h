@@ -29,8 +29,18 @@
 #define _gkMessageManager_h_
 
 #include "gkCommon.h"
+#include "gkHashedString.h"
 #include "utSingleton.h"
+#include "utMemoryPool.h"
 
+
+// Routes messages to listeners by recipient and subject.
+//
+// Listeners register under (to, subject) routes of interned symbols, where
+// GK_NO_SYMBOL matches anything. Sending looks up at most four routes, so it
+// costs the number of matching listeners, not the number registered. The
+// message is copied once into a pooled, reference counted Message and every
+// listener holds a reference to that same copy.
 class gkMessageManager : public utSingleton<gkMessageManager>
 {
 public:
@@ -41,46 +51,105 @@ public:
 		gkString m_to;
 		gkString m_subject;
 		gkString m_body;
+		int      m_refs;
+
+		Message() : m_refs(0) {}
 
 		Message& operator = (const Message& m);
+
+		GK_INLINE void addRef(void) {++m_refs;}
+
+		// Back to the manager's free list after the last reference.
+		void release(void);
 	};
 
+	typedef utArray<Message*> Messages;
+
+
+	struct Route
+	{
+		gkSymbol m_to;
+		gkSymbol m_subject;
+	};
+
+	typedef utArray<Route> Routes;
+
+
 	struct    MessageListener
 	{
 		MessageListener() {}
 		virtual ~MessageListener() {}
 
+		// Routes to register under, the default hears every message.
+		virtual void getRoutes(Routes& routes) const;
+
 		virtual void handleMessage(gkMessageManager::Message* message) = 0;
+
+		// Routes registered under, kept by the manager.
+		Routes m_routes;
 	};
 
+	// Queues the messages addressed to it until swapMessages. An empty to or
+	// subject filter matches anything. With a to filter, messages sent to
+	// nobody are only heard when accepting empty to.
 	struct GenericMessageListener : public MessageListener
 	{
-		gkString m_fromFilter, m_toFilter, m_subjectFilter;
-		bool m_acceptEmptyTo;
-		utArray<Message> m_messages;
+		gkString       m_fromFilter;
+		gkHashedString m_toFilter, m_subjectFilter;
+		bool           m_acceptEmptyTo;
+		Messages       m_messages;      // arrived since the last swap
+		Messages       m_received;      // arrived before the last swap
 
-		GenericMessageListener(gkString fromfilter = "", gkString tofilter = "", gkString subjectfilter = "")
+		GenericMessageListener(const gkString& fromfilter = "", const gkHashedString& tofilter = "", const gkHashedString& subjectfilter = "")
 			:    m_fromFilter(fromfilter), m_toFilter(tofilter), m_subjectFilter(subjectfilter), m_acceptEmptyTo(false) {}
 
-		void setAcceptEmptyTo(bool accept){this->m_acceptEmptyTo=accept;}
-		bool isAcceptingEmptyTo(){return this->m_acceptEmptyTo;}
+		~GenericMessageListener() {emptyMessages();}
 
-		~GenericMessageListener() {m_messages.clear();}
+		// Changing a routed filter moves a registered listener to its new routes.
+		void setToFilter(const gkHashedString& v);
+		void setSubjectFilter(const gkHashedString& v);
+		void setAcceptEmptyTo(bool accept);
+		bool isAcceptingEmptyTo(){return this->m_acceptEmptyTo;}
 
+		void getRoutes(Routes& routes) const;
 		void handleMessage(gkMessageManager::Message* message);
-		void emptyMessages() {m_messages.clear();}
+
+		// Hands the queued messages over to m_received, releasing the previous ones.
+		void swapMessages(void);
+		void emptyMessages(void);
 	};
 
 private:
-	utArray<MessageListener*> m_listeners;
+	typedef utArray<MessageListener*>                 Listeners;
+	typedef utHashTable<utIntHashKey, Listeners>      SubjectRoutes;
+	typedef utHashTable<utIntHashKey, SubjectRoutes*> RouteTable;
+
+	RouteTable                m_routeTable;
+	utMemoryPool<Message, 0>  m_messagePool;
+	Messages                  m_freeMessages;
+
+	Listeners* getListeners(const Route& route, bool create);
+	void route(const gkString& from, const gkString& to, const gkString& subject, const gkString& body,
+	           gkSymbol toSymbol, gkSymbol subjectSymbol);
 
 public:
 	gkMessageManager();
-	virtual ~gkMessageManager() {}
+	virtual ~gkMessageManager();
 
 	void addListener(MessageListener* listener);
 	void removeListener(MessageListener* listener);
-	void sendMessage(gkString from, gkString to, gkString subject, gkString body);
+
+	// Re-reads the routes of a registered listener.
+	void updateListener(MessageListener* listener);
+
+	// Names that were never interned cannot match a filter and only reach
+	// listeners that accept anything.
+	void sendMessage(const gkString& from, const gkString& to, const gkString& subject, const gkString& body);
+
+	// Skips the symbol lookups, for senders that interned to and subject up front.
+	void sendInternedMessage(const gkString& from, const gkHashedString& to, const gkHashedString& subject, const gkString& body);
+
+	void recycleMessage(Message* message);
 
 	UT_DECLARE_SINGLETON(gkMessageManager);
 };
@@ -0,0 +1,413 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkProfiler.h"
+#include "gkLogger.h"
+#include "Thread/gkThread.h"
+
+#include <stdio.h>
+
+#ifdef WIN32
+# include <windows.h>
+#elif defined(__APPLE__)
+# include <mach/mach_time.h>
+#else
+# include <time.h>
+#endif
+
+
+// Zones outlive any profiler instance so that cached pointers stay valid.
+class gkProfileZoneRegistry
+{
+public:
+	~gkProfileZoneRegistry()
+	{
+		for (UTsize i = 0; i < m_zones.size(); i++)
+			delete m_zones[i];
+	}
+
+	gkProfileZone* get(const char* name)
+	{
+		gkCriticalSection::Lock guard(m_lock);
+
+		for (UTsize i = 0; i < m_zones.size(); i++)
+		{
+			if (m_zones[i]->m_name == name)
+				return m_zones[i];
+		}
+
+		gkProfileZone* zone = new gkProfileZone(name, m_zones.size());
+		m_zones.push_back(zone);
+		return zone;
+	}
+
+private:
+	gkCriticalSection       m_lock;
+	utArray<gkProfileZone*> m_zones;
+};
+
+
+static gkProfileZoneRegistry gkProfileZones;
+
+gkProfileZone* gkProfileZone::get(const char* name)
+{
+	return gkProfileZones.get(name);
+}
+
+
+
+gkProfileBuffer::gkProfileBuffer(UTsize index, const gkString& name)
+	:   depth(0), m_index(index), m_name(name)
+{
+}
+
+
+void gkProfileBuffer::push(const gkProfileEvent& event)
+{
+	int head = m_head.get();
+	if (head - m_tail.get() >= CAPACITY)
+	{
+		m_dropped.increment();
+		return;
+	}
+
+	m_events[head & (CAPACITY - 1)] = event;
+	m_head.set(head + 1);
+}
+
+
+
+// Buffer of the calling thread, tagged with the profiler it was made for.
+static GK_THREAD_LOCAL gkProfileBuffer* gkProfileThreadBuffer = 0;
+static GK_THREAD_LOCAL int gkProfileThreadGeneration = 0;
+static int gkProfileGeneration = 0;
+
+bool gkProfiler::m_active = false;
+
+UT_IMPLEMENT_SINGLETON(gkProfiler);
+
+gkProfiler::gkProfiler()
+	:   m_captureLimit(0),
+	    m_capturing(false),
+	    m_lastFrameTime(0),
+	    m_frame(0),
+	    m_generation(++gkProfileGeneration)
+{
+	m_start = m_frameStart = now();
+	m_active = true;
+}
+
+
+gkProfiler::~gkProfiler()
+{
+	m_active = false;
+
+	gkCriticalSection::Lock guard(m_lock);
+	for (UTsize i = 0; i < m_buffers.size(); i++)
+		delete m_buffers[i];
+	m_buffers.clear();
+}
+
+
+UTuint64 gkProfiler::now(void)
+{
+#ifdef WIN32
+	static LARGE_INTEGER freq = {0};
+	if (!freq.QuadPart)
+		QueryPerformanceFrequency(&freq);
+
+	LARGE_INTEGER count;
+	QueryPerformanceCounter(&count);
+
+	UTuint64 ticks = (UTuint64)count.QuadPart, rate = (UTuint64)freq.QuadPart;
+	return (ticks / rate) * 1000000000ULL + (ticks % rate) * 1000000000ULL / rate;
+#elif defined(__APPLE__)
+	static mach_timebase_info_data_t base = {0, 0};
+	if (!base.denom)
+		mach_timebase_info(&base);
+
+	return mach_absolute_time() * base.numer / base.denom;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (UTuint64)ts.tv_sec * 1000000000ULL + (UTuint64)ts.tv_nsec;
+#endif
+}
+
+
+gkProfileBuffer* gkProfiler::getThreadBuffer(void)
+{
+	if (gkProfileThreadGeneration != m_generation)
+	{
+		gkCriticalSection::Lock guard(m_lock);
+
+		char name[32];
+		if (m_buffers.empty())
+			sprintf(name, "Main");
+		else
+			sprintf(name, "Thread %u", (unsigned int)m_buffers.size());
+
+		gkProfileThreadBuffer = new gkProfileBuffer(m_buffers.size(), name);
+		gkProfileThreadGeneration = m_generation;
+		m_buffers.push_back(gkProfileThreadBuffer);
+	}
+
+	return gkProfileThreadBuffer;
+}
+
+
+UTuint64 gkProfiler::enter(void)
+{
+	if (m_active)
+		getSingleton().getThreadBuffer()->depth++;
+
+	return now();
+}
+
+
+void gkProfiler::leave(gkProfileZone* zone, UTuint64 begin)
+{
+	if (!m_active)
+		return;
+
+	gkProfileBuffer* buffer = getSingleton().getThreadBuffer();
+	if (buffer->depth > 0)
+		buffer->depth--;
+
+	gkProfileEvent event = {zone, begin, now(), buffer->depth};
+	buffer->push(event);
+}
+
+
+void gkProfiler::record(gkProfileZone* zone, UTuint64 begin)
+{
+	if (!m_active)
+		return;
+
+	gkProfileBuffer* buffer = getSingleton().getThreadBuffer();
+
+	gkProfileEvent event = {zone, begin, now(), buffer->depth};
+	buffer->push(event);
+}
+
+
+void gkProfiler::setThreadName(const gkString& name)
+{
+	if (m_active)
+		getSingleton().getThreadBuffer()->setName(name);
+}
+
+
+
+class gkProfileCollector
+{
+public:
+	gkProfileCollector(gkProfiler* profiler) : m_profiler(profiler) {}
+
+	void operator()(gkProfileBuffer& buffer, const gkProfileEvent& event)
+	{
+		gkProfiler& p = *m_profiler;
+
+		UTsize index = event.zone->getIndex();
+		if (index >= p.m_slots.size())
+			p.m_slots.resize(index + 1, -1);
+
+		int slot = p.m_slots[index];
+		if (slot < 0)
+		{
+			slot = p.m_slots[index] = (int)p.m_current.size();
+
+			gkProfiler::Rollup rollup = {event.zone, 0, 0, event.depth, event.begin};
+			p.m_current.push_back(rollup);
+		}
+
+		gkProfiler::Rollup& rollup = p.m_current[slot];
+		rollup.time += event.end - event.begin;
+		rollup.calls++;
+		if (event.depth < rollup.depth)
+			rollup.depth = event.depth;
+		if (event.begin < rollup.first)
+			rollup.first = event.begin;
+
+		if (p.m_capturing && p.m_capture.size() < p.m_captureLimit)
+		{
+			p.m_capture.push_back(event);
+			p.m_captureThreads.push_back(buffer.getIndex());
+		}
+	}
+
+private:
+	gkProfiler* m_profiler;
+};
+
+
+// utArray::sort swaps neighbours for which this holds
+static bool gkProfileRollupAfter(const gkProfiler::Rollup& a, const gkProfiler::Rollup& b)
+{
+	return a.first > b.first;
+}
+
+
+void gkProfiler::nextFrame(void)
+{
+	UTuint64 end = now();
+
+	gkCriticalSection::Lock guard(m_lock);
+
+	gkProfileCollector collector(this);
+	for (UTsize i = 0; i < m_buffers.size(); i++)
+		m_buffers[i]->drain(collector);
+
+	m_last.clear(true);
+	for (UTsize i = 0; i < m_current.size(); i++)
+	{
+		m_last.push_back(m_current[i]);
+		m_slots[m_current[i].zone->getIndex()] = -1;
+	}
+	m_current.clear(true);
+
+	// parents open before their children, so this reads as a tree
+	m_last.sort(gkProfileRollupAfter);
+
+	m_lastFrameTime = end - m_frameStart;
+	m_frameStart = end;
+	m_frame++;
+}
+
+
+const gkProfiler::Rollup* gkProfiler::getLastRollup(const gkString& name) const
+{
+	for (UTsize i = 0; i < m_last.size(); i++)
+	{
+		if (m_last[i].zone->getName() == name)
+			return &m_last[i];
+	}
+	return 0;
+}
+
+
+UTsize gkProfiler::getDroppedEvents(void)
+{
+	gkCriticalSection::Lock guard(m_lock);
+
+	UTsize dropped = 0;
+	for (UTsize i = 0; i < m_buffers.size(); i++)
+		dropped += m_buffers[i]->getDropped();
+	return dropped;
+}
+
+
+void gkProfiler::beginCapture(UTsize maxEvents)
+{
+	gkCriticalSection::Lock guard(m_lock);
+
+	m_capture.clear();
+	m_captureThreads.clear();
+	m_captureLimit = maxEvents;
+	m_capturing = true;
+}
+
+
+void gkProfiler::endCapture(void)
+{
+	gkCriticalSection::Lock guard(m_lock);
+	m_capturing = false;
+}
+
+
+static void gkProfileAppendJsonString(gkString& out, const gkString& str)
+{
+	out += '"';
+	for (UTsize i = 0; i < str.size(); i++)
+	{
+		char c = str[i];
+		if (c == '"' || c == '\\')
+			out += '\\';
+		if ((unsigned char)c >= 0x20)
+			out += c;
+	}
+	out += '"';
+}
+
+
+void gkProfiler::writeChromeTrace(gkString& out)
+{
+	gkCriticalSection::Lock guard(m_lock);
+
+	char buf[128];
+	out += "{\"traceEvents\":[\n";
+
+	for (UTsize i = 0; i < m_buffers.size(); i++)
+	{
+		sprintf(buf, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", (unsigned int)i);
+		out += buf;
+		gkProfileAppendJsonString(out, m_buffers[i]->getName());
+		out += "}},\n";
+	}
+
+	for (UTsize i = 0; i < m_capture.size(); i++)
+	{
+		const gkProfileEvent& event = m_capture[i];
+
+		out += "{\"name\":";
+		gkProfileAppendJsonString(out, event.zone->getName());
+
+		// microseconds, relative to the profiler start
+		sprintf(buf, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+		        (unsigned int)m_captureThreads[i],
+		        double(event.begin - m_start) / 1000.0,
+		        double(event.end - event.begin) / 1000.0);
+		out += buf;
+
+		if (i + 1 < m_capture.size())
+			out += ',';
+		out += '\n';
+	}
+
+	// drop the trailing comma left by the metadata when nothing was captured
+	if (m_capture.empty() && !m_buffers.empty())
+		out.erase(out.size() - 2, 1);
+
+	out += "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+
+bool gkProfiler::writeChromeTrace(const gkString& path)
+{
+	gkString out;
+	writeChromeTrace(out);
+
+	FILE* fp = fopen(path.c_str(), "wb");
+	if (!fp)
+	{
+		gkLogMessage("Profiler: cannot write trace " << path);
+		return false;
+	}
+
+	fwrite(out.c_str(), 1, out.size(), fp);
+	fclose(fp);
+	return true;
+}
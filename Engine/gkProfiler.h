@@ -0,0 +1,268 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkProfiler_h_
+#define _gkProfiler_h_
+
+#include "gkCommon.h"
+#include "gkString.h"
+#include "utSingleton.h"
+#include "Thread/gkAtomic.h"
+#include "Thread/gkCriticalSection.h"
+
+// Hierarchical frame profiler.
+//
+// Code marks named zones with GK_PROFILE_SCOPE, each thread appends the
+// finished spans to its own ring buffer, and gkProfiler::nextFrame drains the
+// rings into per zone rollups. A capture keeps the raw spans for export to the
+// Chrome trace event format (chrome://tracing, Perfetto).
+//
+// Without OGREKIT_USE_PROFILER the macros compile to nothing.
+
+
+// Named zone, interned for the life of the process so call sites may cache it.
+class gkProfileZone
+{
+public:
+
+	static gkProfileZone* get(const char* name);
+
+	GK_INLINE const gkString& getName(void) const { return m_name; }
+	GK_INLINE UTsize getIndex(void) const         { return m_index; }
+
+private:
+	friend class gkProfileZoneRegistry;
+
+	gkProfileZone(const gkString& name, UTsize index) : m_name(name), m_index(index) {}
+
+	gkString    m_name;
+	UTsize      m_index;
+};
+
+
+// Finished span, times in nanoseconds off gkProfiler::now.
+struct gkProfileEvent
+{
+	gkProfileZone*  zone;
+	UTuint64        begin;
+	UTuint64        end;
+	UTuint32        depth;
+};
+
+
+// Single producer, single consumer ring owned by one thread.
+class gkProfileBuffer
+{
+public:
+	enum { CAPACITY = 8192 };
+
+	gkProfileBuffer(UTsize index, const gkString& name);
+
+	// producer side, drops the span when the consumer is behind
+	void push(const gkProfileEvent& event);
+
+	// consumer side, returns the number of events copied
+	template <typename Fn>
+	UTsize drain(Fn& fn)
+	{
+		int tail = m_tail.get();
+		int head = m_head.get();
+
+		UTsize n = 0;
+		for (; tail != head; tail++, n++)
+			fn(*this, m_events[tail & (CAPACITY - 1)]);
+
+		m_tail.set(tail);
+		return n;
+	}
+
+	GK_INLINE UTsize getIndex(void) const             { return m_index; }
+	GK_INLINE const gkString& getName(void) const     { return m_name; }
+	GK_INLINE void setName(const gkString& name)      { m_name = name; }
+	GK_INLINE int getDropped(void) const              { return m_dropped.get(); }
+
+	UTuint32    depth;      // open scopes on the owning thread
+
+private:
+	gkProfileEvent  m_events[CAPACITY];
+	gkAtomicInt     m_head, m_tail, m_dropped;
+	UTsize          m_index;
+	gkString        m_name;
+};
+
+
+class gkProfiler : public utSingleton<gkProfiler>
+{
+public:
+
+	// Inclusive time of one zone over the last frame, summed across threads.
+	struct Rollup
+	{
+		gkProfileZone*  zone;
+		UTuint64        time;
+		UTuint32        calls;
+		UTuint32        depth;  // shallowest nesting seen
+		UTuint64        first;  // earliest begin, rollups are sorted on it
+	};
+
+	typedef utArray<Rollup>             Rollups;
+	typedef utArray<gkProfileEvent>     Events;
+	typedef utArray<gkProfileBuffer*>   Buffers;
+
+public:
+
+	gkProfiler();
+	virtual ~gkProfiler();
+
+	// Steady clock in nanoseconds.
+	static UTuint64 now(void);
+
+	// Opens a nested span on the calling thread, returns its start.
+	static UTuint64 enter(void);
+
+	// Closes the span opened by enter.
+	static void leave(gkProfileZone* zone, UTuint64 begin);
+
+	// Appends a span at the calling thread's current nesting.
+	static void record(gkProfileZone* zone, UTuint64 begin);
+
+	// Names the calling thread in traces.
+	static void setThreadName(const gkString& name);
+
+	GK_INLINE static bool isActive(void) { return m_active; }
+
+
+	// Closes the frame, rolling up everything recorded since the last call.
+	void nextFrame(void);
+
+	GK_INLINE const Rollups& getLastFrame(void) const   { return m_last; }
+	GK_INLINE UTuint64 getLastFrameTime(void) const     { return m_lastFrameTime; }
+	GK_INLINE UTsize getFrameCount(void) const          { return m_frame; }
+
+	// Rollup of a zone in the last frame, or null.
+	const Rollup* getLastRollup(const gkString& name) const;
+
+	// Spans lost to full buffers since startup.
+	UTsize getDroppedEvents(void);
+
+
+	// Keeps raw spans from the next frame on, up to maxEvents.
+	void beginCapture(UTsize maxEvents = 1 << 20);
+	void endCapture(void);
+
+	GK_INLINE bool isCapturing(void) const          { return m_capturing; }
+	GK_INLINE const Events& getCapture(void) const  { return m_capture; }
+
+	// Writes the capture as Chrome trace event JSON.
+	bool writeChromeTrace(const gkString& path);
+	void writeChromeTrace(gkString& out);
+
+private:
+	friend class gkProfileCollector;
+
+	gkProfileBuffer* getThreadBuffer(void);
+
+	gkCriticalSection   m_lock;
+	Buffers             m_buffers;
+	Rollups             m_current, m_last;
+	utArray<int>        m_slots;        // zone index to m_current slot, -1 if unseen
+	Events              m_capture;
+	UTsize              m_captureLimit;
+	utArray<UTsize>     m_captureThreads;
+	bool                m_capturing;
+	UTuint64            m_start, m_frameStart, m_lastFrameTime;
+	UTsize              m_frame;
+	int                 m_generation;
+
+	static bool         m_active;
+
+	UT_DECLARE_SINGLETON(gkProfiler);
+};
+
+
+// Times the enclosing block as one zone.
+class gkProfileScope
+{
+public:
+	GK_INLINE gkProfileScope(gkProfileZone* zone)
+		:   m_zone(gkProfiler::isActive() ? zone : 0)
+	{
+		if (m_zone)
+			m_begin = gkProfiler::enter();
+	}
+
+	GK_INLINE ~gkProfileScope()
+	{
+		if (m_zone)
+			gkProfiler::leave(m_zone, m_begin);
+	}
+
+private:
+	gkProfileZone*  m_zone;
+	UTuint64        m_begin;
+};
+
+
+#define GK_PROFILE_CAT_(a, b)  a ## b
+#define GK_PROFILE_CAT(a, b)   GK_PROFILE_CAT_(a, b)
+
+#ifdef OGREKIT_USE_PROFILER
+
+// Times the rest of the block under a string literal name.
+#define GK_PROFILE_SCOPE(name) \
+	static gkProfileZone* GK_PROFILE_CAT(gkProfileZone_, __LINE__) = gkProfileZone::get(name); \
+	gkProfileScope GK_PROFILE_CAT(gkProfileScope_, __LINE__)(GK_PROFILE_CAT(gkProfileZone_, __LINE__))
+
+// Times the rest of the block under an already resolved zone.
+#define GK_PROFILE_ZONE(zone) \
+	gkProfileScope GK_PROFILE_CAT(gkProfileScope_, __LINE__)(zone)
+
+// Spans crossing callbacks: mark the start into a UTuint64, record it later
+// on the same thread. Zones in between nest under the span.
+#define GK_PROFILE_MARK(var) \
+	var = gkProfiler::isActive() ? gkProfiler::enter() : 0
+
+#define GK_PROFILE_RECORD(name, var) \
+	do { if (var) { \
+		static gkProfileZone* GK_PROFILE_CAT(gkProfileZone_, __LINE__) = gkProfileZone::get(name); \
+		gkProfiler::leave(GK_PROFILE_CAT(gkProfileZone_, __LINE__), var); \
+		var = 0; \
+	} } while (0)
+
+#define GK_PROFILE_THREAD(name) gkProfiler::setThreadName(name)
+
+#else
+
+#define GK_PROFILE_SCOPE(name)
+#define GK_PROFILE_ZONE(zone)
+#define GK_PROFILE_MARK(var)
+#define GK_PROFILE_RECORD(name, var)
+#define GK_PROFILE_THREAD(name)
+
+#endif
+
+
+#endif//_gkProfiler_h_
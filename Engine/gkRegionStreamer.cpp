@@ -0,0 +1,449 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkRegionStreamer.h"
+#include "gkScene.h"
+#include "gkGameObject.h"
+#include "gkEntity.h"
+#include "gkMesh.h"
+#include "gkCamera.h"
+#include "gkEngine.h"
+#include "gkUserDefs.h"
+#include "gkLogger.h"
+#include "OgreMeshManager.h"
+
+#include <algorithm>
+
+
+
+struct gkRegionLoadEntry
+{
+	gkScalar    distance;
+	UTsize      cell;
+
+	bool operator < (const gkRegionLoadEntry& o) const { return distance < o.distance; }
+};
+
+
+
+gkRegionStreamer::gkRegionStreamer(gkScene* scene, int mode, gkScalar cellSize, gkScalar loadRadius, gkScalar unloadRadius)
+	:    m_scene(scene),
+	     m_mode(mode),
+	     m_cellSize(gkMax<gkScalar>(cellSize, 1.f)),
+	     m_loadRadius(loadRadius),
+	     m_unloadRadius(gkMax<gkScalar>(loadRadius, unloadRadius)),
+	     m_focus(0),
+	     m_loads(0),
+	     m_unloads(0),
+	     m_lastLoadMs(0),
+	     m_maxLoadMs(0),
+	     m_totalLoadMs(0)
+{
+}
+
+
+
+gkRegionStreamer::~gkRegionStreamer()
+{
+	UTsize i, j;
+	for (i = 0; i < m_cells.size(); ++i)
+	{
+		Cell* cell = m_cells[i];
+
+		// queued creates would outlive the scene
+		if (cell->state == CS_LOADING)
+		{
+			for (j = 0; j < cell->objects.size(); ++j)
+				cell->objects[j]->getInstanceCreator()->removeInstanceQueue(cell->objects[j]);
+		}
+
+		delete cell;
+	}
+}
+
+
+
+bool gkRegionStreamer::canStream(gkGameObject* obj, gkGameObjectSet& parents)
+{
+	if (obj->getType() != GK_ENTITY || obj == m_focus)
+		return false;
+
+	// inactive layers are not instanced at all
+	if (!(m_scene->getLayer() & obj->getLayer()))
+		return false;
+
+	if (obj->isGroupInstance() || obj->getLogicBricks())
+		return false;
+
+	gkGameObjectProperties& props = obj->getProperties();
+	if (!props.m_parent.empty() || parents.find(obj) != UT_NPOS)
+		return false;
+
+	if (props.m_physics.isLinkedToOther())
+		return false;
+
+	return obj->getEntity()->getEntityProperties().m_mesh != 0;
+}
+
+
+
+UTsize gkRegionStreamer::getCell(gkGameObject* obj, utHashTable<utIntHashKey, UTsize>& keys)
+{
+	int key = 0;
+
+	if (m_mode == RM_LAYERS)
+	{
+		// lowest layer the object is on
+		UTuint32 lay = obj->getLayer();
+		while (key < 31 && !(lay & (1 << key)))
+			++key;
+	}
+	else
+	{
+		// 16 bits a side, the grid wraps after 32768 cells
+		const gkVector3& pos = obj->getProperties().m_transform.loc;
+		int cx = (int)floor(pos.x / m_cellSize);
+		int cy = (int)floor(pos.y / m_cellSize);
+		key = ((cx & 0xFFFF) << 16) | (cy & 0xFFFF);
+	}
+
+	UTsize pos = keys.find(key);
+	if (pos != UT_NPOS)
+		return keys.at(pos);
+
+	Cell* cell = new Cell();
+	cell->state     = CS_UNLOADED;
+	cell->pending   = 0;
+	cell->requested = 0;
+
+	m_cells.push_back(cell);
+	keys.insert(key, m_cells.size() - 1);
+	return m_cells.size() - 1;
+}
+
+
+
+void gkRegionStreamer::build(void)
+{
+	gkGameObjectHashMap& objects = m_scene->getObjects();
+
+
+	// parents stay with the scene, children follow them
+	gkGameObjectSet parents;
+
+	gkGameObjectHashMap::Iterator pit = objects.iterator();
+	while (pit.hasMoreElements())
+	{
+		const gkString& pname = pit.getNext().second->getProperties().m_parent;
+		if (!pname.empty())
+		{
+			gkGameObject* pobj = m_scene->getObject(pname);
+			if (pobj)
+				parents.insert(pobj);
+		}
+	}
+
+
+	utHashTable<utIntHashKey, UTsize> keys;
+
+	gkGameObjectHashMap::Iterator it = objects.iterator();
+	while (it.hasMoreElements())
+	{
+		gkGameObject* obj = it.getNext().second;
+		if (!canStream(obj, parents))
+			continue;
+
+		UTsize index = getCell(obj, keys);
+		Cell* cell = m_cells[index];
+
+		cell->objects.push_back(obj);
+		m_cellOf.insert(obj, index);
+
+
+		// loaded transforms are in world space
+		const gkTransformState& trans = obj->getProperties().m_transform;
+		gkMesh* me = obj->getEntity()->getEntityProperties().m_mesh;
+
+		gkBoundingBox box = me->getBoundingBox();
+		if (box.isFinite())
+		{
+			box.transformAffine(trans.toMatrix());
+			cell->bounds.merge(box);
+		}
+		cell->bounds.merge(trans.loc);
+
+
+		if (cell->meshes.find(me) == UT_NPOS)
+		{
+			cell->meshes.push_back(me);
+
+			if (m_meshes.find(me) == UT_NPOS)
+			{
+				MeshRef ref = {0, 0};
+				m_meshes.insert(me, ref);
+			}
+		}
+	}
+
+	gkLogMessage("RegionStreamer: " << m_cellOf.size() << " objects of '" << m_scene->getName()
+	             << "' in " << m_cells.size() << " cells.");
+}
+
+
+
+bool gkRegionStreamer::getFocusPosition(gkVector3& pos)
+{
+	gkGameObject* focus = m_focus;
+	if (!focus)
+		focus = m_scene->getMainCamera();
+
+	if (!focus || !focus->isInstanced())
+		return false;
+
+	pos = focus->getWorldPosition();
+	return true;
+}
+
+
+
+void gkRegionStreamer::update(void)
+{
+	gkVector3 focus;
+	if (m_cells.empty() || !getFocusPosition(focus))
+		return;
+
+	gkScalar load   = m_loadRadius * m_loadRadius;
+	gkScalar unload = m_unloadRadius * m_unloadRadius;
+
+	utArray<gkRegionLoadEntry> toLoad;
+
+	UTsize i;
+	for (i = 0; i < m_cells.size(); ++i)
+	{
+		Cell* cell = m_cells[i];
+		gkScalar dist = cell->bounds.squaredDistance(focus);
+
+		if (cell->state == CS_UNLOADED)
+		{
+			if (dist <= load)
+			{
+				gkRegionLoadEntry e = {dist, i};
+				toLoad.push_back(e);
+			}
+		}
+		else if (dist > unload)
+			unloadCell(cell);
+	}
+
+	// nearest first through the queue
+	if (toLoad.size() > 1)
+		std::sort(toLoad.ptr(), toLoad.ptr() + toLoad.size());
+
+	for (i = 0; i < toLoad.size(); ++i)
+		loadCell(m_cells[toLoad[i].cell]);
+}
+
+
+
+void gkRegionStreamer::loadCell(Cell* cell)
+{
+	cell->state     = CS_LOADING;
+	cell->pending   = 0;
+	cell->requested = m_clock.getMicroseconds();
+
+	UTsize i;
+	for (i = 0; i < cell->meshes.size(); ++i)
+		m_meshes.get(cell->meshes[i])->cells++;
+
+	for (i = 0; i < cell->objects.size(); ++i)
+	{
+		gkGameObject* obj = cell->objects[i];
+		if (!obj->isInstanced())
+		{
+			cell->pending++;
+			obj->createInstance(true);
+		}
+	}
+
+	if (cell->pending == 0)
+		finishCell(cell);
+}
+
+
+
+void gkRegionStreamer::finishCell(Cell* cell)
+{
+	cell->state = CS_RESIDENT;
+
+	m_lastLoadMs   = (gkScalar)(m_clock.getMicroseconds() - cell->requested) / 1000.f;
+	m_maxLoadMs    = gkMax(m_maxLoadMs, m_lastLoadMs);
+	m_totalLoadMs += m_lastLoadMs;
+	m_loads++;
+}
+
+
+
+void gkRegionStreamer::unloadCell(Cell* cell)
+{
+	UTsize i;
+	for (i = 0; i < cell->objects.size(); ++i)
+	{
+		gkGameObject* obj = cell->objects[i];
+
+		if (cell->state == CS_LOADING)
+			obj->getInstanceCreator()->removeInstanceQueue(obj);
+
+		obj->destroyInstance();
+	}
+
+	cell->state   = CS_UNLOADED;
+	cell->pending = 0;
+	m_unloads++;
+
+	for (i = 0; i < cell->meshes.size(); ++i)
+	{
+		gkMesh* me = cell->meshes[i];
+		MeshRef* ref = m_meshes.get(me);
+
+		if (--ref->cells == 0 && ref->users == 0)
+			releaseMesh(me);
+	}
+}
+
+
+
+void gkRegionStreamer::releaseMesh(gkMesh* me)
+{
+	if (!gkEngine::getSingleton().getUserDefs().headless)
+	{
+		Ogre::MeshPtr omesh = Ogre::MeshManager::getSingleton().getByName(me->getResourceName().getName());
+		if (!omesh.isNull())
+			omesh->unload();
+	}
+
+	me->releaseTriMesh();
+}
+
+
+
+void gkRegionStreamer::notifyInstanceCreated(gkGameObject* obj)
+{
+	gkEntity* ent = obj->getEntity();
+
+	// parked clones never let go of their entity
+	if (ent && !obj->isParked())
+	{
+		MeshRef* ref = m_meshes.get(ent->getEntityProperties().m_mesh);
+		if (ref)
+			ref->users++;
+	}
+
+	UTsize pos = m_cellOf.find(obj);
+	if (pos != UT_NPOS)
+	{
+		Cell* cell = m_cells[m_cellOf.at(pos)];
+		if (cell->state == CS_LOADING && --cell->pending == 0)
+			finishCell(cell);
+	}
+}
+
+
+
+void gkRegionStreamer::notifyInstanceDestroyed(gkGameObject* obj)
+{
+	gkEntity* ent = obj->getEntity();
+	if (!ent || obj->isParked())
+		return;
+
+	gkMesh* me = ent->getEntityProperties().m_mesh;
+	MeshRef* ref = m_meshes.get(me);
+
+	if (ref && ref->users > 0 && --ref->users == 0 && ref->cells == 0)
+		releaseMesh(me);
+}
+
+
+
+void gkRegionStreamer::notifyObjectRemoved(gkGameObject* obj)
+{
+	if (obj == m_focus)
+		m_focus = 0;
+
+	UTsize pos = m_cellOf.find(obj);
+	if (pos == UT_NPOS)
+		return;
+
+	Cell* cell = m_cells[m_cellOf.at(pos)];
+	if (cell->state == CS_LOADING && !obj->isInstanced())
+	{
+		obj->getInstanceCreator()->removeInstanceQueue(obj);
+		if (--cell->pending == 0)
+			finishCell(cell);
+	}
+
+	cell->objects.erase(obj);
+	m_cellOf.remove(obj);
+}
+
+
+
+void gkRegionStreamer::getStats(Stats& stats)
+{
+	stats.cells           = m_cells.size();
+	stats.residentCells   = 0;
+	stats.loadingCells    = 0;
+	stats.residentObjects = 0;
+	stats.residentMeshes  = 0;
+
+	UTsize i;
+	for (i = 0; i < m_cells.size(); ++i)
+	{
+		Cell* cell = m_cells[i];
+		if (cell->state == CS_RESIDENT)
+		{
+			stats.residentCells++;
+			stats.residentObjects += cell->objects.size();
+		}
+		else if (cell->state == CS_LOADING)
+		{
+			stats.loadingCells++;
+			stats.residentObjects += cell->objects.size() - cell->pending;
+		}
+	}
+
+	for (i = 0; i < m_meshes.size(); ++i)
+	{
+		const MeshRef& ref = m_meshes.at(i);
+		if (ref.cells > 0 || ref.users > 0)
+			stats.residentMeshes++;
+	}
+
+	stats.loads      = m_loads;
+	stats.unloads    = m_unloads;
+	stats.lastLoadMs = m_lastLoadMs;
+	stats.maxLoadMs  = m_maxLoadMs;
+	stats.avgLoadMs  = m_loads ? m_totalLoadMs / (gkScalar)m_loads : 0.f;
+}
@@ -0,0 +1,149 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkRegionStreamer_h_
+#define _gkRegionStreamer_h_
+
+#include "gkCommon.h"
+#include "gkMathUtils.h"
+#include "OgreTimer.h"
+
+
+// Keeps only the parts of a large scene near a focus point instanced.
+//
+// Before the scene instances anything, its standalone entities (no parent,
+// no children, no logic, no physics links) are split into cells, one per
+// blender layer or one per square of an XY grid. The scene leaves them out of
+// its own instancing. Cells whose bounds come within the load radius of the
+// focus are queued for creation, nearest first, and resident cells past the
+// unload radius are destroyed again.
+//
+// Cell meshes are counted over the cells listing them and the instanced
+// entities drawing them. Once both are zero the Ogre mesh is unloaded and the
+// collision triangles freed, the mesh loader brings them back on demand.
+class gkRegionStreamer
+{
+public:
+
+	enum Mode
+	{
+		RM_NONE,
+		RM_LAYERS,
+		RM_GRID,
+	};
+
+	struct Stats
+	{
+		UTsize      cells;
+		UTsize      residentCells;
+		UTsize      loadingCells;
+		UTsize      residentObjects;
+		UTsize      residentMeshes; // cell meshes in use
+		UTsize      loads;
+		UTsize      unloads;
+		gkScalar    lastLoadMs;     // queued to fully instanced
+		gkScalar    avgLoadMs;
+		gkScalar    maxLoadMs;
+	};
+
+public:
+
+	gkRegionStreamer(gkScene* scene, int mode, gkScalar cellSize, gkScalar loadRadius, gkScalar unloadRadius);
+	~gkRegionStreamer();
+
+	void build(void);
+
+	GK_INLINE bool isStreamed(gkGameObject* obj) const { return m_cellOf.find(obj) != UT_NPOS; }
+
+	// Loads and unloads cells around the focus.
+	void update(void);
+
+	// Object the cells follow, the main camera when 0.
+	GK_INLINE void          setFocus(gkGameObject* obj) { m_focus = obj; }
+	GK_INLINE gkGameObject* getFocus(void)              { return m_focus; }
+
+	void notifyInstanceCreated(gkGameObject* obj);
+	void notifyInstanceDestroyed(gkGameObject* obj);
+	void notifyObjectRemoved(gkGameObject* obj);
+
+	void getStats(Stats& stats);
+
+	GK_INLINE UTsize getCellCount(void) const { return m_cells.size(); }
+
+private:
+
+	enum CellState
+	{
+		CS_UNLOADED,
+		CS_LOADING,
+		CS_RESIDENT,
+	};
+
+	struct Cell
+	{
+		gkBoundingBox       bounds;
+		gkGameObjectArray   objects;
+		utArray<gkMesh*>    meshes;
+		int                 state;
+		UTsize              pending;    // queued objects not yet instanced
+		unsigned long       requested;
+	};
+
+	struct MeshRef
+	{
+		UTsize  cells;      // loading or resident cells listing it
+		UTsize  users;      // instanced entities drawing it
+	};
+
+	typedef utArray<Cell*>                              Cells;
+	typedef utHashTable<utPointerHashKey, UTsize>       CellIndex;
+	typedef utHashTable<utPointerHashKey, MeshRef>      MeshRefs;
+
+	bool     canStream(gkGameObject* obj, gkGameObjectSet& parents);
+	UTsize   getCell(gkGameObject* obj, utHashTable<utIntHashKey, UTsize>& keys);
+	bool     getFocusPosition(gkVector3& pos);
+
+	void     loadCell(Cell* cell);
+	void     finishCell(Cell* cell);
+	void     unloadCell(Cell* cell);
+	void     releaseMesh(gkMesh* me);
+
+	gkScene*        m_scene;
+	int             m_mode;
+	gkScalar        m_cellSize;
+	gkScalar        m_loadRadius, m_unloadRadius;
+	gkGameObject*   m_focus;
+
+	Cells           m_cells;
+	CellIndex       m_cellOf;
+	MeshRefs        m_meshes;
+
+	UTsize          m_loads, m_unloads;
+	gkScalar        m_lastLoadMs, m_maxLoadMs, m_totalLoadMs;
+	Ogre::Timer     m_clock;
+};
+
+#endif//_gkRegionStreamer_h_
@@ -54,7 +54,7 @@ public:
 
 	bool initRTShaderSystem(const gkString& shaderLang, const gkString& shaderCachePath, bool hasFixedCapability);
 
-	GK_INLINE const utArray<gkResourceNameString> getResourceGroupList() { return m_groups; }
+	GK_INLINE const utArray<gkResourceNameString>& getResourceGroupList() { return m_groups; }
 
 	UT_DECLARE_SINGLETON(gkResourceGroupManager)
 };
@@ -48,22 +48,18 @@ gkResourceManager::~gkResourceManager()
 
 gkResource* gkResourceManager::getByName(const gkResourceName& name)
 {
-	gkResource* obCan = 0;
-	Resources::Iterator iter = m_resources.iterator();
-	while (iter.hasMoreElements())
-	{
-		gkResource* ob = iter.peekNextValue();
-		if (ob->getResourceName().isNameEqual(name))
-		{
-			if (ob->getResourceName().isGroupEqual(name))
-				return ob;
-			else if (name.isGroupEmpty())
-				obCan = ob;
-		}
+	gkResource** ob = m_nameIndex.get(NameKey(name));
+	if (ob)
+		return *ob;
 
-		iter.next();
+	// without a group, any group will do
+	if (name.isGroupEmpty())
+	{
+		NameEntry* entry = m_nameOnlyIndex.get(name.name);
+		if (entry)
+			return entry->first;
 	}
-	return obCan;
+	return 0;
 }
 
 
@@ -97,6 +93,7 @@ gkResource* gkResourceManager::create(const gkResourceName& name)
 	notifyResourceCreated(ob);
 
 	m_resources.insert(ob->getResourceHandle(), ob);
+	addToIndex(ob);
 	return ob;
 }
 
@@ -113,6 +110,7 @@ void gkResourceManager::destroy(const gkResourceHandle& handle)
 
 		notifyResourceDestroyed(res);
 		m_resources.remove(handle);
+		removeFromIndex(res);
 		delete res;
 	}
 }
@@ -127,6 +125,7 @@ void gkResourceManager::destroy(const gkResourceName& name)
 
 		notifyResourceDestroyed(res);
 		m_resources.remove(res->getResourceHandle());
+		removeFromIndex(res);
 		delete res;
 	}
 }
@@ -147,6 +146,8 @@ void gkResourceManager::destroyGroup(const gkResourceNameString& group)
 	Resources tmp;
 	tmp.reserve(m_resources.size());
 
+	utArray<gkResource*> dead;
+
 	Resources::Iterator iter = m_resources.iterator();
 	while (iter.hasMoreElements())
 	{
@@ -156,13 +157,18 @@ void gkResourceManager::destroyGroup(const gkResourceNameString& group)
 			ob->notifyResourceDestroying();
 			notifyResourceDestroyed(ob);
 
-			delete ob;
+			removeFromIndex(ob);
+			dead.push_back(ob);
 		}
 		else
 			tmp.insert(iter.peekNextKey(), ob);
 		iter.next();
 	}
 
+	// the index may still look at them until the whole group is out
+	for (UTsize i = 0; i < dead.size(); i++)
+		delete dead[i];
+
 	m_resources = tmp;
 }
 
@@ -185,6 +191,8 @@ void gkResourceManager::destroyAll(void)
 	}
 
 	m_resources.clear();
+	m_nameIndex.clear();
+	m_nameOnlyIndex.clear();
 }
 
 
@@ -239,3 +247,55 @@ bool gkResourceManager::exists(const gkResourceName& name)
 {
 	return getByName(name) != NULL;
 }
+
+
+void gkResourceManager::addToIndex(gkResource* res)
+{
+	const gkResourceName& name = res->getResourceName();
+	m_nameIndex.insert(NameKey(name), res);
+
+	NameEntry* entry = m_nameOnlyIndex.get(name.name);
+	if (entry)
+		entry->count++;
+	else
+	{
+		NameEntry first = { res, 1 };
+		m_nameOnlyIndex.insert(name.name, first);
+	}
+}
+
+
+void gkResourceManager::removeFromIndex(gkResource* res)
+{
+	const gkResourceName& name = res->getResourceName();
+	m_nameIndex.remove(NameKey(name));
+
+	NameEntry* entry = m_nameOnlyIndex.get(name.name);
+	if (!entry)
+		return;
+
+	if (--entry->count == 0)
+	{
+		m_nameOnlyIndex.remove(name.name);
+		return;
+	}
+
+	if (entry->first != res)
+		return;
+
+	// only names used in more than one group get here, pick another
+	// resource that is still indexed
+	entry->first = 0;
+
+	Resources::Iterator iter = m_resources.iterator();
+	while (iter.hasMoreElements() && !entry->first)
+	{
+		gkResource* ob = iter.getNext().second;
+		if (ob->getResourceName().isNameEqual(name))
+		{
+			gkResource** indexed = m_nameIndex.get(NameKey(ob->getResourceName()));
+			if (indexed && *indexed == ob)
+				entry->first = ob;
+		}
+	}
+}
@@ -52,6 +52,32 @@ public:
 
 	typedef utArray<ResourceListener*> Listeners;
 
+
+	// (name, group) key of the name index
+	class NameKey
+	{
+	public:
+		NameKey() {}
+		NameKey(const gkResourceName& name) : m_name(name.name), m_group(name.group) {}
+
+		GK_INLINE UThash hash(void) const                       { return (m_name.hash() * 16777619u) ^ m_group.hash(); }
+		GK_INLINE bool operator==(const NameKey& o) const       { return m_name == o.m_name && m_group == o.m_group; }
+		GK_INLINE bool operator!=(const NameKey& o) const       { return !(*this == o); }
+
+	private:
+		gkResourceNameString m_name, m_group;
+	};
+
+	// resources sharing a name across groups, for lookups without a group
+	struct NameEntry
+	{
+		gkResource* first;
+		UTsize      count;
+	};
+
+	typedef utHashTable<NameKey, gkResource*>                     NameIndex;
+	typedef utHashTable<gkResourceNameString, NameEntry>          NameOnlyIndex;
+
 public:
 
 	gkResourceManager(const gkString& type, const gkString& rtype);
@@ -113,7 +139,12 @@ protected:
 
 
 private:
+	void addToIndex(gkResource* res);
+	void removeFromIndex(gkResource* res);
+
 	gkResourceHandle m_resourceHandles;
+	NameIndex        m_nameIndex;
+	NameOnlyIndex    m_nameOnlyIndex;
 };
 
 
@@ -52,7 +52,13 @@
 #include "gkDebugger.h"
 #include "gkMeshManager.h"
 #include "Thread/gkActiveObject.h"
-#include "gkStats.h"
+#include "gkProfiler.h"
+#include "gkStageGraph.h"
+#include "gkSceneContext.h"
+#include "gkTransformSnapshot.h"
+#include "gkTransformStore.h"
+#include "gkSpatialHash.h"
+#include "gkRegionStreamer.h"
 #include "gkUtils.h"
 
 #include "gkConstraintManager.h"
@@ -82,11 +88,14 @@
 #endif
 #include "Physics/gkGhost.h"
 #include "gkValue.h"
+#include "gkVariable.h"
 #include "OgreEntity.h"
 #include "gkBone.h"
 #include "OgreTagPoint.h"
 #include "gkCurve.h"
 
+#include <algorithm>
+
 using Ogre::TagPoint;
 
 //using namespace Ogre;
@@ -108,6 +117,9 @@ gkScene::gkScene(gkInstancedManager* creator, const gkResourceName& name, const
 	     m_hasLights(false),
 	     m_markDBVT(false),
 	     m_cloneCount(0),
+	     m_prewarmPending(false),
+	     m_streaming(false),
+	     m_streamTotal(0),
 	     m_layers(0xFFFFFFFF),
 	     m_skybox(0),
 		 m_window(0),
@@ -115,7 +127,16 @@ gkScene::gkScene(gkInstancedManager* creator, const gkResourceName& name, const
 		 m_blendFile(0),
 	     m_renderToViewport(true),
 	     m_zorder(0),
-	     m_logicBrickManager(0)
+	     m_logicBrickManager(0),
+	     m_stages(0),
+	     m_detachedStamp(0),
+	     m_cullPending(false),
+	     m_transforms(0),
+	     m_spatial(0),
+	     m_regions(0),
+	     m_snapshot(0),
+	     m_simulationRoot(0),
+	     m_physicsAhead(false)
 #ifdef OGREKIT_USE_PROCESSMANAGER
 		,m_processManager(0)
 #endif
@@ -400,6 +421,10 @@ void gkScene::_eraseObject(gkGameObject* gobj)
 		return;
 	}
 
+	cancelQueuedInstance(gobj);
+	if (m_regions)
+		m_regions->notifyObjectRemoved(gobj);
+
 	gobj->destroyInstance();
 	gobj->setOwner(0);
 
@@ -473,6 +498,7 @@ void gkScene::removeObject(gkGameObject* gobj)
 		return;
 	}
 
+	cancelQueuedInstance(gobj);
 	gobj->destroyInstance();
 }
 
@@ -487,6 +513,10 @@ void gkScene::destroyObject(gkGameObject* gobj)
 	}
 
 
+	cancelQueuedInstance(gobj);
+	if (m_regions)
+		m_regions->notifyObjectRemoved(gobj);
+
 	gobj->destroyInstance();
 	m_objects.remove(name);
 	gkGameObjectManager::getSingleton().destroy(gobj);
@@ -510,9 +540,9 @@ int gkScene::getSceneManagerType(void)
 
 void gkScene::setHorizonColor(const gkColor& col)
 {
-	if (isInstanced())
+	if (isInstanced() && m_viewport)
 	{
-		GK_ASSERT(m_manager && m_viewport);
+		GK_ASSERT(m_manager);
 		m_viewport->getViewport()->setBackgroundColour(col);
 	}
 	else
@@ -532,9 +562,9 @@ const gkColor& gkScene::getHorizonColor(void)
 
 void gkScene::setZenithColor(const gkColor& col)
 {
-	if (isInstanced())
+	if (isInstanced() && m_viewport)
 	{
-		GK_ASSERT(m_manager && m_viewport);
+		GK_ASSERT(m_manager);
 		m_viewport->getViewport()->setBackgroundColour(col);
 	}
 	else
@@ -659,6 +689,9 @@ void gkScene::setMainCamera(gkCamera* cam)
 	Ogre::Camera* main = m_startCam->getCamera();
 	GK_ASSERT(main);
 
+	// headless, nothing to render into
+	if (!getDisplayWindow()->getRenderWindow())
+		return;
 
 	if (!m_viewport)
 	{
@@ -807,6 +840,13 @@ void gkScene::_destroyPhysicsObject(gkGameObject* obj)
 	{
 		gkPhysicsController* phyCon = obj->getPhysicsController();
 
+		if (obj->isParked())
+		{
+			// stays attached, out of the world until the clone is reused
+			phyCon->suspend(true);
+			return;
+		}
+
 		obj->attachRigidBody(0);
 		obj->attachCharacter(0);
 		obj->attachGhost(0);
@@ -833,100 +873,131 @@ void gkScene::_destroyPhysicsObject(gkGameObject* obj)
 
 
 
+void gkScene::_resumePhysicsObject(gkGameObject* obj)
+{
+	GK_ASSERT(obj && obj->isParked() && m_physicsWorld);
+
+	gkPhysicsController* phyCon = obj->getPhysicsController();
+	if (!phyCon)
+		return;
+
+	phyCon->suspend(false);
+	phyCon->updateTransform();
+
+	gkRigidBody* body = obj->getAttachedBody();
+	if (body && body->getBody())
+	{
+		// starts at rest, like a new clone
+		btRigidBody* rb = body->getBody();
+		rb->setLinearVelocity(btVector3(0, 0, 0));
+		rb->setAngularVelocity(btVector3(0, 0, 0));
+		rb->clearForces();
+		rb->setInterpolationWorldTransform(rb->getWorldTransform());
+		rb->activate(true);
+	}
+}
+
+
+
 void gkScene::_applyBuiltinParents(gkGameObjectSet& instanceObjects)
 {
 	gkGameObjectSet::Iterator it = instanceObjects.iterator();
 	while (it.hasMoreElements())
-	{
-		gkGameObject* gobj = it.getNext(), *pobj = 0;
+		_applyBuiltinParent(it.getNext());
+}
 
-		GK_ASSERT(gobj->isInstanced());
 
-		const gkHashedString pname = gobj->getProperties().m_parent;
 
-		if (!pname.str().empty())
-			pobj = findInstancedObject(pname.str());
+void gkScene::_applyBuiltinParent(gkGameObject* gobj)
+{
+	gkGameObject* pobj = 0;
 
-		if (pobj)
-		{
+	GK_ASSERT(gobj->isInstanced());
 
-			if (gobj->getProperties().hasBoneParent())
-			{
-				int boneParent = 0;
+	const gkHashedString pname = gobj->getProperties().m_parent;
+
+	if (!pname.str().empty())
+		pobj = findInstancedObject(pname.str());
+
+	if (pobj)
+	{
+
+		if (gobj->getProperties().hasBoneParent())
+		{
+			int boneParent = 0;
 
-				GK_ASSERT(pobj->getType()==GK_SKELETON);
+			GK_ASSERT(pobj->getType()==GK_SKELETON);
 
-				gkSkeleton* skel = static_cast<gkSkeleton*>(pobj);
-				gkBone* parentBone = skel->getBone(gobj->getProperties().m_boneParent);
+			gkSkeleton* skel = static_cast<gkSkeleton*>(pobj);
+			gkBone* parentBone = skel->getBone(gobj->getProperties().m_boneParent);
 
 
-				parentBone->attachObject(gobj);
+			parentBone->attachObject(gobj);
 
-				// if the skeleton is attached to an entity parent the attached obj to the entity
-				// due to calculation of the proper delta-translation between the bone and the attached-object
-				gkGameObject* parentTo = skel->getController()?
-													static_cast<gkGameObject*>(skel->getController())
-													:static_cast<gkGameObject*>(skel);
+			// if the skeleton is attached to an entity parent the attached obj to the entity
+			// due to calculation of the proper delta-translation between the bone and the attached-object
+			gkGameObject* parentTo = skel->getController()?
+												static_cast<gkGameObject*>(skel->getController())
+												:static_cast<gkGameObject*>(skel);
 
-				parentTo->addChild(gobj);
-				gkMatrix4 omat, pmat;
+			parentTo->addChild(gobj);
+			gkMatrix4 omat, pmat;
 
-				gobj->getProperties().m_transform.toMatrix(omat);
-				parentTo->getProperties().m_transform.toMatrix(pmat);
-				omat = pmat.inverse() * omat;
+			gobj->getProperties().m_transform.toMatrix(omat);
+			parentTo->getProperties().m_transform.toMatrix(pmat);
+			omat = pmat.inverse() * omat;
 
-				gkTransformState st;
-				gkMathUtils::extractTransform(omat, st.loc, st.rot, st.scl);
+			gkTransformState st;
+			gkMathUtils::extractTransform(omat, st.loc, st.rot, st.scl);
 
 
-				// apply
-				gobj->setTransform(st);
+			// apply
+			gobj->setTransform(st);
 
 //  calculate the delta-position to the bone to keep the distance :D
-				if (!gobj->_getBoneTransform())
-				{
+			if (!gobj->_getBoneTransform())
+			{
 
-					gkMatrix4 objMat = st.toMatrix();
-					gkBone* bone = skel->getBone(gobj->getProperties().m_boneParent);
+				gkMatrix4 objMat = st.toMatrix();
+				gkBone* bone = skel->getBone(gobj->getProperties().m_boneParent);
 
-					// get the transformation of this bone in restposition (you have to save all animations
-					// that should be attached in rest position
-					gkMatrix4 boneMat = bone->getRestTransform();
-					gkMatrix4 objInBoneSpace = boneMat.inverse() * objMat ;
-					gkTransformState* ts = new gkTransformState(objInBoneSpace);
-					gobj->_setBoneTransform(ts);
+				// get the transformation of this bone in restposition (you have to save all animations
+				// that should be attached in rest position
+				gkMatrix4 boneMat = bone->getRestTransform();
+				gkMatrix4 objInBoneSpace = boneMat.inverse() * objMat ;
+				gkTransformState* ts = new gkTransformState(objInBoneSpace);
+				gobj->_setBoneTransform(ts);
 
-				}
-				continue;
 			}
+			return;
+		}
 
 
-			pobj->addChild(gobj);
-			const gkTransformState& gobjTrans = gobj->getProperties().m_transform;
-			const gkTransformState& pobjTrans = pobj->getProperties().m_transform;
+		pobj->addChild(gobj);
+		const gkTransformState& gobjTrans = gobj->getProperties().m_transform;
+		const gkTransformState& pobjTrans = pobj->getProperties().m_transform;
 
-			gkLogger::write("GObj:"+gobj->getName()+" Pos:"+gkToString(gobj->getPosition()));
+		gkLogger::write("GObj:"+gobj->getName()+" Pos:"+gkToString(gobj->getPosition()));
 
-			gkLogger::write("PObj:"+pobj->getName()+" Pos:"+gkToString(pobj->getPosition()));
+		gkLogger::write("PObj:"+pobj->getName()+" Pos:"+gkToString(pobj->getPosition()));
 
-			// m_transform no longer contains
-			// parent information, we must do it here.
+		// m_transform no longer contains
+		// parent information, we must do it here.
 
 
-			gkMatrix4 omat, pmat;
+		gkMatrix4 omat, pmat;
 
-			gobj->getProperties().m_transform.toMatrix(omat);
-			pobj->getProperties().m_transform.toMatrix(pmat);
+		gobj->getProperties().m_transform.toMatrix(omat);
+		pobj->getProperties().m_transform.toMatrix(pmat);
 
-			omat = pmat.inverse() * omat;
+		omat = pmat.inverse() * omat;
 
-			gkTransformState st;
-			gkMathUtils::extractTransform(omat, st.loc, st.rot, st.scl);
+		gkTransformState st;
+		gkMathUtils::extractTransform(omat, st.loc, st.rot, st.scl);
 
-			// apply
-			gobj->setTransform(st);
+		// apply
+		gobj->setTransform(st);
 
-		}
 	}
 }
 
@@ -985,6 +1056,10 @@ void gkScene::setLayer(UTuint32 v)
 		{
 			gkGameObject* gobj = it.getNext().second;
 
+			// loaded by distance instead
+			if (m_regions && m_regions->isStreamed(gobj))
+				continue;
+
 			if (gobj->getLayer() & m_layers)
 			{
 				if (!gobj->isInstanced())
@@ -992,6 +1067,7 @@ void gkScene::setLayer(UTuint32 v)
 			}
 			else
 			{
+				cancelQueuedInstance(gobj);
 				if (gobj->isInstanced())
 					gobj->destroyInstance(true);
 			}
@@ -1022,7 +1098,31 @@ void gkScene::createInstanceImpl(void)
 	Ogre::RTShader::ShaderGenerator::getSingleton().addSceneManager(m_manager);
 #endif
 
-	m_skybox  = gkMaterialLoader::loadSceneSkyMaterial(this, m_baseProps.m_material);
+	gkUserDefs& defs = gkEngine::getSingleton().getUserDefs();
+
+	if (!defs.headless)
+		m_skybox  = gkMaterialLoader::loadSceneSkyMaterial(this, m_baseProps.m_material);
+
+	m_transforms = new gkTransformStore();
+
+	if (defs.spatialCellSize > 0)
+		m_spatial = new gkSpatialHash(defs.spatialCellSize, m_transforms);
+
+	if (defs.regionStreaming != gkRegionStreamer::RM_NONE)
+	{
+		m_regions = new gkRegionStreamer(this, defs.regionStreaming, defs.regionCellSize,
+		                                 defs.regionLoadRadius, defs.regionUnloadRadius);
+		m_regions->build();
+	}
+
+	if (defs.pipelined || defs.interpolate)
+	{
+		m_snapshot = new gkTransformSnapshot();
+
+		// objects simulate off the rendered tree, Ogre draws their proxies
+		if (!defs.headless)
+			m_simulationRoot = m_manager->createSceneNode(m_name.getName() + "_Simulation");
+	}
 
 
 
@@ -1030,27 +1130,32 @@ void gkScene::createInstanceImpl(void)
 	(void)getDynamicsWorld();
 
 
-	gkGameObjectHashMap::Iterator it = m_objects.iterator();
-	while (it.hasMoreElements())
+	if (defs.instanceBudget > 0)
+		beginInstanceStream();
+	else
 	{
-		gkGameObject* gobj = it.getNext().second;
-
-		if (!gobj->isInstanced())
+		gkGameObjectHashMap::Iterator it = m_objects.iterator();
+		while (it.hasMoreElements())
 		{
-			// Skip creation of inactive layers
-			if (m_layers & gobj->getLayer())
+			gkGameObject* gobj = it.getNext().second;
+
+			if (!gobj->isInstanced() && !(m_regions && m_regions->isStreamed(gobj)))
 			{
-				// call builder
-				gobj->createInstance();
+				// Skip creation of inactive layers
+				if (m_layers & gobj->getLayer())
+				{
+					// call builder
+					gobj->createInstance();
+				}
 			}
 		}
-	}
 
-	// Build groups.
-	gkGroupManager::getSingleton().createGameObjectInstances(this);
+		// Build groups.
+		gkGroupManager::getSingleton().createGameObjectInstances(this);
 
-	if (gkEngine::getSingleton().getUserDefs().buildStaticGeometry)
-		gkGroupManager::getSingleton().createStaticBatches(this);
+		if (defs.buildStaticGeometry && !defs.headless)
+			gkGroupManager::getSingleton().createStaticBatches(this);
+	}
 
 
 	gkGameObjectSet objs;
@@ -1096,17 +1201,18 @@ void gkScene::createInstanceImpl(void)
 		}
 	}
 
-	GK_ASSERT(m_viewport);
+	GK_ASSERT(m_viewport || defs.headless);
 
-	m_viewport->getViewport()->setBackgroundColour(m_baseProps.m_material.m_horizon);
+	if (m_viewport)
+		m_viewport->getViewport()->setBackgroundColour(m_baseProps.m_material.m_horizon);
 	m_manager->setAmbientLight(m_baseProps.m_material.m_ambient);
 
 
 
 
 #if OGRE_NO_VIEWPORT_ORIENTATIONMODE == 0
-	const gkString& iparam = gkEngine::getSingleton().getUserDefs().viewportOrientation;
-	if (!iparam.empty())
+	const gkString& iparam = defs.viewportOrientation;
+	if (m_viewport && !iparam.empty())
 	{
 		int oparam = Ogre::OR_PORTRAIT;
 		if (iparam == "landscaperight") //viewport orientation is reversed.
@@ -1157,6 +1263,21 @@ void gkScene::createInstanceImpl(void)
 
 #endif
 
+	// scenes ticking side by side rely on the graph's shared stage locking
+	if (defs.parallelStages || defs.parallelScenes)
+		createStageGraph();
+
+	// parenting and setup moved the objects
+	m_transforms->update();
+	m_transforms->syncNodes();
+
+	if (m_snapshot)
+	{
+		// first frame renders the loaded hierarchy
+		m_snapshot->capture(this);
+		m_snapshot->publish();
+	}
+
 	// notify main scene
 	gkEngine::getSingleton().registerActiveScene(this);
 }
@@ -1164,12 +1285,214 @@ void gkScene::createInstanceImpl(void)
 
 void gkScene::postCreateInstanceImpl(void)
 {
+	// streamed scenes finish in update
+	if (!m_streaming)
+		notifySceneInstanced();
+}
+
+
+
+void gkScene::notifySceneInstanced(void)
+{
+	// clones need a fully created scene, see update
+	m_prewarmPending = true;
+
 #ifdef OGREKIT_USE_LUA
 	gkLuaScript* script = gkLuaManager::getSingleton().getByName<gkLuaScript>(gkResourceName(DEFAULT_STARTUP_LUA_FILE, getGroupName()));
 
 	if (script)
 		script->execute();
 #endif
+
+	UTsize i;
+	for (i = 0; i < m_listeners.size(); ++i)
+		m_listeners[i]->notifySceneInstanced(this);
+}
+
+
+
+void gkScene::addListener(Listener* li)
+{
+	if (m_listeners.find(li) == UT_NPOS)
+		m_listeners.push_back(li);
+}
+
+
+
+void gkScene::removeListener(Listener* li)
+{
+	if (m_listeners.find(li) != UT_NPOS)
+		m_listeners.erase(li);
+}
+
+
+
+gkScalar gkScene::getInstanceProgress(void)
+{
+	if (!isInstanced())
+		return 0.f;
+
+	if (!m_streaming || m_streamTotal == 0)
+		return 1.f;
+
+	return (gkScalar)(m_streamTotal - m_streamPending.size()) / (gkScalar)m_streamTotal;
+}
+
+
+
+struct gkSceneStreamEntry
+{
+	gkScalar      distance;
+	gkGameObject* object;
+
+	bool operator < (const gkSceneStreamEntry& o) const { return distance < o.distance; }
+};
+
+
+
+void gkScene::instanceWithParent(gkGameObject* gobj, bool queue)
+{
+	if (gobj->isInstanced() || m_streamPending.find(gobj) != UT_NPOS)
+		return;
+
+	const gkHashedString& pname = gobj->getProperties().m_parent;
+	if (!pname.str().empty())
+	{
+		gkGameObject* pobj = getObject(pname);
+		if (pobj && pobj != gobj && (m_layers & pobj->getLayer()))
+			instanceWithParent(pobj, queue);
+	}
+
+	if (queue)
+	{
+		m_streamPending.insert(gobj);
+		gobj->createInstance(true);
+	}
+	else
+		gobj->createInstance();
+}
+
+
+
+void gkScene::beginInstanceStream(void)
+{
+	utArray<gkSceneStreamEntry> order;
+	order.reserve(m_objects.size());
+
+	gkGameObjectHashMap::Iterator it = m_objects.iterator();
+	while (it.hasMoreElements())
+	{
+		gkGameObject* gobj = it.getNext().second;
+
+		if (gobj->isInstanced() || !(m_layers & gobj->getLayer()))
+			continue;
+
+		if (m_regions && m_regions->isStreamed(gobj))
+			continue;
+
+		// the viewport needs its camera now
+		if (gobj->getType() == GK_CAMERA)
+			instanceWithParent(gobj, false);
+		else
+		{
+			gkSceneStreamEntry e = {0.f, gobj};
+			order.push_back(e);
+		}
+	}
+
+
+	gkCamera* eye = m_startCam;
+	if (!eye && !m_cameras.empty())
+		eye = m_cameras.at(0);
+
+	// loaded transforms are in world space
+	gkVector3 eyePos = eye ? eye->getProperties().m_transform.loc : gkVector3::ZERO;
+
+	UTsize i;
+	for (i = 0; i < order.size(); ++i)
+		order[i].distance = eyePos.squaredDistance(order[i].object->getProperties().m_transform.loc);
+
+	if (!order.empty())
+		std::sort(order.ptr(), order.ptr() + order.size());
+
+
+	m_streaming = true;
+	for (i = 0; i < order.size(); ++i)
+		instanceWithParent(order[i].object, true);
+
+	m_streamTotal = m_streamPending.size();
+}
+
+
+
+void gkScene::updateInstanceStream(void)
+{
+	UTsize i;
+	for (i = 0; i < m_streamArrived.size(); ++i)
+	{
+		gkGameObject* gobj = m_streamArrived[i];
+		if (gobj->isInstanced())
+			_applyBuiltinParent(gobj);
+	}
+
+	for (i = 0; i < m_streamArrived.size(); ++i)
+	{
+		gkGameObject* gobj = m_streamArrived[i];
+		if (!gobj->isInstanced() || !gobj->getProperties().isPhysicsObject())
+			continue;
+
+		_createPhysicsObject(gobj);
+
+		// the linked object may still be queued
+		if (gobj->getProperties().m_physics.isLinkedToOther())
+			m_streamLinked.push_back(gobj);
+	}
+
+	m_streamArrived.clear(true);
+
+	if (m_streamPending.empty())
+		endInstanceStream();
+}
+
+
+
+void gkScene::endInstanceStream(void)
+{
+	m_streaming = false;
+
+	UTsize i;
+	for (i = 0; i < m_streamLinked.size(); ++i)
+	{
+		if (m_streamLinked[i]->isInstanced())
+			_postCreatePhysicsObject(m_streamLinked[i]);
+	}
+	m_streamLinked.clear();
+
+	// Build groups.
+	gkGroupManager::getSingleton().createGameObjectInstances(this);
+
+	gkUserDefs& defs = gkEngine::getSingleton().getUserDefs();
+	if (defs.buildStaticGeometry && !defs.headless)
+		gkGroupManager::getSingleton().createStaticBatches(this);
+
+	notifySceneInstanced();
+}
+
+
+
+void gkScene::cancelQueuedInstance(gkGameObject* gobj)
+{
+	if (!m_streaming)
+		return;
+
+	if (m_streamPending.find(gobj) != UT_NPOS)
+	{
+		m_streamPending.erase(gobj);
+		gobj->getInstanceCreator()->removeInstanceQueue(gobj);
+	}
+
+	m_streamArrived.erase(gobj);
+	m_streamLinked.erase(gobj);
 }
 
 
@@ -1180,6 +1503,25 @@ void gkScene::destroyInstanceImpl(void)
 	//if (m_objects.empty())
 	//	return;
 
+	// cancels its queued cells
+	delete m_regions;
+	m_regions = 0;
+
+	if (m_streaming)
+	{
+		gkGameObjectSet::Iterator pit = m_streamPending.iterator();
+		while (pit.hasMoreElements())
+		{
+			gkGameObject* gobj = pit.getNext();
+			gobj->getInstanceCreator()->removeInstanceQueue(gobj);
+		}
+
+		m_streamPending.clear();
+		m_streamArrived.clear();
+		m_streamLinked.clear();
+		m_streaming = false;
+	}
+
 	if (m_navMeshData.get())
 		m_navMeshData->destroyInstances();
 
@@ -1197,7 +1539,8 @@ void gkScene::destroyInstanceImpl(void)
 
 
 	// Destroy all batched geometry
-	if (gkEngine::getSingleton().getUserDefs().buildStaticGeometry)
+	gkUserDefs& defs = gkEngine::getSingleton().getUserDefs();
+	if (defs.buildStaticGeometry && !defs.headless)
 		gkGroupManager::getSingleton().destroyStaticBatches(this);
 
 
@@ -1215,12 +1558,33 @@ void gkScene::destroyInstanceImpl(void)
 	m_instanceObjects.clear(true);
 
 
+	if (m_stages)
+	{
+		delete m_stages;
+		m_stages = 0;
+	}
+	nextDetachedStamp();
+
+	if (m_snapshot)
+	{
+		delete m_snapshot;
+		m_snapshot = 0;
+	}
+	m_simulationRoot = 0;
+	m_physicsAhead = false;
+
 	// Free cloned.
 	destroyClones();
 
 	// Remove any pending
 	endObjects();
 
+	delete m_spatial;
+	m_spatial = 0;
+
+	delete m_transforms;
+	m_transforms = 0;
+
 
 	if (m_physicsWorld)
 	{
@@ -1316,7 +1680,7 @@ void gkScene::setShadows()
 {
 	gkUserDefs& defs = gkEngine::getSingleton().getUserDefs();
 
-	if (defs.enableshadows && defs.hasFixedCapability)
+	if (defs.enableshadows && defs.hasFixedCapability && !defs.headless)
 	{
 		Ogre::ShadowTechnique shadowTechnique = ::ParseShadowTechnique(defs.shadowtechnique);
 		m_manager->setShadowTechnique(shadowTechnique);
@@ -1331,6 +1695,10 @@ void gkScene::notifyInstanceCreated(gkGameObject* gobj)
 	bool result = m_instanceObjects.insert(gobj);
 	UT_ASSERT(result);
 
+	bool streamed = m_streaming && m_streamPending.find(gobj) != UT_NPOS;
+	if (streamed)
+		m_streamPending.erase(gobj);
+
 
 	// Tell constraints
 	if (m_constraintManager)
@@ -1342,9 +1710,22 @@ void gkScene::notifyInstanceCreated(gkGameObject* gobj)
 	if (m_navMeshData.get())
 		m_navMeshData->updateOrCreate(gobj);
 
+	if (m_spatial)
+		m_spatial->track(gobj);
+
+	if (m_regions)
+		m_regions->notifyInstanceCreated(gobj);
+
 
 	// apply physics
-	if (!isBeingCreated())
+	if (gobj->isParked())
+		_resumePhysicsObject(gobj);
+	else if (streamed)
+	{
+		// parented once it is done creating, see updateInstanceStream
+		m_streamArrived.push_back(gobj);
+	}
+	else if (!isBeingCreated())
 	{
 		_createPhysicsObject(gobj);
 		_postCreatePhysicsObject(gobj);
@@ -1362,6 +1743,9 @@ void gkScene::notifyInstanceDestroyed(gkGameObject* gobj)
 {
 	m_instanceObjects.erase(gobj);
 
+	if (m_snapshot)
+		m_snapshot->remove(gobj);
+
 
 	// Tell constraints
 	if (m_constraintManager)
@@ -1371,6 +1755,12 @@ void gkScene::notifyInstanceDestroyed(gkGameObject* gobj)
 	if (m_navMeshData.get())
 		m_navMeshData->destroyInstance(gobj);
 
+	if (m_spatial)
+		m_spatial->remove(gobj);
+
+	if (m_regions)
+		m_regions->notifyInstanceDestroyed(gobj);
+
 	// destroy physics
 	_destroyPhysicsObject(gobj);
 
@@ -1414,12 +1804,10 @@ void gkScene::destroyClones(void)
 {
 	if (!m_clones.empty())
 	{
-		gkGameObjectArray::Pointer buffer = m_clones.ptr();
-		size_t size = m_clones.size();
-		size_t i = 0;
-		while (i < size)
+		gkGameObjectSet::Iterator it = m_clones.iterator();
+		while (it.hasMoreElements())
 		{
-			gkGameObject* obj = buffer[i++];
+			gkGameObject* obj = it.getNext();
 			obj->destroyInstance();
 			delete obj;
 		}
@@ -1428,36 +1816,59 @@ void gkScene::destroyClones(void)
 	}
 	if (!m_tickClones.empty())
 	{
-		gkGameObjectArray::Pointer buffer = m_tickClones.ptr();
-		size_t size = m_tickClones.size();
-		size_t i = 0;
-		while (i < size)
+		gkGameObjectSet::Iterator it = m_tickClones.iterator();
+		while (it.hasMoreElements())
 		{
-			gkGameObject* obj = buffer[i++];
+			gkGameObject* obj = it.getNext();
 			obj->destroyInstance();
 			delete obj;
 		}
 
 		m_tickClones.clear();
 	}
+
+	destroyClonePools();
 	m_cloneCount = 0;
 }
 
 
 
+void gkScene::destroyClonePools(void)
+{
+	utHashTableIterator<ClonePools> it(m_clonePools);
+	while (it.hasMoreElements())
+	{
+		ClonePool* pool = it.getNext().second;
+
+		for (UTsize i = 0; i < pool->parked.size(); i++)
+		{
+			gkGameObject* obj = pool->parked[i];
+
+			// suspended bodies are out of the world already,
+			// nodes and movables go with the scene manager
+			if (obj->getPhysicsController() && m_physicsWorld)
+				m_physicsWorld->destroyObject(obj->getPhysicsController());
+
+			delete obj;
+		}
+
+		delete pool;
+	}
+
+	m_clonePools.clear();
+}
+
+
+
 
 void gkScene::tickClones(void)
 {
 	if (!m_tickClones.empty())
 	{
-		gkGameObjectArray::Pointer buffer = m_tickClones.ptr();
-		UTsize size = m_tickClones.size();
-		UTsize i = 0;
-
-
-		while (i < size)
+		gkGameObjectSet::Iterator it = m_tickClones.iterator();
+		while (it.hasMoreElements())
 		{
-			gkGameObject* obj = buffer[i++];
+			gkGameObject* obj = it.getNext();
 			gkGameObject::LifeSpan& life = obj->getLifeSpan();
 
 			if ((life.tick++) > life.timeToLive)
@@ -1469,23 +1880,173 @@ void gkScene::tickClones(void)
 
 
 
-gkGameObject* gkScene::cloneObject(gkGameObject* obj, int lifeSpan, bool instantiate)
+gkScene::ClonePool* gkScene::getClonePool(gkGameObject* source)
 {
+	UTsize pos = m_clonePools.find(source);
+	if (pos != UT_NPOS)
+		return m_clonePools.at(pos);
 
-	gkGameObject* nobj = obj->clone(gkUtils::getUniqueName(obj->getName()));
-	nobj->setActiveLayer(true);
+	ClonePool* pool = new ClonePool();
+	pool->limit = (UTsize)gkEngine::getSingleton().getUserDefs().clonePoolSize;
+	memset(&pool->stats, 0, sizeof(CloneStats));
 
-	gkGameObject::LifeSpan life = {0, lifeSpan};
-	nobj->setLifeSpan(life);
+	m_clonePools.insert(source, pool);
+	return pool;
+}
+
+
+
+bool gkScene::canParkClone(gkGameObject* obj)
+{
+	if (isBeingDestroyed() || !obj->getCloneSource())
+		return false;
+
+	// only the plain cases come back to the exact same state
+	if (obj->getType() != GK_ENTITY && obj->getType() != GK_OBJECT)
+		return false;
+
+	if (!obj->isInstanced() && !obj->isParked())
+		return false;
+
+	if (obj->isGroupInstance() || obj->hasParent() || !obj->getChildren().empty())
+		return false;
+
+	if (obj->getEntity() && obj->getEntity()->getSkeleton())
+		return false;
+
+	if (obj->getProperties().m_physics.hasPhysicsConstraint())
+		return false;
+
+	gkPhysicsController* phyCon = obj->getPhysicsController();
+	return !phyCon || !phyCon->isStaticObject();
+}
+
+
+
+bool gkScene::parkClone(gkGameObject* obj)
+{
+	if (!canParkClone(obj))
+		return false;
+
+	ClonePool* pool = getClonePool(obj->getCloneSource());
+	if (pool->parked.size() >= pool->limit)
+		return false;
+
+	if (m_clones.find(obj) != UT_NPOS)
+		m_clones.erase(obj);
+	else if (m_tickClones.find(obj) != UT_NPOS)
+		m_tickClones.erase(obj);
+	else
+		return obj->isParked(); // ended twice
+
+	obj->park();
+
+	pool->parked.push_back(obj);
+	pool->stats.parked = pool->parked.size();
+	pool->stats.peakParked = gkMax(pool->stats.peakParked, pool->stats.parked);
+	return true;
+}
+
+
+
+void gkScene::prewarmClones(gkGameObject* obj, UTsize count)
+{
+	GK_ASSERT(obj && isInstanced());
+
+	ClonePool* pool = getClonePool(obj);
+	if (pool->limit < count)
+		pool->limit = count;
+
+	while (pool->parked.size() < count)
+	{
+		gkGameObject* nobj = obj->clone(gkUtils::getUniqueName(obj->getName()));
+		nobj->setActiveLayer(true);
+
+		if (nobj->getOwner() != this)
+			nobj->setOwner(this);
+
+		m_clones.insert(nobj);
+		nobj->createInstance();
+
+		if (!parkClone(nobj))
+		{
+			_unloadAndDestroy(nobj);
+			break;
+		}
+	}
+}
+
+
+
+void gkScene::prewarmClonePools(void)
+{
+	gkGameObjectHashMap::Iterator it = m_objects.iterator();
+	while (it.hasMoreElements())
+	{
+		gkGameObject* obj = it.getNext().second;
+
+		gkVariable* prewarm = obj->getVariable("gk_prewarm");
+		if (prewarm && prewarm->getValueInt() > 0)
+			prewarmClones(obj, (UTsize)prewarm->getValueInt());
+	}
+}
+
+
+
+void gkScene::getCloneStats(CloneStats& stats, gkGameObject* source)
+{
+	memset(&stats, 0, sizeof(CloneStats));
+
+	utHashTableIterator<ClonePools> it(m_clonePools);
+	while (it.hasMoreElements())
+	{
+		ClonePools::Entry& pair = it.getNext();
+		if (source && pair.first.key() != source)
+			continue;
+
+		const CloneStats& ps = pair.second->stats;
+		stats.spawned    += ps.spawned;
+		stats.recycled   += ps.recycled;
+		stats.parked     += ps.parked;
+		stats.peakParked += ps.peakParked;
+	}
+}
+
+
+
+
+gkGameObject* gkScene::cloneObject(gkGameObject* obj, int lifeSpan, bool instantiate)
+{
+	ClonePool* pool = getClonePool(obj);
+	pool->stats.spawned++;
+
+	gkGameObject* nobj;
+	if (!pool->parked.empty())
+	{
+		// reuse a parked clone, it only needs a new transform
+		nobj = pool->parked.back();
+		pool->parked.pop_back();
+		pool->stats.parked = pool->parked.size();
+		pool->stats.recycled++;
+
+		nobj->_recycleClone();
+	}
+	else
+		nobj = obj->clone(gkUtils::getUniqueName(obj->getName()));
+
+	nobj->setActiveLayer(true);
+
+	gkGameObject::LifeSpan life = {0, lifeSpan};
+	nobj->setLifeSpan(life);
 
 
 	if (nobj->getOwner() != this)
 		nobj->setOwner(this);
 
 	if (lifeSpan > 0)
-		m_tickClones.push_back(nobj);
+		m_tickClones.insert(nobj);
 	else
-		m_clones.push_back(nobj);
+		m_clones.insert(nobj);
 	
 
 	if (instantiate)
@@ -1515,30 +2076,26 @@ void gkScene::_unloadAndDestroy(gkGameObject* gobj)
 	if (!gobj)
 		return;
 
+	if (gobj->isClone() && parkClone(gobj))
+		return;
+
 	gobj->destroyInstance();
 
-	UTsize it;
 	if (gobj->isClone())
 	{
-		if ((it = m_clones.find(gobj)) != UT_NPOS)
+		if (m_clones.find(gobj) != UT_NPOS)
 		{
-			m_clones.erase(it);
+			m_clones.erase(gobj);
 			UT_ASSERT(!gobj->isGroupInstance());
 
 			delete gobj;
-
-			if (m_clones.empty())
-				m_tickClones.clear(true);
 		}
-		else if ((it = m_tickClones.find(gobj)) != UT_NPOS)
+		else if (m_tickClones.find(gobj) != UT_NPOS)
 		{
-			m_tickClones.erase(it);
+			m_tickClones.erase(gobj);
 			UT_ASSERT(!gobj->isGroupInstance());
 
 			delete gobj;
-
-			if (m_tickClones.empty())
-				m_tickClones.clear(true);
 		}
 		else
 		{
@@ -1581,7 +2138,7 @@ void gkScene::removeAnimationUpdate(gkGameObject* obj)
 
 
 
-void gkScene::updateObjectsAnimations(const gkScalar tick)
+void gkScene::updateObjectsAnimations(const gkScalar tick, int filter)
 {
 	gkScalar animtick = tick;
 	
@@ -1589,14 +2146,31 @@ void gkScene::updateObjectsAnimations(const gkScalar tick)
 	if (animtick > 0.1f)
 		animtick = 0.016667f;
 	
+	if (filter == AF_DETACHED)
+	{
+		// taken in updateStages, logic running alongside may add to m_updateAnimObjects
+		for (UTsize i = 0; i < m_detachedAnimUpdates.size(); ++i)
+		{
+			gkGameObject* gobj = m_detachedAnimUpdates[i];
+			if (gobj->isInstanced())
+				gobj->updateAnimationBlender(animtick);
+		}
+		return;
+	}
+
 	if (!m_updateAnimObjects.empty())
 	{
 		gkGameObjectSet::Iterator it = m_updateAnimObjects.iterator();
 		while (it.hasMoreElements())
 		{
 			gkGameObject* gobj = it.getNext();
-			if (gobj && gobj->isInstanced())
-				gobj->updateAnimationBlender(animtick);
+			if (!gobj || !gobj->isInstanced())
+				continue;
+
+			if (filter != AF_ALL && isDetached(gobj) != (filter == AF_DETACHED))
+				continue;
+
+			gobj->updateAnimationBlender(animtick);
 		}
 
 
@@ -1617,7 +2191,10 @@ void gkScene::beginFrame(void)
 	endObjects();
 
 	GK_ASSERT(m_physicsWorld);
-	m_physicsWorld->resetContacts();
+
+	// contacts of a step taken ahead are already this frame's
+	if (!m_physicsAhead)
+		m_physicsWorld->resetContacts();
 
 #ifdef OGREKIT_OPENAL_SOUND
 
@@ -1638,88 +2215,445 @@ void gkScene::update(gkScalar tickRate)
 
 	GK_ASSERT(m_physicsWorld);
 
-	// update simulation
-	if (m_updateFlags & UF_PHYSICS)
 	{
-		gkStats::getSingleton().startClock();
-		m_physicsWorld->step(tickRate);
-		gkStats::getSingleton().stopPhysicsClock();
-	}
+		// instancing reaches the resource and message managers
+		gkSceneContext::SharedScope shared;
 
+		if (m_streaming)
+			updateInstanceStream();
 
-	// update logic bricks
-	if (m_updateFlags & UF_LOGIC_BRICKS)
+		if (m_regions)
+		{
+			GK_PROFILE_SCOPE("Regions");
+			m_regions->update();
+		}
+
+		if (m_prewarmPending)
+		{
+			m_prewarmPending = false;
+			prewarmClonePools();
+		}
+	}
+
+	if (m_stages)
 	{
-		gkStats::getSingleton().startClock();
-		m_logicBrickManager->update(tickRate);
-		gkStats::getSingleton().stopLogicBricksClock();
+		updateStages(tickRate);
 	}
+	else
+	{
+		// update simulation
+		if (m_updateFlags & UF_PHYSICS)
+		{
+			GK_PROFILE_SCOPE("Physics");
+			stepPhysics(tickRate);
+		}
+
+
+		// update logic bricks
+		if (m_updateFlags & UF_LOGIC_BRICKS)
+		{
+			GK_PROFILE_SCOPE("LogicBricks");
+			updateLogicBricks(tickRate);
+		}
 
 #ifdef OGREKIT_USE_PROCESSMANAGER
-	if (m_processManager && m_updateFlags & UF_PROCESS)
+		if (m_processManager && m_updateFlags & UF_PROCESS)
+		{
+			GK_PROFILE_SCOPE("Process");
+			updateProcesses(tickRate);
+		}
+#endif
+
+#ifdef OGREKIT_USE_NNODE
+		// update node trees
+		if (m_updateFlags & UF_NODE_TREES)
+		{
+			GK_PROFILE_SCOPE("NodeTrees");
+			updateNodeTrees(tickRate);
+		}
+#endif
+
+		// update animations
+		if (m_updateFlags & UF_ANIMATIONS)
+		{
+			GK_PROFILE_SCOPE("Animations");
+			updateObjectsAnimations(tickRate);
+		}
+
+
+#ifdef OGREKIT_OPENAL_SOUND
+		// update sound manager.
+		if (m_updateFlags & UF_SOUNDS)
+		{
+			GK_PROFILE_SCOPE("Sounds");
+			gkSoundManager::getSingleton().update(this);
+		}
+#endif
+
+		if (m_updateFlags & UF_DBVT)
+		{
+			GK_PROFILE_SCOPE("Dbvt");
+			if (m_markDBVT)
+			{
+				m_markDBVT = false;
+				m_physicsWorld->handleDbvt(m_startCam);
+			}
+		}
+
+		if (m_updateFlags & UF_DEBUG)
+			drawDebug(tickRate);
+	}
+
+
 	{
-		gkStats::getSingleton().startClock();
-		m_processManager->update(tickRate);
-		gkStats::getSingleton().stopProcessClock();
+		// same as above, destroying objects touches engine wide managers
+		gkSceneContext::SharedScope shared;
+
+		// tick life span
+		tickClones();
+
+
+		// Free any
+		endObjects();
+	}
+
+
+	// compose the world transforms once and hand them to Ogre
+	{
+		GK_PROFILE_SCOPE("Transforms");
+		m_transforms->update();
+		m_transforms->syncNodes();
 	}
+
+	if (m_spatial)
+		m_spatial->invalidate();
+}
+
+
+
+void gkScene::stepPhysics(gkScalar tick)
+{
+	// sensors look at the stepped positions
+	if (m_spatial)
+		m_spatial->invalidate();
+
+	if (m_physicsAhead)
+	{
+		// simulated while the last frame was drawn, debug lines are
+		// only safe to emit from here
+		m_physicsAhead = false;
+		m_physicsWorld->drawDebugWorld();
+		return;
+	}
+
+	m_physicsWorld->step(tick);
+}
+
+
+void gkScene::stepPhysicsAhead(gkScalar tick)
+{
+	// still ahead when the last tick skipped physics
+	if (!isInstanced() || !(m_updateFlags & UF_PHYSICS) || m_physicsAhead)
+		return;
+
+	m_physicsWorld->resetContacts();
+	m_physicsWorld->step(tick, false);
+	m_physicsAhead = true;
+}
+
+
+Ogre::SceneNode* gkScene::getObjectRoot(void)
+{
+	GK_ASSERT(m_manager);
+	return m_simulationRoot ? m_simulationRoot : m_manager->getRootSceneNode();
+}
+
+
+void gkScene::updateLogicBricks(gkScalar tick)
+{
+	m_logicBrickManager->update(tick);
+}
+
+
+void gkScene::updateProcesses(gkScalar tick)
+{
+#ifdef OGREKIT_USE_PROCESSMANAGER
+	if (m_processManager)
+		m_processManager->update(tick);
 #endif
+}
 
+
+void gkScene::updateNodeTrees(gkScalar tick)
+{
 #ifdef OGREKIT_USE_NNODE
-	// update node trees
-	if (m_updateFlags & UF_NODE_TREES)
+	gkNodeManager::getSingleton().update(tick);
+#endif
+}
+
+
+void gkScene::updateAttachedAnimations(gkScalar tick)
+{
+	updateObjectsAnimations(tick, AF_ATTACHED);
+}
+
+
+void gkScene::updateDetachedAnimations(gkScalar tick)
+{
+	updateObjectsAnimations(tick, AF_DETACHED);
+}
+
+
+void gkScene::updateSoundListener(gkScalar tick)
+{
+#ifdef OGREKIT_OPENAL_SOUND
+	if (m_startCam)
+		gkSoundManager::getSingleton().updateListener(m_listenerPos, m_listenerVel, m_listenerRot);
+#endif
+}
+
+
+void gkScene::updateSounds(gkScalar tick)
+{
+#ifdef OGREKIT_OPENAL_SOUND
+	gkSoundManager::getSingleton().collectGarbage();
+	gkSoundManager::getSingleton().drawDebug(this);
+#endif
+}
+
+
+void gkScene::updateDbvt(gkScalar tick)
+{
+	if (m_cullPending)
 	{
-		gkStats::getSingleton().startClock();
-		gkNodeManager::getSingleton().update(tickRate);
-		gkStats::getSingleton().stopLogicNodesClock();
+		m_cullPending = false;
+		m_physicsWorld->handleDbvt(m_cullPlanes);
 	}
-#endif
+}
 
-	// update animations
-	if (m_updateFlags & UF_ANIMATIONS)
+
+void gkScene::drawDebug(gkScalar tick)
+{
+	if (m_debugger)
 	{
-		gkStats::getSingleton().startClock();
-		updateObjectsAnimations(tickRate);
-		gkStats::getSingleton().stopAnimationsClock();
+		m_physicsWorld->DrawDebug();
+		m_debugger->flush();
 	}
+}
 
 
-#ifdef OGREKIT_OPENAL_SOUND
-	// update sound manager.
-	if (m_updateFlags & UF_SOUNDS)
+
+// Resources touched by the scene update stages.
+enum gkSceneStageResource
+{
+	SSR_PHYSICS     = 1 << 0,   // bullet world and broadphase
+	SSR_TRANSFORMS  = 1 << 1,   // scene nodes of attached objects
+	SSR_LOGIC       = 1 << 2,   // bricks, scripts, processes and node trees
+	SSR_ANIMATIONS  = 1 << 3,   // animation players of attached objects
+	SSR_POSES       = 1 << 4,   // everything owned by detached animated objects
+	SSR_SOUND       = 1 << 5,   // playing sources
+	SSR_LISTENER    = 1 << 6,
+	SSR_VISIBILITY  = 1 << 7,
+	SSR_DEBUG       = 1 << 8,
+
+	// logic can reach any attached object through actuators and scripts
+	SSR_SCENE       = SSR_PHYSICS | SSR_TRANSFORMS | SSR_LOGIC | SSR_ANIMATIONS |
+	                  SSR_SOUND | SSR_VISIBILITY | SSR_DEBUG,
+};
+
+
+class gkSceneStage : public gkStageGraph::Stage
+{
+public:
+	typedef void (gkScene::*Method)(gkScalar);
+
+	gkSceneStage(const gkString& name, UTuint32 reads, UTuint32 writes,
+	             gkScene* scene, Method method, UTuint32 flag, bool shared = false)
+		:   gkStageGraph::Stage(name, reads, writes),
+		    m_scene(scene), m_method(method), m_flag(flag), m_shared(shared),
+		    m_zone(gkProfileZone::get(name.c_str()))
 	{
-		gkStats::getSingleton().startClock();
-		gkSoundManager::getSingleton().update(this);
-		gkStats::getSingleton().stopSoundClock();
 	}
-#endif
 
-	if (m_updateFlags & UF_DBVT)
+	void update(gkScalar tick)
 	{
-		gkStats::getSingleton().startClock();
-		if (m_markDBVT)
+		if (!(m_scene->getUpdateFlags() & m_flag))
+			return;
+
+		// any job thread may pick this up, even one inside another scene
+		gkSceneContext context(m_scene);
+		GK_PROFILE_ZONE(m_zone);
+
+		if (m_shared)
 		{
-			m_markDBVT = false;
-			m_physicsWorld->handleDbvt(m_startCam);
+			gkSceneContext::SharedScope shared;
+			(m_scene->*m_method)(tick);
 		}
-		gkStats::getSingleton().stopDbvtClock();
+		else
+			(m_scene->*m_method)(tick);
+	}
+
+private:
+	gkScene*        m_scene;
+	Method          m_method;
+	UTuint32        m_flag;
+	bool            m_shared;   // reaches engine wide managers
+	gkProfileZone*  m_zone;
+};
+
+
+
+void gkScene::createStageGraph(void)
+{
+	GK_ASSERT(!m_stages);
+
+	m_stages = new gkStageGraph();
+
+	// serial order, stages wait only on earlier stages they conflict with
+	m_stages->addStage(new gkSceneStage("Physics", 0, SSR_PHYSICS | SSR_TRANSFORMS,
+		this, &gkScene::stepPhysics, UF_PHYSICS));
+
+	m_stages->addStage(new gkSceneStage("Poses", 0, SSR_POSES,
+		this, &gkScene::updateDetachedAnimations, UF_ANIMATIONS));
+
+	m_stages->addStage(new gkSceneStage("Listener", 0, SSR_LISTENER,
+		this, &gkScene::updateSoundListener, UF_SOUNDS, true));
+
+	m_stages->addStage(new gkSceneStage("LogicBricks", SSR_SCENE, SSR_SCENE,
+		this, &gkScene::updateLogicBricks, UF_LOGIC_BRICKS, true));
+
+	m_stages->addStage(new gkSceneStage("Process", SSR_SCENE, SSR_SCENE,
+		this, &gkScene::updateProcesses, UF_PROCESS, true));
+
+	m_stages->addStage(new gkSceneStage("NodeTrees", SSR_SCENE, SSR_SCENE,
+		this, &gkScene::updateNodeTrees, UF_NODE_TREES, true));
+
+	m_stages->addStage(new gkSceneStage("Animations", 0, SSR_ANIMATIONS | SSR_TRANSFORMS,
+		this, &gkScene::updateAttachedAnimations, UF_ANIMATIONS));
+
+	m_stages->addStage(new gkSceneStage("Sounds", 0, SSR_SOUND | SSR_DEBUG,
+		this, &gkScene::updateSounds, UF_SOUNDS, true));
+
+	m_stages->addStage(new gkSceneStage("Dbvt", SSR_PHYSICS, SSR_VISIBILITY,
+		this, &gkScene::updateDbvt, UF_DBVT));
+
+	m_stages->addStage(new gkSceneStage("Debug", SSR_PHYSICS, SSR_DEBUG,
+		this, &gkScene::drawDebug, UF_DEBUG));
+}
+
+
+
+bool gkScene::isDetachedAnimation(gkGameObject* obj)
+{
+	// object updates feed the navigation mesh
+	if (m_navMeshData.get())
+		return false;
+
+	if (obj->getLogicBricks() || obj->getPhysicsController())
+		return false;
+
+	gkGameObjectArray::Iterator it(obj->getChildren());
+	while (it.hasMoreElements())
+	{
+		if (!isDetachedAnimation(it.getNext()))
+			return false;
 	}
 
-	if (m_updateFlags & UF_DEBUG)
+	return true;
+}
+
+
+
+void gkScene::insertDetached(gkGameObject* obj)
+{
+	// the whole hierarchy goes with its root, children write into its node
+	obj->_setDetachedStamp(m_detachedStamp);
+
+	gkGameObjectArray::Iterator it(obj->getChildren());
+	while (it.hasMoreElements())
+		insertDetached(it.getNext());
+}
+
+
+
+bool gkScene::isDetached(gkGameObject* obj)
+{
+	return m_detachedStamp != 0 && obj->_getDetachedStamp() == m_detachedStamp;
+}
+
+
+
+void gkScene::nextDetachedStamp(void)
+{
+	// zero never matches, it is what objects start with
+	if (++m_detachedStamp == 0)
+		m_detachedStamp = 1;
+}
+
+
+
+void gkScene::updateStages(gkScalar tick)
+{
+	// Taken on this thread before anything runs, stages overlapping the
+	// logic see the state the previous frame was rendered with.
+
+	// a new stamp drops last frame's marks without walking the objects,
+	// some of which may have been destroyed since
+	nextDetachedStamp();
+	m_detachedAnimUpdates.clear(true);
+
+	if (m_updateFlags & UF_ANIMATIONS)
 	{
-		if (m_debugger)
+		bool detached = false;
+
+		gkGameObjectSet::Iterator it = m_updateAnimObjects.iterator();
+		while (it.hasMoreElements())
 		{
-			m_physicsWorld->DrawDebug();
-			m_debugger->flush();
+			gkGameObject* gobj = it.getNext();
+
+			if (gobj && gobj->isInstanced() && !gobj->getParent() && isDetachedAnimation(gobj))
+			{
+				insertDetached(gobj);
+				detached = true;
+			}
 		}
+
+		// the Poses stage walks this copy, not the set logic can insert into
+		if (detached)
+		{
+			gkGameObjectSet::Iterator upd = m_updateAnimObjects.iterator();
+			while (upd.hasMoreElements())
+			{
+				gkGameObject* gobj = upd.getNext();
+				if (gobj && isDetached(gobj))
+					m_detachedAnimUpdates.push_back(gobj);
+			}
+		}
+
+		// with the root flagged for a full update, moving its children
+		// no longer touches its pending update list from other threads
+		if (detached && m_manager)
+			m_manager->getRootSceneNode()->needUpdate();
 	}
 
+	if (m_startCam)
+	{
+		m_listenerPos = m_startCam->getWorldPosition();
+		m_listenerVel = m_startCam->getLinearVelocity();
+		m_listenerRot = m_startCam->getWorldOrientation();
 
-	// tick life span
-	tickClones();
+		if (m_markDBVT && (m_updateFlags & UF_DBVT))
+		{
+			const Ogre::Plane* planes = m_startCam->getCamera()->getFrustumPlanes();
+			for (int i = 0; i < 6; i++)
+				m_cullPlanes[i] = planes[i];
 
+			m_markDBVT = false;
+			m_cullPending = true;
+		}
+	}
 
-	// Free any
-	endObjects();
+	m_stages->run(tick);
 }
 
 #ifdef OGREKIT_USE_PROCESSMANAGER
@@ -45,9 +45,27 @@
 #endif
 
 class gkCurve;
+class gkStageGraph;
+class gkTransformSnapshot;
+class gkTransformStore;
+class gkSpatialHash;
+class gkRegionStreamer;
 
 class gkScene : public gkInstancedObject
 {
+public:
+
+	class Listener
+	{
+	public:
+		virtual ~Listener() {}
+
+		///Every object of the scene is instanced.
+		virtual void notifySceneInstanced(gkScene* scene) = 0;
+	};
+
+	typedef utArray<Listener*> Listeners;
+
 public:
 
 	gkScene(gkInstancedManager* creator, const gkResourceName& name, const gkResourceHandle& handle);
@@ -112,9 +130,36 @@ public:
 	void              endObject(gkGameObject* obj);
 
 
+	///Ended clones are parked per source object and handed out again by cloneObject,
+	///up to gkUserDefs::clonePoolSize each. Objects with a "gk_prewarm" int variable
+	///get that many parked clones before the first scene update.
+	struct CloneStats
+	{
+		UTsize spawned;     // cloneObject calls
+		UTsize recycled;    // spawns served from a pool
+		UTsize parked;      // clones waiting in the pools
+		UTsize peakParked;
+
+		gkScalar getHitRate(void) const { return spawned ? (gkScalar)recycled / (gkScalar)spawned : 0.f; }
+	};
+
+	void              prewarmClones(gkGameObject* obj, UTsize count);
+	void              getCloneStats(CloneStats& stats, gkGameObject* source = 0);
+
+
 	void              getGroups(gkGroupArray& groups);
 
 
+	///With gkUserDefs::instanceBudget set, cameras are instanced with the scene and the
+	///other objects stream in through the game object queue, nearest to the camera first.
+	///Groups, static batches and the startup script wait for the last of them.
+	GK_INLINE bool    isFullyInstanced(void)   { return isInstanced() && !m_streaming; }
+	gkScalar          getInstanceProgress(void);
+
+	void              addListener(Listener* li);
+	void              removeListener(Listener* li);
+
+
 	gkDebugger*       getDebugger(void);
 
 	GK_INLINE void    setNavMeshData(PNAVMESHDATA navMeshData) { m_navMeshData = navMeshData; }
@@ -187,12 +232,14 @@ public:
 	void setDisplayWindow(gkWindow* window, int zorder=0);
 
 	void _applyBuiltinParents(gkGameObjectSet& instanceObjects);
+	void _applyBuiltinParent(gkGameObject* obj);
 	void _applyBuiltinPhysics(gkGameObjectSet& instanceObjects);
 	
 	void _createPhysicsObject(gkGameObject* obj);
 	void _postCreatePhysicsObject(gkGameObject* obj);
 	void _createPhysicsConstraint(gkGameObject* obj);
 	void _destroyPhysicsObject(gkGameObject* obj);
+	void _resumePhysicsObject(gkGameObject* obj);
 
 	void _unloadAndDestroy(gkGameObject* obj);
 
@@ -223,6 +270,28 @@ public:
 
 	gkLogicManager* getLogicBrickManager(void)			{ return m_logicBrickManager; }
 
+
+	// Transforms of the instanced objects, see gkTransformStore
+	GK_INLINE gkTransformStore*    getTransformStore(void)  { return m_transforms; }
+
+	// Proximity queries over the instanced objects, null when disabled
+	GK_INLINE gkSpatialHash*       getSpatialHash(void)     { return m_spatial; }
+
+	// Cells of entities loaded around the camera, null when disabled
+	GK_INLINE gkRegionStreamer*    getRegionStreamer(void)  { return m_regions; }
+
+	// Pipelined rendering, see gkTransformSnapshot
+	GK_INLINE gkTransformSnapshot* getSnapshot(void)        { return m_snapshot; }
+	GK_INLINE bool                 hasRenderProxies(void)   { return m_simulationRoot != 0; }
+
+	///Parent node of unparented objects, kept out of the rendered tree
+	///when objects are drawn through proxies.
+	Ogre::SceneNode* getObjectRoot(void);
+
+	///Steps physics for the coming tick ahead of time, off the main thread.
+	///The tick's own physics step is then skipped.
+	void stepPhysicsAhead(gkScalar tick);
+
 #ifdef OGREKIT_USE_PROCESSMANAGER
 	gkProcessManager* getProcessManager(void);
 #endif
@@ -236,7 +305,55 @@ private:
 	void tickClones(void);
 	void destroyClones(void);
 	void endObjects(void);
-	void updateObjectsAnimations(const gkScalar tick);
+
+	struct ClonePool
+	{
+		gkGameObjectArray   parked;
+		UTsize              limit;
+		CloneStats          stats;
+	};
+	typedef utHashTable<utPointerHashKey, ClonePool*> ClonePools;
+
+	ClonePool* getClonePool(gkGameObject* source);
+	bool       canParkClone(gkGameObject* obj);
+	bool       parkClone(gkGameObject* obj);
+	void       destroyClonePools(void);
+	void       prewarmClonePools(void);
+
+	void       instanceWithParent(gkGameObject* obj, bool queue);
+	void       beginInstanceStream(void);
+	void       updateInstanceStream(void);
+	void       endInstanceStream(void);
+	void       cancelQueuedInstance(gkGameObject* obj);
+	void       notifySceneInstanced(void);
+
+	enum ANIMATION_FILTER
+	{
+		AF_ALL,
+		AF_ATTACHED,
+		AF_DETACHED,
+	};
+
+	void updateObjectsAnimations(const gkScalar tick, int filter = AF_ALL);
+
+	// parallel update stages, see gkStageGraph
+	void createStageGraph(void);
+	void updateStages(gkScalar tick);
+	bool isDetachedAnimation(gkGameObject* obj);
+	void insertDetached(gkGameObject* obj);
+	bool isDetached(gkGameObject* obj);
+	void nextDetachedStamp(void);
+
+	void stepPhysics(gkScalar tick);
+	void updateLogicBricks(gkScalar tick);
+	void updateProcesses(gkScalar tick);
+	void updateNodeTrees(gkScalar tick);
+	void updateAttachedAnimations(gkScalar tick);
+	void updateDetachedAnimations(gkScalar tick);
+	void updateSoundListener(gkScalar tick);
+	void updateSounds(gkScalar tick);
+	void updateDbvt(gkScalar tick);
+	void drawDebug(gkScalar tick);
 
 	Ogre::SceneManager*     m_manager;
 	gkCamera*               m_startCam;
@@ -252,9 +369,10 @@ private:
 	gkGameObjectSet         m_instanceObjects;
 
 
-	gkGameObjectArray       m_clones;
-	gkGameObjectArray       m_tickClones;
+	gkGameObjectSet         m_clones;
+	gkGameObjectSet         m_tickClones;
 	gkGameObjectSet         m_endObjects;
+	ClonePools              m_clonePools;
 	gkGameObjectSet         m_updateAnimObjects;
 	gkPhysicsControllerSet  m_staticControllers;
 	gkCameraSet             m_cameras;
@@ -267,6 +385,13 @@ private:
 	bool                    m_hasLights;
 	bool                    m_markDBVT;
 	int                     m_cloneCount;
+	bool                    m_prewarmPending;
+	bool                    m_streaming;
+	gkGameObjectSet         m_streamPending;    // queued, not yet instanced
+	gkGameObjectArray       m_streamArrived;    // instanced since the last update
+	gkGameObjectArray       m_streamLinked;     // physics links wait for the whole scene
+	UTsize                  m_streamTotal;
+	Listeners               m_listeners;
 	UTuint32                m_layers;
 	gkBoundingBox           m_limits;
 	PNAVMESHDATA            m_navMeshData;
@@ -280,6 +405,21 @@ private:
 
 	gkLogicManager*			m_logicBrickManager;
 
+	gkStageGraph*           m_stages;
+	UTuint32                m_detachedStamp;
+	gkGameObjectArray       m_detachedAnimUpdates;
+	gkVector3               m_listenerPos, m_listenerVel;
+	gkQuaternion            m_listenerRot;
+	Ogre::Plane             m_cullPlanes[6];
+	bool                    m_cullPending;
+
+	gkTransformStore*       m_transforms;
+	gkSpatialHash*          m_spatial;
+	gkRegionStreamer*       m_regions;
+	gkTransformSnapshot*    m_snapshot;
+	Ogre::SceneNode*        m_simulationRoot;
+	bool                    m_physicsAhead;
+
 #ifdef OGREKIT_USE_PROCESSMANAGER
 	gkProcessManager*		m_processManager;
 #endif
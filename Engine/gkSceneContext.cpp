@@ -0,0 +1,98 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkSceneContext.h"
+#include "Thread/gkThread.h"
+#include "Thread/gkJobSystem.h"
+
+
+static GK_THREAD_LOCAL gkScene* gkCurrentScene = 0;
+static bool gkScenesConcurrent = false;
+static gkCriticalSection gkSceneSharedLock;
+static GK_THREAD_LOCAL int gkSceneSharedDepth = 0;
+
+
+
+gkSceneContext::gkSceneContext(gkScene* scene)
+	:    m_previous(gkCurrentScene)
+{
+	gkCurrentScene = scene;
+}
+
+
+gkSceneContext::~gkSceneContext()
+{
+	gkCurrentScene = m_previous;
+}
+
+
+gkScene* gkSceneContext::getCurrent(void)
+{
+	return gkCurrentScene;
+}
+
+
+void gkSceneContext::setConcurrent(bool v)
+{
+	// only flipped on the main thread, outside of any scene update
+	gkScenesConcurrent = v;
+}
+
+
+bool gkSceneContext::isConcurrent(void)
+{
+	return gkScenesConcurrent;
+}
+
+
+gkCriticalSection& gkSceneContext::getSharedLock(void)
+{
+	return gkSceneSharedLock;
+}
+
+
+
+gkSceneContext::SharedScope::SharedScope()
+	:    m_locked(gkScenesConcurrent && gkSceneSharedDepth == 0)
+{
+	if (!m_locked)
+		return;
+
+	gkSceneSharedLock.BeginLock();
+	gkSceneSharedDepth++;
+	gkJobSystem::beginSerial();
+}
+
+
+gkSceneContext::SharedScope::~SharedScope()
+{
+	if (!m_locked)
+		return;
+
+	gkJobSystem::endSerial();
+	gkSceneSharedDepth--;
+	gkSceneSharedLock.EndLock();
+}
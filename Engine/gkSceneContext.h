@@ -0,0 +1,76 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkSceneContext_h_
+#define _gkSceneContext_h_
+
+#include "gkCommon.h"
+#include "Thread/gkCriticalSection.h"
+
+
+// Makes a scene current on the calling thread for the lifetime of the
+// object. gkEngine::getActiveScene, and with it every per scene manager
+// reached through it (gkLogicManager::getSingleton, node trees, scripts),
+// answers with the current scene of the asking thread, so scenes updated
+// side by side on different workers each see only themselves.
+class gkSceneContext
+{
+public:
+
+	gkSceneContext(gkScene* scene);
+	~gkSceneContext();
+
+	static gkScene* getCurrent(void);
+
+
+	// Set by the engine while several scenes tick at once. Work that
+	// reaches engine wide state (messages, sound, scripts) then runs
+	// under the shared lock.
+	static void setConcurrent(bool v);
+	static bool isConcurrent(void);
+
+	static gkCriticalSection& getSharedLock(void);
+
+
+	// Holds the shared lock while scenes tick concurrently, and nothing
+	// otherwise. Scopes nest on a thread. The holder waits on jobs without
+	// running any, a queued job could be another scene wanting the lock.
+	class SharedScope : gkNonCopyable
+	{
+	public:
+		SharedScope();
+		~SharedScope();
+
+	private:
+		bool m_locked;
+	};
+
+private:
+
+	gkScene* m_previous;
+};
+
+#endif//_gkSceneContext_h_
@@ -160,7 +160,14 @@ public:
 
 	gkTextureProperties& getTextureProp(int nr) { return m_textures[nr];}
 
+	// Loaders intern the name into m_symbol, others fall back to a string compare.
+	GK_INLINE bool isNamed(const gkHashedString& name) const
+	{
+		return m_symbol.empty() ? m_name == name.str() : m_symbol == name;
+	}
+
 	gkString                m_name;
+	gkHashedString          m_symbol;
 	unsigned int            m_mode;
 	int                     m_rblend;
 	gkColor                 m_diffuse;
@@ -64,7 +64,7 @@ void gkSkeleton::createInstanceImpl(void)
 	gkGameObject::createInstanceImpl();
 
 	if (m_baseProps.isInvisible())
-		m_node->setVisible(false);
+		setVisibleRecursive(false);
 }
 
 
@@ -0,0 +1,586 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkSpatialHash.h"
+#include "gkTransformStore.h"
+#include "gkGameObject.h"
+#include "gkEntity.h"
+#include "gkMesh.h"
+#include <math.h>
+
+
+static UTsize gkSpatialCellHash(int x, int y, int z)
+{
+	return (UTsize)(((UTuint32)x * 73856093u) ^ ((UTuint32)y * 19349663u) ^ ((UTuint32)z * 83492791u));
+}
+
+
+static gkScalar gkSpatialMaxScale(const gkVector3& s)
+{
+	return gkMax(gkAbs(s.x), gkMax(gkAbs(s.y), gkAbs(s.z)));
+}
+
+
+static bool gkSpatialAccept(gkGameObject* ob, const gkSpatialHash::Filter* filter)
+{
+	if (!filter)
+		return true;
+
+	if (ob == filter->exclude)
+		return false;
+
+	if (filter->physicsOnly && !ob->getPhysicsController())
+		return false;
+
+	if (!filter->prop.empty())
+		return ob->hasVariable(filter->prop);
+
+	if (!filter->material.empty())
+		return ob->hasSensorMaterial(filter->material);
+
+	return true;
+}
+
+
+
+// Query shapes against an entry's bounding sphere
+
+struct gkSpatialSphereTest
+{
+	gkVector3   center;
+	gkScalar    radius;
+
+	bool operator()(const gkVector3& p, gkScalar r) const
+	{
+		gkScalar d = radius + r;
+		return center.squaredDistance(p) <= d * d;
+	}
+};
+
+
+struct gkSpatialPointTest
+{
+	gkVector3   center;
+	gkScalar    radius;
+
+	bool operator()(const gkVector3& p, gkScalar) const
+	{
+		return center.squaredDistance(p) <= radius * radius;
+	}
+};
+
+
+struct gkSpatialBoxTest
+{
+	gkVector3   lo, hi;
+
+	bool operator()(const gkVector3& p, gkScalar r) const
+	{
+		gkVector3 q(gkClamp(p.x, lo.x, hi.x), gkClamp(p.y, lo.y, hi.y), gkClamp(p.z, lo.z, hi.z));
+		return q.squaredDistance(p) <= r * r;
+	}
+};
+
+
+struct gkSpatialConeTest
+{
+	gkVector3   apex, dir;
+	gkScalar    length, sinA, cosA;
+
+	bool operator()(const gkVector3& p, gkScalar r) const
+	{
+		gkVector3 v = p - apex;
+		gkScalar along = v.dotProduct(dir);
+		if (along < -r || along > length + r)
+			return false;
+
+		// distance to the side of the cone
+		gkScalar perp = (v - dir * along).length();
+		return perp * cosA - along * sinA <= r;
+	}
+};
+
+
+
+gkSpatialHash::gkSpatialHash(gkScalar cellSize, gkTransformStore* store)
+	:    m_cellSize(cellSize), m_invCellSize(1.f / cellSize), m_maxRadius(0), m_store(store),
+	     m_cells(0), m_capacity(0), m_cellsUsed(0), m_large(END),
+	     m_min(gkVector3::ZERO), m_max(gkVector3::ZERO), m_stale(true)
+{
+	GK_ASSERT(cellSize > 0);
+	rebuild(64);
+}
+
+
+gkSpatialHash::~gkSpatialHash()
+{
+	delete[] m_cells;
+}
+
+
+
+void gkSpatialHash::insert(gkGameObject* obj, const gkVector3& pos, gkScalar radius)
+{
+	GK_ASSERT(obj && !contains(obj));
+
+	UTsize i = m_entries.size();
+
+	Entry e = {pos, radius, obj, END};
+	m_entries.push_back(e);
+
+	Track t = {UT_NPOS, 0, END, radius, false};
+	m_tracks.push_back(t);
+
+	m_index.insert(obj, i);
+
+	if (i == 0)
+		m_min = m_max = pos;
+
+	m_min.makeFloor(pos);
+	m_max.makeCeil(pos);
+	link(i, cellOf(pos, radius, true));
+}
+
+
+
+void gkSpatialHash::move(gkGameObject* obj, const gkVector3& pos, gkScalar radius)
+{
+	UTsize at = m_index.find(obj);
+	if (at != UT_NPOS)
+		relocate(m_index.at(at), pos, radius);
+}
+
+
+
+void gkSpatialHash::remove(gkGameObject* obj)
+{
+	UTsize pos = m_index.find(obj);
+	if (pos == UT_NPOS)
+		return;
+
+	UTsize i = m_index.at(pos);
+	unlink(i);
+	m_index.remove(obj);
+
+	UTsize last = m_entries.size() - 1;
+	if (i != last)
+	{
+		// the last entry fills the hole
+		unlink(last);
+		m_entries[i] = m_entries[last];
+		m_tracks[i] = m_tracks[last];
+		link(i, m_tracks[i].cell);
+
+		m_index.at(m_index.find(m_entries[i].object)) = i;
+	}
+
+	m_entries.pop_back();
+	m_tracks.pop_back();
+}
+
+
+
+bool gkSpatialHash::contains(gkGameObject* obj) const
+{
+	return m_index.find(obj) != UT_NPOS;
+}
+
+
+
+void gkSpatialHash::track(gkGameObject* obj)
+{
+	gkScalar base = 0;
+
+	gkEntity* ent = obj->getEntity();
+	if (ent && ent->getEntityProperties().m_mesh)
+	{
+		const gkBoundingBox& box = ent->getEntityProperties().m_mesh->getBoundingBox();
+		if (box.isFinite())
+			base = gkMax(box.getMinimum().length(), box.getMaximum().length());
+	}
+
+	insert(obj, obj->getWorldPosition(), base * gkSpatialMaxScale(obj->getWorldScale()));
+
+	Track& t = m_tracks.back();
+	t.tracked = true;
+	t.baseRadius = base;
+	t.slot = m_store ? obj->getTransformSlot() : UT_NPOS;
+
+	if (t.slot != UT_NPOS)
+		t.stamp = m_store->getStamp(t.slot);
+}
+
+
+
+void gkSpatialHash::refresh(void)
+{
+	for (UTsize i = 0; i < m_entries.size(); i++)
+		refreshEntry(i);
+
+	m_stale = false;
+}
+
+
+
+void gkSpatialHash::refreshEntry(UTsize i)
+{
+	Track& t = m_tracks[i];
+	if (!t.tracked)
+		return;
+
+	gkVector3 pos, scl;
+	if (t.slot != UT_NPOS)
+	{
+		pos = m_store->getWorldPosition(t.slot);
+
+		UTuint32 stamp = m_store->getStamp(t.slot);
+		if (stamp == t.stamp)
+			return;
+
+		t.stamp = stamp;
+		scl = m_store->getWorldScale(t.slot);
+	}
+	else
+	{
+		gkGameObject* ob = m_entries[i].object;
+		pos = ob->getWorldPosition();
+		scl = ob->getWorldScale();
+	}
+
+	relocate(i, pos, t.baseRadius * gkSpatialMaxScale(scl));
+}
+
+
+
+void gkSpatialHash::relocate(UTsize i, const gkVector3& pos, gkScalar radius)
+{
+	Entry& e = m_entries[i];
+	e.pos = pos;
+	e.radius = radius;
+
+	m_min.makeFloor(pos);
+	m_max.makeCeil(pos);
+
+	int cell = cellOf(pos, radius, true);
+	if (cell != m_tracks[i].cell)
+	{
+		unlink(i);
+		link(i, cell);
+	}
+}
+
+
+
+int gkSpatialHash::cellOf(const gkVector3& pos, gkScalar radius, bool create)
+{
+	if (radius > m_cellSize)
+		return END;
+
+	if (create && radius > m_maxRadius)
+		m_maxRadius = radius;
+
+	int x = coord(pos.x), y = coord(pos.y), z = coord(pos.z);
+
+	int cell = findCell(x, y, z);
+	if (cell >= 0 || !create)
+		return cell;
+
+	if ((m_cellsUsed + 1) * 2 > m_capacity)
+	{
+		// grow, dropping the cells that emptied
+		UTsize live = 0;
+		for (UTsize c = 0; c < m_capacity; c++)
+			live += m_cells[c].head >= 0 ? 1 : 0;
+
+		UTsize capacity = 64;
+		while (capacity < (live + 1) * 4)
+			capacity <<= 1;
+
+		rebuild(capacity);
+	}
+
+	UTsize mask = m_capacity - 1;
+	UTsize c = gkSpatialCellHash(x, y, z) & mask;
+	while (m_cells[c].head != NO_CELL)
+		c = (c + 1) & mask;
+
+	Cell& nc = m_cells[c];
+	nc.x = x;
+	nc.y = y;
+	nc.z = z;
+	nc.head = END;
+
+	m_cellsUsed++;
+	return (int)c;
+}
+
+
+
+int gkSpatialHash::findCell(int x, int y, int z) const
+{
+	UTsize mask = m_capacity - 1;
+	UTsize c = gkSpatialCellHash(x, y, z) & mask;
+
+	for (;;)
+	{
+		const Cell& cell = m_cells[c];
+		if (cell.head == NO_CELL)
+			return -1;
+
+		if (cell.x == x && cell.y == y && cell.z == z)
+			return (int)c;
+
+		c = (c + 1) & mask;
+	}
+}
+
+
+
+void gkSpatialHash::link(UTsize i, int cell)
+{
+	int& head = cell == END ? m_large : m_cells[cell].head;
+
+	m_entries[i].next = head;
+	head = (int)i;
+	m_tracks[i].cell = cell;
+}
+
+
+
+void gkSpatialHash::unlink(UTsize i)
+{
+	int cell = m_tracks[i].cell;
+	int* next = cell == END ? &m_large : &m_cells[cell].head;
+
+	while (*next != (int)i)
+	{
+		GK_ASSERT(*next >= 0);
+		next = &m_entries[*next].next;
+	}
+
+	*next = m_entries[i].next;
+}
+
+
+
+void gkSpatialHash::rebuild(UTsize capacity)
+{
+	Cell* old = m_cells;
+	UTsize oldCapacity = m_capacity;
+
+	m_cells = new Cell[capacity];
+	m_capacity = capacity;
+	m_cellsUsed = 0;
+
+	for (UTsize c = 0; c < capacity; c++)
+		m_cells[c].head = NO_CELL;
+
+	UTsize mask = capacity - 1;
+	for (UTsize o = 0; o < oldCapacity; o++)
+	{
+		const Cell& oc = old[o];
+		if (oc.head < 0)
+			continue;
+
+		UTsize c = gkSpatialCellHash(oc.x, oc.y, oc.z) & mask;
+		while (m_cells[c].head != NO_CELL)
+			c = (c + 1) & mask;
+
+		m_cells[c] = oc;
+		m_cellsUsed++;
+
+		for (int i = oc.head; i >= 0; i = m_entries[i].next)
+			m_tracks[i].cell = (int)c;
+	}
+
+	delete[] old;
+}
+
+
+
+template <typename Test>
+UTsize gkSpatialHash::collectList(int head, const Test& test, Results& out, const Filter* filter)
+{
+	const Entry* entries = m_entries.ptr();
+	UTsize n = 0;
+
+	for (int i = head; i >= 0; i = entries[i].next)
+	{
+		const Entry& e = entries[i];
+		if (test(e.pos, e.radius) && gkSpatialAccept(e.object, filter))
+		{
+			out.push_back(e.object);
+			n++;
+		}
+	}
+
+	return n;
+}
+
+
+
+template <typename Test>
+UTsize gkSpatialHash::collect(const gkVector3& lo, const gkVector3& hi, const Test& test, Results& out, const Filter* filter)
+{
+	if (m_stale)
+		refresh();
+
+	int x0 = coord(lo.x), y0 = coord(lo.y), z0 = coord(lo.z);
+	int x1 = coord(hi.x), y1 = coord(hi.y), z1 = coord(hi.z);
+
+	UTsize n = 0;
+
+	gkScalar span = gkScalar(x1 - x0 + 1) * gkScalar(y1 - y0 + 1) * gkScalar(z1 - z0 + 1);
+	if (span > gkScalar(m_cellsUsed))
+	{
+		// fewer cells in use than in range
+		for (UTsize c = 0; c < m_capacity; c++)
+		{
+			const Cell& cell = m_cells[c];
+			if (cell.head < 0 ||
+			    cell.x < x0 || cell.x > x1 || cell.y < y0 || cell.y > y1 || cell.z < z0 || cell.z > z1)
+				continue;
+
+			n += collectList(cell.head, test, out, filter);
+		}
+	}
+	else
+	{
+		for (int z = z0; z <= z1; z++)
+		{
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					int c = findCell(x, y, z);
+					if (c >= 0)
+						n += collectList(m_cells[c].head, test, out, filter);
+				}
+			}
+		}
+	}
+
+	return n + collectList(m_large, test, out, filter);
+}
+
+
+
+UTsize gkSpatialHash::querySphere(const gkVector3& center, gkScalar radius, Results& out, const Filter* filter)
+{
+	gkSpatialSphereTest test = {center, radius};
+	gkVector3 reach(radius + m_maxRadius);
+
+	return collect(center - reach, center + reach, test, out, filter);
+}
+
+
+
+UTsize gkSpatialHash::queryBox(const gkBoundingBox& box, Results& out, const Filter* filter)
+{
+	if (box.isNull())
+		return 0;
+
+	gkSpatialBoxTest test = {box.getMinimum(), box.getMaximum()};
+	gkVector3 reach(m_maxRadius);
+
+	return collect(box.getMinimum() - reach, box.getMaximum() + reach, test, out, filter);
+}
+
+
+
+UTsize gkSpatialHash::queryCone(const gkVector3& apex, const gkVector3& dir, gkScalar length, gkScalar halfAngle,
+                                Results& out, const Filter* filter)
+{
+	gkSpatialConeTest test = {apex, dir, length, gkScalar(sin(halfAngle)), gkScalar(cos(halfAngle))};
+
+	// sphere around the cone
+	gkScalar base = length * gkScalar(tan(halfAngle));
+	gkScalar half = length * 0.5f;
+	gkVector3 reach(gkScalar(sqrt(half * half + base * base)) + m_maxRadius);
+	gkVector3 mid = apex + dir * half;
+
+	return collect(mid - reach, mid + reach, test, out, filter);
+}
+
+
+
+UTsize gkSpatialHash::queryNearest(const gkVector3& pos, UTsize k, Results& out, const Filter* filter, gkScalar maxDistance)
+{
+	if (m_stale)
+		refresh();
+
+	if (k == 0 || m_entries.empty())
+		return 0;
+
+	// nothing lies beyond the farthest corner of the centres seen
+	gkVector3 corner(gkMax(gkAbs(pos.x - m_min.x), gkAbs(pos.x - m_max.x)),
+	                 gkMax(gkAbs(pos.y - m_min.y), gkAbs(pos.y - m_max.y)),
+	                 gkMax(gkAbs(pos.z - m_min.z), gkAbs(pos.z - m_max.z)));
+
+	gkScalar limit = corner.length();
+	if (maxDistance > 0 && maxDistance < limit)
+		limit = maxDistance;
+
+	utSmallArray<gkGameObject*, 32> found;
+
+	// widen until k are in, any closer one is then among them
+	gkScalar radius = gkMin(m_cellSize, limit);
+	for (;;)
+	{
+		found.clear();
+
+		gkSpatialPointTest test = {pos, radius};
+		gkVector3 reach(radius);
+		collect(pos - reach, pos + reach, test, found, filter);
+
+		if (found.size() >= k || radius >= limit)
+			break;
+
+		radius = gkMin(radius * 2, limit);
+	}
+
+	utSmallArray<gkScalar, 32> dist;
+	for (UTsize i = 0; i < found.size(); i++)
+		dist.push_back(m_entries[m_index.at(m_index.find(found[i]))].pos.squaredDistance(pos));
+
+	UTsize n = gkMin(k, found.size());
+	for (UTsize i = 0; i < n; i++)
+	{
+		UTsize best = i;
+		for (UTsize j = i + 1; j < found.size(); j++)
+		{
+			if (dist[j] < dist[best])
+				best = j;
+		}
+
+		gkGameObject* ob = found[best];
+		found[best] = found[i];
+		dist[best] = dist[i];
+		out.push_back(ob);
+	}
+
+	return n;
+}
@@ -0,0 +1,167 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkSpatialHash_h_
+#define _gkSpatialHash_h_
+
+#include "gkCommon.h"
+#include "gkMathUtils.h"
+#include "gkHashedString.h"
+
+class gkTransformStore;
+
+
+// Uniform grid of a scene's instanced objects for proximity queries.
+//
+// Each object is filed under the cell holding its centre, as a bounding
+// sphere, in a linked list threaded through one dense entry array. Cells
+// live in an open addressed table keyed by their integer coordinates, so
+// a query only touches the cells its bounds overlap and the entries in
+// them. Objects larger than a cell go on a separate list every query
+// checks.
+//
+// Tracked objects follow their world transform on refresh(), which only
+// refiles the ones whose gkTransformStore stamp moved on.
+class gkSpatialHash
+{
+public:
+
+	struct Filter
+	{
+		Filter() : exclude(0), physicsOnly(false) {}
+
+		gkHashedString  prop;           // objects having this variable
+		gkHashedString  material;       // or this sensor material, when prop is empty
+		gkGameObject*   exclude;
+		bool            physicsOnly;    // objects with a physics controller
+	};
+
+	typedef utArray<gkGameObject*> Results;
+
+public:
+
+	gkSpatialHash(gkScalar cellSize, gkTransformStore* store = 0);
+	~gkSpatialHash();
+
+
+	void insert(gkGameObject* obj, const gkVector3& pos, gkScalar radius);
+	void move(gkGameObject* obj, const gkVector3& pos, gkScalar radius);
+	void remove(gkGameObject* obj);
+	bool contains(gkGameObject* obj) const;
+
+	// Inserts obj with the bounds of its entity, kept up to date by refresh().
+	void track(gkGameObject* obj);
+
+	// Refiles tracked objects that moved since the last refresh. Queries
+	// refresh first when the hash was invalidated.
+	void refresh(void);
+	GK_INLINE void invalidate(void)         { m_stale = true; }
+	GK_INLINE bool isStale(void) const      { return m_stale; }
+
+
+	// Queries append the matching objects to out and return how many.
+	UTsize querySphere(const gkVector3& center, gkScalar radius, Results& out, const Filter* filter = 0);
+	UTsize queryBox(const gkBoundingBox& box, Results& out, const Filter* filter = 0);
+
+	// Cone from apex along the unit dir, halfAngle in radians.
+	UTsize queryCone(const gkVector3& apex, const gkVector3& dir, gkScalar length, gkScalar halfAngle,
+	                 Results& out, const Filter* filter = 0);
+
+	// The k closest centres, nearest first. maxDistance 0 for no limit.
+	UTsize queryNearest(const gkVector3& pos, UTsize k, Results& out, const Filter* filter = 0,
+	                    gkScalar maxDistance = 0);
+
+
+	GK_INLINE gkScalar getCellSize(void) const  { return m_cellSize; }
+	GK_INLINE UTsize   getCount(void) const     { return m_entries.size(); }
+	GK_INLINE UTsize   getCellCount(void) const { return m_cellsUsed; }
+
+private:
+
+	enum { NO_CELL = -2, END = -1 };
+
+	// Read by queries, kept to half a cache line.
+	struct Entry
+	{
+		gkVector3       pos;
+		gkScalar        radius;
+		gkGameObject*   object;
+		int             next;
+	};
+
+	// Written by refresh only.
+	struct Track
+	{
+		UTsize          slot;
+		UTuint32        stamp;
+		int             cell;       // table index, END for the large list
+		gkScalar        baseRadius;
+		bool            tracked;
+	};
+
+	struct Cell
+	{
+		int x, y, z;
+		int head;                   // NO_CELL for a free table slot
+	};
+
+	typedef utArray<Entry>  Entries;
+	typedef utArray<Track>  Tracks;
+	typedef utHashTable<utPointerHashKey, UTsize> Index;
+
+	template <typename Test>
+	UTsize collectList(int head, const Test& test, Results& out, const Filter* filter);
+	template <typename Test>
+	UTsize collect(const gkVector3& lo, const gkVector3& hi, const Test& test, Results& out, const Filter* filter);
+
+	GK_INLINE int coord(gkScalar v) const { return (int)floor(v * m_invCellSize); }
+
+	int  cellOf(const gkVector3& pos, gkScalar radius, bool create);
+	int  findCell(int x, int y, int z) const;
+	void link(UTsize i, int cell);
+	void unlink(UTsize i);
+	void relocate(UTsize i, const gkVector3& pos, gkScalar radius);
+	void rebuild(UTsize capacity);
+	void refreshEntry(UTsize i);
+
+
+	gkScalar            m_cellSize, m_invCellSize;
+	gkScalar            m_maxRadius;    // of the entries filed in cells
+	gkTransformStore*   m_store;
+
+	Entries             m_entries;
+	Tracks              m_tracks;
+	Index               m_index;
+
+	Cell*               m_cells;
+	UTsize              m_capacity;     // power of two
+	UTsize              m_cellsUsed;    // table slots taken, empty lists included
+	int                 m_large;        // head of the large entry list
+	gkVector3           m_min, m_max;   // of all centres seen
+	bool                m_stale;
+};
+
+#endif//_gkSpatialHash_h_
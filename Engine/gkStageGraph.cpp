@@ -0,0 +1,153 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkStageGraph.h"
+
+
+
+gkStageGraph::Stage::Stage(const gkString& name, UTuint32 reads, UTuint32 writes)
+	:   m_name(name),
+	    m_reads(reads),
+	    m_writes(writes),
+	    m_time(0),
+	    m_graph(0),
+	    m_numDeps(0)
+{
+}
+
+
+bool gkStageGraph::Stage::conflicts(const Stage* other) const
+{
+	// write after read, read after write and write after write
+	return (m_writes & (other->m_reads | other->m_writes)) != 0 ||
+	       (m_reads & other->m_writes) != 0;
+}
+
+
+void gkStageGraph::Stage::run(void)
+{
+	unsigned long start = m_graph->m_clock.getMicroseconds();
+
+	update(m_graph->m_tick);
+
+	m_time = m_graph->m_clock.getMicroseconds() - start;
+
+	if (!m_graph->m_jobs)
+		return;
+
+	UTsize i;
+	for (i = 0; i < m_dependents.size(); i++)
+	{
+		Stage* next = m_dependents[i];
+
+		// the last predecessor to finish releases the stage
+		if (next->m_pending.decrement() == 0)
+			m_graph->m_jobs->submit(next, &m_graph->m_done);
+	}
+}
+
+
+
+gkStageGraph::gkStageGraph()
+	:   m_built(false),
+	    m_tick(0),
+	    m_jobs(0)
+{
+}
+
+
+gkStageGraph::~gkStageGraph()
+{
+	UTsize i;
+	for (i = 0; i < m_stages.size(); i++)
+		delete m_stages[i];
+}
+
+
+void gkStageGraph::addStage(Stage* stage)
+{
+	GK_ASSERT(stage && !m_built);
+
+	stage->m_graph = this;
+	m_stages.push_back(stage);
+}
+
+
+void gkStageGraph::build(void)
+{
+	UTsize i, j;
+	for (i = 0; i < m_stages.size(); i++)
+	{
+		Stage* stage = m_stages[i];
+
+		for (j = i + 1; j < m_stages.size(); j++)
+		{
+			Stage* later = m_stages[j];
+
+			if (stage->conflicts(later))
+			{
+				stage->m_dependents.push_back(later);
+				later->m_numDeps++;
+			}
+		}
+	}
+
+	m_built = true;
+}
+
+
+void gkStageGraph::run(gkScalar tick)
+{
+	if (!m_built)
+		build();
+
+	m_tick = tick;
+	m_jobs = gkJobSystem::getSingletonPtr();
+
+	if (m_jobs && m_jobs->getNumWorkers() == 0)
+		m_jobs = 0;
+
+	m_clock.reset();
+
+	UTsize i;
+	if (!m_jobs)
+	{
+		for (i = 0; i < m_stages.size(); i++)
+			m_stages[i]->run();
+		return;
+	}
+
+	for (i = 0; i < m_stages.size(); i++)
+		m_stages[i]->m_pending.set(m_stages[i]->m_numDeps);
+
+	for (i = 0; i < m_stages.size(); i++)
+	{
+		if (m_stages[i]->m_numDeps == 0)
+			m_jobs->submit(m_stages[i], &m_done);
+	}
+
+	m_jobs->wait(m_done);
+}
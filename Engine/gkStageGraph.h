@@ -0,0 +1,98 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkStageGraph_h_
+#define _gkStageGraph_h_
+
+#include "gkCommon.h"
+#include "gkMathUtils.h"
+#include "Thread/gkJobSystem.h"
+#include "OgreTimer.h"
+
+
+// Runs a fixed list of update stages. Each stage declares the resources
+// it reads and writes as bit masks. A stage waits for every earlier
+// stage it has a hazard with and overlaps the rest on the job system.
+// Without workers the stages simply run in the order they were added.
+class gkStageGraph
+{
+public:
+
+	class Stage : public gkCall
+	{
+	public:
+		Stage(const gkString& name, UTuint32 reads, UTuint32 writes);
+		virtual ~Stage() {}
+
+		virtual void update(gkScalar tick) = 0;
+
+		GK_INLINE const gkString&   getName(void) const    { return m_name; }
+		GK_INLINE unsigned long     getTime(void) const    { return m_time; }
+
+		bool conflicts(const Stage* other) const;
+
+	private:
+		friend class gkStageGraph;
+
+		void run(void);
+
+		gkString            m_name;
+		UTuint32            m_reads, m_writes;
+		unsigned long       m_time;
+
+		gkStageGraph*       m_graph;
+		utArray<Stage*>     m_dependents;
+		int                 m_numDeps;
+		gkAtomicInt         m_pending;
+	};
+
+	typedef utArray<Stage*> Stages;
+
+public:
+
+	gkStageGraph();
+	~gkStageGraph();
+
+	// stages are owned by the graph, order is the serial order
+	void addStage(Stage* stage);
+
+	void run(gkScalar tick);
+
+	GK_INLINE Stages& getStages(void) { return m_stages; }
+
+private:
+
+	void build(void);
+
+	Stages          m_stages;
+	bool            m_built;
+	gkScalar        m_tick;
+	gkJobSystem*    m_jobs;
+	gkJobCounter    m_done;
+	Ogre::Timer     m_clock;
+};
+
+#endif//_gkStageGraph_h_
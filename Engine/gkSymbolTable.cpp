@@ -0,0 +1,224 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkCommon.h"
+#include "gkSymbolTable.h"
+#include "gkLogger.h"
+#include "Thread/gkCriticalSection.h"
+
+#include <string.h>
+
+
+class gkSymbolTableData
+{
+public:
+	typedef gkSymbolTable::Entry Entry;
+
+	gkSymbolTableData()
+		:   m_full(false), m_count(0), m_index(0), m_indexSize(0)
+	{
+		memset(m_pages, 0, sizeof(m_pages));
+
+		m_none.hash = 0;
+		m_none.id = GK_NO_SYMBOL;
+
+		// the empty string is always symbol 0
+		add("", 0, hash("", 0));
+		GK_ASSERT(m_count == 1);
+	}
+
+	~gkSymbolTableData()
+	{
+		for (UTsize i = 0; i < gkSymbolTable::MAX_PAGES && m_pages[i]; i++)
+			delete []m_pages[i];
+		delete []m_index;
+	}
+
+	static UThash hash(const char* str, UTsize len)
+	{
+		UThash h = (UThash)2166136261u;
+		for (UTsize i = 0; i < len; i++)
+		{
+			h = h ^ (str[i]);
+			h = h * 16777619u;
+		}
+		return h;
+	}
+
+	GK_INLINE Entry& at(gkSymbol id)
+	{
+		return m_pages[id / gkSymbolTable::PAGE_SIZE][id % gkSymbolTable::PAGE_SIZE];
+	}
+
+	// Called with the lock held, index slots hold id + 1.
+	Entry* lookup(const char* str, UTsize len, UThash h)
+	{
+		if (!m_index)
+			return 0;
+
+		UTsize mask = m_indexSize - 1;
+		for (UTsize i = h & mask; m_index[i] != 0; i = (i + 1) & mask)
+		{
+			Entry& e = at(m_index[i] - 1);
+			if (e.hash == h && e.str.size() == len && memcmp(e.str.c_str(), str, len) == 0)
+				return &e;
+		}
+		return 0;
+	}
+
+	// Called with the lock held, returns m_none when the table is full.
+	Entry& add(const char* str, UTsize len, UThash h)
+	{
+		gkSymbol id = m_count;
+		UTsize page = id / gkSymbolTable::PAGE_SIZE;
+
+		if (page >= gkSymbolTable::MAX_PAGES)
+		{
+			if (!m_full)
+			{
+				gkLogMessage("SymbolTable: table full, names interned from now on are invalid.");
+				m_full = true;
+			}
+			return m_none;
+		}
+
+		if (!m_pages[page])
+			m_pages[page] = new Entry[gkSymbolTable::PAGE_SIZE];
+
+		Entry& e = at(id);
+		e.str.assign(str, len);
+		e.hash = h;
+		e.id = id;
+
+		if (id != 0)
+		{
+			if ((m_count + 1) * 2 > m_indexSize)
+				grow();
+			insert(id, h);
+		}
+
+		m_count++;
+		return e;
+	}
+
+	void insert(gkSymbol id, UThash h)
+	{
+		UTsize mask = m_indexSize - 1, i = h & mask;
+		while (m_index[i] != 0)
+			i = (i + 1) & mask;
+		m_index[i] = id + 1;
+	}
+
+	void grow(void)
+	{
+		delete []m_index;
+
+		m_indexSize = m_indexSize ? m_indexSize * 2 : 1024;
+		m_index = new UTuint32[m_indexSize];
+		memset(m_index, 0, m_indexSize * sizeof(UTuint32));
+
+		for (gkSymbol id = 1; id < m_count; id++)
+			insert(id, at(id).hash);
+	}
+
+	gkCriticalSection   m_lock;
+	Entry               m_none;
+	bool                m_full;
+	Entry*              m_pages[gkSymbolTable::MAX_PAGES];
+	volatile UTsize     m_count;
+	UTuint32*           m_index;
+	UTsize              m_indexSize;
+};
+
+
+// first use may come from static initializers in other units
+static gkSymbolTableData& gkGetSymbolTable(void)
+{
+	static gkSymbolTableData table;
+	return table;
+}
+
+
+
+const gkSymbolTable::Entry& gkSymbolTable::intern(const char* str, UTsize len)
+{
+	gkSymbolTableData& table = gkGetSymbolTable();
+	if (!str || len == 0)
+		return table.at(0);
+
+	UThash h = gkSymbolTableData::hash(str, len);
+
+	gkCriticalSection::Lock guard(table.m_lock);
+
+	Entry* e = table.lookup(str, len, h);
+	return e ? *e : table.add(str, len, h);
+}
+
+
+const gkSymbolTable::Entry& gkSymbolTable::intern(const char* str)
+{
+	return intern(str, str ? strlen(str) : 0);
+}
+
+
+const gkSymbolTable::Entry& gkSymbolTable::intern(const gkString& str)
+{
+	return intern(str.c_str(), str.size());
+}
+
+
+const gkSymbolTable::Entry* gkSymbolTable::find(const char* str)
+{
+	gkSymbolTableData& table = gkGetSymbolTable();
+
+	UTsize len = str ? strlen(str) : 0;
+	if (len == 0)
+		return &table.at(0);
+
+	UThash h = gkSymbolTableData::hash(str, len);
+
+	gkCriticalSection::Lock guard(table.m_lock);
+	return table.lookup(str, len, h);
+}
+
+
+const gkSymbolTable::Entry& gkSymbolTable::get(gkSymbol id)
+{
+	GK_ASSERT(id < getCount());
+	return gkGetSymbolTable().at(id);
+}
+
+
+const gkSymbolTable::Entry& gkSymbolTable::empty(void)
+{
+	return gkGetSymbolTable().at(0);
+}
+
+
+UTsize gkSymbolTable::getCount(void)
+{
+	return gkGetSymbolTable().m_count;
+}
@@ -0,0 +1,75 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkSymbolTable_h_
+#define _gkSymbolTable_h_
+
+#include "gkString.h"
+
+
+typedef UTuint32 gkSymbol;
+
+#define GK_NO_SYMBOL 0xFFFFFFFF
+
+
+// Engine wide table of interned names.
+//
+// Every distinct string is stored once and numbered in order of arrival, 0 is
+// the empty string. Entries are never removed or moved, so a symbol and the
+// text it refers to stay valid for the life of the process. Interning takes a
+// lock, reading an entry that was handed out does not.
+//
+// Names are meant to be interned once, when they are loaded or configured.
+// Interning per frame generated strings grows the table without bound. Once
+// MAX_PAGES are full, intern hands out a single invalid entry instead: id
+// GK_NO_SYMBOL, empty text, equal only to other names that did not fit.
+class gkSymbolTable
+{
+public:
+	enum { PAGE_SIZE = 1024, MAX_PAGES = 4096 };
+
+	struct Entry
+	{
+		gkString    str;
+		UThash      hash;       // same FNV hash utHashedString uses
+		gkSymbol    id;
+	};
+
+public:
+	static const Entry& intern(const char* str, UTsize len);
+	static const Entry& intern(const char* str);
+	static const Entry& intern(const gkString& str);
+
+	// Entry of an interned string, without adding it. 0 if not interned.
+	static const Entry* find(const char* str);
+
+	static const Entry& get(gkSymbol id);
+	static const Entry& empty(void);
+	static UTsize       getCount(void);
+};
+
+
+#endif//_gkSymbolTable_h_
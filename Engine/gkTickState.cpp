@@ -27,6 +27,7 @@
 #include "gkTickState.h"
 
 #define gkGetTickCount(timerPtr) ((unsigned long)(timerPtr)->getTimeMilliseconds())
+#define gkGetMicroCount(timerPtr) ((unsigned long)(timerPtr)->getTimeMicroseconds())
 #define gkMSScale                gkScalar(0.001)
 
 
@@ -41,7 +42,18 @@ gkTickState::gkTickState()
 		m_invt(0),
 		m_clock(0),
 		m_lock(false),
-		m_init(false)
+		m_init(false),
+		m_mode(TM_MILLISECOND),
+		m_catchUp(CU_DROP),
+		m_maxSteps(5),
+		m_last(0),
+		m_step(0),
+		m_accum(0),
+		m_deferred(0),
+		m_alpha(1.f),
+		m_count(0),
+		m_dropped(0),
+		m_stretched(0)
 {
 	initialize(60);
 }
@@ -59,7 +71,18 @@ gkTickState::gkTickState(int rate)
 		m_invt(0),
 		m_clock(0),
 		m_lock(false),
-		m_init(false)
+		m_init(false),
+		m_mode(TM_MILLISECOND),
+		m_catchUp(CU_DROP),
+		m_maxSteps(5),
+		m_last(0),
+		m_step(0),
+		m_accum(0),
+		m_deferred(0),
+		m_alpha(1.f),
+		m_count(0),
+		m_dropped(0),
+		m_stretched(0)
 {
 	initialize(rate);
 }
@@ -85,6 +108,8 @@ void gkTickState::initialize(int rate)
 	m_invt  = gkScalar(1.0) / (gkScalar)m_ticks;
 	m_fixed = gkScalar(1.0) / (gkScalar)m_rate;
 
+	m_step  = gkMax<UTuint64>(1, 1000000 / m_rate);
+
 	if (m_clock)
 		delete m_clock;
 	m_clock = new btClock();
@@ -98,6 +123,21 @@ void gkTickState::reset(void)
 }
 
 
+void gkTickState::setMode(int mode)
+{
+	m_mode  = mode;
+	m_alpha = 1.f;
+	m_init  = false;
+}
+
+
+void gkTickState::setCatchUp(int policy, int maxSteps)
+{
+	m_catchUp  = policy;
+	m_maxSteps = (unsigned long)gkMax<int>(1, maxSteps);
+}
+
+
 
 void gkTickState::tick(void)
 {
@@ -105,7 +145,18 @@ void gkTickState::tick(void)
 
 	beginTickImpl();
 
+	if (m_mode == TM_ACCUMULATOR)
+		tickAccumulator();
+	else
+		tickMillisecond();
+
+	endTickImpl();
+}
+
+
 
+void gkTickState::tickMillisecond(void)
+{
 	m_loop = 0;
 	m_lock = false;
 
@@ -122,11 +173,13 @@ void gkTickState::tick(void)
 	while ((m_cur = gkGetTickCount(m_clock)) > m_next && m_loop < m_skip)
 	{
 		tickImpl(m_fixed);
+		++m_count;
 
 		// test for a long tick, and stop if were over
 		if ( (( gkGetTickCount(m_clock) - m_cur) * gkMSScale) > m_fixed)
 		{
 			m_lock = true;
+			++m_stretched;
 			break;
 		}
 
@@ -137,8 +190,79 @@ void gkTickState::tick(void)
 	if (m_lock || m_cur > m_next)
 	{
 		// sync tick back to a usable state
-		m_cur = m_next = gkGetTickCount(m_clock);
+		m_cur = gkGetTickCount(m_clock);
+		if (m_cur > m_next && m_ticks > 0)
+			m_dropped += (m_cur - m_next) / m_ticks;
+
+		m_next = m_cur;
+	}
+}
+
+
+
+void gkTickState::tickAccumulator(void)
+{
+	if (!m_init)
+	{
+		m_init = true;
+		m_clock->reset();
+		m_last     = gkGetMicroCount(m_clock);
+		m_accum    = 0;
+		m_deferred = 0;
 	}
 
+	// unsigned difference, survives the clock wrapping
+	unsigned long now = gkGetMicroCount(m_clock);
+	m_accum += (UTuint64)(unsigned long)(now - m_last);
+	m_last = now;
+
+
+	UTuint64 steps = 0;
+	while (m_accum >= m_step && (m_catchUp == CU_ALL || steps < m_maxSteps))
+	{
+		tickImpl(m_fixed);
+		m_accum -= m_step;
+		++steps;
+		++m_count;
+	}
+
+	// ticks carried from the last frame went first
+	m_stretched += gkMin<UTuint64>(steps, m_deferred);
+
+
+	UTuint64 backlog = m_accum / m_step;
+	UTuint64 keep = m_catchUp == CU_SPREAD ? gkMin<UTuint64>(backlog, m_maxSteps) : 0;
+
+	if (backlog > keep)
+	{
+		m_dropped += backlog - keep;
+		m_accum   -= (backlog - keep) * m_step;
+	}
+
+	m_deferred = keep;
+	m_alpha = gkMin(gkScalar(m_accum % m_step) / gkScalar(m_step), gkScalar(1.0));
+}
+
+
+
+void gkTickState::step(void)
+{
+	beginTickImpl();
+	tickImpl(m_fixed);
+	++m_count;
 	endTickImpl();
 }
+
+
+
+bool gkTickState::isTickDue(void)
+{
+	// before the first tick the timer starts on tick()
+	if (!m_init)
+		return false;
+
+	if (m_mode == TM_ACCUMULATOR)
+		return m_accum + (UTuint64)(unsigned long)(gkGetMicroCount(m_clock) - m_last) >= m_step;
+
+	return gkGetTickCount(m_clock) > m_next;
+}
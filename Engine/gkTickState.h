@@ -36,6 +36,22 @@
 ///Timer for running loops at a fixed rate
 class gkTickState
 {
+public:
+
+	enum Mode
+	{
+		TM_MILLISECOND,     // whole millisecond ticks, resyncs after an overrun
+		TM_ACCUMULATOR,     // microsecond accumulator, see CatchUp
+	};
+
+	///What the accumulator does with due ticks past the per frame limit.
+	enum CatchUp
+	{
+		CU_DROP,            // discard them, game time falls behind
+		CU_SPREAD,          // run them on later frames, up to one more frame's limit
+		CU_ALL,             // no limit, run every due tick
+	};
+
 private:
 
 	unsigned long   m_ticks, m_rate;
@@ -45,6 +61,18 @@ private:
 	btClock*         m_clock;
 	bool            m_lock, m_init;
 
+	int             m_mode, m_catchUp;
+	unsigned long   m_maxSteps;
+	unsigned long   m_last;         // clock, microseconds
+	UTuint64        m_step;         // tick length, microseconds
+	UTuint64        m_accum;        // simulated time owed, microseconds
+	UTuint64        m_deferred;     // due ticks carried to the next frame
+	gkScalar        m_alpha;
+	UTuint64        m_count, m_dropped, m_stretched;
+
+	void tickMillisecond(void);
+	void tickAccumulator(void);
+
 protected:
 
 	virtual void tickImpl(gkScalar delta) = 0;
@@ -61,6 +89,35 @@ public:
 	void reset(void);
 	void initialize(int rate);
 	void tick(void);
+
+	///Runs exactly one fixed tick, independent of the wall clock.
+	void step(void);
+
+	///True when the next call to tick() runs at least one fixed tick.
+	bool isTickDue(void);
+
+
+	void setMode(int mode);
+	GK_INLINE int getMode(void) const               { return m_mode; }
+
+	///maxSteps bounds the ticks run by one call to tick(), CU_ALL ignores it.
+	void setCatchUp(int policy, int maxSteps);
+	GK_INLINE int getCatchUp(void) const            { return m_catchUp; }
+
+
+	///Part of a tick owed after the last tick(), in [0, 1).
+	///Blend the previous and current tick's state by it when rendering.
+	///Always 1 in millisecond mode.
+	GK_INLINE gkScalar getAlpha(void) const         { return m_alpha; }
+
+	GK_INLINE UTuint64 getTickCount(void) const     { return m_count; }
+
+	///Due ticks that were never run. Each one is lost game time.
+	GK_INLINE UTuint64 getDroppedTicks(void) const  { return m_dropped; }
+
+	///Ticks run a frame or more after they were due, or that
+	///overran their own length in millisecond mode.
+	GK_INLINE UTuint64 getStretchedTicks(void) const { return m_stretched; }
 };
 
 
@@ -0,0 +1,222 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkTransformSnapshot.h"
+#include "gkGameObject.h"
+#include "gkScene.h"
+#include "gkTransformStore.h"
+#include "Thread/gkJobSystem.h"
+
+#include "OgreSceneNode.h"
+
+// below this many objects a capture is not worth splitting
+#define GK_SNAPSHOT_GRAIN 256
+
+
+class gkSnapshotCaptureBody : public gkParallelForCall
+{
+public:
+	gkSnapshotCaptureBody(gkTransformSnapshot::Entries& entries, gkTransformStore* store)
+		:    m_entries(entries), m_store(store)
+	{
+	}
+
+	void run(UTsize begin, UTsize end)
+	{
+		for (UTsize i = begin; i < end; i++)
+		{
+			gkTransformSnapshot::Entry& entry = m_entries[i];
+
+			// world state is current, see capture
+			UTsize slot = entry.object->getTransformSlot();
+			if (slot != UT_NPOS)
+			{
+				m_store->getWorld(slot, entry.world);
+				continue;
+			}
+
+			Ogre::SceneNode* node = entry.object->getNode();
+			entry.world.loc = node->_getDerivedPosition();
+			entry.world.rot = node->_getDerivedOrientation();
+			entry.world.scl = node->_getDerivedScale();
+		}
+	}
+
+private:
+	gkTransformSnapshot::Entries& m_entries;
+	gkTransformStore*             m_store;
+};
+
+
+
+gkTransformSnapshot::gkTransformSnapshot()
+	:    m_front(0),
+	     m_frame(0),
+	     m_valid(false),
+	     m_previous(false)
+{
+}
+
+
+gkTransformSnapshot::~gkTransformSnapshot()
+{
+}
+
+
+void gkTransformSnapshot::capture(gkScene* scene)
+{
+	GK_ASSERT(scene && scene->isInstanced());
+
+	{
+		// the front becomes the blend source below
+		gkCriticalSection::Lock guard(m_lock);
+		sweep();
+	}
+
+	Entries& back = m_buffers[1 - m_front];
+
+	gkGameObjectSet& objects = scene->getInstancedObjects();
+	back.resize(objects.size());
+
+	UTsize count = 0;
+	bool unstored = false;
+	gkGameObjectSet::Iterator iter(objects);
+	while (iter.hasMoreElements())
+	{
+		gkGameObject* obj = iter.getNext();
+		if (!obj->getNode())
+			continue;
+
+		Entry& entry = back[count++];
+		entry.object = obj;
+		entry.proxy  = obj->getRenderNode() != obj->getNode() ? obj->getRenderNode() : 0;
+
+		if (obj->getTransformSlot() == UT_NPOS)
+			unstored = true;
+	}
+	back.resize(count);
+
+
+	// bring every world transform up to date once, the parallel
+	// reads below then never write to a shared parent
+	gkTransformStore* store = scene->getTransformStore();
+	store->update();
+
+	if (unstored)
+		scene->getObjectRoot()->_update(true, false);
+
+	gkSnapshotCaptureBody body(back, store);
+
+	gkJobSystem* jobs = gkJobSystem::getSingletonPtr();
+	if (jobs && count > GK_SNAPSHOT_GRAIN)
+		jobs->parallelFor(count, GK_SNAPSHOT_GRAIN, body);
+	else
+		body.run(0, count);
+
+
+	gkCriticalSection::Lock guard(m_lock);
+	m_previous = m_valid;
+	m_front = 1 - m_front;
+	m_valid = true;
+	++m_frame;
+}
+
+
+void gkTransformSnapshot::publish(gkScalar alpha)
+{
+	if (!m_valid)
+		return;
+
+	{
+		gkCriticalSection::Lock guard(m_lock);
+		sweep();
+	}
+
+	const Entries& front = m_buffers[m_front];
+	const Entries& back  = m_buffers[1 - m_front];
+
+	bool blend = m_previous && alpha < 1.f;
+
+	gkTransformState state;
+
+	UTsize i;
+	for (i = 0; i < front.size(); i++)
+	{
+		const Entry& entry = front[i];
+		if (!entry.proxy)
+			continue;
+
+		// both captures walk the same set, entries line up unless
+		// objects were added or removed in between
+		if (blend && i < back.size() && back[i].object == entry.object)
+		{
+			state.blend(back[i].world, entry.world, alpha);
+
+			entry.proxy->setPosition(state.loc);
+			entry.proxy->setOrientation(state.rot);
+			entry.proxy->setScale(state.scl);
+		}
+		else
+		{
+			entry.proxy->setPosition(entry.world.loc);
+			entry.proxy->setOrientation(entry.world.rot);
+			entry.proxy->setScale(entry.world.scl);
+		}
+	}
+}
+
+
+void gkTransformSnapshot::remove(gkGameObject* object)
+{
+	gkCriticalSection::Lock guard(m_lock);
+	m_removed.insert(object);
+}
+
+
+void gkTransformSnapshot::sweep(void)
+{
+	if (m_removed.empty())
+		return;
+
+	// one pass for every object that went away since the last sweep
+	for (int b = 0; b < 2; b++)
+	{
+		Entries& entries = m_buffers[b];
+
+		UTsize i;
+		for (i = 0; i < entries.size(); i++)
+		{
+			Entry& entry = entries[i];
+			if (entry.object && m_removed.find(entry.object) != UT_NPOS)
+			{
+				entry.object = 0;
+				entry.proxy  = 0;
+			}
+		}
+	}
+
+	m_removed.clear(true);
+}
@@ -0,0 +1,99 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkTransformSnapshot_h_
+#define _gkTransformSnapshot_h_
+
+#include "gkCommon.h"
+#include "gkTransformState.h"
+#include "Thread/gkCriticalSection.h"
+
+
+// Double buffered world transforms of a scene's instanced objects.
+//
+// With pipelined rendering Ogre only sees flat proxy nodes, one per
+// object. The simulation moves the objects own nodes, which are kept out
+// of the rendered tree, and the snapshot taken after the tick is what the
+// proxies get on the next frame. The next tick can then start while the
+// current frame is still culled. Headless servers keep the snapshot as
+// the replication source.
+//
+// Captured after every tick, the back buffer holds the tick before and
+// publish can blend the two by the tick state's alpha.
+class gkTransformSnapshot
+{
+public:
+
+	struct Entry
+	{
+		gkGameObject*       object;
+		Ogre::SceneNode*    proxy;      // null for headless scenes
+		gkTransformState    world;
+	};
+
+	typedef utArray<Entry> Entries;
+
+public:
+
+	gkTransformSnapshot();
+	~gkTransformSnapshot();
+
+
+	// Records the world transforms of scene objects in the back buffer
+	// and makes it the front one. Main thread only, after the tick.
+	void capture(gkScene* scene);
+
+	// Moves the proxies to the front buffer, in one pass. With alpha
+	// below one they are placed between the previous capture and it.
+	void publish(gkScalar alpha = 1.f);
+
+	// The object went away. Its entries in both buffers are dropped
+	// before the next publish or capture, the other proxies carry on.
+	void remove(gkGameObject* object);
+
+
+	// Readers on other threads hold getLock() while copying the front,
+	// and skip entries without an object.
+	GK_INLINE const Entries&     getFront(void) const   { return m_buffers[m_front]; }
+	GK_INLINE gkCriticalSection& getLock(void)          { return m_lock; }
+	GK_INLINE UTuint32           getFrame(void) const   { return m_frame; }
+	GK_INLINE bool               isValid(void) const    { return m_valid; }
+
+private:
+
+	// Clears the entries of removed objects, with the lock held.
+	void sweep(void);
+
+	Entries             m_buffers[2];
+	int                 m_front;
+	UTuint32            m_frame;
+	bool                m_valid;
+	bool                m_previous;     // back buffer holds the previous capture
+	gkGameObjectSet     m_removed;
+	gkCriticalSection   m_lock;
+};
+
+#endif//_gkTransformSnapshot_h_
@@ -102,6 +102,14 @@ public:
 		scl.x = gkScalar(1.0); scl.y = gkScalar(1.0); scl.z = gkScalar(1.0);
 	}
 
+	///Blend of a and b, from a at t=0 to b at t=1.
+	GK_INLINE void blend(const gkTransformState& a, const gkTransformState& b, gkScalar t)
+	{
+		loc = gkMathUtils::interp(a.loc, b.loc, t);
+		rot = gkMathUtils::interp(a.rot, b.rot, t);
+		scl = gkMathUtils::interp(a.scl, b.scl, t);
+	}
+
 	GK_INLINE bool isNaN(void) const
 	{
 		return loc.isNaN() || rot.isNaN() || scl.isNaN();
@@ -0,0 +1,423 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkTransformStore.h"
+
+#include "OgreSceneNode.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE
+#include <xmmintrin.h>
+#endif
+
+
+
+#if __OGRE_HAVE_SSE
+
+// Quaternions load as [w x y z] and vectors as [0 x y z], so the
+// vector parts share lanes.
+
+static GK_INLINE __m128 gkStoreLoad(const gkVector3& v)
+{
+	return _mm_setr_ps(0.f, v.x, v.y, v.z);
+}
+
+
+static GK_INLINE __m128 gkStoreCross(__m128 a, __m128 b)
+{
+	// lane 0 cancels out
+	__m128 a1 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 3, 2, 0));
+	__m128 b1 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 1, 3, 0));
+	__m128 a2 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 1, 3, 0));
+	__m128 b2 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 3, 2, 0));
+	return _mm_sub_ps(_mm_mul_ps(a1, b1), _mm_mul_ps(a2, b2));
+}
+
+
+static GK_INLINE __m128 gkStoreMultiply(__m128 a, __m128 b)
+{
+	static const __m128 s1 = _mm_setr_ps(-1.f,  1.f, -1.f,  1.f);
+	static const __m128 s2 = _mm_setr_ps(-1.f,  1.f,  1.f, -1.f);
+	static const __m128 s3 = _mm_setr_ps(-1.f, -1.f,  1.f,  1.f);
+
+	__m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b);
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)),
+	                             _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), s1)));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)),
+	                             _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)), s2)));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)),
+	                             _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)), s3)));
+	return r;
+}
+
+
+static GK_INLINE void gkStoreCompose(const gkVector3& ppos, const gkQuaternion& prot, const gkVector3& pscl,
+                                     const gkVector3& lpos, const gkQuaternion& lrot, const gkVector3& lscl,
+                                     gkVector3& wpos, gkQuaternion& wrot, gkVector3& wscl)
+{
+	__m128 q = _mm_loadu_ps(&prot.w);
+	__m128 v = _mm_mul_ps(gkStoreLoad(pscl), gkStoreLoad(lpos));
+
+	// same expansion as Ogre::Quaternion * Vector3
+	__m128 uv  = gkStoreCross(q, v);
+	__m128 uuv = gkStoreCross(q, uv);
+	__m128 w2  = _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 0, 0));
+	w2 = _mm_add_ps(w2, w2);
+
+	v = _mm_add_ps(v, _mm_mul_ps(uv, w2));
+	v = _mm_add_ps(v, _mm_add_ps(uuv, uuv));
+	v = _mm_add_ps(v, gkStoreLoad(ppos));
+
+	float out[4];
+	_mm_storeu_ps(out, v);
+	wpos.x = out[1];
+	wpos.y = out[2];
+	wpos.z = out[3];
+
+	_mm_storeu_ps(&wrot.w, gkStoreMultiply(q, _mm_loadu_ps(&lrot.w)));
+
+	wscl.x = pscl.x * lscl.x;
+	wscl.y = pscl.y * lscl.y;
+	wscl.z = pscl.z * lscl.z;
+}
+
+#else
+
+static GK_INLINE void gkStoreCompose(const gkVector3& ppos, const gkQuaternion& prot, const gkVector3& pscl,
+                                     const gkVector3& lpos, const gkQuaternion& lrot, const gkVector3& lscl,
+                                     gkVector3& wpos, gkQuaternion& wrot, gkVector3& wscl)
+{
+	wpos = prot * (pscl * lpos) + ppos;
+	wrot = prot * lrot;
+	wscl = pscl * lscl;
+}
+
+#endif
+
+
+
+gkTransformStore::gkTransformStore()
+	:    m_size(0),
+	     m_live(0),
+	     m_composed(0),
+	     m_orderDirty(false)
+{
+	memset(m_pages, 0, sizeof(m_pages));
+}
+
+
+gkTransformStore::~gkTransformStore()
+{
+	UTsize i;
+	for (i = 0; i < MAX_PAGES && m_pages[i]; i++)
+		delete m_pages[i];
+}
+
+
+UTsize gkTransformStore::create(Ogre::SceneNode* node, const gkTransformState& local, UTsize parent)
+{
+	UTsize s;
+	if (!m_free.empty())
+	{
+		s = m_free.back();
+		m_free.pop_back();
+	}
+	else
+	{
+		if (m_size == PAGE_SIZE * MAX_PAGES)
+			return UT_NPOS;
+
+		if (m_size % PAGE_SIZE == 0)
+			m_pages[m_size / PAGE_SIZE] = new Page();
+
+		s = m_size++;
+		page(s).flags[s % PAGE_SIZE] = 0;
+	}
+
+	Page& pg = page(s);
+	UTsize i = s % PAGE_SIZE;
+
+	pg.localPos[i]      = local.loc;
+	pg.localRot[i]      = local.rot;
+	pg.localScl[i]      = local.scl;
+	pg.parent[i]        = UT_NPOS;
+	pg.stamp[i]         = 0;
+	pg.parentStamp[i]   = 0;
+	pg.children[i]      = 0;
+	pg.node[i]          = node;
+	pg.flags[i]         = (pg.flags[i] & TF_ORDERED) | TF_LIVE | TF_LOCAL | TF_NODE;
+
+	// roots go anywhere in the order
+	if (!(pg.flags[i] & TF_ORDERED))
+	{
+		m_order.push_back(s);
+		pg.flags[i] |= TF_ORDERED;
+	}
+
+	++m_live;
+
+	if (parent != UT_NPOS)
+		setParent(s, parent);
+	return s;
+}
+
+
+void gkTransformStore::destroy(UTsize slot)
+{
+	Page& pg = page(slot);
+	UTsize i = slot % PAGE_SIZE;
+
+	GK_ASSERT(pg.flags[i] & TF_LIVE);
+
+	UTsize parent = pg.parent[i];
+
+	if (pg.children[i] != 0)
+	{
+		UTsize s;
+		for (s = 0; s < m_size && pg.children[i] != 0; s++)
+		{
+			Page& cp = page(s);
+			UTsize c = s % PAGE_SIZE;
+
+			if ((cp.flags[c] & TF_LIVE) && cp.parent[c] == slot)
+				setParent(s, parent);
+		}
+	}
+
+	if (parent != UT_NPOS)
+		page(parent).children[parent % PAGE_SIZE]--;
+
+	// the order entry stays until the next rebuild
+	pg.flags[i] &= TF_ORDERED;
+	pg.node[i] = 0;
+
+	m_free.push_back(slot);
+	--m_live;
+}
+
+
+void gkTransformStore::setParent(UTsize slot, UTsize parent)
+{
+	Page& pg = page(slot);
+	UTsize i = slot % PAGE_SIZE;
+
+	GK_ASSERT(parent != slot);
+
+	if (pg.parent[i] == parent)
+		return;
+
+	if (pg.parent[i] != UT_NPOS)
+		page(pg.parent[i]).children[pg.parent[i] % PAGE_SIZE]--;
+	if (parent != UT_NPOS)
+		page(parent).children[parent % PAGE_SIZE]++;
+
+	pg.parent[i] = parent;
+	pg.flags[i] |= TF_LOCAL;
+
+	m_orderDirty = true;
+}
+
+
+void gkTransformStore::setLocal(UTsize slot, const gkTransformState& v)
+{
+	Page& pg = page(slot);
+	UTsize i = slot % PAGE_SIZE;
+
+	pg.localPos[i] = v.loc;
+	pg.localRot[i] = v.rot;
+	pg.localScl[i] = v.scl;
+	pg.flags[i] |= TF_LOCAL | TF_NODE;
+}
+
+
+void gkTransformStore::getWorld(UTsize slot, gkTransformState& state)
+{
+	resolve(slot);
+
+	const Page& pg = page(slot);
+	UTsize i = slot % PAGE_SIZE;
+
+	state.loc = pg.worldPos[i];
+	state.rot = pg.worldRot[i];
+	state.scl = pg.worldScl[i];
+}
+
+
+void gkTransformStore::resolve(UTsize slot)
+{
+	// Readers on different threads may compose the same shared parent,
+	// they write the same values.
+	Page& pg = page(slot);
+	UTsize i = slot % PAGE_SIZE;
+
+	if (pg.parent[i] != UT_NPOS)
+		resolve(pg.parent[i]);
+
+	if (isStale(pg, i))
+		compose(pg, i);
+}
+
+
+void gkTransformStore::compose(Page& pg, UTsize i)
+{
+	UTsize p = pg.parent[i];
+
+	if (p == UT_NPOS)
+	{
+		pg.worldPos[i] = pg.localPos[i];
+		pg.worldRot[i] = pg.localRot[i];
+		pg.worldScl[i] = pg.localScl[i];
+	}
+	else
+	{
+		const Page& pp = page(p);
+		UTsize j = p % PAGE_SIZE;
+
+		gkStoreCompose(pp.worldPos[j], pp.worldRot[j], pp.worldScl[j],
+		               pg.localPos[i], pg.localRot[i], pg.localScl[i],
+		               pg.worldPos[i], pg.worldRot[i], pg.worldScl[i]);
+
+		pg.parentStamp[i] = pp.stamp[j];
+	}
+
+	pg.stamp[i]++;
+	pg.flags[i] &= ~TF_LOCAL;
+}
+
+
+int gkTransformStore::depthOf(UTsize slot)
+{
+	int& depth = m_depth[slot];
+	if (depth < 0)
+	{
+		UTsize p = getParent(slot);
+		depth = p == UT_NPOS ? 0 : depthOf(p) + 1;
+	}
+	return depth;
+}
+
+
+void gkTransformStore::buildOrder(void)
+{
+	// counting sort by depth, every level only depends on the ones above
+	m_depth.resize(m_size);
+
+	UTsize s, maxDepth = 0;
+	for (s = 0; s < m_size; s++)
+	{
+		m_depth[s] = -1;
+		page(s).flags[s % PAGE_SIZE] &= ~TF_ORDERED;
+	}
+
+	for (s = 0; s < m_size; s++)
+	{
+		if (page(s).flags[s % PAGE_SIZE] & TF_LIVE)
+			maxDepth = gkMax<UTsize>(maxDepth, (UTsize)depthOf(s));
+	}
+
+	m_levels.resize(maxDepth + 2);
+	for (s = 0; s < m_levels.size(); s++)
+		m_levels[s] = 0;
+
+	for (s = 0; s < m_size; s++)
+	{
+		if (m_depth[s] >= 0)
+			m_levels[m_depth[s] + 1]++;
+	}
+
+	for (s = 1; s < m_levels.size(); s++)
+		m_levels[s] += m_levels[s - 1];
+
+	m_order.resize(m_live);
+	for (s = 0; s < m_size; s++)
+	{
+		if (m_depth[s] >= 0)
+		{
+			m_order[m_levels[m_depth[s]]++] = s;
+			page(s).flags[s % PAGE_SIZE] |= TF_ORDERED;
+		}
+	}
+
+	m_orderDirty = false;
+}
+
+
+void gkTransformStore::update(void)
+{
+	if (m_orderDirty)
+		buildOrder();
+
+	m_composed = 0;
+
+	UTsize n;
+	for (n = 0; n < m_order.size(); n++)
+	{
+		UTsize s = m_order[n];
+		Page& pg = page(s);
+		UTsize i = s % PAGE_SIZE;
+
+		// parents came first, their stamps are final
+		if ((pg.flags[i] & TF_LIVE) && isStale(pg, i))
+		{
+			compose(pg, i);
+			++m_composed;
+		}
+	}
+}
+
+
+void gkTransformStore::syncNodes(void)
+{
+	UTsize p, i;
+	for (p = 0; p * PAGE_SIZE < m_size; p++)
+	{
+		Page& pg = *m_pages[p];
+		UTsize end = gkMin<UTsize>(PAGE_SIZE, m_size - p * PAGE_SIZE);
+
+		for (i = 0; i < end; i++)
+		{
+			if ((pg.flags[i] & (TF_LIVE | TF_NODE)) == (TF_LIVE | TF_NODE))
+				syncNode(p * PAGE_SIZE + i);
+		}
+	}
+}
+
+
+void gkTransformStore::syncNode(UTsize slot)
+{
+	Page& pg = page(slot);
+	UTsize i = slot % PAGE_SIZE;
+
+	pg.flags[i] &= ~TF_NODE;
+
+	Ogre::SceneNode* node = pg.node[i];
+	if (node)
+	{
+		node->setPosition(pg.localPos[i]);
+		node->setOrientation(pg.localRot[i]);
+		node->setScale(pg.localScl[i]);
+	}
+}
@@ -0,0 +1,170 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkTransformStore_h_
+#define _gkTransformStore_h_
+
+#include "gkCommon.h"
+#include "gkTransformState.h"
+
+
+// Engine side transforms of a scene's instanced objects.
+//
+// Local and world position, orientation and scale are kept in contiguous
+// per attribute arrays, one slot per object. Setters only write the local
+// arrays and mark the slot. update() then composes every stale world
+// transform in one pass, parents before children, and syncNodes() hands the
+// moved locals to the Ogre nodes in bulk. Reading a world transform between
+// updates composes just the stale part of its chain up to the root.
+//
+// Slots live in fixed pages and keep their index for the life of the
+// object, writes from the tick stages never race a reallocation. The
+// parent first order is a separate index list, rebuilt by update() after
+// the hierarchy changed.
+class gkTransformStore
+{
+public:
+	enum { PAGE_SIZE = 256, MAX_PAGES = 1024 };
+
+	enum Flags
+	{
+		TF_LIVE     = 1 << 0,
+		TF_LOCAL    = 1 << 1,   // local changed since the world was composed
+		TF_NODE     = 1 << 2,   // local changed since the node was synced
+		TF_ORDERED  = 1 << 3,   // slot index is in the update order
+	};
+
+public:
+
+	gkTransformStore();
+	~gkTransformStore();
+
+
+	// New slot holding local, UT_NPOS once the store is full. The node
+	// gets the local transform on sync, it may be null.
+	UTsize create(Ogre::SceneNode* node, const gkTransformState& local, UTsize parent = UT_NPOS);
+
+	// Children of the slot move up to its parent keeping their local
+	// transform, as Ogre does with their nodes.
+	void destroy(UTsize slot);
+
+	void   setParent(UTsize slot, UTsize parent);
+	GK_INLINE UTsize getParent(UTsize s) const { return page(s).parent[s % PAGE_SIZE]; }
+
+
+	GK_INLINE const gkVector3&      getPosition(UTsize s) const     { return page(s).localPos[s % PAGE_SIZE]; }
+	GK_INLINE const gkQuaternion&   getOrientation(UTsize s) const  { return page(s).localRot[s % PAGE_SIZE]; }
+	GK_INLINE const gkVector3&      getScale(UTsize s) const        { return page(s).localScl[s % PAGE_SIZE]; }
+
+	GK_INLINE void setPosition(UTsize s, const gkVector3& v)        { page(s).localPos[s % PAGE_SIZE] = v; markLocal(s); }
+	GK_INLINE void setOrientation(UTsize s, const gkQuaternion& v)  { page(s).localRot[s % PAGE_SIZE] = v; markLocal(s); }
+	GK_INLINE void setScale(UTsize s, const gkVector3& v)           { page(s).localScl[s % PAGE_SIZE] = v; markLocal(s); }
+
+	void setLocal(UTsize slot, const gkTransformState& v);
+
+
+	// World transforms, composed on demand when the slot went stale.
+	GK_INLINE const gkVector3&      getWorldPosition(UTsize s)      { resolve(s); return page(s).worldPos[s % PAGE_SIZE]; }
+	GK_INLINE const gkQuaternion&   getWorldOrientation(UTsize s)   { resolve(s); return page(s).worldRot[s % PAGE_SIZE]; }
+	GK_INLINE const gkVector3&      getWorldScale(UTsize s)         { resolve(s); return page(s).worldScl[s % PAGE_SIZE]; }
+
+	void getWorld(UTsize slot, gkTransformState& state);
+
+	// Changes whenever the world transform is composed, see gkSpatialHash.
+	GK_INLINE UTuint32 getStamp(UTsize s) const { return page(s).stamp[s % PAGE_SIZE]; }
+
+
+	// Composes every stale world transform, parents first. Main thread,
+	// outside of the tick stages.
+	void update(void);
+
+	// Pushes the locals changed since the last sync to their nodes.
+	void syncNodes(void);
+	void syncNode(UTsize slot);
+
+
+	GK_INLINE UTsize getCount(void) const       { return m_live; }
+
+	// World transforms composed by the last update, lazily composed
+	// ones not included.
+	GK_INLINE UTsize getComposedCount(void) const   { return m_composed; }
+
+private:
+
+	struct Page
+	{
+		gkVector3           localPos[PAGE_SIZE];
+		gkQuaternion        localRot[PAGE_SIZE];
+		gkVector3           localScl[PAGE_SIZE];
+		gkVector3           worldPos[PAGE_SIZE];
+		gkQuaternion        worldRot[PAGE_SIZE];
+		gkVector3           worldScl[PAGE_SIZE];
+		UTsize              parent[PAGE_SIZE];
+		UTuint32            stamp[PAGE_SIZE];       // bumped each time the world is composed
+		UTuint32            parentStamp[PAGE_SIZE]; // parent stamp the world was composed from
+		UTuint32            children[PAGE_SIZE];
+		UTuint8             flags[PAGE_SIZE];
+		Ogre::SceneNode*    node[PAGE_SIZE];
+	};
+
+	typedef utArray<UTsize> Slots;
+
+
+	GK_INLINE Page& page(UTsize s) const { return *m_pages[s / PAGE_SIZE]; }
+
+	GK_INLINE void markLocal(UTsize s)
+	{
+		page(s).flags[s % PAGE_SIZE] |= TF_LOCAL | TF_NODE;
+	}
+
+	GK_INLINE bool isStale(const Page& pg, UTsize i) const
+	{
+		if (pg.flags[i] & TF_LOCAL)
+			return true;
+
+		UTsize p = pg.parent[i];
+		return p != UT_NPOS && pg.parentStamp[i] != page(p).stamp[p % PAGE_SIZE];
+	}
+
+	void resolve(UTsize slot);
+	void compose(Page& pg, UTsize i);
+	void buildOrder(void);
+	int  depthOf(UTsize slot);
+
+
+	Page*           m_pages[MAX_PAGES];
+	UTsize          m_size;         // slots carved so far
+	UTsize          m_live;
+	UTsize          m_composed;
+
+	Slots           m_free;
+	Slots           m_order;        // live slots, parents before children
+	Slots           m_levels;
+	utArray<int>    m_depth;
+	bool            m_orderDirty;
+};
+
+#endif//_gkTransformStore_h_
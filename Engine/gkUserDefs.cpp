@@ -32,6 +32,8 @@
 #include "gkPath.h"
 #include "gkWindowSystem.h"
 #include "gkViewport.h"
+#include "gkTickState.h"
+#include "gkRegionStreamer.h"
 
 #include "OgreException.h"
 #include "OgreConfigFile.h"
@@ -88,7 +90,28 @@ gkUserDefs::gkUserDefs()
 	animFps(24.f),
 	shaderCachePath(""),
 	rtss(false),
-	hasFixedCapability(true)
+	hasFixedCapability(true),
+	headless(false),
+	jobThreads(-1),
+	parallelStages(false),
+	parallelScenes(false),
+	parallelSensors(false),
+	pipelined(false),
+	tickRate(60),
+	tickAccumulator(false),
+	tickCatchUp(gkTickState::CU_DROP),
+	maxTickSteps(5),
+	interpolate(false),
+	profileTrace(""),
+	inputRecord(""),
+	inputReplay(""),
+	clonePoolSize(32),
+	spatialCellSize(0.f),
+	instanceBudget(0),
+	regionStreaming(gkRegionStreamer::RM_NONE),
+	regionCellSize(64.f),
+	regionLoadRadius(150.f),
+	regionUnloadRadius(200.f)
 {
 }
 
@@ -165,6 +188,30 @@ int gkUserDefs::getViewportFramingType(const gkString& val)
 	return framingType;
 }
 
+int gkUserDefs::getTickCatchUp(const gkString& val)
+{
+	int catchUp = gkTickState::CU_DROP;
+
+	if (val.find("spread") != val.npos)
+		catchUp = gkTickState::CU_SPREAD;
+	else if (val.find("all") != val.npos)
+		catchUp = gkTickState::CU_ALL;
+
+	return catchUp;
+}
+
+int gkUserDefs::getRegionStreaming(const gkString& val)
+{
+	int mode = gkRegionStreamer::RM_NONE;
+
+	if (val.find("layers") != val.npos)
+		mode = gkRegionStreamer::RM_LAYERS;
+	else if (val.find("grid") != val.npos)
+		mode = gkRegionStreamer::RM_GRID;
+
+	return mode;
+}
+
 void gkUserDefs::parseString(const gkString& key, const gkString& val)
 {
 #define KeyEq(b) (key == b)
@@ -327,6 +374,111 @@ void gkUserDefs::parseString(const gkString& key, const gkString& val)
 		shaderCachePath = val;
 		return;
 	}
+	if (KeyEq("headless"))
+	{
+		headless = Ogre::StringConverter::parseBool(val);
+		return;
+	}
+	if (KeyEq("jobthreads"))
+	{
+		jobThreads = gkMax<int>(-1, Ogre::StringConverter::parseInt(val));
+		return;
+	}
+	if (KeyEq("parallelstages"))
+	{
+		parallelStages = Ogre::StringConverter::parseBool(val);
+		return;
+	}
+	if (KeyEq("parallelscenes"))
+	{
+		parallelScenes = Ogre::StringConverter::parseBool(val);
+		return;
+	}
+	if (KeyEq("parallelsensors"))
+	{
+		parallelSensors = Ogre::StringConverter::parseBool(val);
+		return;
+	}
+	if (KeyEq("pipelined"))
+	{
+		pipelined = Ogre::StringConverter::parseBool(val);
+		return;
+	}
+	if (KeyEq("tickrate"))
+	{
+		tickRate = gkClamp<int>(Ogre::StringConverter::parseInt(val), 1, 1000);
+		return;
+	}
+	if (KeyEq("tickaccumulator"))
+	{
+		tickAccumulator = Ogre::StringConverter::parseBool(val);
+		return;
+	}
+	if (KeyEq("tickcatchup"))
+	{
+		tickCatchUp = getTickCatchUp(val);
+		return;
+	}
+	if (KeyEq("maxticksteps"))
+	{
+		maxTickSteps = gkMax<int>(1, Ogre::StringConverter::parseInt(val));
+		return;
+	}
+	if (KeyEq("interpolate"))
+	{
+		interpolate = Ogre::StringConverter::parseBool(val);
+		return;
+	}
+	if (KeyEq("profiletrace"))
+	{
+		profileTrace = val;
+		return;
+	}
+	if (KeyEq("inputrecord"))
+	{
+		inputRecord = val;
+		return;
+	}
+	if (KeyEq("inputreplay"))
+	{
+		inputReplay = val;
+		return;
+	}
+	if (KeyEq("clonepoolsize"))
+	{
+		clonePoolSize = gkMax<int>(0, Ogre::StringConverter::parseInt(val));
+		return;
+	}
+	if (KeyEq("spatialcellsize"))
+	{
+		spatialCellSize = gkMax<gkScalar>(0, Ogre::StringConverter::parseReal(val));
+		return;
+	}
+	if (KeyEq("instancebudget"))
+	{
+		instanceBudget = gkMax<gkScalar>(0, Ogre::StringConverter::parseReal(val));
+		return;
+	}
+	if (KeyEq("regionstreaming"))
+	{
+		regionStreaming = getRegionStreaming(val);
+		return;
+	}
+	if (KeyEq("regioncellsize"))
+	{
+		regionCellSize = gkMax<gkScalar>(1, Ogre::StringConverter::parseReal(val));
+		return;
+	}
+	if (KeyEq("regionloadradius"))
+	{
+		regionLoadRadius = gkMax<gkScalar>(0, Ogre::StringConverter::parseReal(val));
+		return;
+	}
+	if (KeyEq("regionunloadradius"))
+	{
+		regionUnloadRadius = gkMax<gkScalar>(0, Ogre::StringConverter::parseReal(val));
+		return;
+	}
 
 #undef KeyEq
 }
@@ -79,12 +79,35 @@ public:
 	bool                    rtss;               // Enable RTShadingSystem
 	bool                    hasFixedCapability; // Renderer supports fixed-function pipeline
 	gkString				androidConfig;		// Android Config Handle (Ogre 1.9)
+	bool                    headless;           // Run the simulation without a render system or window
+	int                     jobThreads;         // Job system worker threads, -1 for one per core
+	bool                    parallelStages;     // Overlap independent scene update stages on the job system
+	bool                    parallelScenes;     // Update active scenes side by side on the job system
+	bool                    parallelSensors;    // Run physics sensor queries in parallel batches on the job system
+	bool                    pipelined;          // Simulate the next tick while the current frame renders
+	int                     tickRate;           // Fixed simulation ticks per second
+	bool                    tickAccumulator;    // Microsecond tick accumulator instead of millisecond ticks
+	int                     tickCatchUp;        // drop/spread/all, see gkTickState::CatchUp
+	int                     maxTickSteps;       // Ticks run per frame before the catch up policy applies
+	bool                    interpolate;        // Render objects between the last two ticks (needs tickAccumulator)
+	gkString                profileTrace;       // Chrome trace file written on exit, empty for none
+	gkString                inputRecord;        // Record per tick input to this log file
+	gkString                inputReplay;        // Replay input from this log file, exits at its end
+	int                     clonePoolSize;      // Ended clones kept per source object for reuse, 0 to always destroy
+	gkScalar                spatialCellSize;    // Cell size of the scene proximity grid, 0 to disable. When set, near and radar sensors test bounding spheres of physics objects, not their shapes
+	gkScalar                instanceBudget;     // Milliseconds per tick spent instancing queued objects, 0 loads scenes in one go
+	int                     regionStreaming;    // gkRegionStreamer::Mode, cells of standalone entities load near the camera
+	gkScalar                regionCellSize;     // Side of a grid cell
+	gkScalar                regionLoadRadius;   // Cells closer than this are instanced
+	gkScalar                regionUnloadRadius; // Cells further than this are destroyed
 
 	GK_INLINE bool          isD3DRenderSystem() { return isD3DRenderSystem(rendersystem); }
 
 	static OgreRenderSystem getOgreRenderSystem(const gkString& val);
 	static bool isD3DRenderSystem(OgreRenderSystem rs);
 	static int getViewportFramingType(const gkString& val);
+	static int getTickCatchUp(const gkString& val);
+	static int getRegionStreaming(const gkString& val);
 };
 
 
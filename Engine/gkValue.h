@@ -31,7 +31,6 @@
 #include "gkMathUtils.h"
 #include "gkString.h"
 #include "OgreStringConverter.h"
-#include <typeinfo>
 
 
 
@@ -59,139 +58,208 @@ GK_INLINE gkString gkToString(const gkMatrix3& v)    { return Ogre::StringConver
 GK_INLINE gkString gkToString(const gkMatrix4& v)    { return Ogre::StringConverter::toString(v); }
 
 
+// Tagged value.
+//
+// Scalars, vectors, quaternions and matrices live inline in the union, so
+// copies and compares never touch the heap. Only strings keep their own
+// storage. Type tags follow gkVariable::PropertyTypes.
 class gkValue
 {
 public:
-	typedef std::type_info Info;
-
-
-protected:
-
-	class Value
+	enum Type
 	{
-	public:
-		virtual ~Value() {}
-
-
-		virtual void          fromString(const gkString& v) = 0;
-		virtual gkString      toString(void) const = 0;
-		virtual const Info&    type(void) const = 0;
-		virtual Value*         clone(void) const = 0;
+		VT_NULL = 0,
+		VT_BOOL,
+		VT_REAL,
+		VT_INT,
+		VT_VEC2,
+		VT_VEC3,
+		VT_VEC4,
+		VT_QUAT,
+		VT_MAT3,
+		VT_MAT4,
+		VT_STRING,
 	};
 
-	template <typename T>
-	class ValueType : public Value
-	{
-	public:
-
-		ValueType(const T& v)
-			:   m_value(v)
-		{
-		}
-
-		virtual ~ValueType() {}
+	template<typename T> struct Traits;
 
-		GK_INLINE const Info&  type(void) const    { return typeid(T); }
-		GK_INLINE Value*        clone(void) const  { return new ValueType<T>(m_value); }
 
-		GK_INLINE void fromString(const gkString& v)
-		{
-			gkFromString(v, m_value);
-		}
+protected:
 
-		GK_INLINE gkString toString(void) const
-		{
-			return gkToString(m_value);
-		}
-		T m_value;
+	union Data
+	{
+		bool        m_bool;
+		int         m_int;
+		gkScalar    m_real;
+		gkScalar    m_vec[16];
 	};
 
-	Value* m_data;
+	Data        m_data;
+	gkString    m_string;
+	int         m_type;
 
 
-	GK_INLINE gkValue& swap(gkValue& rhs)
+	GK_INLINE void setType(int type)
 	{
-		utSwap(m_data, rhs.m_data);
-		return *this;
+		if (m_type == VT_STRING && type != VT_STRING)
+			gkString().swap(m_string);
+		m_type = type;
 	}
 
-public:
-
-	gkValue()
-		:   m_data(0)
+	GK_INLINE void store(const gkScalar* v, int type, int n)
 	{
+		setType(type);
+		memcpy(m_data.m_vec, v, sizeof(gkScalar) * n);
 	}
 
-	gkValue(const gkValue& v)
-		:   m_data(v.m_data ? v.m_data->clone() : 0)
+	GK_INLINE void set(bool v)                  { setType(VT_BOOL); m_data.m_bool = v; }
+	GK_INLINE void set(int v)                   { setType(VT_INT);  m_data.m_int  = v; }
+	GK_INLINE void set(gkScalar v)              { setType(VT_REAL); m_data.m_real = v; }
+	GK_INLINE void set(const gkString& v)       { setType(VT_STRING); m_string = v; }
+	GK_INLINE void set(const char* v)           { setType(VT_STRING); m_string = v ? v : ""; }
+	GK_INLINE void set(const gkVector2& v)      { store(v.ptr(), VT_VEC2, 2); }
+	GK_INLINE void set(const gkVector3& v)      { store(v.ptr(), VT_VEC3, 3); }
+	GK_INLINE void set(const gkVector4& v)      { store(v.ptr(), VT_VEC4, 4); }
+	GK_INLINE void set(const gkQuaternion& v)   { store(v.ptr(), VT_QUAT, 4); }
+	GK_INLINE void set(const gkMatrix3& v)      { store(v[0], VT_MAT3, 9); }
+	GK_INLINE void set(const gkMatrix4& v)      { store(v[0], VT_MAT4, 16); }
+
+	GK_INLINE void read(bool& v) const          { v = m_data.m_bool; }
+	GK_INLINE void read(int& v) const           { v = m_data.m_int; }
+	GK_INLINE void read(gkScalar& v) const      { v = m_data.m_real; }
+	GK_INLINE void read(gkString& v) const      { v = m_string; }
+	GK_INLINE void read(gkVector2& v) const     { memcpy(v.ptr(), m_data.m_vec, sizeof(gkScalar) * 2); }
+	GK_INLINE void read(gkVector3& v) const     { memcpy(v.ptr(), m_data.m_vec, sizeof(gkScalar) * 3); }
+	GK_INLINE void read(gkVector4& v) const     { memcpy(v.ptr(), m_data.m_vec, sizeof(gkScalar) * 4); }
+	GK_INLINE void read(gkQuaternion& v) const  { memcpy(v.ptr(), m_data.m_vec, sizeof(gkScalar) * 4); }
+	GK_INLINE void read(gkMatrix3& v) const     { memcpy(v[0], m_data.m_vec, sizeof(gkScalar) * 9); }
+	GK_INLINE void read(gkMatrix4& v) const     { memcpy(v[0], m_data.m_vec, sizeof(gkScalar) * 16); }
+
+public:
+
+	gkValue()
+		:   m_type(VT_NULL)
 	{
+		m_data.m_int = 0;
 	}
 
 	template<typename T>
 	gkValue(const T& v)
-		:   m_data(new ValueType<T>(v))
+		:   m_type(VT_NULL)
 	{
+		set(v);
 	}
 
-	~gkValue()
+	// a literal would otherwise convert to bool
+	gkValue(const char* v)
+		:   m_type(VT_NULL)
 	{
-		delete m_data;
+		set(v);
 	}
 
 	template<typename T>
 	GK_INLINE gkValue& operator = (const T& rhs)
 	{
-		gkValue(rhs).swap(*this);
+		set(rhs);
 		return *this;
 	}
 
-	GK_INLINE gkValue& operator = (const gkValue& rhs)
-	{
-		gkValue(rhs).swap(*this);
-		return *this;
-	}
+
+	GK_INLINE int  getType(void) const { return m_type; }
+	GK_INLINE bool isNull(void) const  { return m_type == VT_NULL; }
 
 
 	template<typename T>
 	GK_INLINE operator T(void) const
 	{
-		if (m_data && m_data->type() == typeid(T))
-			return static_cast<ValueType<T>*>(m_data)->m_value;
-		return T();
+		return get<T>();
 	}
 
 	template<typename T>
 	GK_INLINE T get(const T& def = T()) const
 	{
-		if (m_data && m_data->type() == typeid(T))
-			return static_cast<ValueType<T>*>(m_data)->m_value;
-		return def;
+		if (m_type != Traits<T>::TYPE)
+			return def;
+
+		T v;
+		read(v);
+		return v;
 	}
 
+	// Unchecked access, the caller has already switched on getType.
+	GK_INLINE bool            getBool(void) const   { return m_data.m_bool; }
+	GK_INLINE int             getInt(void) const    { return m_data.m_int; }
+	GK_INLINE gkScalar        getReal(void) const   { return m_data.m_real; }
+	GK_INLINE const gkString& getString(void) const { return m_string; }
 
-	GK_INLINE gkString toString(void) const
+
+	gkString toString(void) const
 	{
-		if (m_data)
-			return m_data->toString();
+		switch (m_type)
+		{
+		case VT_BOOL:   return gkToString(m_data.m_bool);
+		case VT_INT:    return gkToString(m_data.m_int);
+		case VT_REAL:   return gkToString(m_data.m_real);
+		case VT_STRING: return m_string;
+		case VT_VEC2:   return gkToString(get<gkVector2>());
+		case VT_VEC3:   return gkToString(get<gkVector3>());
+		case VT_VEC4:   return gkToString(get<gkVector4>());
+		case VT_QUAT:   return gkToString(get<gkQuaternion>());
+		case VT_MAT3:   return gkToString(get<gkMatrix3>());
+		case VT_MAT4:   return gkToString(get<gkMatrix4>());
+		default:
+			break;
+		}
 		return "";
 	}
 
-	GK_INLINE void fromString(const gkString& v) const
+	// Parses into the current type.
+	GK_INLINE void fromString(const gkString& v)
+	{
+		fromString(m_type, v);
+	}
+
+	void fromString(int type, const gkString& v)
 	{
-		if (m_data)
-			m_data->fromString(v);
+		switch (type)
+		{
+		case VT_BOOL:   { bool b;         gkFromString(v, b); set(b); } break;
+		case VT_INT:    { int i;          gkFromString(v, i); set(i); } break;
+		case VT_REAL:   { gkScalar f;     gkFromString(v, f); set(f); } break;
+		case VT_VEC2:   { gkVector2 r;    gkFromString(v, r); set(r); } break;
+		case VT_VEC3:   { gkVector3 r;    gkFromString(v, r); set(r); } break;
+		case VT_VEC4:   { gkVector4 r;    gkFromString(v, r); set(r); } break;
+		case VT_QUAT:   { gkQuaternion r; gkFromString(v, r); set(r); } break;
+		case VT_MAT3:   { gkMatrix3 r;    gkFromString(v, r); set(r); } break;
+		case VT_MAT4:   { gkMatrix4 r;    gkFromString(v, r); set(r); } break;
+		default:
+			set(v);
+			break;
+		}
 	}
 
 	GK_INLINE bool isTypeOf(const gkValue& v) const
 	{
-		return m_data && v.m_data && m_data->type() ==  v.m_data->type();
+		return m_type != VT_NULL && m_type == v.m_type;
 	}
 
-	GK_INLINE bool isTypeOf(const Info& v) const
+	GK_INLINE bool isTypeOf(int type) const
 	{
-		return m_data && m_data->type() ==  v;
+		return m_type != VT_NULL && m_type == type;
 	}
 };
 
 
+template<> struct gkValue::Traits<bool>         { enum { TYPE = VT_BOOL }; };
+template<> struct gkValue::Traits<int>          { enum { TYPE = VT_INT }; };
+template<> struct gkValue::Traits<gkScalar>     { enum { TYPE = VT_REAL }; };
+template<> struct gkValue::Traits<gkString>     { enum { TYPE = VT_STRING }; };
+template<> struct gkValue::Traits<gkVector2>    { enum { TYPE = VT_VEC2 }; };
+template<> struct gkValue::Traits<gkVector3>    { enum { TYPE = VT_VEC3 }; };
+template<> struct gkValue::Traits<gkVector4>    { enum { TYPE = VT_VEC4 }; };
+template<> struct gkValue::Traits<gkQuaternion> { enum { TYPE = VT_QUAT }; };
+template<> struct gkValue::Traits<gkMatrix3>    { enum { TYPE = VT_MAT3 }; };
+template<> struct gkValue::Traits<gkMatrix4>    { enum { TYPE = VT_MAT4 }; };
+
+
 #endif//_gkValue_h_
@@ -30,8 +30,7 @@
 
 
 gkVariable::gkVariable()
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
@@ -40,8 +39,7 @@ gkVariable::gkVariable()
 
 
 gkVariable::gkVariable(const gkString& n, bool dbg)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(),
 	     m_name(n),
 	     m_debug(dbg), m_lock(false)
 {
@@ -49,94 +47,82 @@ gkVariable::gkVariable(const gkString& n, bool dbg)
 
 
 gkVariable::gkVariable(bool v, const gkString& name)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(v),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
-	setValue(v);
 }
 
 
 gkVariable::gkVariable(int v, const gkString& name)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(v),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
-	setValue(v);
 }
 
 
 gkVariable::gkVariable(gkScalar v, const gkString& name)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(v),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
-	setValue(v);
 }
 
+
 gkVariable::gkVariable(const gkString& v, const gkString& name)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(v),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
-	setValue(v);
 }
 
+
 gkVariable::gkVariable(const gkVector2& v, const gkString& name)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(v),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
-	setValue(v);
 }
 
+
 gkVariable::gkVariable(const gkVector3& v, const gkString& name)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(v),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
-	setValue(v);
 }
 
+
 gkVariable::gkVariable(const gkVector4& v, const gkString& name)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(v),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
-	setValue(v);
 }
+
+
 gkVariable::gkVariable(const gkQuaternion& v, const gkString& name)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(v),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
-	setValue(v);
 }
 
+
 gkVariable::gkVariable(const gkMatrix3& v, const gkString& name)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(v),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
-	setValue(v);
 }
 
+
 gkVariable::gkVariable(const gkMatrix4& v, const gkString& name)
-	:    m_value((int)0),
-	     m_type(VAR_NULL),
+	:    m_value(v),
 	     m_name(""),
 	     m_debug(false), m_lock(false)
 {
-	setValue(v);
 }
 
 
@@ -160,121 +146,85 @@ void gkVariable::reset(void)
 
 gkVariable* gkVariable::clone(void)
 {
-	gkVariable* v = new gkVariable(*this);
-	v->m_value = gkValue(m_value);
-	return v;
+	return new gkVariable(*this);
 }
 
 
 void gkVariable::setValue(int type, const gkString& v)
 {
+	// parsed once here, the typed value is what gets compared
 	if (!m_lock)
-	{
-		m_type = type;
-		assign(v);
-	}
+		m_value.fromString(type, v);
 }
 
 
 void gkVariable::setValue(gkScalar v)
 {
 	if (!m_lock)
-	{
-		m_type = VAR_REAL;
 		m_value = v;
-	}
 }
 
 
-
 void gkVariable::setValue(bool v)
 {
 	if (!m_lock)
-	{
-		m_type = VAR_BOOL;
 		m_value = v;
-	}
 }
 
 
-
 void gkVariable::setValue(int v)
 {
 	if (!m_lock)
-	{
-		m_type = VAR_INT;
 		m_value = v;
-	}
 }
 
 
 void gkVariable::setValue(const gkString& v)
 {
 	if (!m_lock)
-	{
-		m_type = VAR_STRING;
 		m_value = v;
-	}
 }
 
 
 void gkVariable::setValue(const gkVector2& v)
 {
 	if (!m_lock)
-	{
-		m_type = VAR_VEC2;
 		m_value = v;
-	}
 }
 
 
 void gkVariable::setValue(const gkVector3& v)
 {
 	if (!m_lock)
-	{
-		m_type = VAR_VEC3;
 		m_value = v;
-	}
 }
 
 
 void gkVariable::setValue(const gkVector4& v)
 {
 	if (!m_lock)
-	{
-		m_type = VAR_VEC4;
 		m_value = v;
-	}
 }
 
 
 void gkVariable::setValue(const gkQuaternion& v)
 {
 	if (!m_lock)
-	{
-		m_type = VAR_QUAT;
 		m_value = v;
-	}
 }
 
 
 void gkVariable::setValue(const gkMatrix3& v)
 {
 	if (!m_lock)
-	{
-		m_type = VAR_MAT3;
 		m_value = v;
-	}
 }
 
 
 void gkVariable::setValue(const gkMatrix4& v)
 {
 	if (!m_lock)
-	{
-		m_type = VAR_MAT4;
 		m_value = v;
-	}
 }
 
 
@@ -282,7 +232,6 @@ void gkVariable::setValue(const gkVariable& v)
 {
 	if (!m_lock)
 	{
-		m_type  = v.m_type;
 		m_value = v.m_value;
 		m_debug = v.m_debug;
 		m_name  = v.m_name;
@@ -292,14 +241,20 @@ void gkVariable::setValue(const gkVariable& v)
 
 bool gkVariable::getValueBool(void) const
 {
-	switch (m_type)
+	switch (m_value.getType())
 	{
 	case VAR_INT:
-		return m_value.get<int>() != 0;
+		return m_value.getInt() != 0;
 	case VAR_REAL:
-		return m_value.get<gkScalar>() != 0.f;
+		return m_value.getReal() != 0.f;
 	case VAR_BOOL:
-		return m_value.get<bool>();
+		return m_value.getBool();
+	case VAR_STRING:
+		{
+			bool v;
+			gkFromString(m_value.getString(), v);
+			return v;
+		}
 	default:
 		{
 			bool v;
@@ -313,14 +268,20 @@ bool gkVariable::getValueBool(void) const
 
 gkScalar gkVariable::getValueReal(void) const
 {
-	switch (m_type)
+	switch (m_value.getType())
 	{
 	case VAR_INT:
-		return (gkScalar)m_value.get<int>();
+		return (gkScalar)m_value.getInt();
 	case VAR_REAL:
-		return m_value.get<gkScalar>();
+		return m_value.getReal();
 	case VAR_BOOL:
-		return m_value.get<bool>() ? 1.f : 0.f;
+		return m_value.getBool() ? 1.f : 0.f;
+	case VAR_STRING:
+		{
+			gkScalar v;
+			gkFromString(m_value.getString(), v);
+			return v;
+		}
 	default:
 		{
 			gkScalar v;
@@ -335,14 +296,20 @@ gkScalar gkVariable::getValueReal(void) const
 
 int gkVariable::getValueInt(void) const
 {
-	switch (m_type)
+	switch (m_value.getType())
 	{
 	case VAR_INT:
-		return m_value.get<int>(0);
+		return m_value.getInt();
 	case VAR_REAL:
-		return (int)m_value.get<gkScalar>(0.f);
+		return (int)m_value.getReal();
 	case VAR_BOOL:
-		return m_value.get<bool>(false) ? 1 : 0;
+		return m_value.getBool() ? 1 : 0;
+	case VAR_STRING:
+		{
+			int v;
+			gkFromString(m_value.getString(), v);
+			return v;
+		}
 	default:
 		{
 			int v;
@@ -398,9 +365,17 @@ gkMatrix4 gkVariable::getValueMatrix4(void) const
 }
 
 
+int gkVariable::compareString(const gkVariable& o) const
+{
+	if (m_value.getType() == VAR_STRING && o.m_value.getType() == VAR_STRING)
+		return m_value.getString().compare(o.m_value.getString());
+	return getValueString().compare(o.getValueString());
+}
+
+
 bool gkVariable::operator < (const gkVariable& o) const
 {
-	switch (m_type)
+	switch (m_value.getType())
 	{
 	case VAR_BOOL: return (int)getValueBool()  < (int)o.getValueBool();
 	case VAR_INT:  return getValueInt()        < o.getValueInt();
@@ -408,7 +383,7 @@ bool gkVariable::operator < (const gkVariable& o) const
 	case VAR_VEC2: return getValueVector2()    < o.getValueVector2();
 	case VAR_VEC3: return getValueVector3()    < o.getValueVector3();
 	default:
-		return getValueString() < o.getValueString();
+		return compareString(o) < 0;
 	}
 	return false;
 }
@@ -416,7 +391,7 @@ bool gkVariable::operator < (const gkVariable& o) const
 
 bool gkVariable::operator > (const gkVariable& o) const
 {
-	switch (m_type)
+	switch (m_value.getType())
 	{
 	case VAR_BOOL: return (int)getValueBool()  > (int)o.getValueBool();
 	case VAR_INT:  return getValueInt()        > o.getValueInt();
@@ -424,7 +399,7 @@ bool gkVariable::operator > (const gkVariable& o) const
 	case VAR_VEC2: return getValueVector2()    > o.getValueVector2();
 	case VAR_VEC3: return getValueVector3()    > o.getValueVector3();
 	default:
-		return getValueString() > o.getValueString();
+		return compareString(o) > 0;
 	}
 	return false;
 }
@@ -445,7 +420,7 @@ bool gkVariable::operator >= (const gkVariable& o) const
 
 bool gkVariable::operator == (const gkVariable& o) const
 {
-	switch (m_type)
+	switch (m_value.getType())
 	{
 	case VAR_BOOL: return (int)getValueBool()  == (int)o.getValueBool();
 	case VAR_INT:  return getValueInt()        == o.getValueInt();
@@ -457,7 +432,7 @@ bool gkVariable::operator == (const gkVariable& o) const
 	case VAR_MAT3: return getValueMatrix3()    == o.getValueMatrix3();
 	case VAR_MAT4: return getValueMatrix4()    == o.getValueMatrix4();
 	default:
-		return getValueString() == o.getValueString();
+		return compareString(o) == 0;
 	}
 	return false;
 }
@@ -473,10 +448,7 @@ bool gkVariable::operator != (const gkVariable& o) const
 void gkVariable::assign(const gkString& o)
 {
 	if (!m_lock)
-	{
-		m_type  = VAR_STRING;
 		m_value = o;
-	}
 }
 
 
@@ -486,7 +458,7 @@ void gkVariable::add(const gkString& o)
 	if (!m_lock)
 	{
 		gkVariable nv;
-		nv.setValue(o);
+		nv.setValue(getType(), o);
 		add(nv);
 	}
 }
@@ -498,7 +470,7 @@ void gkVariable::inverse(const gkString& o)
 	if (!m_lock)
 	{
 		gkVariable nv;
-		nv.setValue(o);
+		nv.setValue(getType(), o);
 		inverse(nv);
 	}
 }
@@ -518,10 +490,7 @@ void gkVariable::toggle(const gkString& o)
 void gkVariable::assign(const gkVariable& nv)
 {
 	if (!m_lock)
-	{
-		m_type  = nv.m_type;
 		m_value = nv.m_value;
-	}
 }
 
 
@@ -529,7 +498,7 @@ void gkVariable::add(const gkVariable& nv)
 {
 	if (!m_lock)
 	{
-		switch (m_type)
+		switch (m_value.getType())
 		{
 		case VAR_BOOL:  setValue(getValueBool()      != nv.getValueBool());       break;
 		case VAR_INT:   setValue(getValueInt()        + nv.getValueInt());        break;
@@ -551,7 +520,7 @@ void gkVariable::add(const gkVariable& nv)
 
 bool gkVariable::hasInverse(void)
 {
-	switch (m_type)
+	switch (m_value.getType())
 	{
 	case VAR_BOOL:
 	case VAR_INT:
@@ -574,7 +543,7 @@ void gkVariable::inverse(const gkVariable& nv)
 {
 	if (!m_lock)
 	{
-		switch (m_type)
+		switch (m_value.getType())
 		{
 		case VAR_BOOL:  setValue(!nv.getValueBool());            break;
 		case VAR_INT:   setValue(nv.getValueInt()  ? 0   : 1);   break;
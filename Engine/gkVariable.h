@@ -73,12 +73,13 @@ public:
 
 	gkVariable* clone(void);
 
-	GK_INLINE int   getType(void) const           { return m_type;}
+	GK_INLINE int   getType(void) const           { return m_value.getType();}
 	GK_INLINE void  setDebug(bool v)              { m_debug = v;}
 	GK_INLINE void  setReadOnly(bool v)           { m_lock = v;}
 	GK_INLINE bool  isReadOnly(void)              { return m_lock;}
 	GK_INLINE bool  isDebug(void) const           { return m_debug; }
 	GK_INLINE const gkString& getName(void) const { return m_name; }
+	GK_INLINE const gkValue& getValue(void) const { return m_value; }
 
 	void setValue(int type, const gkString& v);
 
@@ -136,9 +137,10 @@ public:
 
 private:
 
+	int compareString(const gkVariable& o) const;
+
 	gkValue         m_value;
 	gkValue         m_default;
-	int          m_type;
 	gkString     m_name;
 	bool         m_debug, m_lock;
 };
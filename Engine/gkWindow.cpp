@@ -34,6 +34,7 @@
 #include "gkWindowSystem.h"
 #include "gkWindow.h"
 #include "gkViewport.h"
+#include "gkInputLog.h"
 
 #include "OgreRenderWindow.h"
 #include "OgreRoot.h"
@@ -432,6 +433,70 @@ void gkWindow::clearStates(void)
 		m_joysticks[i]->clear();
 }
 
+bool gkWindow::replayInput(gkInputPlayer& player, UTuint32& tick)
+{
+	// same per tick reset as dispatch, the log holds what the devices changed
+	m_mouse.moved = false;
+	m_mouse.wheelDelta = 0.f;
+	m_mouse.relative.x = 0.f;
+	m_mouse.relative.y = 0.f;
+
+	// a headless or different machine may lack the recorded joysticks
+	const gkInputLog::Joysticks& layout = player.getLayout();
+	while (m_joysticks.size() < layout.size())
+	{
+		const gkJoystick* js = layout[m_joysticks.size()];
+		m_joysticks.push_back(new gkJoystick(js->buttons.size(), js->axes.size()));
+	}
+
+	gkInputChanges changes;
+	if (!player.play(tick, m_keyboard, m_mouse, m_joysticks, changes))
+		return false;
+
+	gkWindowSystem::Listener* node = m_listeners.begin();
+	while (node)
+	{
+		UTsize i;
+		for (i = 0; i < changes.keys.size(); i++)
+		{
+			int kc = changes.keys[i];
+			if (m_keyboard.keys[kc] == GK_Pressed)
+				node->keyPressed(m_keyboard, (gkScanCode)kc);
+			else if (m_keyboard.keys[kc] == GK_Released)
+				node->keyReleased(m_keyboard, (gkScanCode)kc);
+		}
+
+		for (i = 0; i < changes.buttons.size(); i++)
+		{
+			int state = m_mouse.buttons[changes.buttons[i]];
+			if (state == GK_Pressed)
+				node->mousePressed(m_mouse);
+			else if (state == GK_Released)
+				node->mouseReleased(m_mouse);
+		}
+
+		if (changes.mouseMoved)
+			node->mouseMoved(m_mouse);
+
+		for (i = 0; i < changes.joysticks.size(); i++)
+		{
+			const gkInputChanges::Joystick& change = changes.joysticks[i];
+			const gkJoystick& js = *m_joysticks[change.joystick];
+
+			if (change.axis)
+				node->joystickMoved(js, change.index);
+			else if (js.buttons[change.index] == GK_Pressed)
+				node->joystickPressed(js, change.index);
+			else if (js.buttons[change.index] == GK_Released)
+				node->joystickReleased(js, change.index);
+		}
+
+		node = node->getNext();
+	}
+
+	return true;
+}
+
 bool gkWindow::mouseMoved(const OIS::MouseEvent& arg)
 {
 	gkMouse& data = m_mouse;
@@ -715,6 +780,9 @@ gkScene* gkWindow::getRenderScene(void)
 
 gkString gkWindow::writeContentsToTimestampedFile(const gkString& filenamePrefix, const gkString& filenameSuffix)
 {
+	if (!m_rwindow)
+		return "";
+
 	gkString suffix;
 	if (filenameSuffix.find(".") != gkString::npos)
 		suffix = filenameSuffix;
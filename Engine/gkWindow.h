@@ -36,6 +36,8 @@
 #include "gkInput.h"
 #include "gkWindowSystem.h"
 
+class gkInputPlayer;
+
 #ifdef OGREKIT_COMPILE_LIBROCKET
 #include "GUI/gkGUI.h"
 #endif
@@ -116,6 +118,9 @@ public:
 
 	virtual void clearStates(void);
 
+	// Takes this tick's input from a log instead of the devices, false once it ran out.
+	bool replayInput(gkInputPlayer& player, UTuint32& tick);
+
 	void addListener(gkWindowSystem::Listener* l);
 	void removeListener(gkWindowSystem::Listener* l);
 
@@ -147,8 +152,8 @@ public:
 	GK_INLINE UTsize getViewportCount(void)			{ return m_viewports.size(); }
 	GK_INLINE gkViewport* getViewport(UTsize i)		{ return m_viewports[i]; }
 
-	GK_INLINE int getWidth(void)					{ return (int)m_rwindow->getWidth();  }
-	GK_INLINE int getHeight(void)					{ return (int)m_rwindow->getHeight(); }
+	GK_INLINE int getWidth(void)					{ return m_rwindow ? (int)m_rwindow->getWidth()  : m_requestedWidth;  }
+	GK_INLINE int getHeight(void)					{ return m_rwindow ? (int)m_rwindow->getHeight() : m_requestedHeight; }
 	GK_INLINE gkVector2 getSize(void)				{ return gkVector2(getWidth(), getHeight()); }
 
 	GK_INLINE int getRequestedWidth(void)			{ return m_requestedWidth;  }
@@ -158,6 +163,7 @@ public:
 	GK_INLINE gkKeyboard* getKeyboard(void)			{ return &m_keyboard; }
 	GK_INLINE unsigned int getNumJoysticks(void)	{ return m_joysticks.size(); }
 	GK_INLINE gkJoystick* getJoystick(int index)	{ return (index >= (int)m_joysticks.size() || index < 0) ? 0 : m_joysticks[index]; }
+	GK_INLINE const utArray<gkJoystick*>& getJoysticks(void) { return m_joysticks; }
 
 	gkScene* getRenderScene(void);
 	void setRenderScene(gkScene* scene);
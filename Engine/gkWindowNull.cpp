@@ -0,0 +1,73 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "gkCommon.h"
+#include "gkWindowNull.h"
+#include "gkUserDefs.h"
+
+
+
+gkWindowNull::gkWindowNull()
+{
+}
+
+
+gkWindowNull::~gkWindowNull()
+{
+}
+
+
+bool gkWindowNull::createWindow(gkWindowSystem* sys, const gkUserDefs& prefs)
+{
+	if (!sys)
+		return false;
+
+	m_sys = sys;
+
+	m_requestedWidth  = (int)(prefs.winsize.x + 0.5f);
+	m_requestedHeight = (int)(prefs.winsize.y + 0.5f);
+	m_framingType     = prefs.framingType;
+
+	// keep hit testing consistent with a real window of the requested size
+	m_mouse.winsize.x = (gkScalar)m_requestedWidth;
+	m_mouse.winsize.y = (gkScalar)m_requestedHeight;
+
+	return setupInput(prefs);
+}
+
+
+void gkWindowNull::dispatch(void)
+{
+	m_mouse.moved = false;
+	m_mouse.wheelDelta = 0.f;
+	m_mouse.relative.x = 0.f;
+	m_mouse.relative.y = 0.f;
+}
+
+
+void gkWindowNull::process(void)
+{
+}
@@ -0,0 +1,50 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#ifndef _gkWindowNull_h_
+#define _gkWindowNull_h_
+
+#include "gkWindow.h"
+
+
+///Window without a render target or input devices, used by the headless mode.
+///Input state objects exist but are only changed by whoever feeds them directly.
+class gkWindowNull : public gkWindow
+{
+protected:
+	virtual bool setupInput(const gkUserDefs& prefs) { return true; }
+
+public:
+	gkWindowNull();
+	virtual ~gkWindowNull();
+
+	virtual bool createWindow(gkWindowSystem* sys, const gkUserDefs& prefs);
+
+	virtual void dispatch(void);
+	virtual void process(void);
+};
+
+#endif//_gkWindowNull_h_
@@ -32,6 +32,10 @@
 #include "gkEngine.h"
 #include "gkScene.h"
 #include "gkWindow.h"
+#include "gkWindowNull.h"
+#include "gkInputLog.h"
+#include "gkTickState.h"
+#include "utStreams.h"
 
 #include "OgreRenderWindow.h"
 #include "OgreRoot.h"
@@ -57,7 +61,10 @@
 UT_IMPLEMENT_SINGLETON(gkWindowSystem);
 
 gkWindowSystem::gkWindowSystem() 
-	:	m_exit(false)
+	:	m_exit(false),
+		m_recorder(0),
+		m_player(0),
+		m_replayDesync(false)
 {
 
 }
@@ -65,6 +72,9 @@ gkWindowSystem::gkWindowSystem()
 
 gkWindowSystem::~gkWindowSystem()
 {
+	stopRecording();
+	stopReplay();
+
 	UTsize i;
 	for (i = 0; i < m_windows.size(); i++)
 		delete m_windows[i];
@@ -76,14 +86,19 @@ gkWindowSystem::~gkWindowSystem()
 // Creates the render window, and sets up the OIS input system
 gkWindow* gkWindowSystem::createWindow(const gkUserDefs& prefs)
 {
+	gkWindow* window;
+
+	if (prefs.headless)
+		window = new gkWindowNull();
+	else
 #ifdef OGREKIT_BUILD_IPHONE
-	gkWindow* window = new gkWindowIOS();
+		window = new gkWindowIOS();
 #elif defined(OGREKIT_BUILD_ANDROID)
-	gkWindow* window = new gkWindowAndroid();
+		window = new gkWindowAndroid();
 #elif defined(OGREKIT_BUILD_NACL)
-	gkWindow* window = new gkWindowNaCl();
+		window = new gkWindowNaCl();
 #else
-	gkWindow* window = new gkWindow();
+		window = new gkWindow();
 #endif
 
 	if (!window->createWindow(this, prefs))
@@ -142,9 +157,92 @@ void gkWindowSystem::process(void)
 // Handle platform messages
 void gkWindowSystem::dispatch(void)
 {
+	UTuint32 tick = (UTuint32)gkEngine::getSingleton().getTickState().getTickCount();
+
 	UTsize i;
 	for (i = 0; i < m_windows.size(); i++)
-		m_windows[i]->dispatch();
+	{
+		if (i != 0 || !m_player)
+		{
+			m_windows[i]->dispatch();
+			continue;
+		}
+
+		UTuint32 logged;
+		if (!m_windows[i]->replayInput(*m_player, logged))
+		{
+			gkLogMessage("WindowSystem: Input replay finished after " << m_player->getFrameCount() << " ticks.");
+			stopReplay();
+			m_exit = true;
+		}
+		else if (logged != tick && !m_replayDesync)
+		{
+			gkLogMessage("WindowSystem: Input replay out of sync, recorded tick " << logged << " replayed at " << tick << ".");
+			m_replayDesync = true;
+		}
+	}
+
+	gkWindow* window = getMainWindow();
+	if (m_recorder && window)
+		m_recorder->record(tick, *window->getKeyboard(), *window->getMouse(), window->getJoysticks());
+}
+
+
+bool gkWindowSystem::startRecording(const gkString& path)
+{
+	gkWindow* window = getMainWindow();
+	if (!window)
+		return false;
+
+	stopRecording();
+
+	utFileStream* fs = new utFileStream();
+	fs->open(path.c_str(), utStream::SM_WRITE);
+	if (!fs->isOpen())
+	{
+		gkLogMessage("WindowSystem: Can't record input to " << path << ".");
+		delete fs;
+		return false;
+	}
+
+	m_recorder = new gkInputRecorder(fs);
+	m_recorder->begin(window->getJoysticks());
+	return true;
+}
+
+
+void gkWindowSystem::stopRecording(void)
+{
+	delete m_recorder;
+	m_recorder = 0;
+}
+
+
+bool gkWindowSystem::startReplay(const gkString& path)
+{
+	stopReplay();
+
+	utFileStream* fs = new utFileStream();
+	fs->open(path.c_str(), utStream::SM_READ);
+
+	gkInputPlayer* player = new gkInputPlayer(fs);
+	if (!fs->isOpen() || !player->begin())
+	{
+		gkLogMessage("WindowSystem: " << path << " is not an input log.");
+		delete player;
+		return false;
+	}
+
+	m_player = player;
+	m_replayDesync = false;
+	return true;
+}
+
+
+void gkWindowSystem::stopReplay(void)
+{
+	delete m_player;
+	m_player = 0;
 }
 
 
@@ -32,6 +32,8 @@
 #include "gkInput.h"
 
 class gkWindowIOS;
+class gkInputRecorder;
+class gkInputPlayer;
 
 class gkWindowSystem : public utSingleton<gkWindowSystem>
 {
@@ -58,6 +60,10 @@ protected:
 	utArray<gkWindow*>		m_windows;
 	bool					m_exit;
 
+	gkInputRecorder*		m_recorder;
+	gkInputPlayer*			m_player;
+	bool					m_replayDesync;		// tick mismatch already reported
+
 public:
 	gkWindowSystem();
 	virtual ~gkWindowSystem();
@@ -80,6 +86,16 @@ public:
 
 	void clearStates(void);
 
+	// Per tick input log of the main window, for repeatable runs with a fixed tick.
+	// The replay feeds the main window's state objects and requests exit at its end.
+	bool startRecording(const gkString& path);
+	void stopRecording(void);
+	bool startReplay(const gkString& path);
+	void stopReplay(void);
+
+	GK_INLINE bool isRecording(void)    { return m_recorder != 0; }
+	GK_INLINE bool isReplaying(void)    { return m_player != 0; }
+
 	GK_INLINE void exit(bool v)         { m_exit = v; }
 	GK_INLINE bool exitRequest(void)	{ return m_exit; }
 
@@ -0,0 +1,710 @@
+/*
+-------------------------------------------------------------------------------
+    This file is part of OgreKit.
+    http://gamekit.googlecode.com/
+
+    Copyright (c) 2006-2013 Charlie C.
+
+    Contributor(s): none yet.
+-------------------------------------------------------------------------------
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "tclap/CmdLine.h"
+#include "OgreKit.h"
+#include "gkProfiler.h"
+#include "gkFrameArena.h"
+#include "Thread/gkAtomic.h"
+#include "OgreFileSystem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#ifdef WIN32
+# include <windows.h>
+# include <psapi.h>
+#else
+# include <sys/resource.h>
+#endif
+
+
+// Headless benchmark over a set of .blend files.
+//
+// Every file is loaded through gkBlendLoader, its main scene is instanced and
+// run for a fixed number of ticks without rendering. Load and instancing time,
+// the tick time distribution, per zone profiler rollups, operator new counts and
+// peak memory go to a JSON report, which --baseline compares against a stored one.
+
+
+// ----------------------------------------------------------------------------
+// operator new accounting, sizes live in a prefix so delete can subtract them
+
+#define BENCH_ALLOC_PREFIX 16
+
+static gkAtomicInt gkBenchAllocations;
+static gkAtomicInt gkBenchLiveBytes;
+static gkAtomicInt gkBenchPeakBytes;
+
+static void* gkBenchAlloc(size_t size)
+{
+	char* p = (char*)malloc(size + BENCH_ALLOC_PREFIX);
+	if (!p)
+		return 0;
+
+	*(size_t*)p = size;
+
+	gkBenchAllocations.increment();
+	int live = gkBenchLiveBytes.add((int)size);
+	int peak = gkBenchPeakBytes.get();
+	while (live > peak && !gkBenchPeakBytes.compareAndSwap(peak, live))
+		peak = gkBenchPeakBytes.get();
+
+	return p + BENCH_ALLOC_PREFIX;
+}
+
+static void gkBenchFree(void* ptr)
+{
+	if (!ptr)
+		return;
+
+	char* p = (char*)ptr - BENCH_ALLOC_PREFIX;
+	gkBenchLiveBytes.add(-(int)*(size_t*)p);
+	free(p);
+}
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+	void* p = gkBenchAlloc(size);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+	void* p = gkBenchAlloc(size);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) throw()   { return gkBenchAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) throw() { return gkBenchAlloc(size); }
+void operator delete(void* p) throw()                            { gkBenchFree(p); }
+void operator delete[](void* p) throw()                          { gkBenchFree(p); }
+void operator delete(void* p, const std::nothrow_t&) throw()     { gkBenchFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) throw()   { gkBenchFree(p); }
+
+
+// process wide, so it only grows from file to file
+static UTuint64 gkBenchPeakRss(void)
+{
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		return (UTuint64)pmc.PeakWorkingSetSize;
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+# ifdef __APPLE__
+	return (UTuint64)usage.ru_maxrss;
+# else
+	return (UTuint64)usage.ru_maxrss * 1024;
+# endif
+#endif
+}
+
+
+// ----------------------------------------------------------------------------
+// results
+
+struct gkBenchZone
+{
+	double  ms;         // per tick mean
+	UTsize  calls;      // total
+};
+
+struct gkBenchResult
+{
+	gkString    file;
+	bool        ok;
+	int         ticks;
+	double      loadMs, instanceMs;
+	double      tickMean, tickMedian, tickP95, tickMax;
+	int         allocations;        // operator new calls while loading and ticking
+	int         peakBytes;          // operator new high water mark
+	double      tickAllocations;    // operator new calls per measured tick
+	int         arenaPeakBytes;     // gkFrameArena high water mark over all threads
+	UTuint64    peakRss;
+
+	std::map<gkString, gkBenchZone> zones;
+
+	gkBenchResult()
+		:   ok(false), ticks(0), loadMs(0), instanceMs(0),
+		    tickMean(0), tickMedian(0), tickP95(0), tickMax(0),
+		    allocations(0), peakBytes(0), tickAllocations(0), arenaPeakBytes(0), peakRss(0)
+	{
+	}
+};
+
+typedef std::vector<gkBenchResult> gkBenchResults;
+
+
+static double gkBenchMs(UTuint64 begin, UTuint64 end)
+{
+	return double(end - begin) / 1000000.0;
+}
+
+
+// Instances a loaded scene and measures its ticks, allocations count from 'allocations'.
+static void gkBenchRunScene(gkEngine& engine, gkScene* scene, gkBenchResult& result, int allocations,
+                            UTuint64 start, int warmup, int ticks)
+{
+	UTuint64 loaded = gkProfiler::now();
+	scene->createInstance();
+	UTuint64 instanced = gkProfiler::now();
+
+	result.loadMs = gkBenchMs(start, loaded);
+	result.instanceMs = gkBenchMs(loaded, instanced);
+
+	std::vector<double> times;
+	times.reserve(ticks);
+
+	gkWindowSystem::getSingleton().exit(false);
+
+	int tickAllocations = 0;
+
+	if (engine.initializeStepLoop())
+	{
+		bool running = true;
+		for (int i = 0; running && i < warmup + ticks; i++)
+		{
+			int allocated = gkBenchAllocations.get();
+			UTuint64 begin = gkProfiler::now();
+			running = engine.stepOneFrame();
+			UTuint64 end = gkProfiler::now();
+
+			if (i < warmup)
+				continue;
+
+			tickAllocations += gkBenchAllocations.get() - allocated;
+			times.push_back(gkBenchMs(begin, end));
+
+			const gkProfiler::Rollups& rollups = gkProfiler::getSingleton().getLastFrame();
+			for (UTsize z = 0; z < rollups.size(); z++)
+			{
+				gkBenchZone& zone = result.zones[rollups[z].zone->getName()];
+				zone.ms += double(rollups[z].time) / 1000000.0;
+				zone.calls += rollups[z].calls;
+			}
+		}
+
+		engine.finalizeStepLoop();
+	}
+
+	result.allocations = gkBenchAllocations.get() - allocations;
+	result.peakBytes = gkBenchPeakBytes.get();
+	result.peakRss = gkBenchPeakRss();
+	result.arenaPeakBytes = (int)gkFrameArena::getTotalPeakBytes();
+
+	scene->destroyInstance();
+
+	result.ticks = (int)times.size();
+	result.ok = !times.empty();
+	if (!result.ok)
+		return;
+
+	double sum = 0;
+	for (UTsize i = 0; i < times.size(); i++)
+		sum += times[i];
+
+	std::sort(times.begin(), times.end());
+	result.tickMean = sum / times.size();
+	result.tickMedian = times[times.size() / 2];
+	result.tickP95 = times[gkMin<UTsize>(times.size() - 1, (UTsize)(times.size() * 0.95))];
+	result.tickMax = times.back();
+	result.tickAllocations = double(tickAllocations) / result.ticks;
+
+	std::map<gkString, gkBenchZone>::iterator it;
+	for (it = result.zones.begin(); it != result.zones.end(); ++it)
+		it->second.ms /= result.ticks;
+}
+
+
+static gkBenchResult gkBenchRunFile(gkEngine& engine, const gkString& path, int warmup, int ticks)
+{
+	gkBenchResult result;
+	result.file = gkPath(path).base();
+
+	int allocations = gkBenchAllocations.get();
+	gkBenchPeakBytes.set(gkBenchLiveBytes.get());
+
+	UTuint64 start = gkProfiler::now();
+
+	gkBlendFile* blend = gkBlendLoader::getSingleton().loadFile(path, gkBlendLoader::LO_ALL_SCENES | gkBlendLoader::LO_CREATE_UNIQUE_GROUP);
+	gkScene* scene = blend ? blend->getMainScene() : 0;
+	if (!scene)
+	{
+		gkLogMessage("Benchmark: " << path << " has no usable scene.");
+		if (blend)
+			gkBlendLoader::getSingleton().unloadFile(blend);
+		return result;
+	}
+
+	gkBenchRunScene(engine, scene, result, allocations, start, warmup, ticks);
+	gkBlendLoader::getSingleton().unloadFile(blend);
+	return result;
+}
+
+
+// Synthetic scene with 'bricks' logic bricks in sensor, controller, actuator
+// chains. Half the chains stay on, the other half switch on and off every
+// tick, so the actuator lists see constant churn around a large resident set.
+static gkBenchResult gkBenchRunLogic(gkEngine& engine, int bricks, int warmup, int ticks)
+{
+	gkBenchResult result;
+	result.file = "logicbricks-" + gkToString(bricks);
+
+	int allocations = gkBenchAllocations.get();
+	gkBenchPeakBytes.set(gkBenchLiveBytes.get());
+
+	UTuint64 start = gkProfiler::now();
+
+	gkScene* scene = gkSceneManager::getSingleton().createEmptyScene("LogicBricks", "Camera", "LogicBricks");
+	gkLogicManager* logic = scene->getLogicBrickManager();
+
+	char name[32];
+	int chains = gkMax(1, bricks / 3);
+	for (int i = 0; i < chains; i++)
+	{
+		sprintf(name, "Logic%i", i);
+		gkGameObject* obj = scene->createObject(name);
+
+		gkLogicLink* link = logic->createLink();
+		link->setState(1);
+		link->setObject(obj);
+		obj->setState(1);
+		obj->attachLogic(link);
+		obj->createVariable("count", false)->setValue(0);
+
+		gkPropertyActuator* act = new gkPropertyActuator(obj, link, "Add");
+		act->setType(gkPropertyActuator::PA_ADD);
+		act->setProperty("count");
+		act->setValue("1");
+		link->push(act);
+
+		gkLogicOpController* cont = new gkLogicOpController(obj, link, "And");
+		cont->setOp(gkLogicOpController::OP_AND);
+		cont->setMask(1);
+		cont->link(act);
+		link->push(cont);
+
+		gkLogicSensor* sens;
+		if (i & 1)
+		{
+			gkDelaySensor* delay = new gkDelaySensor(obj, link, "Toggle");
+			delay->setDelay(1);
+			delay->setDuration(1);
+			delay->setRepeat(true);
+			sens = delay;
+		}
+		else
+			sens = new gkAlwaysSensor(obj, link, "Always");
+
+		sens->link(cont);
+		sens->setStartState(1);
+		sens->setMode(gkLogicSensor::PM_TRUE);
+		link->push(sens);
+	}
+
+	gkBenchRunScene(engine, scene, result, allocations, start, warmup, ticks);
+	gkSceneManager::getSingleton().destroy(scene);
+	return result;
+}
+
+
+// ----------------------------------------------------------------------------
+// JSON report
+
+static gkString gkBenchQuote(const gkString& str)
+{
+	gkString out = "\"";
+	for (UTsize i = 0; i < str.size(); i++)
+	{
+		if (str[i] == '"' || str[i] == '\\')
+			out += '\\';
+		out += str[i];
+	}
+	return out + "\"";
+}
+
+
+static bool gkBenchWriteJson(const gkString& path, const gkBenchResults& results, int ticks)
+{
+	FILE* fp = path.empty() ? stdout : fopen(path.c_str(), "wb");
+	if (!fp)
+	{
+		fprintf(stderr, "error: can't write %s\n", path.c_str());
+		return false;
+	}
+
+	fprintf(fp, "{\n  \"ticks\": %d,\n  \"tickRate\": %g,\n  \"results\": [\n", ticks, (double)gkEngine::getTickRate());
+
+	for (UTsize i = 0; i < results.size(); i++)
+	{
+		const gkBenchResult& r = results[i];
+
+		fprintf(fp, "    {\"file\": %s, \"ok\": %s, \"ticks\": %d,\n", gkBenchQuote(r.file).c_str(), r.ok ? "true" : "false", r.ticks);
+		fprintf(fp, "     \"loadMs\": %.4f, \"instanceMs\": %.4f,\n", r.loadMs, r.instanceMs);
+		fprintf(fp, "     \"tickMs\": {\"mean\": %.4f, \"median\": %.4f, \"p95\": %.4f, \"max\": %.4f},\n",
+		        r.tickMean, r.tickMedian, r.tickP95, r.tickMax);
+		fprintf(fp, "     \"allocations\": %d, \"peakBytes\": %d, \"peakRss\": %llu,\n",
+		        r.allocations, r.peakBytes, (unsigned long long)r.peakRss);
+		fprintf(fp, "     \"tickAllocations\": %.2f, \"arenaPeakBytes\": %d,\n", r.tickAllocations, r.arenaPeakBytes);
+
+		fprintf(fp, "     \"zones\": {");
+		std::map<gkString, gkBenchZone>::const_iterator it;
+		for (it = r.zones.begin(); it != r.zones.end(); ++it)
+		{
+			fprintf(fp, "%s\n       %s: {\"ms\": %.4f, \"calls\": %u}", it == r.zones.begin() ? "" : ",",
+			        gkBenchQuote(it->first).c_str(), it->second.ms, (unsigned int)it->second.calls);
+		}
+		fprintf(fp, "}}%s\n", i + 1 < results.size() ? "," : "");
+	}
+
+	fprintf(fp, "  ]\n}\n");
+
+	if (fp != stdout)
+		fclose(fp);
+	return true;
+}
+
+
+// Just enough JSON to read a report back.
+class gkBenchJson
+{
+public:
+	enum Type { JS_NULL, JS_BOOL, JS_NUMBER, JS_STRING, JS_ARRAY, JS_OBJECT };
+
+	Type                                type;
+	double                              number;
+	gkString                            string;
+	std::vector<gkBenchJson>            array;
+	std::map<gkString, gkBenchJson>     object;
+
+	gkBenchJson() : type(JS_NULL), number(0) {}
+
+	const gkBenchJson& operator[](const gkString& key) const
+	{
+		static gkBenchJson none;
+		std::map<gkString, gkBenchJson>::const_iterator it = object.find(key);
+		return it != object.end() ? it->second : none;
+	}
+
+	static bool parse(const char*& p, gkBenchJson& out)
+	{
+		skip(p);
+
+		if (*p == '{')
+		{
+			out.type = JS_OBJECT;
+			for (++p, skip(p); *p && *p != '}'; skip(p))
+			{
+				gkBenchJson key;
+				if (!parse(p, key) || key.type != JS_STRING)
+					return false;
+
+				skip(p);
+				if (*p++ != ':' || !parse(p, out.object[key.string]))
+					return false;
+
+				skip(p);
+				if (*p == ',')
+					p++;
+			}
+			return *p++ == '}';
+		}
+
+		if (*p == '[')
+		{
+			out.type = JS_ARRAY;
+			for (++p, skip(p); *p && *p != ']'; skip(p))
+			{
+				out.array.push_back(gkBenchJson());
+				if (!parse(p, out.array.back()))
+					return false;
+
+				skip(p);
+				if (*p == ',')
+					p++;
+			}
+			return *p++ == ']';
+		}
+
+		if (*p == '"')
+		{
+			out.type = JS_STRING;
+			for (++p; *p && *p != '"'; p++)
+			{
+				if (*p == '\\' && p[1])
+					p++;
+				out.string += *p;
+			}
+			return *p++ == '"';
+		}
+
+		if (!strncmp(p, "true", 4) || !strncmp(p, "false", 5))
+		{
+			out.type = JS_BOOL;
+			out.number = *p == 't' ? 1 : 0;
+			p += *p == 't' ? 4 : 5;
+			return true;
+		}
+
+		if (!strncmp(p, "null", 4))
+		{
+			p += 4;
+			return true;
+		}
+
+		char* end;
+		out.type = JS_NUMBER;
+		out.number = strtod(p, &end);
+		if (end == p)
+			return false;
+
+		p = end;
+		return true;
+	}
+
+private:
+	static void skip(const char*& p)
+	{
+		while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+			p++;
+	}
+};
+
+
+static bool gkBenchReadJson(const gkString& path, gkBenchJson& root)
+{
+	FILE* fp = fopen(path.c_str(), "rb");
+	if (!fp)
+		return false;
+
+	gkString text;
+	char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+		text.append(buf, n);
+	fclose(fp);
+
+	const char* p = text.c_str();
+	return gkBenchJson::parse(p, root) && root.type == gkBenchJson::JS_OBJECT;
+}
+
+
+// Flags a metric that grew past the threshold and past a noise floor.
+static bool gkBenchRegressed(const gkString& file, const char* metric, double base, double cur, double threshold, double floor)
+{
+	if (cur <= base * (1.0 + threshold) || cur - base <= floor)
+		return false;
+
+	printf("REGRESSION %s %s: %.4f -> %.4f (%+.1f%%)\n", file.c_str(), metric, base, cur,
+	       base > 0 ? 100.0 * (cur - base) / base : 100.0);
+	return true;
+}
+
+
+static int gkBenchCompare(const gkBenchJson& baseline, const gkBenchResults& results, double threshold)
+{
+	std::map<gkString, const gkBenchJson*> base;
+
+	const std::vector<gkBenchJson>& entries = baseline["results"].array;
+	for (UTsize i = 0; i < entries.size(); i++)
+		base[entries[i]["file"].string] = &entries[i];
+
+	int regressions = 0;
+	for (UTsize i = 0; i < results.size(); i++)
+	{
+		const gkBenchResult& r = results[i];
+
+		std::map<gkString, const gkBenchJson*>::iterator it = base.find(r.file);
+		if (it == base.end())
+		{
+			printf("NEW        %s\n", r.file.c_str());
+			continue;
+		}
+
+		const gkBenchJson& b = *it->second;
+		if (!r.ok)
+		{
+			if (b["ok"].number != 0)
+			{
+				printf("REGRESSION %s: no longer runs\n", r.file.c_str());
+				regressions++;
+			}
+			continue;
+		}
+
+		const gkBenchJson& tick = b["tickMs"];
+		int before = regressions;
+
+		regressions += gkBenchRegressed(r.file, "tick mean ms",   tick["mean"].number,        r.tickMean,     threshold, 0.05);
+		regressions += gkBenchRegressed(r.file, "tick p95 ms",    tick["p95"].number,         r.tickP95,      threshold, 0.10);
+		regressions += gkBenchRegressed(r.file, "load ms",        b["loadMs"].number,         r.loadMs,       threshold, 5.0);
+		regressions += gkBenchRegressed(r.file, "instance ms",    b["instanceMs"].number,     r.instanceMs,   threshold, 2.0);
+		regressions += gkBenchRegressed(r.file, "allocations",    b["allocations"].number,    r.allocations,  threshold, 64);
+		regressions += gkBenchRegressed(r.file, "peak bytes",     b["peakBytes"].number,      r.peakBytes,    threshold, 65536);
+		if (b["tickAllocations"].type == gkBenchJson::JS_NUMBER)
+			regressions += gkBenchRegressed(r.file, "tick allocations", b["tickAllocations"].number, r.tickAllocations, threshold, 2);
+
+		if (regressions == before)
+			printf("OK         %s\n", r.file.c_str());
+	}
+
+	printf("%d regression(s) at %.0f%% threshold\n", regressions, threshold * 100.0);
+	return regressions;
+}
+
+
+// ----------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+	std::vector<std::string> files;
+	gkString dir, output, baseline;
+	int ticks = 600, warmup = 30, jobThreads = 0, logicBricks = 0;
+	double threshold = 0.1;
+
+	try
+	{
+		TCLAP::CmdLine cmdl("OgreKit headless benchmark", ' ', "n/a");
+		cmdl.setExceptionHandling(false);
+
+		TCLAP::ValueArg<std::string>	dir_arg			("d", "dir",			"Benchmark every .blend in this directory.", false, "", "string");
+		TCLAP::ValueArg<int>			ticks_arg		("n", "ticks",			"Fixed ticks measured per file.", false, ticks, "int");
+		TCLAP::ValueArg<int>			warmup_arg		("w", "warmup",			"Ticks run before measuring.", false, warmup, "int");
+		TCLAP::ValueArg<int>			jobs_arg		("j", "jobthreads",		"Job system workers, -1 for one per core.", false, jobThreads, "int");
+		TCLAP::ValueArg<std::string>	output_arg		("o", "output",			"JSON report file, stdout if empty.", false, "", "string");
+		TCLAP::ValueArg<std::string>	baseline_arg	("b", "baseline",		"Compare against this report, exit code is the regression count.", false, "", "string");
+		TCLAP::ValueArg<float>			threshold_arg	("t", "threshold",		"Relative growth counted as regression.", false, (float)threshold, "float");
+		TCLAP::ValueArg<int>			logic_arg		("l", "logicbricks",	"Also run a synthetic scene with this many logic bricks.", false, logicBricks, "int");
+		TCLAP::UnlabeledMultiArg<std::string> files_arg	("blend-files", "Blender files to benchmark.", false, "string");
+
+		cmdl.add(dir_arg);
+		cmdl.add(ticks_arg);
+		cmdl.add(warmup_arg);
+		cmdl.add(jobs_arg);
+		cmdl.add(output_arg);
+		cmdl.add(baseline_arg);
+		cmdl.add(threshold_arg);
+		cmdl.add(logic_arg);
+		cmdl.add(files_arg);
+
+		cmdl.parse(argc, argv);
+
+		dir         = dir_arg.getValue();
+		ticks       = gkMax(1, ticks_arg.getValue());
+		warmup      = gkMax(0, warmup_arg.getValue());
+		jobThreads  = jobs_arg.getValue();
+		output      = output_arg.getValue();
+		baseline    = baseline_arg.getValue();
+		threshold   = threshold_arg.getValue();
+		logicBricks = gkMax(0, logic_arg.getValue());
+		files       = files_arg.getValue();
+	}
+	catch (TCLAP::ArgException& e)
+	{
+		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+		return -1;
+	}
+	catch (TCLAP::ExitException&)
+	{
+		return -1;
+	}
+
+
+	gkUserDefs prefs;
+	prefs.headless      = true;
+	prefs.disableSound  = true;
+	prefs.verbose       = false;
+	prefs.log           = "Benchmark.log";
+	prefs.jobThreads    = jobThreads;
+
+	gkEngine engine(&prefs);
+	engine.initialize();
+	if (!engine.isInitialized())
+	{
+		fprintf(stderr, "error: engine initialization failed\n");
+		return -1;
+	}
+
+	if (!dir.empty())
+	{
+		Ogre::FileSystemArchive archive(dir, "FileSystem", true);
+		archive.load();
+
+		Ogre::StringVectorPtr found = archive.find("*.blend", false);
+		std::sort(found->begin(), found->end());
+		for (UTsize i = 0; i < found->size(); i++)
+			files.push_back(dir + "/" + (*found)[i]);
+	}
+
+	if (files.empty() && logicBricks == 0)
+	{
+		fprintf(stderr, "error: no .blend files given\n");
+		return -1;
+	}
+
+	gkBenchResults results;
+	for (UTsize i = 0; i < files.size(); i++)
+	{
+		fprintf(stderr, "[%u/%u] %s\n", (unsigned int)(i + 1), (unsigned int)files.size(), files[i].c_str());
+		results.push_back(gkBenchRunFile(engine, files[i], warmup, ticks));
+	}
+
+	if (logicBricks > 0)
+	{
+		fprintf(stderr, "logic bricks: %d\n", logicBricks);
+		results.push_back(gkBenchRunLogic(engine, logicBricks, warmup, ticks));
+	}
+
+	engine.finalize();
+
+	if (!gkBenchWriteJson(output, results, ticks))
+		return -1;
+
+	if (baseline.empty())
+		return 0;
+
+	gkBenchJson base;
+	if (!gkBenchReadJson(baseline, base))
+	{
+		fprintf(stderr, "error: can't read baseline %s\n", baseline.c_str());
+		return -1;
+	}
+
+	return gkBenchCompare(base, results, threshold);
+}
@@ -473,15 +473,15 @@ void okWindow::resetScene()
 
 void okWindow::selectObject(gkGameObject* obj)
 {
-	if (m_selObj && m_selObj->getNode())
+	if (m_selObj && m_selObj->getRenderNode())
 	{
-		m_selObj->getNode()->showBoundingBox(false);
+		m_selObj->getRenderNode()->showBoundingBox(false);
 		m_selObj = NULL;
 	}
 
 	if (!obj) return;
 
-	Ogre::SceneNode* node = obj->getNode();
+	Ogre::SceneNode* node = obj->getRenderNode();
 	if (node) node->showBoundingBox(true);
 
 	m_selObj = obj;
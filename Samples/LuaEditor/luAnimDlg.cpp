@@ -113,7 +113,7 @@ void luAnimDlg::selectObject(gkGameObject* obj, gkScene* scene)
 	m_curAnimPlayer = NULL;
 
 
-	utArray<utHashedString> names;
+	utArray<gkHashedString> names;
 	obj->getAnimationNames(names);
 
 	for (UTsize i = 0; i < names.size(); i++)
@@ -180,7 +180,7 @@ luGameObjProps::luGameObjProps(gkGameObject* obj)
 
 	props = obj->getProperties();
 
-	utArray<utHashedString> names;
+	utArray<gkHashedString> names;
 	obj->getAnimationNames(names);
 
 	for (UTsize i = 0; i < names.size(); i++)
@@ -107,6 +107,7 @@ int OgreKit::setup(int argc, char** argv)
 		TCLAP::ValueArg<std::string>	colourshadow_arg		("",  "colourshadow",			"Set shadow colour.", false, "", "string"); 
 		TCLAP::ValueArg<float>			fardistanceshadow_arg	("",  "fardistanceshadow",		"Set far distance shadow.", false, m_prefs.fardistanceshadow, "float"); 
 		TCLAP::ValueArg<std::string>	shaderCachePath_arg		("",  "shadercachepath",		"RTShaderSystem cache file path.", false, m_prefs.shaderCachePath, "string"); 
+		TCLAP::ValueArg<bool>			headless_arg			("",  "headless",				"Run the simulation without rendering.", false, m_prefs.headless, "bool");
 		
 
 		cmdl.add(rendersystem_arg);
@@ -140,6 +141,7 @@ int OgreKit::setup(int argc, char** argv)
 		cmdl.add(colourshadow_arg);
 		cmdl.add(fardistanceshadow_arg);
 		cmdl.add(shaderCachePath_arg);
+		cmdl.add(headless_arg);
 
 		//input file arguments
 		
@@ -188,6 +190,7 @@ int OgreKit::setup(int argc, char** argv)
 		m_prefs.shadowtechnique			= shadowtechnique_arg.getValue();
 		m_prefs.fardistanceshadow		= fardistanceshadow_arg.getValue();	
 		m_prefs.shaderCachePath			= shaderCachePath_arg.getValue();
+		m_prefs.headless				= headless_arg.getValue();
 
 		if (colourshadow_arg.isSet())
 			m_prefs.colourshadow		= Ogre::StringConverter::parseColourValue(colourshadow_arg.getValue());
@@ -0,0 +1,128 @@
+#include "StdAfx.h"
+
+#define TEST_CASE_NAME testGkClonePool
+
+
+// Headless engine with an empty scene holding one dynamic clone source.
+class TestClonePoolScene
+{
+public:
+	gkUserDefs    prefs;
+	gkEngine*     engine;
+	gkScene*      scene;
+	gkGameObject* source;
+
+	TestClonePoolScene() : engine(0), scene(0), source(0)
+	{
+		prefs.headless     = true;
+		prefs.disableSound = true;
+		prefs.verbose      = false;
+
+		engine = new gkEngine(&prefs);
+		engine->initialize();
+		if (!engine->isInitialized())
+			return;
+
+		scene = gkSceneManager::getSingleton().createEmptyScene("ClonePool", "Camera", "ClonePool");
+
+		source = scene->createObject("Ball");
+		gkPhysicsProperties& phy = source->getProperties().m_physics;
+		phy.m_type   = GK_DYNAMIC;
+		phy.m_shape  = SH_SPHERE;
+		phy.m_mass   = 1.f;
+		phy.m_radius = 0.5f;
+
+		source->createVariable("health", false)->setValue(10);
+		source->createVariable("armor", false)->setValue(2);
+
+		scene->createInstance();
+	}
+
+	~TestClonePoolScene()
+	{
+		delete engine;
+	}
+
+	// ends the clone and runs the frame start that parks it
+	void end(gkGameObject* clone)
+	{
+		scene->endObject(clone);
+		scene->beginFrame();
+	}
+};
+
+
+
+TEST(TEST_CASE_NAME, testRecycleResetsState)
+{
+	TestClonePoolScene test;
+	ASSERT_TRUE(test.scene && test.scene->isInstanced());
+
+	gkGameObject* clone = test.scene->cloneObject(test.source, 0, true);
+	ASSERT_TRUE(clone && clone->isInstanced());
+
+	clone->getVariable("health")->setValue(1);
+	clone->getVariable("health")->setReadOnly(true);
+	clone->createVariable("hits", false)->setValue(3);
+	clone->removeVariable("armor");
+	clone->setState(4);
+
+	test.end(clone);
+	EXPECT_TRUE(clone->isParked());
+	EXPECT_FALSE(clone->isInstanced());
+
+	gkGameObject* reused = test.scene->cloneObject(test.source, 0, true);
+	ASSERT_EQ(reused, clone);
+	EXPECT_FALSE(reused->isParked());
+	EXPECT_TRUE(reused->isInstanced());
+
+	// back to the source's variables and values
+	EXPECT_FALSE(reused->hasVariable("hits"));
+	ASSERT_TRUE(reused->hasVariable("health"));
+	ASSERT_TRUE(reused->hasVariable("armor"));
+	EXPECT_EQ(reused->getVariables().size(), test.source->getVariables().size());
+	EXPECT_EQ(reused->getVariable("health")->getValueInt(), 10);
+	EXPECT_EQ(reused->getVariable("armor")->getValueInt(), 2);
+	EXPECT_FALSE(reused->getVariable("health")->isReadOnly());
+	EXPECT_EQ(reused->getState(), 0);
+
+	gkScene::CloneStats stats;
+	test.scene->getCloneStats(stats, test.source);
+	EXPECT_EQ(stats.spawned, 2);
+	EXPECT_EQ(stats.recycled, 1);
+	EXPECT_EQ(stats.parked, 0);
+}
+
+
+TEST(TEST_CASE_NAME, testRecycleSuspendsPhysics)
+{
+	TestClonePoolScene test;
+	ASSERT_TRUE(test.scene && test.scene->isInstanced());
+
+	btDynamicsWorld* world = test.scene->getDynamicsWorld()->getBulletWorld();
+	int objects = world->getNumCollisionObjects();
+
+	gkGameObject* clone = test.scene->cloneObject(test.source, 0, true);
+	ASSERT_TRUE(clone && clone->getAttachedBody());
+	EXPECT_EQ(world->getNumCollisionObjects(), objects + 1);
+
+	gkPhysicsController* con = clone->getPhysicsController();
+	btRigidBody* body = clone->getAttachedBody()->getBody();
+	body->setLinearVelocity(btVector3(0, 0, 5));
+
+	// parked, the body stays attached but leaves the world
+	test.end(clone);
+	EXPECT_TRUE(clone->isParked());
+	EXPECT_TRUE(con->isSuspended());
+	EXPECT_EQ(clone->getPhysicsController(), con);
+	EXPECT_EQ(world->getNumCollisionObjects(), objects);
+
+	// reused, the same body comes back at rest
+	gkGameObject* reused = test.scene->cloneObject(test.source, 0, true);
+	ASSERT_EQ(reused, clone);
+	EXPECT_EQ(reused->getPhysicsController(), con);
+	EXPECT_FALSE(con->isSuspended());
+	EXPECT_EQ(world->getNumCollisionObjects(), objects + 1);
+	EXPECT_EQ(reused->getProperties().m_physics.m_type, GK_DYNAMIC);
+	EXPECT_FLOAT_EQ(body->getLinearVelocity().length2(), 0.f);
+}
@@ -0,0 +1,66 @@
+#include "StdAfx.h"
+#include "gkFrameArena.h"
+
+#define TEST_CASE_NAME testGkFrameArena
+
+
+TEST(TEST_CASE_NAME, testBumpReset)
+{
+	gkFrameArena arena;
+
+	char* a = (char*)arena.allocate(3);
+	char* b = (char*)arena.allocate(40);
+	EXPECT_EQ((UTuintPtr)a % gkFrameArena::ALIGN, 0);
+	EXPECT_EQ(b - a, gkFrameArena::ALIGN);
+	EXPECT_EQ(arena.getUsedBytes(), 16 + 48);
+
+	arena.reset();
+	EXPECT_EQ(arena.getUsedBytes(), 0);
+	EXPECT_EQ(arena.getPeakBytes(), 64);
+
+	// rewinds onto the same memory
+	EXPECT_EQ((char*)arena.allocate(8), a);
+}
+
+TEST(TEST_CASE_NAME, testOverflowMerges)
+{
+	gkFrameArena arena;
+
+	arena.allocate(gkFrameArena::CHUNK_SIZE - 16);
+	arena.allocate(gkFrameArena::CHUNK_SIZE * 2);
+	arena.allocate(64);
+	EXPECT_EQ(arena.getCapacity(), gkFrameArena::CHUNK_SIZE * 4);
+
+	arena.reset();
+	EXPECT_EQ(arena.getCapacity(), gkFrameArena::CHUNK_SIZE * 4);
+
+	// the whole last frame fits in the merged chunk
+	char* p = (char*)arena.allocate(gkFrameArena::CHUNK_SIZE * 3);
+	char* q = (char*)arena.allocate(64);
+	EXPECT_EQ(q - p, gkFrameArena::CHUNK_SIZE * 3);
+	EXPECT_EQ(arena.getCapacity(), gkFrameArena::CHUNK_SIZE * 4);
+}
+
+TEST(TEST_CASE_NAME, testFrameArray)
+{
+	gkFrameArena& arena = gkFrameArena::get();
+	EXPECT_EQ(&arena, &gkFrameArena::get());
+
+	arena.reset();
+	{
+		utArray<int, gkFrameAllocator<int> > values;
+		for (int i = 0; i < 1000; i++)
+			values.push_back(i);
+
+		EXPECT_EQ(values.size(), 1000);
+		EXPECT_EQ(values[999], 999);
+		EXPECT_TRUE(arena.getUsedBytes() >= 1000 * sizeof(int));
+
+		utArray<int, gkFrameAllocator<int> > copy = values;
+		EXPECT_EQ(copy[500], 500);
+	}
+
+	gkFrameArena::resetAll();
+	EXPECT_EQ(arena.getUsedBytes(), 0);
+	EXPECT_TRUE(gkFrameArena::getTotalPeakBytes() >= 1000 * sizeof(int));
+}
@@ -0,0 +1,96 @@
+#include "StdAfx.h"
+#include "gkInputLog.h"
+#include "utStreams.h"
+
+#define TEST_CASE_NAME testGkInputLog
+
+TEST(TEST_CASE_NAME, testRoundTrip)
+{
+	gkKeyboard keyboard;
+	gkMouse mouse;
+	gkInputLog::Joysticks joysticks;
+	joysticks.push_back(new gkJoystick(4, 2));
+
+	utMemoryStream* out = new utMemoryStream(utStream::SM_WRITE);
+	gkInputRecorder recorder(out, false);
+	recorder.begin(joysticks);
+
+	// tick 0, nothing happened
+	recorder.record(0, keyboard, mouse, joysticks);
+	UTsize idle = out->size();
+
+	keyboard.keys[KC_AKEY] = GK_Pressed;
+	keyboard.key_count = 1;
+	mouse.position = gkVector2(10, 20);
+	mouse.moved = true;
+	joysticks[0]->axes[1] = -300;
+	recorder.record(1, keyboard, mouse, joysticks);
+
+	keyboard.keys[KC_AKEY] = GK_Released;
+	keyboard.key_count = 0;
+	mouse.moved = false;
+	mouse.buttons[gkMouse::Right] = GK_Pressed;
+	recorder.record(2, keyboard, mouse, joysticks);
+
+	// unchanged state costs only the frame header
+	UTsize before = out->size();
+	recorder.record(3, keyboard, mouse, joysticks);
+	EXPECT_EQ(out->size() - before, 5u);
+	EXPECT_GT(idle, 0u);
+	EXPECT_EQ(recorder.getFrameCount(), 4u);
+
+
+	utMemoryStream* in = new utMemoryStream();
+	in->open(out->ptr(), out->size(), utStream::SM_READ);
+
+	gkInputPlayer player(in);
+	ASSERT_TRUE(player.begin());
+	ASSERT_EQ(player.getLayout().size(), 1u);
+	EXPECT_EQ(player.getLayout()[0]->buttons.size(), 4u);
+
+	gkKeyboard rkeyboard;
+	gkMouse rmouse;
+	gkInputLog::Joysticks rjoysticks;
+	rjoysticks.push_back(new gkJoystick(4, 2));
+	gkInputChanges changes;
+	UTuint32 tick;
+
+	ASSERT_TRUE(player.play(tick, rkeyboard, rmouse, rjoysticks, changes));
+	EXPECT_EQ(tick, 0u);
+	EXPECT_TRUE(changes.keys.empty());
+
+	ASSERT_TRUE(player.play(tick, rkeyboard, rmouse, rjoysticks, changes));
+	EXPECT_EQ(tick, 1u);
+	EXPECT_TRUE(rkeyboard.isKeyDown(KC_AKEY));
+	EXPECT_EQ(rkeyboard.key_count, 1);
+	EXPECT_EQ(changes.keys.size(), 1u);
+	EXPECT_TRUE(changes.mouseMoved);
+	EXPECT_EQ(rmouse.position, gkVector2(10, 20));
+	EXPECT_EQ(rjoysticks[0]->getAxisValue(1), -300);
+	EXPECT_EQ(changes.joysticks.size(), 1u);
+
+	ASSERT_TRUE(player.play(tick, rkeyboard, rmouse, rjoysticks, changes));
+	EXPECT_TRUE(rkeyboard.isKeyUp(KC_AKEY));
+	EXPECT_TRUE(rmouse.isButtonDown(gkMouse::Right));
+	EXPECT_EQ(changes.buttons.size(), 1u);
+	EXPECT_FALSE(changes.mouseMoved);
+
+	ASSERT_TRUE(player.play(tick, rkeyboard, rmouse, rjoysticks, changes));
+	EXPECT_EQ(tick, 3u);
+	EXPECT_FALSE(player.play(tick, rkeyboard, rmouse, rjoysticks, changes));
+
+	delete out;
+	delete joysticks[0];
+	delete rjoysticks[0];
+}
+
+TEST(TEST_CASE_NAME, testRejectsForeignData)
+{
+	const char junk[] = "not an input log";
+
+	utMemoryStream* in = new utMemoryStream();
+	in->open(junk, sizeof(junk), utStream::SM_READ);
+
+	gkInputPlayer player(in);
+	EXPECT_FALSE(player.begin());
+}
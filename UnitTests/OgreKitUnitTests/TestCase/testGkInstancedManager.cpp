@@ -0,0 +1,119 @@
+#include "StdAfx.h"
+#include "gkInstancedManager.h"
+#include "gkInstancedObject.h"
+#include "OgreTimer.h"
+
+#define TEST_CASE_NAME testGkInstancedManager
+
+
+static utArray<gkInstancedObject*> createdOrder;
+static unsigned long createCost = 0;
+
+
+class TestInstance : public gkInstancedObject
+{
+public:
+	TestInstance(gkInstancedManager* creator, const gkResourceName& name, const gkResourceHandle& handle)
+		:    gkInstancedObject(creator, name, handle)
+	{
+	}
+
+	void createInstanceImpl(void)
+	{
+		Ogre::Timer timer;
+		while (timer.getMicroseconds() < createCost) {}
+
+		createdOrder.push_back(this);
+	}
+};
+
+
+class TestInstancedManager : public gkInstancedManager
+{
+public:
+	TestInstancedManager() : gkInstancedManager("TestInstancedManager", "TestInstance") {}
+	~TestInstancedManager() { destroyAll(); }
+
+	gkResource* createImpl(const gkResourceName& name, const gkResourceHandle& handle)
+	{
+		return new TestInstance(this, name, handle);
+	}
+};
+
+
+static void createQueued(TestInstancedManager& mgr, gkInstancedObject** objs, int count)
+{
+	char name[32];
+	for (int i = 0; i < count; i++)
+	{
+		sprintf(name, "Object%i", i);
+		objs[i] = static_cast<gkInstancedObject*>(mgr.create(gkResourceName(name)));
+		objs[i]->createInstance(true);
+	}
+}
+
+
+TEST(TEST_CASE_NAME, testQueueAll)
+{
+	TestInstancedManager mgr;
+	gkInstancedObject* objs[4];
+
+	createdOrder.clear();
+	createCost = 0;
+	createQueued(mgr, objs, 4);
+
+	EXPECT_EQ(mgr.getQueueSize(), 4);
+	EXPECT_FALSE(objs[0]->isInstanced());
+
+	mgr.postProcessQueue();
+	EXPECT_EQ(mgr.getQueueSize(), 0);
+	ASSERT_EQ(createdOrder.size(), 4);
+	for (int i = 0; i < 4; i++)
+		EXPECT_EQ(createdOrder[i], objs[i]);
+}
+
+TEST(TEST_CASE_NAME, testQueueBudget)
+{
+	TestInstancedManager mgr;
+	gkInstancedObject* objs[4];
+
+	createdOrder.clear();
+	createCost = 200;
+	createQueued(mgr, objs, 4);
+
+	// every create overruns the budget, one per call
+	mgr.setQueueBudget(50);
+	mgr.postProcessQueue();
+	EXPECT_EQ(createdOrder.size(), 1);
+	EXPECT_EQ(mgr.getQueueSize(), 3);
+
+	mgr.postProcessQueue();
+	EXPECT_EQ(createdOrder.size(), 2);
+
+	mgr.setQueueBudget(0);
+	mgr.postProcessQueue();
+	EXPECT_EQ(mgr.getQueueSize(), 0);
+	ASSERT_EQ(createdOrder.size(), 4);
+	for (int i = 0; i < 4; i++)
+		EXPECT_EQ(createdOrder[i], objs[i]);
+}
+
+TEST(TEST_CASE_NAME, testRemoveInstanceQueue)
+{
+	TestInstancedManager mgr;
+	gkInstancedObject* objs[4];
+
+	createdOrder.clear();
+	createCost = 0;
+	createQueued(mgr, objs, 4);
+
+	mgr.removeInstanceQueue(objs[1]);
+	EXPECT_EQ(mgr.getQueueSize(), 3);
+
+	mgr.postProcessQueue();
+	ASSERT_EQ(createdOrder.size(), 3);
+	EXPECT_EQ(createdOrder[0], objs[0]);
+	EXPECT_EQ(createdOrder[1], objs[2]);
+	EXPECT_EQ(createdOrder[2], objs[3]);
+	EXPECT_FALSE(objs[1]->isInstanced());
+}
@@ -0,0 +1,189 @@
+#include "StdAfx.h"
+#include "Thread/gkJobSystem.h"
+#include "Thread/gkActiveObject.h"
+
+#define TEST_CASE_NAME testGkJobSystem
+
+class CountCall : public gkCall
+{
+public:
+	gkAtomicInt count;
+
+	void run() { count.increment(); }
+};
+
+class OrderCall : public gkCall
+{
+public:
+	OrderCall(gkAtomicInt& clock) : m_clock(clock), stamp(0) {}
+
+	void run() { stamp = m_clock.increment(); }
+
+	gkAtomicInt& m_clock;
+	int stamp;
+};
+
+class SignalCall : public gkCall
+{
+public:
+	gkSyncObj done;
+
+	void run() { done.signal(); }
+};
+
+class MarkBody : public gkParallelForCall
+{
+public:
+	MarkBody(utArray<int>& marks) : m_marks(marks) {}
+
+	void run(UTsize begin, UTsize end)
+	{
+		for (UTsize i = begin; i < end; i++)
+			m_marks[i]++;
+	}
+
+	utArray<int>& m_marks;
+};
+
+
+TEST(TEST_CASE_NAME, testSubmitWait)
+{
+	gkJobSystem jobs(3);
+	CountCall call;
+	gkJobCounter counter;
+
+	const int count = 1000;
+	for (int i = 0; i < count; i++)
+		jobs.submit(&call, &counter);
+
+	jobs.wait(counter);
+
+	EXPECT_TRUE(counter.isDone());
+	EXPECT_EQ(call.count.get(), count);
+}
+
+TEST(TEST_CASE_NAME, testNoWorkers)
+{
+	gkJobSystem jobs(0);
+	CountCall call;
+	gkJobCounter counter;
+
+	for (int i = 0; i < 10; i++)
+		jobs.submit(&call, &counter);
+
+	EXPECT_EQ(jobs.getNumWorkers(), 0);
+	EXPECT_EQ(counter.get(), 10);
+
+	jobs.wait(counter);
+	EXPECT_EQ(call.count.get(), 10);
+}
+
+TEST(TEST_CASE_NAME, testDependencies)
+{
+	gkJobSystem jobs(3);
+	gkAtomicInt clock;
+	OrderCall first(clock), second(clock), third(clock);
+	gkJobCounter stage1, stage2, stage3;
+
+	jobs.submit(&first, &stage1);
+	jobs.submitAfter(stage1, &second, &stage2);
+	jobs.submitAfter(stage2, &third, &stage3);
+
+	jobs.wait(stage3);
+
+	EXPECT_TRUE(stage1.isDone() && stage2.isDone());
+	EXPECT_EQ(first.stamp, 1);
+	EXPECT_EQ(second.stamp, 2);
+	EXPECT_EQ(third.stamp, 3);
+}
+
+TEST(TEST_CASE_NAME, testParallelFor)
+{
+	gkJobSystem jobs(3);
+
+	const int count = 10007;
+	utArray<int> marks;
+	marks.resize(count);
+	for (int i = 0; i < count; i++)
+		marks[i] = 0;
+
+	MarkBody body(marks);
+	jobs.parallelFor(count, 16, body);
+
+	int wrong = 0;
+	for (int i = 0; i < count; i++)
+		wrong += marks[i] != 1;
+
+	EXPECT_EQ(wrong, 0);
+}
+
+TEST(TEST_CASE_NAME, testBenchmarkActiveObject)
+{
+	const int count = 100000;
+	const int trips = 2000;
+
+	Ogre::Timer timer;
+	unsigned long aoThroughput, aoLatency, jsThroughput, jsLatency;
+
+	{
+		gkActiveObject active("benchmark");
+		gkPtrRef<gkCall> call(new CountCall());
+
+		timer.reset();
+		for (int i = 0; i < count; i++)
+			active.enqueue(call);
+		active.join();
+		aoThroughput = timer.getMicroseconds();
+
+		EXPECT_EQ(static_cast<CountCall*>(call.get())->count.get(), count);
+	}
+
+	{
+		gkActiveObject active("latency");
+		SignalCall* signal = new SignalCall();
+		gkPtrRef<gkCall> call(signal);
+
+		timer.reset();
+		for (int i = 0; i < trips; i++)
+		{
+			active.enqueue(call);
+			signal->done.wait();
+		}
+		aoLatency = timer.getMicroseconds();
+
+		active.join();
+	}
+
+	{
+		gkJobSystem jobs;
+		CountCall call;
+		gkJobCounter counter;
+
+		timer.reset();
+		for (int i = 0; i < count; i++)
+			jobs.submit(&call, &counter);
+		jobs.wait(counter);
+		jsThroughput = timer.getMicroseconds();
+
+		EXPECT_EQ(call.count.get(), count);
+	}
+
+	{
+		gkJobSystem jobs(1);
+		SignalCall signal;
+
+		// the main thread never helps here, the worker has to steal
+		timer.reset();
+		for (int i = 0; i < trips; i++)
+		{
+			jobs.submit(&signal);
+			signal.done.wait();
+		}
+		jsLatency = timer.getMicroseconds();
+	}
+
+	printf("[ BENCH    ] %d calls: gkActiveObject %lu us, gkJobSystem(%u workers) %lu us\n",
+		count, aoThroughput, (unsigned)(gkJobSystem::getNumProcessors() - 1), jsThroughput);
+	printf("[ BENCH    ] round trip: gkActiveObject %.2f us, gkJobSystem %.2f us\n",
+		aoLatency / (double)trips, jsLatency / (double)trips);
+}
@@ -0,0 +1,119 @@
+#include "StdAfx.h"
+#include "gkLogicExpression.h"
+#include "gkVariable.h"
+#include "OgreTimer.h"
+
+#define TEST_CASE_NAME testGkLogicExpression
+
+
+class TestScope : public gkLogicExpression::Scope
+{
+public:
+	TestScope()
+		:    health(gkString("health"), false), speed(gkString("speed"), false),
+		     alive(gkString("alive"), false), state(gkString("state"), false)
+	{
+		health.setValue(100);
+		speed.setValue(gkScalar(2.5));
+		alive.setValue(true);
+		state.setValue(gkString("run"));
+	}
+
+	gkLogicSensor* findSensor(const gkString& name)
+	{
+		return 0;
+	}
+
+	gkVariable* findVariable(const gkString& name)
+	{
+		gkVariable* vars[] = {&health, &speed, &alive, &state};
+		for (int i = 0; i < 4; i++)
+		{
+			if (vars[i]->getName() == name)
+				return vars[i];
+		}
+		return 0;
+	}
+
+	gkVariable health, speed, alive, state;
+};
+
+
+static bool evaluate(TestScope& scope, const gkString& expr)
+{
+	gkLogicExpression compiled;
+	EXPECT_TRUE(compiled.compile(expr, scope)) << expr << ": " << compiled.getError();
+	return compiled.evaluate();
+}
+
+
+TEST(TEST_CASE_NAME, testOperators)
+{
+	TestScope scope;
+
+	EXPECT_TRUE(evaluate(scope, "1 + 2 * 3 == 7"));
+	EXPECT_TRUE(evaluate(scope, "(1 + 2) * 3 == 9"));
+	EXPECT_TRUE(evaluate(scope, "-2 ** 2 == -4"));
+	EXPECT_TRUE(evaluate(scope, "-7 % 3 == 2 and 7 // 2 == 3"));
+	EXPECT_TRUE(evaluate(scope, "not 1 > 2"));
+	EXPECT_TRUE(evaluate(scope, "0 or 3"));
+	EXPECT_FALSE(evaluate(scope, "1 and 0"));
+	EXPECT_TRUE(evaluate(scope, "True != False"));
+	EXPECT_TRUE(evaluate(scope, "'abc' < \"abd\""));
+	EXPECT_FALSE(evaluate(scope, "''"));
+}
+
+TEST(TEST_CASE_NAME, testProperties)
+{
+	TestScope scope;
+	gkLogicExpression expr;
+
+	ASSERT_TRUE(expr.compile("health > 50 and alive and state == 'run'", scope));
+	EXPECT_TRUE(expr.evaluate());
+
+	// resolved once, read on every evaluate
+	scope.health.setValue(10);
+	EXPECT_FALSE(expr.evaluate());
+
+	scope.health.setValue(60);
+	scope.state.setValue(gkString("idle"));
+	EXPECT_FALSE(expr.evaluate());
+
+	EXPECT_TRUE(evaluate(scope, "speed * 2 == 5"));
+}
+
+TEST(TEST_CASE_NAME, testErrors)
+{
+	TestScope scope;
+	gkLogicExpression expr;
+
+	EXPECT_FALSE(expr.compile("missing > 1", scope));
+	EXPECT_FALSE(expr.isCompiled());
+	EXPECT_FALSE(expr.getError().empty());
+
+	EXPECT_FALSE(expr.compile("state + 1", scope));
+	EXPECT_FALSE(expr.compile("state == 1", scope));
+	EXPECT_FALSE(expr.compile("(1 + 2", scope));
+	EXPECT_FALSE(expr.compile("1 < 2 < 3", scope));
+	EXPECT_FALSE(expr.compile("", scope));
+	EXPECT_FALSE(expr.compile("'open", scope));
+	EXPECT_FALSE(expr.evaluate());
+}
+
+TEST(TEST_CASE_NAME, testEvaluateCost)
+{
+	TestScope scope;
+	gkLogicExpression expr;
+	ASSERT_TRUE(expr.compile("health > 50 and speed * 2 < 10 or state == 'jump'", scope));
+
+	const int count = 1000000;
+	int hits = 0;
+
+	Ogre::Timer timer;
+	for (int i = 0; i < count; i++)
+		hits += expr.evaluate() ? 1 : 0;
+	unsigned long elapsed = timer.getMicroseconds();
+
+	EXPECT_EQ(hits, count);
+	printf("%.1f ns per evaluate\n", elapsed * 1000.0 / count);
+}
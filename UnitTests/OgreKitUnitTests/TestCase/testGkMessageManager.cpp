@@ -0,0 +1,116 @@
+#include "StdAfx.h"
+#include "gkMessageManager.h"
+
+#define TEST_CASE_NAME testGkMessageManager
+
+
+typedef gkMessageManager::GenericMessageListener TestListener;
+
+
+class CountingListener : public gkMessageManager::MessageListener
+{
+public:
+	CountingListener() : count(0) {}
+
+	void handleMessage(gkMessageManager::Message* message) { count++; }
+
+	int count;
+};
+
+
+TEST(TEST_CASE_NAME, testRoutes)
+{
+	gkMessageManager mgr;
+
+	TestListener player("", "Player", "hit");
+	player.setAcceptEmptyTo(true);
+	TestListener enemy("", "Enemy", "");
+	TestListener anyHit("", "", "hit");
+	CountingListener all;
+
+	mgr.addListener(&player);
+	mgr.addListener(&enemy);
+	mgr.addListener(&anyHit);
+	mgr.addListener(&all);
+
+	mgr.sendMessage("Level", "Player", "hit", "10");
+	mgr.sendMessage("Level", "Player", "heal", "5");
+	mgr.sendMessage("Level", "Enemy", "spawn", "");
+	mgr.sendMessage("Level", "", "hit", "1");
+
+	// sent to nobody, enemy filters by name without accepting empty to
+	EXPECT_EQ(player.m_messages.size(), 2);
+	EXPECT_EQ(enemy.m_messages.size(), 1);
+	EXPECT_EQ(anyHit.m_messages.size(), 2);
+	EXPECT_EQ(all.count, 4);
+
+	// never interned, only the catch all hears it
+	mgr.sendMessage("Level", "Player", "subject that nobody filters on", "");
+	EXPECT_EQ(player.m_messages.size(), 2);
+	EXPECT_EQ(all.count, 5);
+
+	mgr.removeListener(&anyHit);
+	mgr.sendMessage("Level", "Player", "hit", "");
+	EXPECT_EQ(anyHit.m_messages.size(), 2);
+	EXPECT_EQ(player.m_messages.size(), 3);
+
+	mgr.removeListener(&player);
+	mgr.removeListener(&enemy);
+	mgr.removeListener(&all);
+}
+
+TEST(TEST_CASE_NAME, testSharedMessages)
+{
+	gkMessageManager mgr;
+
+	TestListener a("", "", "ping");
+	TestListener b("", "", "ping");
+	mgr.addListener(&a);
+	mgr.addListener(&b);
+
+	mgr.sendMessage("From", "To", "ping", "body");
+	ASSERT_EQ(a.m_messages.size(), 1);
+	ASSERT_EQ(b.m_messages.size(), 1);
+
+	gkMessageManager::Message* m = a.m_messages[0];
+	EXPECT_EQ(m, b.m_messages[0]);
+	EXPECT_EQ(m->m_refs, 2);
+	EXPECT_EQ(m->m_body, "body");
+
+	// readable until the following swap
+	a.swapMessages();
+	b.swapMessages();
+	EXPECT_TRUE(a.m_messages.empty());
+	ASSERT_EQ(a.m_received.size(), 1);
+	EXPECT_EQ(m->m_refs, 2);
+
+	a.swapMessages();
+	b.swapMessages();
+	EXPECT_TRUE(a.m_received.empty());
+
+	// recycled for the next send
+	mgr.sendMessage("From", "To", "ping", "again");
+	ASSERT_EQ(a.m_messages.size(), 1);
+	EXPECT_EQ(a.m_messages[0], m);
+	EXPECT_EQ(m->m_body, "again");
+
+	mgr.removeListener(&a);
+	mgr.removeListener(&b);
+}
+
+TEST(TEST_CASE_NAME, testChangeFilter)
+{
+	gkMessageManager mgr;
+
+	TestListener listener("", "", "open");
+	mgr.addListener(&listener);
+
+	listener.setSubjectFilter("close");
+	mgr.sendMessage("", "", "open", "");
+	mgr.sendMessage("", "", "close", "");
+
+	ASSERT_EQ(listener.m_messages.size(), 1);
+	EXPECT_EQ(listener.m_messages[0]->m_subject, "close");
+
+	mgr.removeListener(&listener);
+}
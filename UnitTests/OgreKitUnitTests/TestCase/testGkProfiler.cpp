@@ -0,0 +1,98 @@
+#include "StdAfx.h"
+#include "gkProfiler.h"
+
+#define TEST_CASE_NAME testGkProfiler
+
+static void profiledLeaf(void)
+{
+	gkProfileScope scope(gkProfileZone::get("Leaf"));
+}
+
+static void profiledParent(void)
+{
+	gkProfileScope scope(gkProfileZone::get("Parent"));
+	profiledLeaf();
+	profiledLeaf();
+}
+
+
+TEST(TEST_CASE_NAME, testZoneInterned)
+{
+	EXPECT_EQ(gkProfileZone::get("Same"), gkProfileZone::get("Same"));
+	EXPECT_NE(gkProfileZone::get("Same"), gkProfileZone::get("Other"));
+	EXPECT_EQ(gkProfileZone::get("Same")->getName(), "Same");
+}
+
+TEST(TEST_CASE_NAME, testInactive)
+{
+	// nothing recorded, nothing crashes
+	profiledParent();
+	EXPECT_FALSE(gkProfiler::isActive());
+}
+
+TEST(TEST_CASE_NAME, testRollup)
+{
+	gkProfiler profiler;
+
+	profiledParent();
+	profiledParent();
+	profiler.nextFrame();
+
+	const gkProfiler::Rollup* parent = profiler.getLastRollup("Parent");
+	const gkProfiler::Rollup* leaf = profiler.getLastRollup("Leaf");
+
+	ASSERT_TRUE(parent && leaf);
+	EXPECT_EQ(parent->calls, 2u);
+	EXPECT_EQ(leaf->calls, 4u);
+	EXPECT_EQ(parent->depth, 0u);
+	EXPECT_EQ(leaf->depth, 1u);
+	EXPECT_GE(parent->time, leaf->time);
+	EXPECT_GE(profiler.getLastFrameTime(), parent->time);
+
+	// parents sort before their children
+	EXPECT_EQ(profiler.getLastFrame()[0].zone, parent->zone);
+
+	profiler.nextFrame();
+	EXPECT_TRUE(profiler.getLastFrame().empty());
+}
+
+TEST(TEST_CASE_NAME, testMarkRecord)
+{
+	gkProfiler profiler;
+
+	UTuint64 start = 0;
+	GK_PROFILE_MARK(start);
+	profiledLeaf();
+	GK_PROFILE_RECORD("Span", start);
+	profiler.nextFrame();
+
+	const gkProfiler::Rollup* span = profiler.getLastRollup("Span");
+	const gkProfiler::Rollup* leaf = profiler.getLastRollup("Leaf");
+
+	ASSERT_TRUE(span && leaf);
+	EXPECT_EQ(span->depth, 0u);
+	EXPECT_EQ(leaf->depth, 1u);
+	EXPECT_EQ(start, 0u);
+}
+
+TEST(TEST_CASE_NAME, testChromeTrace)
+{
+	gkProfiler profiler;
+	gkProfiler::setThreadName("Main");
+
+	profiler.beginCapture(2);
+	profiledParent();
+	profiler.nextFrame();
+	profiler.endCapture();
+
+	// the limit keeps the first two spans, both leaves
+	EXPECT_EQ(profiler.getCapture().size(), 2u);
+
+	gkString json;
+	profiler.writeChromeTrace(json);
+
+	EXPECT_EQ(json.find("{\"traceEvents\":["), 0u);
+	EXPECT_NE(json.find("\"name\":\"Main\""), gkString::npos);
+	EXPECT_NE(json.find("\"name\":\"Leaf\",\"ph\":\"X\""), gkString::npos);
+	EXPECT_EQ(json.find("\"name\":\"Parent\""), gkString::npos);
+}
@@ -0,0 +1,106 @@
+#include "StdAfx.h"
+#include "gkResourceManager.h"
+#include "gkResource.h"
+
+#define TEST_CASE_NAME testGkResourceManager
+
+class TestResourceManager : public gkResourceManager
+{
+public:
+	TestResourceManager() : gkResourceManager("TestResourceManager", "TestResource") {}
+	~TestResourceManager() { destroyAll(); }
+
+	gkResource* createImpl(const gkResourceName& name, const gkResourceHandle& handle)
+	{
+		return new gkResource(this, name, handle);
+	}
+};
+
+
+TEST(TEST_CASE_NAME, testGetByName)
+{
+	TestResourceManager mgr;
+
+	gkResource* a = mgr.create(gkResourceName("Cube", "Scene1"));
+	gkResource* b = mgr.create(gkResourceName("Cube", "Scene2"));
+	gkResource* c = mgr.create(gkResourceName("Lamp", ""));
+	ASSERT_TRUE(a && b && c);
+
+	EXPECT_EQ(mgr.getByName(gkResourceName("Cube", "Scene1")), a);
+	EXPECT_EQ(mgr.getByName(gkResourceName("Cube", "Scene2")), b);
+	EXPECT_TRUE(mgr.getByName(gkResourceName("Cube", "Scene3")) == 0);
+	EXPECT_EQ(mgr.getByName(gkResourceName("Lamp", "")), c);
+	EXPECT_TRUE(mgr.getByName(gkResourceName("Lamp", "Scene1")) == 0);
+
+	// no group, any group
+	gkResource* any = mgr.getByName(gkResourceName("Cube"));
+	EXPECT_TRUE(any == a || any == b);
+
+	// duplicates are refused
+	EXPECT_TRUE(mgr.create(gkResourceName("Cube", "Scene1")) == 0);
+	EXPECT_EQ(mgr.getResourceCount(), 3);
+}
+
+TEST(TEST_CASE_NAME, testDestroy)
+{
+	TestResourceManager mgr;
+
+	gkResource* a = mgr.create(gkResourceName("Cube", "Scene1"));
+	gkResource* b = mgr.create(gkResourceName("Cube", "Scene2"));
+	mgr.create(gkResourceName("Plane", "Scene1"));
+	mgr.create(gkResourceName("Plane", "Scene2"));
+
+	mgr.destroy(a);
+	EXPECT_TRUE(mgr.getByName(gkResourceName("Cube", "Scene1")) == 0);
+	EXPECT_EQ(mgr.getByName(gkResourceName("Cube")), b);
+
+	mgr.destroy(gkResourceName("Cube", "Scene2"));
+	EXPECT_TRUE(mgr.getByName(gkResourceName("Cube")) == 0);
+
+	// the name can be reused
+	EXPECT_TRUE(mgr.create(gkResourceName("Cube", "Scene1")) != 0);
+
+	mgr.destroyGroup("Scene1");
+	EXPECT_EQ(mgr.getResourceCount(), 1);
+	EXPECT_TRUE(mgr.getByName(gkResourceName("Cube")) == 0);
+	EXPECT_TRUE(mgr.getByName(gkResourceName("Plane", "Scene1")) == 0);
+
+	gkResource* plane = mgr.getByName(gkResourceName("Plane"));
+	ASSERT_TRUE(plane != 0);
+	EXPECT_EQ(plane->getGroupName(), "Scene2");
+
+	mgr.destroyAll();
+	EXPECT_TRUE(mgr.getByName(gkResourceName("Plane")) == 0);
+}
+
+
+// Creation time as a loader sees it, printed rather than asserted.
+// Every create checks for a duplicate by name first.
+TEST(TEST_CASE_NAME, benchCreate)
+{
+	utArray<gkResourceName> names;
+	char buf[32];
+	for (int i = 0; i < 50000; i++)
+	{
+		sprintf(buf, "Object.%05d", i);
+		names.push_back(gkResourceName(buf, i % 2 ? "Scene" : ""));
+	}
+
+	for (int count = 6250; count <= 50000; count *= 2)
+	{
+		TestResourceManager mgr;
+		btClock timer;
+
+		for (int i = 0; i < count; i++)
+			mgr.create(names[i]);
+		unsigned long createUs = timer.getTimeMicroseconds();
+
+		timer.reset();
+		mgr.destroyGroup("Scene");
+		unsigned long unloadUs = timer.getTimeMicroseconds();
+
+		EXPECT_EQ(mgr.getResourceCount(), count / 2);
+
+		printf("  %6d resources  create %8.2f ms  destroy group %8.2f ms\n", count, createUs / 1000.0, unloadUs / 1000.0);
+	}
+}
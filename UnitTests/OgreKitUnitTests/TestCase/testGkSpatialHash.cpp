@@ -0,0 +1,111 @@
+#include "StdAfx.h"
+#include "gkSpatialHash.h"
+
+#define TEST_CASE_NAME testGkSpatialHash
+
+
+// entries are never dereferenced without a filter
+static gkGameObject* fakeObject(UTuintPtr i)
+{
+	return (gkGameObject*)(i * 16);
+}
+
+static bool hasObject(const gkSpatialHash::Results& res, gkGameObject* ob)
+{
+	return res.find(ob) != UT_NPOS;
+}
+
+
+TEST(TEST_CASE_NAME, testSphere)
+{
+	gkSpatialHash hash(2.f);
+
+	hash.insert(fakeObject(1), gkVector3(0, 0, 0), 0.5f);
+	hash.insert(fakeObject(2), gkVector3(3, 0, 0), 0.5f);
+	hash.insert(fakeObject(3), gkVector3(-7, 5, 1), 0.5f);
+	hash.insert(fakeObject(4), gkVector3(0, 0, 0), 50.f);   // larger than a cell
+
+	gkSpatialHash::Results res;
+	EXPECT_EQ(hash.querySphere(gkVector3(1, 0, 0), 1.6f, res), 3);
+	EXPECT_TRUE(hasObject(res, fakeObject(1)));
+	EXPECT_TRUE(hasObject(res, fakeObject(2)));
+	EXPECT_TRUE(hasObject(res, fakeObject(4)));
+
+	// touching bounding spheres count
+	res.clear();
+	EXPECT_EQ(hash.querySphere(gkVector3(-7, 5, 2.4f), 1.f, res), 2);
+	EXPECT_TRUE(hasObject(res, fakeObject(3)));
+
+	// whole table walk gives the same answer
+	res.clear();
+	EXPECT_EQ(hash.querySphere(gkVector3(0, 0, 0), 1000.f, res), 4);
+}
+
+TEST(TEST_CASE_NAME, testMoveRemove)
+{
+	gkSpatialHash hash(1.f);
+
+	for (UTuintPtr i = 1; i <= 200; i++)
+		hash.insert(fakeObject(i), gkVector3(gkScalar(i), 0, 0), 0.25f);
+
+	EXPECT_EQ(hash.getCount(), 200);
+
+	hash.move(fakeObject(10), gkVector3(150.2f, 0, 0), 0.25f);
+	for (UTuintPtr i = 100; i <= 120; i++)
+		hash.remove(fakeObject(i));
+
+	EXPECT_EQ(hash.getCount(), 179);
+	EXPECT_FALSE(hash.contains(fakeObject(110)));
+	EXPECT_TRUE(hash.contains(fakeObject(200)));
+
+	gkSpatialHash::Results res;
+	hash.querySphere(gkVector3(150, 0, 0), 0.5f, res);
+	EXPECT_EQ(res.size(), 2);
+	EXPECT_TRUE(hasObject(res, fakeObject(10)));
+	EXPECT_TRUE(hasObject(res, fakeObject(150)));
+
+	res.clear();
+	EXPECT_EQ(hash.querySphere(gkVector3(10, 0, 0), 0.5f, res), 0);
+	EXPECT_EQ(hash.querySphere(gkVector3(110, 0, 0), 0.5f, res), 0);
+}
+
+TEST(TEST_CASE_NAME, testBoxCone)
+{
+	gkSpatialHash hash(4.f);
+
+	hash.insert(fakeObject(1), gkVector3(5, 0, 0), 0.1f);
+	hash.insert(fakeObject(2), gkVector3(5, 4, 0), 0.1f);
+	hash.insert(fakeObject(3), gkVector3(-5, 0, 0), 0.1f);
+
+	gkSpatialHash::Results res;
+	EXPECT_EQ(hash.queryBox(gkBoundingBox(gkVector3(4, -1, -1), gkVector3(6, 5, 1)), res), 2);
+
+	// 30 degrees either side of +x
+	res.clear();
+	EXPECT_EQ(hash.queryCone(gkVector3::ZERO, gkVector3::UNIT_X, 10.f, gkDegree(30).valueRadians(), res), 1);
+	EXPECT_TRUE(hasObject(res, fakeObject(1)));
+
+	res.clear();
+	EXPECT_EQ(hash.queryCone(gkVector3::ZERO, gkVector3::UNIT_X, 10.f, gkDegree(60).valueRadians(), res), 2);
+}
+
+TEST(TEST_CASE_NAME, testNearest)
+{
+	gkSpatialHash hash(1.f);
+
+	for (UTuintPtr i = 1; i <= 50; i++)
+		hash.insert(fakeObject(i), gkVector3(gkScalar(i) * 3.f, 0, 0), 0.f);
+
+	gkSpatialHash::Results res;
+	EXPECT_EQ(hash.queryNearest(gkVector3(31, 0, 0), 3, res), 3);
+	EXPECT_EQ(res[0], fakeObject(10));
+	EXPECT_EQ(res[1], fakeObject(11));
+	EXPECT_EQ(res[2], fakeObject(9));
+
+	res.clear();
+	EXPECT_EQ(hash.queryNearest(gkVector3(-100, 0, 0), 2, res, 0, 10.f), 0);
+
+	res.clear();
+	EXPECT_EQ(hash.queryNearest(gkVector3(-100, 0, 0), 1, res), 1);
+	EXPECT_EQ(res[0], fakeObject(1));
+}
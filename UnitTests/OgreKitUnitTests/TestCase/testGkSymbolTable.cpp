@@ -0,0 +1,98 @@
+#include "StdAfx.h"
+#include "gkSymbolTable.h"
+#include "Thread/gkJobSystem.h"
+
+#define TEST_CASE_NAME testGkSymbolTable
+
+class InternBody : public gkParallelForCall
+{
+public:
+	InternBody(utArray<gkSymbol>& ids) : m_ids(ids) {}
+
+	void run(UTsize begin, UTsize end)
+	{
+		char name[32];
+		for (UTsize i = begin; i < end; i++)
+		{
+			sprintf(name, "threaded_%d", (int)(i % 500));
+			m_ids[i] = gkHashedString(name).id();
+		}
+	}
+
+	utArray<gkSymbol>& m_ids;
+};
+
+
+TEST(TEST_CASE_NAME, testIntern)
+{
+	gkHashedString a("Cube"), b(gkString("Cube")), c("Cube.001");
+
+	EXPECT_TRUE(a == b);
+	EXPECT_TRUE(a != c);
+	EXPECT_EQ(a.id(), b.id());
+	EXPECT_EQ(&a.str(), &b.str());
+	EXPECT_EQ(a.str(), "Cube");
+
+	// keys the same as before interning
+	EXPECT_EQ(a.hash(), utHashedString("Cube").hash());
+	EXPECT_EQ(gkSymbolTable::find("Cube"), &gkSymbolTable::get(a.id()));
+	UTsize count = gkSymbolTable::getCount();
+	EXPECT_TRUE(gkSymbolTable::find("never interned") == 0);
+	EXPECT_EQ(gkSymbolTable::getCount(), count);
+
+	gkHashedString e, f(""), g((const char*)0);
+	EXPECT_TRUE(e.empty());
+	EXPECT_TRUE(e == f);
+	EXPECT_TRUE(e == g);
+	EXPECT_EQ(e.id(), 0);
+	EXPECT_TRUE(e.str().empty());
+}
+
+TEST(TEST_CASE_NAME, testStable)
+{
+	gkHashedString first("stable_0");
+	const char* text = first.c_str();
+
+	// enough to fill pages and grow the index a few times
+	char name[32];
+	for (int i = 1; i < 5000; i++)
+	{
+		sprintf(name, "stable_%d", i);
+		gkSymbolTable::intern(name);
+	}
+
+	EXPECT_EQ(first.c_str(), text);
+	EXPECT_EQ(gkHashedString("stable_0"), first);
+
+	sprintf(name, "stable_%d", 4321);
+	EXPECT_EQ(gkHashedString(name).str(), name);
+	EXPECT_TRUE(gkSymbolTable::getCount() > 5000);
+}
+
+TEST(TEST_CASE_NAME, testHashTableKey)
+{
+	utHashTable<gkHashedString, int> table;
+	table.insert("Lamp", 1);
+	table.insert("Camera", 2);
+
+	EXPECT_EQ(table.find(gkString("Camera")), table.find("Camera"));
+	EXPECT_EQ(*table.get("Lamp"), 1);
+	EXPECT_TRUE(table.find("Plane") == UT_NPOS);
+}
+
+TEST(TEST_CASE_NAME, testThreaded)
+{
+	gkJobSystem jobs(4);
+
+	const UTsize count = 20000;
+	utArray<gkSymbol> ids;
+	ids.resize(count);
+
+	InternBody body(ids);
+	jobs.parallelFor(count, 64, body);
+
+	for (UTsize i = 0; i < count; i++)
+		EXPECT_EQ(ids[i], ids[i % 500]);
+
+	EXPECT_EQ(gkSymbolTable::get(ids[7]).str, "threaded_7");
+}
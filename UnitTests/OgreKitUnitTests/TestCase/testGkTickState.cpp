@@ -0,0 +1,91 @@
+#include "StdAfx.h"
+#include "gkTickState.h"
+
+#define TEST_CASE_NAME testGkTickState
+
+class CountTicks : public gkTickState
+{
+public:
+	CountTicks(int rate) : gkTickState(rate), ticks(0) {}
+
+	void tickImpl(gkScalar delta) { ticks++; }
+
+	int ticks;
+};
+
+static void busyWaitMs(unsigned long ms)
+{
+	btClock clock;
+	clock.reset();
+	while (clock.getTimeMilliseconds() < ms);
+}
+
+
+TEST(TEST_CASE_NAME, testStep)
+{
+	CountTicks state(60);
+
+	state.step();
+	state.step();
+
+	EXPECT_EQ(state.ticks, 2);
+	EXPECT_EQ(state.getTickCount(), 2u);
+	EXPECT_EQ(state.getAlpha(), 1.f);
+	EXPECT_FALSE(state.isTickDue());
+}
+
+TEST(TEST_CASE_NAME, testAccumulatorDrop)
+{
+	CountTicks state(1000);
+	state.setMode(gkTickState::TM_ACCUMULATOR);
+	state.setCatchUp(gkTickState::CU_DROP, 2);
+
+	state.tick();
+	state.ticks = 0;
+
+	busyWaitMs(20);
+	EXPECT_TRUE(state.isTickDue());
+	state.tick();
+
+	EXPECT_EQ(state.ticks, 2);
+	EXPECT_GE(state.getDroppedTicks(), 15u);
+	EXPECT_GE(state.getAlpha(), 0.f);
+	EXPECT_LT(state.getAlpha(), 1.f);
+}
+
+TEST(TEST_CASE_NAME, testAccumulatorSpread)
+{
+	CountTicks state(1000);
+	state.setMode(gkTickState::TM_ACCUMULATOR);
+	state.setCatchUp(gkTickState::CU_SPREAD, 4);
+
+	state.tick();
+	state.ticks = 0;
+
+	busyWaitMs(20);
+	state.tick();
+	EXPECT_EQ(state.ticks, 4);
+	EXPECT_EQ(state.getStretchedTicks(), 0u);
+
+	// the carried ticks run next frame, late
+	state.tick();
+	EXPECT_GE(state.ticks, 8);
+	EXPECT_EQ(state.getStretchedTicks(), 4u);
+}
+
+TEST(TEST_CASE_NAME, testAccumulatorAll)
+{
+	CountTicks state(1000);
+	state.setMode(gkTickState::TM_ACCUMULATOR);
+	state.setCatchUp(gkTickState::CU_ALL, 1);
+
+	state.tick();
+	state.ticks = 0;
+
+	busyWaitMs(10);
+	state.tick();
+
+	EXPECT_GE(state.ticks, 10);
+	EXPECT_EQ(state.getDroppedTicks(), 0u);
+	EXPECT_FALSE(state.isTickDue());
+}
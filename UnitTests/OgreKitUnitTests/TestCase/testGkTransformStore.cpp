@@ -0,0 +1,124 @@
+#include "StdAfx.h"
+#include "gkTransformStore.h"
+
+#define TEST_CASE_NAME testGkTransformStore
+
+
+static void expectNear(const gkVector3& a, const gkVector3& b)
+{
+	EXPECT_NEAR(a.x, b.x, 1e-4f);
+	EXPECT_NEAR(a.y, b.y, 1e-4f);
+	EXPECT_NEAR(a.z, b.z, 1e-4f);
+}
+
+static void expectNear(const gkQuaternion& a, const gkQuaternion& b)
+{
+	EXPECT_NEAR(a.w, b.w, 1e-4f);
+	EXPECT_NEAR(a.x, b.x, 1e-4f);
+	EXPECT_NEAR(a.y, b.y, 1e-4f);
+	EXPECT_NEAR(a.z, b.z, 1e-4f);
+}
+
+
+TEST(TEST_CASE_NAME, testCompose)
+{
+	gkTransformStore store;
+
+	gkTransformState ps(gkVector3(1, 2, 3), gkQuaternion(gkDegree(90), gkVector3::UNIT_Z), gkVector3(2, 2, 2));
+	gkTransformState cs(gkVector3(1, 0, 0), gkQuaternion(gkDegree(30), gkVector3::UNIT_X), gkVector3(1, 3, 1));
+
+	UTsize parent = store.create(0, ps);
+	UTsize child  = store.create(0, cs, parent);
+	store.update();
+
+	// same as Ogre::Node::_updateFromParent
+	expectNear(store.getWorldPosition(child), ps.rot * (ps.scl * cs.loc) + ps.loc);
+	expectNear(store.getWorldOrientation(child), ps.rot * cs.rot);
+	expectNear(store.getWorldScale(child), ps.scl * cs.scl);
+	expectNear(store.getWorldPosition(child), gkVector3(1, 4, 3));
+}
+
+
+TEST(TEST_CASE_NAME, testStaleOnly)
+{
+	gkTransformStore store;
+
+	UTsize a = store.create(0, gkTransformState());
+	UTsize b = store.create(0, gkTransformState(gkVector3(1, 0, 0)), a);
+	UTsize c = store.create(0, gkTransformState());
+
+	store.update();
+	EXPECT_EQ(store.getComposedCount(), 3);
+
+	store.update();
+	EXPECT_EQ(store.getComposedCount(), 0);
+
+	// children follow their parent
+	store.setPosition(a, gkVector3(0, 5, 0));
+	store.update();
+	EXPECT_EQ(store.getComposedCount(), 2);
+	expectNear(store.getWorldPosition(b), gkVector3(1, 5, 0));
+
+	store.setPosition(c, gkVector3(0, 0, 1));
+	store.update();
+	EXPECT_EQ(store.getComposedCount(), 1);
+
+	// reads between updates compose the chain
+	store.setPosition(a, gkVector3(0, 7, 0));
+	expectNear(store.getWorldPosition(b), gkVector3(1, 7, 0));
+	store.update();
+	EXPECT_EQ(store.getComposedCount(), 0);
+}
+
+
+TEST(TEST_CASE_NAME, testHierarchyChanges)
+{
+	gkTransformStore store;
+
+	// child ahead of its parent in the slots
+	UTsize child  = store.create(0, gkTransformState(gkVector3(1, 0, 0)));
+	UTsize parent = store.create(0, gkTransformState(gkVector3(0, 2, 0)));
+	UTsize top    = store.create(0, gkTransformState(gkVector3(0, 0, 3)));
+
+	store.setParent(child, parent);
+	store.setParent(parent, top);
+	store.update();
+	EXPECT_EQ(store.getComposedCount(), 3);
+	expectNear(store.getWorldPosition(child), gkVector3(1, 2, 3));
+
+	// children move up keeping their local transform
+	store.destroy(parent);
+	EXPECT_EQ(store.getParent(child), top);
+	EXPECT_EQ(store.getCount(), 2);
+	store.update();
+	expectNear(store.getWorldPosition(child), gkVector3(1, 0, 3));
+
+	// slots are reused
+	UTsize next = store.create(0, gkTransformState(gkVector3(4, 0, 0)), child);
+	EXPECT_EQ(next, parent);
+	EXPECT_EQ(store.getCount(), 3);
+	expectNear(store.getWorldPosition(next), gkVector3(5, 0, 3));
+
+	store.setParent(child, UT_NPOS);
+	store.update();
+	expectNear(store.getWorldPosition(next), gkVector3(5, 0, 0));
+}
+
+
+TEST(TEST_CASE_NAME, testPages)
+{
+	gkTransformStore store;
+
+	const UTsize count = gkTransformStore::PAGE_SIZE * 3 + 7;
+
+	UTsize i, prev = UT_NPOS;
+	for (i = 0; i < count; i++)
+	{
+		// one long chain across the pages
+		prev = store.create(0, gkTransformState(gkVector3(1, 0, 0)), prev);
+	}
+
+	store.update();
+	EXPECT_EQ(store.getComposedCount(), count);
+	expectNear(store.getWorldPosition(prev), gkVector3((gkScalar)count, 0, 0));
+}
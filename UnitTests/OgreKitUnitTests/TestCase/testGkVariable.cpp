@@ -0,0 +1,80 @@
+#include "StdAfx.h"
+#include "gkVariable.h"
+
+#define TEST_CASE_NAME testGkVariable
+
+
+TEST(TEST_CASE_NAME, testTypedStorage)
+{
+	gkValue v(3);
+	EXPECT_EQ(v.getType(), gkValue::VT_INT);
+	EXPECT_EQ(v.get<int>(), 3);
+	EXPECT_EQ(v.get<gkScalar>(-1.f), -1.f);
+
+	v = gkVector3(1, 2, 3);
+	EXPECT_EQ(v.getType(), gkValue::VT_VEC3);
+	EXPECT_EQ(v.get<gkVector3>(), gkVector3(1, 2, 3));
+
+	v = gkString("abc");
+	EXPECT_EQ(v.get<gkString>(), "abc");
+
+	// character strings are strings, not bools
+	gkValue s("xyz");
+	EXPECT_EQ(s.getType(), gkValue::VT_STRING);
+	EXPECT_EQ(s.get<gkString>(), "xyz");
+
+	const char* str = "uvw";
+	s = str;
+	EXPECT_EQ(s.get<gkString>(), "uvw");
+	s = "def";
+	EXPECT_EQ(s.getType(), gkValue::VT_STRING);
+
+	gkValue c(v);
+	v = gkMatrix3::IDENTITY;
+	EXPECT_EQ(c.toString(), "abc");
+	EXPECT_EQ(v.get<gkMatrix3>(), gkMatrix3::IDENTITY);
+}
+
+TEST(TEST_CASE_NAME, testParseOnce)
+{
+	gkVariable prop(5);
+	gkVariable test;
+
+	// operands coming from the loader are parsed into the property type
+	test.setValue(prop.getType(), "5");
+	EXPECT_EQ(test.getType(), gkVariable::VAR_INT);
+	EXPECT_TRUE(prop == test);
+
+	test.setValue(prop.getType(), "7");
+	EXPECT_TRUE(prop < test);
+	EXPECT_TRUE(prop != test);
+
+	gkVariable vec(gkVector3(1, 2, 3));
+	test.setValue(vec.getType(), "1 2 3");
+	EXPECT_EQ(test.getType(), gkVariable::VAR_VEC3);
+	EXPECT_TRUE(vec == test);
+}
+
+TEST(TEST_CASE_NAME, testArithmetic)
+{
+	gkVariable prop(5);
+	gkVariable step;
+	step.setValue(prop.getType(), "2");
+
+	prop.add(step);
+	EXPECT_EQ(prop.getType(), gkVariable::VAR_INT);
+	EXPECT_EQ(prop.getValueInt(), 7);
+
+	prop.assign(step);
+	EXPECT_EQ(prop.getType(), gkVariable::VAR_INT);
+	EXPECT_EQ(prop.getValueInt(), 2);
+
+	gkVariable flag(true);
+	flag.toggle(flag);
+	EXPECT_FALSE(flag.getValueBool());
+
+	gkVariable name(gkString("ab"));
+	name.add(gkString("cd"));
+	EXPECT_EQ(name.getValueString(), "abcd");
+	EXPECT_TRUE(name == gkVariable(gkString("abcd")));
+}
@@ -108,4 +108,171 @@ TEST(TEST_CASE_NAME, testSort)
 
 	for (int i = 0; i < count; i++)
 		EXPECT_EQ(arr1[i], i);
+}
+
+TEST(TEST_CASE_NAME, testSwapErase)
+{
+	utArray<int> arr1;
+	for (int i = 0; i < 5; i++)
+		arr1.push_back(i);
+
+	// the last element fills the hole
+	arr1.erase((UTsize)1);
+	EXPECT_EQ(arr1.size(), 4);
+	EXPECT_EQ(arr1[1], 4);
+	EXPECT_EQ(arr1[3], 3);
+
+	arr1.erase((UTsize)3);
+	EXPECT_EQ(arr1.size(), 3);
+	EXPECT_EQ(arr1.find(3), UT_NPOS);
+
+	utArray<utString> arr2;
+	arr2.push_back("a");
+	arr2.push_back("b");
+	arr2.push_back("c");
+	arr2.erase((UTsize)0);
+	EXPECT_EQ(arr2[0], "c");
+	EXPECT_EQ(arr2[1], "b");
+
+	// removed slots drop what they held
+	arr2.pop_back();
+	EXPECT_TRUE(arr2.ptr()[1].empty());
+}
+
+TEST(TEST_CASE_NAME, testSmallArray)
+{
+	utSmallArray<int, 4> arr1;
+	EXPECT_TRUE(arr1.isInline());
+	EXPECT_EQ(arr1.capacity(), 4);
+
+	for (int i = 0; i < 4; i++)
+		arr1.push_back(i);
+	EXPECT_TRUE(arr1.isInline());
+
+	arr1.push_back(4);
+	EXPECT_FALSE(arr1.isInline());
+	for (int i = 0; i < 5; i++)
+		EXPECT_EQ(arr1[i], i);
+
+	arr1.clear();
+	EXPECT_TRUE(arr1.isInline());
+	EXPECT_EQ(arr1.capacity(), 4);
+
+	// usable as a plain utArray
+	utArray<int>& base = arr1;
+	base.push_back(7);
+	EXPECT_EQ(arr1.size(), 1);
+	EXPECT_TRUE(arr1.isInline());
+
+	utSmallArray<int, 4> arr2(arr1);
+	EXPECT_TRUE(arr2.isInline());
+	EXPECT_EQ(arr2[0], 7);
+
+	utArray<int> arr3;
+	for (int i = 0; i < 10; i++)
+		arr3.push_back(i);
+
+	arr2 = arr3;
+	EXPECT_FALSE(arr2.isInline());
+	EXPECT_EQ(arr2.size(), 10);
+	EXPECT_EQ(arr2[9], 9);
+
+	arr3 = arr1;
+	EXPECT_EQ(arr3.size(), 1);
+	EXPECT_EQ(arr3[0], 7);
+
+	arr2.swap(arr3);
+	EXPECT_EQ(arr2.size(), 1);
+	EXPECT_EQ(arr3.size(), 10);
+}
+
+TEST(TEST_CASE_NAME, testMoveGrowth)
+{
+	utArray<utArray<int> > arr1;
+	for (int i = 0; i < 100; i++)
+	{
+		arr1.push_back(utArray<int>());
+		for (int j = 0; j <= i; j++)
+			arr1.back().push_back(j);
+	}
+
+	for (int i = 0; i < 100; i++)
+	{
+		EXPECT_EQ(arr1[i].size(), i + 1);
+		EXPECT_EQ(arr1[i][i], i);
+	}
+
+	utStringArray arr2;
+	for (int i = 0; i < 100; i++)
+		arr2.push_back(utString(40, (char)('a' + i % 26)));
+	EXPECT_EQ(arr2[99], utString(40, 'a' + 99 % 26));
+
+	utArray<int> a, b;
+	a.push_back(1);
+	const int* storage = a.ptr();
+	a.swap(b);
+	EXPECT_TRUE(a.empty());
+	EXPECT_EQ(b.ptr(), storage);
+}
+
+
+// Growth, iteration and copy timings, printed rather than asserted.
+
+template<typename T> static T benchValue(int i);
+template<> int benchValue<int>(int i)             { return i; }
+template<> utString benchValue<utString>(int i)   { return utString(24, (char)('a' + i % 26)); }
+
+static int benchWeight(int v)               { return v; }
+static int benchWeight(const utString& v)   { return (int)v.size(); }
+
+template<typename Array>
+static void benchArray(const char* name, int count, int rounds)
+{
+	btClock timer;
+	int sum = 0;
+
+	timer.reset();
+	for (int r = 0; r < rounds; r++)
+	{
+		Array arr;
+		for (int i = 0; i < count; i++)
+			arr.push_back(benchValue<typename Array::ValueType>(i));
+		sum += (int)arr.size();
+	}
+	unsigned long growUs = timer.getTimeMicroseconds();
+
+	Array src;
+	for (int i = 0; i < count; i++)
+		src.push_back(benchValue<typename Array::ValueType>(i));
+
+	timer.reset();
+	for (int r = 0; r < rounds; r++)
+	{
+		typename Array::Iterator it = src.iterator();
+		while (it.hasMoreElements())
+			sum += benchWeight(it.getNext());
+	}
+	unsigned long iterUs = timer.getTimeMicroseconds();
+
+	timer.reset();
+	for (int r = 0; r < rounds; r++)
+	{
+		Array copy(src);
+		sum += benchWeight(copy[count - 1]);
+	}
+	unsigned long copyUs = timer.getTimeMicroseconds();
+
+	EXPECT_NE(sum, 0);
+
+	double ops = double(rounds);
+	printf("  %-16s %6d  grow %8.1f  iterate %8.1f  copy %8.1f ns/array\n", name, count,
+	       growUs * 1000.0 / ops, iterUs * 1000.0 / ops, copyUs * 1000.0 / ops);
+}
+
+TEST(TEST_CASE_NAME, benchGrowth)
+{
+	benchArray<utArray<int> >("utArray", 8, 200000);
+	benchArray<utSmallArray<int, 8> >("utSmallArray<8>", 8, 200000);
+	benchArray<utArray<int> >("utArray", 100000, 50);
+	benchArray<utArray<utString> >("utStringArray", 10000, 20);
 }
\ No newline at end of file
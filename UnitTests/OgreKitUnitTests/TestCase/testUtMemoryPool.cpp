@@ -0,0 +1,157 @@
+#include "StdAfx.h"
+#include "utMemoryPool.h"
+#include "Thread/gkJobSystem.h"
+
+#define TEST_CASE_NAME testUtMemoryPool
+
+struct PoolItem
+{
+	PoolItem() : value(7) { ++alive; }
+	~PoolItem() { --alive; }
+
+	int value;
+	double pad[3];
+
+	static int alive;
+};
+
+int PoolItem::alive = 0;
+
+
+class PooledBase
+{
+public:
+	virtual ~PooledBase() {}
+
+	UT_DECLARE_POOLED_CLASS()
+};
+
+class PooledLarge : public PooledBase
+{
+public:
+	char data[300];
+};
+
+
+struct ChurnItem
+{
+	int value[6];
+};
+
+class ChurnBody : public gkParallelForCall
+{
+public:
+	ChurnBody(utMemoryPool<ChurnItem, 0>& pool) : m_pool(pool) {}
+
+	void run(UTsize begin, UTsize end)
+	{
+		ChurnItem* items[8];
+		for (UTsize i = begin; i < end; i++)
+		{
+			for (int j = 0; j < 8; j++)
+				items[j] = m_pool.alloc();
+			for (int j = 0; j < 8; j++)
+				m_pool.dealloc(items[j]);
+		}
+	}
+
+	utMemoryPool<ChurnItem, 0>& m_pool;
+};
+
+
+TEST(TEST_CASE_NAME, testConstructReuse)
+{
+	utMemoryPool<PoolItem, 0> pool(4);
+	EXPECT_EQ(pool.getAllocatedCount(), 4);
+
+	PoolItem* a = pool.alloc();
+	PoolItem* b = pool.alloc();
+	EXPECT_EQ(a->value, 7);
+	EXPECT_EQ(PoolItem::alive, 2);
+	EXPECT_EQ(pool.getLiveCount(), 2);
+
+	// slots come from one contiguous block
+	long step = (long)((char*)b - (char*)a);
+	EXPECT_EQ(step < 0 ? -step : step, (long)pool.getBlockSize());
+
+	pool.dealloc(a);
+	EXPECT_EQ(PoolItem::alive, 1);
+
+	PoolItem* c = pool.alloc();
+	EXPECT_EQ(c, a);
+
+	pool.dealloc(b);
+	pool.dealloc(c);
+	EXPECT_EQ(PoolItem::alive, 0);
+	EXPECT_EQ(pool.getLiveCount(), 0);
+	EXPECT_EQ(pool.getPeakCount(), 2);
+}
+
+TEST(TEST_CASE_NAME, testMaxAlloc)
+{
+	utMemoryPool<PoolItem, 3> pool;
+
+	PoolItem* items[3];
+	for (int i = 0; i < 3; i++)
+		items[i] = pool.alloc();
+
+	EXPECT_TRUE(pool.alloc() == 0);
+
+	for (int i = 0; i < 3; i++)
+		pool.dealloc(items[i]);
+
+	EXPECT_TRUE(pool.alloc() != 0);
+}
+
+TEST(TEST_CASE_NAME, testStats)
+{
+	utMemoryPool<PoolItem, 0> pool;
+
+	utArray<PoolItem*> items;
+	for (int i = 0; i < 1000; i++)
+		items.push_back(pool.alloc());
+
+	utMemoryPoolStats stats;
+	pool.getStats(stats);
+	EXPECT_EQ(stats.live, 1000);
+	EXPECT_EQ(stats.peak, 1000);
+	EXPECT_GE(stats.slots, 1000);
+	EXPECT_GE(stats.reservedBytes, stats.slots * stats.slotSize);
+	EXPECT_EQ(pool.getLiveBytes(), 1000 * stats.slotSize);
+
+	for (UTsize i = 0; i < items.size(); i++)
+		pool.dealloc(items[i]);
+
+	pool.getStats(stats);
+	EXPECT_EQ(stats.live, 0);
+	EXPECT_EQ(stats.peak, 1000);
+}
+
+TEST(TEST_CASE_NAME, testThreads)
+{
+	utMemoryPool<ChurnItem, 0> pool;
+	gkJobSystem jobs(3);
+
+	ChurnBody body(pool);
+	jobs.parallelFor(10000, 16, body);
+
+	EXPECT_EQ(pool.getLiveCount(), 0);
+	EXPECT_EQ(pool.getPeakCount() <= 4 * 8, true);
+
+	// magazines keep the slot count near threads * (8 + magazine)
+	EXPECT_LT(pool.getAllocatedCount(), 4096);
+}
+
+TEST(TEST_CASE_NAME, testPooledClass)
+{
+	utMemoryPoolStats before, after;
+	utPoolAllocator::getStats(6, before);
+
+	PooledBase* p = new PooledLarge();
+	utPoolAllocator::getStats(6, after);
+	EXPECT_EQ(after.live, before.live + 1);
+
+	delete p;
+	utPoolAllocator::getStats(6, after);
+	EXPECT_EQ(after.live, before.live);
+}